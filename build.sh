@@ -25,6 +25,8 @@ for ARGI; do
         echo "    Build stand-alone apps"
         echo "  --tests"
         echo "    Build executable with basic tests"
+        echo "  --benchmarks"
+        echo "    Build performance benchmarks"
 
         exit 0
     elif [ "${ARGI}" = "--clean" -o "${ARGI}" = "-c" -o "${ARGI}" = "clean" ]; then
@@ -38,6 +40,8 @@ for ARGI; do
         CMAKE_FLAGS+=" -DBUILD_APPS=true"
     elif [ "${ARGI}" = "--tests" ]; then
         CMAKE_FLAGS+=" -DBUILD_TESTS=true"
+    elif [ "${ARGI}" = "--benchmarks" ]; then
+        CMAKE_FLAGS+=" -DBUILD_BENCHMARKS=true"
     fi
 done
 
@@ -12,6 +12,8 @@
 #include <chrono>
 
 #include "utils/InterfaceHelper.h"
+#include "utils/LatencyTracker.h"
+#include "utils/MetricsExporter.h"
 
 DEFINE_bool(use_mcast, false, "Enable UDP Multicast");
 DEFINE_string(mcast_group, "224.1.1.1", "UDP Multicast Group");
@@ -19,6 +21,10 @@ DEFINE_string(iface_ip, "127.0.0.1", "Local network interface IP");
 DEFINE_int32(port, 9760, "Target port for UDP traffic");
 
 DEFINE_string(outdir, "/tmp/", "Target directory for output log files");
+DEFINE_int32(latency_report_sec, 10, "Pipeline latency report period, with --latency_tracking");
+DEFINE_int32(metrics_port, 0, "Serve Prometheus metrics on localhost at this port (0 = off)");
+DEFINE_string(metrics_file, "", "Periodically rewrite Prometheus metrics to this file");
+DEFINE_double(metrics_period_sec, 10.0, "Rewrite period of --metrics_file");
 
 int main(int argc, char *argv[]) {
   // Initialize Google’s logging library.
@@ -44,11 +50,23 @@ int main(int argc, char *argv[]) {
 
   ss_helper.run_threads();
 
+  MetricsExporter metrics;
+  metrics.add_interface_helper(ss_helper);
+  if (FLAGS_metrics_port > 0)
+    metrics.serve_http(FLAGS_metrics_port);
+  if (!FLAGS_metrics_file.empty())
+    metrics.write_file(FLAGS_metrics_file, FLAGS_metrics_period_sec);
+
   UdpPtsData pts;
   bool _new_data = false;
+  int64_t elapsed_sec = 0;
   while (true) {
     //sleep(1);
     std::this_thread::sleep_for(std::chrono::seconds(1));
+    elapsed_sec++;
+    if (FLAGS_latency_tracking && FLAGS_latency_report_sec > 0 &&
+        elapsed_sec % FLAGS_latency_report_sec == 0)
+      LOG(INFO) << "Pipeline latency" << std::endl << LatencyTracker::instance().report();
   }
 
   return 0;
@@ -0,0 +1,541 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: traffic_generator.cpp                                  */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+// Synthetic AcSense traffic for load testing the receive / processing / logging chain.
+//
+// Every packet is built with the same encoders the decoders are tested against, so a
+// run_logger (or any other consumer) pointed at --dest_ip:--port sees well-formed
+// AC, ACB2, ACBR/ACBC, PT, IM, EP, RT, BN and BR traffic. Packet loss and reordering
+// can be injected on the send side; --flood ignores the configured rates and sends as
+// fast as the socket allows, to find the packets/s ceiling of the receiving side.
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <iomanip>
+#include <netinet/in.h>
+#include <random>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// includes from within project
+#include "udp_protocols/UdpAcousticData.h"
+#include "udp_protocols/UdpBeamform2D.h"
+#include "udp_protocols/UdpBeamformRaw.h"
+#include "udp_protocols/UdpBnoData.h"
+#include "udp_protocols/UdpBnrData.h"
+#include "udp_protocols/UdpEptData.h"
+#include "udp_protocols/UdpImuData.h"
+#include "udp_protocols/UdpPtsData.h"
+#include "udp_protocols/UdpRtcData.h"
+
+DEFINE_string(dest_ip, "127.0.0.1", "Destination IP for generated UDP traffic");
+DEFINE_int32(port, 9760, "Destination port for generated UDP traffic");
+DEFINE_string(types, "AC,PTS,IMU,EPT,RTC,BNO,BNR",
+              "Comma separated packet types: AC, ACB2, ACBR, PTS, IMU, EPT, RTC, BNO, BNR");
+DEFINE_double(duration_sec, 10, "Run time in seconds; <= 0 runs until interrupted");
+DEFINE_bool(flood, false, "Ignore the configured rates and send as fast as possible");
+DEFINE_double(report_interval, 1.0, "Seconds between rate reports");
+DEFINE_int32(send_buffer_bytes, 4 << 20, "Requested SO_SNDBUF size");
+
+DEFINE_int32(channels, 8, "Acoustic channels per AC packet");
+DEFINE_double(sample_rate, 52734, "Acoustic sample rate [Hz]");
+DEFINE_int32(samples_per_packet, 32, "Acoustic samples per channel in each AC packet");
+DEFINE_double(aco_rate, 0, "AC packets/s; 0 derives it from sample_rate / samples_per_packet");
+DEFINE_double(tone_hz, 1000, "Frequency of the tone on every acoustic channel [Hz]");
+DEFINE_double(tone_amplitude, 8000, "Tone amplitude [counts]");
+DEFINE_double(noise_amplitude, 500, "Standard deviation of the added noise [counts]");
+
+DEFINE_double(beam2d_rate, 1, "ACB2 packets/s");
+DEFINE_double(beamraw_rate, 0.5, "ACBR series/s");
+DEFINE_int32(beam_elements, 8, "Array elements in beamformer packets");
+DEFINE_int32(beam_frequencies, 64, "Frequencies in beamformer packets");
+DEFINE_int32(beam_bearings, 360, "Bearings in beamformer packets");
+DEFINE_int32(beam_elevations, 9, "Elevations in beamformer packets");
+DEFINE_int32(max_datagram, 65000, "Largest datagram; ACBR series are split into ACBC packets");
+
+DEFINE_double(sensor_rate, 10, "Packets/s for each sensor type");
+
+DEFINE_double(loss_prob, 0, "Probability that a datagram is dropped instead of sent");
+DEFINE_double(reorder_prob, 0, "Probability that a datagram is held back and sent late");
+DEFINE_int32(reorder_depth, 3, "Number of later datagrams sent before a held one");
+DEFINE_int32(seed, 0, "Seed for noise, loss and reorder; 0 seeds from the clock");
+
+static volatile std::sig_atomic_t keep_running = 1;
+static void handle_signal(int) { keep_running = 0; }
+
+static int64_t epoch_nsec() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+struct Stream {
+  std::string name;
+  double rate_hz;
+  // builds the datagram(s) for the next packet
+  std::function<void(std::vector<std::vector<int8_t>> &)> make;
+
+  std::chrono::steady_clock::time_point next;
+  std::chrono::nanoseconds period{0};
+
+  uint64_t packets = 0;
+  uint64_t sent = 0;
+  uint64_t dropped = 0;
+  uint64_t reordered = 0;
+  uint64_t send_errors = 0;
+  uint64_t bytes = 0;
+  uint64_t late = 0;
+};
+
+// Datagram output with loss / reorder injection
+class Sender {
+public:
+  Sender(int sock, sockaddr_in addr, uint32_t seed) : sock(sock), addr(addr), rng(seed) {}
+
+  void send(std::vector<int8_t> &msg, Stream &stream) {
+    if (FLAGS_loss_prob > 0 && this->uniform(this->rng) < FLAGS_loss_prob) {
+      stream.dropped++;
+      return;
+    }
+    if (FLAGS_reorder_prob > 0 && this->uniform(this->rng) < FLAGS_reorder_prob) {
+      this->held.push_back({this->num_sent + FLAGS_reorder_depth, &stream, std::move(msg)});
+      stream.reordered++;
+      return;
+    }
+
+    this->send_now(msg, stream);
+    while (!this->held.empty() && this->held.front().release_after <= this->num_sent) {
+      Held &hh = this->held.front();
+      this->send_now(hh.msg, *hh.stream);
+      this->held.pop_front();
+    }
+  }
+
+  void flush() {
+    for (auto &hh : this->held) {
+      this->send_now(hh.msg, *hh.stream);
+    }
+    this->held.clear();
+  }
+
+protected:
+  struct Held {
+    uint64_t release_after;
+    Stream *stream;
+    std::vector<int8_t> msg;
+  };
+
+  void send_now(const std::vector<int8_t> &msg, Stream &stream) {
+    ssize_t res = sendto(this->sock, msg.data(), msg.size(), 0,
+                         reinterpret_cast<const sockaddr *>(&this->addr), sizeof(this->addr));
+    if (res < 0) {
+      stream.send_errors++;
+      VLOG_EVERY_N(1, 1000) << "sendto failed for " << stream.name << ": " << std::strerror(errno);
+      return;
+    }
+    stream.sent++;
+    stream.bytes += msg.size();
+    this->num_sent++;
+  }
+
+  int sock;
+  sockaddr_in addr;
+  std::mt19937 rng;
+  std::uniform_real_distribution<double> uniform{0.0, 1.0};
+  std::deque<Held> held;
+  uint64_t num_sent = 0;
+};
+
+// Stream factories
+// ================
+static Stream make_aco_stream(std::mt19937 &rng) {
+  int num_ch = FLAGS_channels;
+  int spp = FLAGS_samples_per_packet;
+  double fs = FLAGS_sample_rate;
+
+  // one second of tone + noise (rounded to whole packets), replayed as a ring
+  int num_blocks = std::max(1, (int)std::round(fs / spp));
+  Eigen::MatrixX<int16_t> ring(num_ch, (Eigen::Index)num_blocks * spp);
+  std::normal_distribution<double> noise(0.0, FLAGS_noise_amplitude);
+  for (Eigen::Index ss = 0; ss < ring.cols(); ss++) {
+    double tone = FLAGS_tone_amplitude * std::sin(2 * M_PI * FLAGS_tone_hz * ss / fs);
+    for (int ch = 0; ch < num_ch; ch++) {
+      double val = std::round(tone + noise(rng));
+      ring(ch, ss) = (int16_t)std::max(-32768.0, std::min(32767.0, val));
+    }
+  }
+
+  auto aco = UdpAcousticData::create(Eigen::MatrixX<int16_t>(num_ch, spp), num_ch, num_ch * spp,
+                                     fs, 0, 0, 0, 0);
+  int64_t t0_nsec = epoch_nsec();
+  int64_t packet_num = 0;
+
+  Stream stream;
+  stream.name = "AC";
+  stream.rate_hz = FLAGS_aco_rate > 0 ? FLAGS_aco_rate : fs / spp;
+  stream.make = [=](std::vector<std::vector<int8_t>> &out) mutable {
+    // timestamps follow the sample clock, so consumers see a gap-free stream
+    int64_t start_sample = packet_num * spp;
+    aco->header.start_time_nsec = t0_nsec + (int64_t)(start_sample * 1e9 / fs);
+    aco->header.tick_time_nsec = aco->header.start_time_nsec - t0_nsec;
+    aco->header.adc_count = start_sample;
+    aco->header.packet_num = packet_num;
+    aco->data = ring.middleCols((packet_num % num_blocks) * spp, spp);
+    packet_num++;
+    out.push_back(aco->encode());
+  };
+  return stream;
+}
+
+template <typename T> static void fill_beamformer_geometry(T &header) {
+  header.num_elements = FLAGS_beam_elements;
+  header.num_frequencies = FLAGS_beam_frequencies;
+  header.num_bearings = FLAGS_beam_bearings;
+  header.num_elevations = FLAGS_beam_elevations;
+  header.sample_rate = FLAGS_sample_rate;
+  header.window_length_sec = 1.0;
+}
+
+static Stream make_beam2d_stream() {
+  auto beam = std::make_shared<UdpBeamform2D>();
+  fill_beamformer_geometry(beam->header);
+  // 2D packets carry a single (frequency-averaged) slice per bearing / elevation
+  beam->header.num_frequencies = 1;
+
+  int num_el = FLAGS_beam_elements;
+  Eigen::VectorXd angles = Eigen::VectorXd::LinSpaced(num_el, 0, 2 * M_PI * (num_el - 1) / num_el);
+  beam->data.array_x = 0.1 * angles.array().cos();
+  beam->data.array_y = 0.1 * angles.array().sin();
+  beam->data.array_z = Eigen::VectorXd::Zero(num_el);
+  beam->data.frequencies = Eigen::VectorXd::Constant(1, FLAGS_tone_hz);
+  beam->data.element_mask = Eigen::VectorX<bool>::Constant(num_el, true);
+  beam->data.element_weights = Eigen::VectorXd::Ones(num_el);
+  beam->data.bearings_rad = Eigen::VectorXd::LinSpaced(FLAGS_beam_bearings, -M_PI, M_PI);
+  beam->data.elevations_rad =
+      Eigen::VectorXd::LinSpaced(FLAGS_beam_elevations, -M_PI / 2, M_PI / 2);
+  beam->data.beampattern =
+      Eigen::MatrixXd::Random(FLAGS_beam_bearings, FLAGS_beam_elevations).cwiseAbs();
+
+  int32_t packet_num = 0;
+
+  Stream stream;
+  stream.name = "ACB2";
+  stream.rate_hz = FLAGS_beam2d_rate;
+  stream.make = [=](std::vector<std::vector<int8_t>> &out) mutable {
+    beam->header.start_time_nsec = epoch_nsec();
+    beam->header.packet_num = packet_num++;
+    out.push_back(beam->encode());
+  };
+  return stream;
+}
+
+static Stream make_beamraw_stream(std::mt19937 &rng) {
+  auto beam = std::make_shared<UdpBeamformRaw>();
+  fill_beamformer_geometry(beam->header);
+
+  int num_el = FLAGS_beam_elements;
+  std::uniform_real_distribution<double> level(0.0, 1.0);
+  for (int ii = 0; ii < num_el; ii++) {
+    double angle = 2 * M_PI * ii / num_el;
+    beam->data.array_x.push_back(0.1 * std::cos(angle));
+    beam->data.array_y.push_back(0.1 * std::sin(angle));
+    beam->data.array_z.push_back(0);
+    beam->data.element_mask.push_back(true);
+    beam->data.element_weights.push_back(1);
+  }
+  for (int ii = 0; ii < FLAGS_beam_frequencies; ii++) {
+    beam->data.frequencies.push_back(FLAGS_sample_rate / 2 * (ii + 1) / FLAGS_beam_frequencies);
+  }
+  for (int ii = 0; ii < FLAGS_beam_bearings; ii++) {
+    beam->data.bearings_rad.push_back(-M_PI + 2 * M_PI * ii / FLAGS_beam_bearings);
+  }
+  for (int ii = 0; ii < FLAGS_beam_elevations; ii++) {
+    beam->data.elevations_rad.push_back(-M_PI / 2 + M_PI * ii / FLAGS_beam_elevations);
+  }
+  beam->data.beampattern.assign(
+      FLAGS_beam_bearings,
+      std::vector<std::vector<double>>(FLAGS_beam_elevations,
+                                       std::vector<double>(FLAGS_beam_frequencies)));
+  for (auto &slice_ee : beam->data.beampattern) {
+    for (auto &slice_ff : slice_ee) {
+      for (auto &val : slice_ff) {
+        val = level(rng);
+      }
+    }
+  }
+
+  int32_t packet_num = 0;
+
+  Stream stream;
+  stream.name = "ACBR";
+  stream.rate_hz = FLAGS_beamraw_rate;
+  stream.make = [=](std::vector<std::vector<int8_t>> &out) mutable {
+    beam->header.start_time_nsec = epoch_nsec();
+    beam->header.packet_num = packet_num++;
+    out = beam->encode_datagrams(FLAGS_max_datagram);
+  };
+  return stream;
+}
+
+static Stream make_sensor_stream(const std::string &name) {
+  Stream stream;
+  stream.name = name;
+  stream.rate_hz = FLAGS_sensor_rate;
+  int64_t count = 0;
+
+  // slowly varying values, so plots of the logged output are recognizable
+  if (name == "PTS") {
+    stream.make = [=](std::vector<std::vector<int8_t>> &out) mutable {
+      UdpPtsData pts;
+      pts.header.start_time_nsec = epoch_nsec();
+      pts.pressure_mbar = 1013.25 + 5 * std::sin(count * 0.01);
+      pts.temperature_c = 20 + std::cos(count++ * 0.001);
+      out.push_back(pts.encode());
+    };
+  } else if (name == "IMU") {
+    stream.make = [=](std::vector<std::vector<int8_t>> &out) mutable {
+      UdpImuData imu;
+      imu.header.start_time_nsec = epoch_nsec();
+      imu.pitch_ned_deg = 10 * std::sin(count * 0.05);
+      imu.roll_ned_deg = 5 * std::cos(count * 0.05);
+      imu.accel_z = 1000;
+      imu.gyro_x = count++ % 100;
+      out.push_back(imu.encode());
+    };
+  } else if (name == "EPT") {
+    stream.make = [=](std::vector<std::vector<int8_t>> &out) mutable {
+      UdpEptData ept;
+      ept.header.start_time_nsec = epoch_nsec();
+      ept.pressure_mbar = 2000 + 50 * std::sin(count * 0.01);
+      ept.temperature_c = 12 + std::cos(count++ * 0.001);
+      out.push_back(ept.encode());
+    };
+  } else if (name == "RTC") {
+    stream.make = [=](std::vector<std::vector<int8_t>> &out) mutable {
+      UdpRtcData rtc;
+      rtc.header.start_time_nsec = epoch_nsec();
+      rtc.rtc_time = rtc.header.start_time_nsec / 1000000000;
+      out.push_back(rtc.encode());
+    };
+  } else if (name == "BNO") {
+    stream.make = [=](std::vector<std::vector<int8_t>> &out) mutable {
+      const char sense_chars[3] = {'A', 'G', 'M'};
+      UdpBnoData bno;
+      bno.header.start_time_nsec = epoch_nsec();
+      bno.sense_char = sense_chars[count % 3];
+      bno.status = 3;
+      bno.sense_x = std::sin(count * 0.02);
+      bno.sense_y = std::cos(count * 0.02);
+      bno.sense_z = 9.81;
+      count++;
+      out.push_back(bno.encode());
+    };
+  } else if (name == "BNR") {
+    stream.make = [=](std::vector<std::vector<int8_t>> &out) mutable {
+      UdpBnrData bnr;
+      bnr.header.start_time_nsec = epoch_nsec();
+      double half_yaw = 0.5 * std::fmod(count++ * 0.01, 2 * M_PI);
+      bnr.status = 3;
+      bnr.quat_k = std::sin(half_yaw);
+      bnr.quat_r = std::cos(half_yaw);
+      bnr.accuracy = 0.1;
+      out.push_back(bnr.encode());
+    };
+  } else {
+    stream.make = nullptr;
+  }
+  return stream;
+}
+
+static void print_report(std::vector<Stream> &streams, std::vector<Stream> &last, double elapsed,
+                         bool final) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1);
+  oss << (final ? "Totals" : "Rates") << " over " << elapsed << " s:";
+
+  uint64_t tot_sent = 0;
+  uint64_t tot_bytes = 0;
+  for (size_t ii = 0; ii < streams.size(); ii++) {
+    Stream &ss = streams.at(ii);
+    uint64_t sent = ss.sent - (final ? 0 : last.at(ii).sent);
+    uint64_t bytes = ss.bytes - (final ? 0 : last.at(ii).bytes);
+    tot_sent += sent;
+    tot_bytes += bytes;
+
+    oss << std::endl
+        << "  " << std::setw(5) << ss.name << ": " << std::setw(10) << sent / elapsed << " pkt/s "
+        << std::setw(9) << bytes * 8 / elapsed / 1e6 << " Mbit/s";
+    if (final) {
+      oss << "  packets=" << ss.packets << " sent=" << ss.sent << " dropped=" << ss.dropped
+          << " reordered=" << ss.reordered << " errors=" << ss.send_errors
+          << " late=" << ss.late;
+    }
+  }
+  oss << std::endl
+      << "  " << std::setw(5) << "ALL"
+      << ": " << std::setw(10) << tot_sent / elapsed << " pkt/s " << std::setw(9)
+      << tot_bytes * 8 / elapsed / 1e6 << " Mbit/s";
+  LOG(INFO) << oss.str();
+}
+
+int main(int argc, char *argv[]) {
+  // Initialize Google’s logging library.
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_alsologtostderr = 1;
+
+  gflags::SetUsageMessage("Usage:");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_channels < 1 || FLAGS_channels > 127 || FLAGS_samples_per_packet < 1) {
+    LOG(ERROR) << "--channels must be in [1, 127] and --samples_per_packet positive";
+    return 1;
+  }
+  if (FLAGS_channels * FLAGS_samples_per_packet * 2 + sizeof(UdpAcousticData::Header) > 65507) {
+    LOG(ERROR) << "AC packets of " << FLAGS_channels << " x " << FLAGS_samples_per_packet
+               << " samples do not fit in a UDP datagram";
+    return 1;
+  }
+  if (FLAGS_max_datagram > 65507) {
+    LOG(WARNING) << "--max_datagram limited to 65507 bytes";
+    FLAGS_max_datagram = 65507;
+  }
+
+  uint32_t seed = FLAGS_seed != 0 ? FLAGS_seed : (uint32_t)epoch_nsec();
+  std::mt19937 rng(seed);
+
+  std::vector<Stream> streams;
+  std::stringstream ss_types(FLAGS_types);
+  std::string type;
+  while (std::getline(ss_types, type, ',')) {
+    if (type.empty()) {
+      continue;
+    }
+    Stream stream;
+    if (type == "AC") {
+      stream = make_aco_stream(rng);
+    } else if (type == "ACB2") {
+      stream = make_beam2d_stream();
+    } else if (type == "ACBR") {
+      stream = make_beamraw_stream(rng);
+    } else {
+      stream = make_sensor_stream(type);
+    }
+    if (!stream.make) {
+      LOG(ERROR) << "Unknown packet type " << type;
+      return 1;
+    }
+    if (stream.rate_hz <= 0 && !FLAGS_flood) {
+      LOG(INFO) << "Skipping " << type << " (rate " << stream.rate_hz << ")";
+      continue;
+    }
+    streams.push_back(std::move(stream));
+  }
+  if (streams.empty()) {
+    LOG(ERROR) << "Nothing to send";
+    return 1;
+  }
+
+  int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock < 0) {
+    LOG(ERROR) << "Could not create socket!";
+    return 1;
+  }
+  int sndbuf = FLAGS_send_buffer_bytes;
+  setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(FLAGS_port);
+  if (inet_pton(AF_INET, FLAGS_dest_ip.c_str(), &addr.sin_addr) != 1) {
+    LOG(ERROR) << "Invalid destination IP " << FLAGS_dest_ip;
+    return 1;
+  }
+
+  std::signal(SIGINT, handle_signal);
+  std::signal(SIGTERM, handle_signal);
+
+  Sender sender(sock, addr, seed + 1);
+
+  auto t_start = std::chrono::steady_clock::now();
+  for (auto &stream : streams) {
+    stream.period = FLAGS_flood ? std::chrono::nanoseconds(0)
+                                : std::chrono::nanoseconds((int64_t)(1e9 / stream.rate_hz));
+    stream.next = t_start;
+    LOG(INFO) << "Generating " << stream.name << " at "
+              << (FLAGS_flood ? "max" : std::to_string(stream.rate_hz)) << " packets/s to "
+              << FLAGS_dest_ip << ":" << FLAGS_port;
+  }
+
+  auto t_end = t_start + std::chrono::nanoseconds((int64_t)(FLAGS_duration_sec * 1e9));
+  auto report_period = std::chrono::nanoseconds((int64_t)(FLAGS_report_interval * 1e9));
+  auto t_report = t_start + report_period;
+  std::vector<Stream> last = streams;
+
+  std::vector<std::vector<int8_t>> datagrams;
+  while (keep_running) {
+    // earliest due stream; in flood mode all are due and they take turns
+    Stream *due = &streams.front();
+    for (auto &stream : streams) {
+      if (stream.next < due->next) {
+        due = &stream;
+      }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (FLAGS_duration_sec > 0 && now >= t_end) {
+      break;
+    }
+    if (now >= t_report) {
+      std::chrono::duration<double> elapsed = now - (t_report - report_period);
+      print_report(streams, last, elapsed.count(), false);
+      last = streams;
+      t_report += report_period;
+      continue;
+    }
+    if (due->next > now) {
+      auto wake = std::min(due->next, t_report);
+      // unbounded runs have no end time to wake for (t_end == t_start)
+      if (FLAGS_duration_sec > 0)
+        wake = std::min(wake, t_end);
+      std::this_thread::sleep_until(wake);
+      continue;
+    }
+
+    // a stream more than one period behind means the generator is the bottleneck
+    if (!FLAGS_flood && now - due->next > due->period) {
+      due->late++;
+    }
+
+    datagrams.clear();
+    due->make(datagrams);
+    due->packets++;
+    for (auto &msg : datagrams) {
+      sender.send(msg, *due);
+    }
+    due->next += FLAGS_flood ? std::chrono::nanoseconds(1) : due->period;
+  }
+  sender.flush();
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t_start;
+  print_report(streams, last, elapsed.count(), true);
+
+  close(sock);
+  return 0;
+}
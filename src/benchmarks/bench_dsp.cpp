@@ -0,0 +1,265 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: bench_dsp.cpp                                          */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+// FFT frame throughput and detector per-frame cost, through the synchronous
+// process() calls that the processing threads wrap.
+
+#include <benchmark/benchmark.h>
+
+#include "benchmarks.h"
+
+// includes from within project
+#include "utils/Beamformer.h"
+#include "utils/EnergyDetector.h"
+#include "utils/FFT.h"
+#include "utils/SteeringCache.h"
+#include "utils/ToneTracker.h"
+
+static const int NUM_FRAMES_PER_PACKET = 32;
+
+// Each iteration feeds one hop (nstep samples) of packets, i.e. yields one frame
+static void BM_FFTFrames(benchmark::State &state) {
+  size_t NFFT = state.range(0);
+  int num_channels = state.range(1);
+
+  FFT fft;
+  fft.set_NFFT(NFFT);
+  size_t packets_per_hop = std::max<size_t>(1, fft.get_nstep() / NUM_FRAMES_PER_PACKET);
+  auto stream = make_aco_stream(num_channels, NUM_FRAMES_PER_PACKET, 64 * packets_per_hop);
+
+  // fill the first window outside the timed loop
+  size_t idx = 0;
+  std::vector<std::shared_ptr<UdpAcousticData>> hop;
+  while (idx * NUM_FRAMES_PER_PACKET < NFFT) {
+    fft.process(stream.at(idx++ % stream.size()));
+  }
+
+  size_t num_frames = 0;
+  for (auto _ : state) {
+    hop.clear();
+    for (size_t ii = 0; ii < packets_per_hop; ii++) {
+      hop.push_back(stream.at(idx++ % stream.size()));
+    }
+    num_frames += fft.process(hop).size();
+  }
+  state.SetItemsProcessed(num_frames);
+  state.counters["frames"] = num_frames;
+}
+BENCHMARK(BM_FFTFrames)
+    ->ArgNames({"NFFT", "ch"})
+    ->Args({256, 8})
+    ->Args({1024, 8})
+    ->Args({4096, 8})
+    ->Args({16384, 8})
+    ->Args({1024, 32})
+    ->Unit(benchmark::kMicrosecond);
+
+// Same feed as BM_FFTFrames in Welch mode: frames are folded into a running |X|^2 sum,
+// and one PSD is allocated per 16 hops instead of one complex frame per hop
+static void BM_FFTWelchPSD(benchmark::State &state) {
+  size_t NFFT = state.range(0);
+  int num_channels = state.range(1);
+
+  FFT fft;
+  fft.set_NFFT(NFFT);
+  fft.set_psd_averages(16);
+  size_t packets_per_hop = std::max<size_t>(1, fft.get_nstep() / NUM_FRAMES_PER_PACKET);
+  auto stream = make_aco_stream(num_channels, NUM_FRAMES_PER_PACKET, 64 * packets_per_hop);
+
+  size_t idx = 0;
+  std::vector<std::shared_ptr<UdpAcousticData>> hop;
+  while (idx * NUM_FRAMES_PER_PACKET < NFFT) {
+    fft.process_psd({stream.at(idx++ % stream.size())});
+  }
+
+  size_t num_averages = 0;
+  for (auto _ : state) {
+    hop.clear();
+    for (size_t ii = 0; ii < packets_per_hop; ii++) {
+      hop.push_back(stream.at(idx++ % stream.size()));
+    }
+    num_averages += fft.process_psd(hop).size();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["averages"] = num_averages;
+}
+BENCHMARK(BM_FFTWelchPSD)
+    ->ArgNames({"NFFT", "ch"})
+    ->Args({1024, 8})
+    ->Args({4096, 8})
+    ->Unit(benchmark::kMicrosecond);
+
+// Same feed as BM_FFTFrames, tracking a few tones instead of the full spectrum
+static void BM_ToneTracker(benchmark::State &state) {
+  size_t NFFT = state.range(0);
+  int num_bins = state.range(1);
+  TONE_METHOD method = state.range(2) ? TONE_METHOD::SLIDING_DFT : TONE_METHOD::GOERTZEL;
+  int num_channels = 8;
+
+  auto stream = make_aco_stream(num_channels, NUM_FRAMES_PER_PACKET, 64);
+  ToneTracker tones;
+  tones.set_NFFT(NFFT);
+  tones.set_sample_rate(stream.front()->header.sample_rate);
+  for (int ii = 0; ii < num_bins; ii++) {
+    tones.add_frequency_bin_closest(1000.0 * (ii + 1));
+  }
+  tones.set_method(method);
+  size_t packets_per_hop = std::max<size_t>(1, tones.get_nstep() / NUM_FRAMES_PER_PACKET);
+
+  size_t idx = 0;
+  std::vector<std::shared_ptr<UdpAcousticData>> hop;
+  while (idx * NUM_FRAMES_PER_PACKET < NFFT) {
+    tones.process({stream.at(idx++ % stream.size())});
+  }
+
+  size_t num_frames = 0;
+  for (auto _ : state) {
+    hop.clear();
+    for (size_t ii = 0; ii < packets_per_hop; ii++) {
+      hop.push_back(stream.at(idx++ % stream.size()));
+    }
+    num_frames += tones.process(hop).size();
+  }
+  state.SetItemsProcessed(num_frames);
+  state.counters["frames"] = num_frames;
+}
+BENCHMARK(BM_ToneTracker)
+    ->ArgNames({"NFFT", "bins", "sdft"})
+    ->Args({1024, 1, 0})
+    ->Args({1024, 4, 0})
+    ->Args({1024, 1, 1})
+    ->Args({1024, 4, 1})
+    ->Args({16384, 4, 0})
+    ->Args({16384, 4, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_EnergyDetector(benchmark::State &state) {
+  size_t NFFT = state.range(0);
+  int num_channels = state.range(1);
+
+  FFT fft;
+  fft.set_NFFT(NFFT);
+  auto stream = make_aco_stream(num_channels, NUM_FRAMES_PER_PACKET,
+                                2 * NFFT / NUM_FRAMES_PER_PACKET + 1);
+  std::vector<std::shared_ptr<IpcFFT>> frames = fft.process(stream);
+
+  EnergyDetector detector;
+  detector.set_NFFT(NFFT);
+  detector.set_sample_rate(stream.front()->header.sample_rate);
+  detector.add_frequency_band_min_max(500, 5000);
+
+  size_t idx = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(detector.process(frames.at(idx++ % frames.size())));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EnergyDetector)
+    ->ArgNames({"NFFT", "ch"})
+    ->Args({256, 8})
+    ->Args({1024, 8})
+    ->Args({4096, 8})
+    ->Args({1024, 32})
+    ->Args({1024, 64});
+
+// Batches of frames, as the detector thread hands them over after pop_all()
+static void BM_EnergyDetectorBatch(benchmark::State &state) {
+  size_t NFFT = 1024;
+  int num_channels = state.range(0);
+  size_t batch_size = state.range(1);
+
+  FFT fft;
+  fft.set_NFFT(NFFT);
+  auto stream = make_aco_stream(num_channels, NUM_FRAMES_PER_PACKET,
+                                (batch_size + 1) * NFFT / 2 / NUM_FRAMES_PER_PACKET + 1);
+  std::vector<std::shared_ptr<IpcFFT>> frames = fft.process(stream);
+  frames.resize(std::min(frames.size(), batch_size));
+
+  EnergyDetector detector;
+  detector.set_NFFT(NFFT);
+  detector.set_sample_rate(stream.front()->header.sample_rate);
+  detector.add_frequency_band_min_max(500, 5000);
+
+  std::vector<std::shared_ptr<IpcDetector>> detections;
+  for (auto _ : state) {
+    detections.clear();
+    detector.process_batch(frames, detections);
+    benchmark::DoNotOptimize(detections.data());
+  }
+  state.SetItemsProcessed(state.iterations() * frames.size());
+}
+BENCHMARK(BM_EnergyDetectorBatch)
+    ->ArgNames({"ch", "batch"})
+    ->Args({8, 16})
+    ->Args({32, 16})
+    ->Args({64, 16});
+
+// Conventional beamforming of a batch of frames: 72 bearings x 4 elevations over a
+// 500-2000 Hz band, on a ring of ch elements
+static void BM_Beamformer(benchmark::State &state) {
+  size_t NFFT = 1024;
+  int num_channels = state.range(0);
+  size_t batch_size = state.range(1);
+
+  FFT fft;
+  fft.set_NFFT(NFFT);
+  auto stream = make_aco_stream(num_channels, NUM_FRAMES_PER_PACKET,
+                                (batch_size + 1) * NFFT / 2 / NUM_FRAMES_PER_PACKET + 1);
+  std::vector<std::shared_ptr<IpcFFT>> frames = fft.process(stream);
+  frames.resize(std::min(frames.size(), batch_size));
+
+  Eigen::VectorXd angle =
+      Eigen::VectorXd::LinSpaced(num_channels, 0, 2 * M_PI * (num_channels - 1) / num_channels);
+  Beamformer beamformer;
+  beamformer.set_NFFT(NFFT);
+  beamformer.set_sample_rate(stream.front()->header.sample_rate);
+  beamformer.add_frequency_band_min_max(500, 2000);
+  beamformer.set_array(0.5 * angle.array().cos(), 0.5 * angle.array().sin(),
+                       Eigen::VectorXd::Zero(num_channels));
+  beamformer.set_elevations_rad(Eigen::VectorXd::LinSpaced(4, 0, M_PI / 4));
+
+  for (auto _ : state) {
+    auto patterns = beamformer.process(frames);
+    benchmark::DoNotOptimize(patterns.data());
+  }
+  state.SetItemsProcessed(state.iterations() * frames.size());
+}
+BENCHMARK(BM_Beamformer)
+    ->ArgNames({"ch", "batch"})
+    ->Args({8, 1})
+    ->Args({8, 16})
+    ->Args({32, 16})
+    ->Args({64, 16});
+
+// Steering tensor for an incoming 64-element, 72 x 4 beam, 29 frequency header: built from
+// scratch vs. kept by SteeringCache::refresh while the header does not change
+static void BM_SteeringTensor(benchmark::State &state) {
+  bool cached = state.range(0);
+  int num_elements = 64;
+  Eigen::VectorXd angle =
+      Eigen::VectorXd::LinSpaced(num_elements, 0, 2 * M_PI * (num_elements - 1) / num_elements);
+  UdpBeamform2D beam;
+  beam.data.array_x = 0.5 * angle.array().cos();
+  beam.data.array_y = 0.5 * angle.array().sin();
+  beam.data.array_z = Eigen::VectorXd::Zero(num_elements);
+  beam.data.frequencies = Eigen::VectorXd::LinSpaced(29, 500, 2000);
+  beam.data.bearings_rad = Eigen::VectorXd::LinSpaced(72, 0, 2 * M_PI * 71 / 72);
+  beam.data.elevations_rad = Eigen::VectorXd::LinSpaced(4, 0, M_PI / 4);
+
+  std::shared_ptr<const SteeringTensor> current;
+  for (auto _ : state) {
+    if (cached) {
+      SteeringCache::instance().refresh(current, beam.data, 1500);
+    } else {
+      current = std::make_shared<const SteeringTensor>(SteeringGrid(beam.data, 1500));
+    }
+    benchmark::DoNotOptimize(current.get());
+  }
+}
+BENCHMARK(BM_SteeringTensor)->ArgName("cached")->Arg(0)->Arg(1);
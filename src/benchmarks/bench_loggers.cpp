@@ -0,0 +1,74 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: bench_loggers.cpp                                      */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+// Acoustic logger throughput, written synchronously in the calling thread so the
+// numbers are the formatting / encoding cost plus the file I/O the logger issues.
+// Closing the file (final flush) is included once per run.
+
+#include <benchmark/benchmark.h>
+
+#include "benchmarks.h"
+
+// includes from within project
+#include "utils/Logger_Acoustic.h"
+
+static const int NUM_FRAMES_PER_PACKET = 32;
+static const size_t NUM_RING_PACKETS = 256;
+
+template <typename LOGGER>
+static void run_logger_benchmark(benchmark::State &state, LOGGER &logger, const char *name) {
+  int num_channels = state.range(0);
+  auto ring = make_aco_stream(num_channels, NUM_FRAMES_PER_PACKET, NUM_RING_PACKETS);
+  const UdpAcousticData::Header first = ring.front()->header;
+  double dt_nsec = 1e9 / first.sample_rate;
+
+  logger.set_outdir(make_out_dir(name));
+  logger.set_fsync_policy(FSYNC_POLICY::NONE);
+  logger.Initialize_from_aco(ring.front());
+  logger.Start();
+
+  int64_t packet_num = 0;
+  for (auto _ : state) {
+    // reuse the ring, but keep time and counters moving forward like a live stream
+    auto &pkt = ring.at(packet_num % NUM_RING_PACKETS);
+    int64_t sample = packet_num * NUM_FRAMES_PER_PACKET;
+    pkt->header.start_time_nsec = first.start_time_nsec + (int64_t)(sample * dt_nsec);
+    pkt->header.tick_time_nsec = (uint64_t)(sample * dt_nsec);
+    pkt->header.adc_count = sample;
+    pkt->header.packet_num = packet_num++;
+
+    logger.Log_ACO_Data(pkt);
+  }
+  logger.Stop();
+  logger.Shutdown();
+
+  int64_t num_samples = state.iterations() * NUM_FRAMES_PER_PACKET;
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(num_samples * num_channels * sizeof(int16_t));
+  state.counters["x_realtime"] =
+      benchmark::Counter(num_samples / first.sample_rate, benchmark::Counter::kIsRate);
+}
+
+static void BM_LoggerCSV(benchmark::State &state) {
+  Logger_Acoustic_CSV logger;
+  run_logger_benchmark(state, logger, "csv");
+}
+BENCHMARK(BM_LoggerCSV)->ArgName("ch")->Arg(8)->Arg(32)->UseRealTime();
+
+static void BM_LoggerWAV(benchmark::State &state) {
+  Logger_Acoustic_WAV logger;
+  run_logger_benchmark(state, logger, "wav");
+}
+BENCHMARK(BM_LoggerWAV)->ArgName("ch")->Arg(8)->Arg(32)->UseRealTime();
+
+static void BM_LoggerFLAC(benchmark::State &state) {
+  Logger_Acoustic_FLAC logger;
+  run_logger_benchmark(state, logger, "flac");
+}
+BENCHMARK(BM_LoggerFLAC)->ArgName("ch")->Arg(8)->Arg(32)->UseRealTime();
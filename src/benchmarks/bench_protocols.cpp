@@ -0,0 +1,204 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: bench_protocols.cpp                                    */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+// Packet decode / encode cost, plus the full UdpSocketIn::dispatch() path (ID check,
+// decode, sanity check, queue fan-out) without the recv() syscall.
+
+#include <benchmark/benchmark.h>
+
+#include "benchmarks.h"
+
+// includes from within project
+#include "udp_protocols/UdpBeamform2D.h"
+#include "udp_protocols/UdpBeamformRaw.h"
+#include "udp_protocols/UdpImuData.h"
+#include "udp_protocols/UdpPtsData.h"
+#include "utils/BearingTimeRecord.h"
+#include "utils/UdpSocketIn.h"
+
+// Acoustic
+// ========
+static void BM_AcousticDecode(benchmark::State &state) {
+  int num_channels = state.range(0);
+  int num_frames = state.range(1);
+  std::vector<int8_t> buff = make_aco_stream(num_channels, num_frames, 1).front()->encode();
+
+  for (auto _ : state) {
+    UdpAcousticData aco(buff);
+    benchmark::DoNotOptimize(aco.data.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * buff.size());
+}
+BENCHMARK(BM_AcousticDecode)
+    ->ArgNames({"ch", "frames"})
+    ->Args({4, 32})
+    ->Args({8, 32})
+    ->Args({32, 32})
+    ->Args({64, 32})
+    ->Args({8, 512});
+
+static void BM_AcousticDecodeSample(benchmark::State &state) {
+  std::vector<int8_t> buff = load_packet("sample_raw_acoustic_packet.dat");
+
+  for (auto _ : state) {
+    UdpAcousticData aco(buff);
+    benchmark::DoNotOptimize(aco.data.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * buff.size());
+}
+BENCHMARK(BM_AcousticDecodeSample);
+
+static void BM_AcousticEncode(benchmark::State &state) {
+  auto aco = make_aco_stream(state.range(0), state.range(1), 1).front();
+
+  size_t num_bytes = 0;
+  for (auto _ : state) {
+    std::vector<int8_t> buff = aco->encode();
+    num_bytes = buff.size();
+    benchmark::DoNotOptimize(buff.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * num_bytes);
+}
+BENCHMARK(BM_AcousticEncode)->ArgNames({"ch", "frames"})->Args({8, 32})->Args({64, 32});
+
+// Beamformer
+// ==========
+// storage: 0 FLOAT64, 1 FLOAT32, 2 FLOAT16, 3 DB_U8
+static void BM_Beamform2DDecode(benchmark::State &state) {
+  BEAM_STORAGE storage = (BEAM_STORAGE)state.range(0);
+  std::vector<int8_t> buff = load_packet("sample_beamformer_2d_packet.dat");
+
+  for (auto _ : state) {
+    UdpBeamform2D beam(buff, storage);
+    benchmark::DoNotOptimize(beam.data.bearings_rad.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * buff.size());
+}
+BENCHMARK(BM_Beamform2DDecode)->ArgName("storage")->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+
+static void BM_Beamform2DEncode(benchmark::State &state) {
+  std::vector<int8_t> buff = load_packet("sample_beamformer_2d_packet.dat");
+  UdpBeamform2D beam(buff);
+
+  for (auto _ : state) {
+    std::vector<int8_t> out = beam.encode();
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * buff.size());
+}
+BENCHMARK(BM_Beamform2DEncode);
+
+// Bearing-time record line per frame: get_1D() into a growing buffer (the former
+// beamformer buffer) vs. reduction into the preallocated ring, with and without peaks
+static void BM_BtrLine(benchmark::State &state) {
+  int mode = state.range(0);
+  std::vector<int8_t> buff = load_packet("sample_beamformer_2d_packet.dat");
+  UdpBeamform2D beam(buff);
+
+  BearingTimeRecord btr(1000);
+  btr.set_num_peaks(mode == 2 ? 4 : 0);
+  Eigen::MatrixXd data_buffer(beam.data.bearings_rad.size(), 0);
+  for (auto _ : state) {
+    if (mode == 0) {
+      if (data_buffer.cols() > 2000)
+        data_buffer.resize(Eigen::NoChange, 0);
+      data_buffer.conservativeResize(Eigen::NoChange, data_buffer.cols() + 1);
+      data_buffer.rightCols(1) = beam.get_1D();
+      benchmark::DoNotOptimize(data_buffer.data());
+    } else {
+      btr.add(beam);
+      benchmark::DoNotOptimize(btr.get_latest_peaks().data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BtrLine)->ArgName("mode")->Arg(0)->Arg(1)->Arg(2);
+
+static void BM_BeamformRawDecode(benchmark::State &state) {
+  // the sample is a fully reassembled series, i.e. a single ACBR packet
+  std::vector<int8_t> buff = load_packet("sample_beamformer_raw_packet.dat");
+
+  for (auto _ : state) {
+    UdpBeamformRaw beam(buff);
+    benchmark::DoNotOptimize(beam.data.beampattern.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * buff.size());
+}
+BENCHMARK(BM_BeamformRawDecode)->Unit(benchmark::kMicrosecond);
+
+static void BM_BeamformRawEncode(benchmark::State &state) {
+  std::vector<int8_t> buff = load_packet("sample_beamformer_raw_packet.dat");
+  UdpBeamformRaw beam(buff);
+
+  for (auto _ : state) {
+    std::vector<int8_t> out = beam.encode();
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * buff.size());
+}
+BENCHMARK(BM_BeamformRawEncode)->Unit(benchmark::kMicrosecond);
+
+// ACBR primary + ACBC continuations through the socket's reassembly
+static void BM_BeamformRawReassemble(benchmark::State &state) {
+  std::vector<int8_t> buff = load_packet("sample_beamformer_raw_packet.dat");
+  UdpBeamformRaw beam(buff);
+  std::vector<std::vector<int8_t>> datagrams = beam.encode_datagrams(65000);
+
+  UdpSocketIn socket;
+  auto q_beamraw = std::make_shared<tsQueue<std::shared_ptr<UdpBeamformRaw>>>(16);
+  socket.register_client_beamraw(q_beamraw);
+
+  for (auto _ : state) {
+    for (auto &msg : datagrams) {
+      socket.dispatch(msg);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * buff.size());
+  state.counters["datagrams"] = datagrams.size();
+}
+BENCHMARK(BM_BeamformRawReassemble)->Unit(benchmark::kMicrosecond);
+
+// Socket dispatch
+// ===============
+static void BM_DispatchAcoustic(benchmark::State &state) {
+  std::vector<int8_t> buff = make_aco_stream(state.range(0), 32, 1).front()->encode();
+
+  UdpSocketIn socket;
+  auto q_aco = std::make_shared<tsQueue<std::shared_ptr<UdpAcousticData>>>(16);
+  socket.register_client_aco(q_aco);
+
+  for (auto _ : state) {
+    socket.dispatch(buff);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * buff.size());
+}
+BENCHMARK(BM_DispatchAcoustic)->ArgName("ch")->Arg(8)->Arg(64);
+
+template <typename T> static void BM_SensorDecode(benchmark::State &state) {
+  T sample;
+  sample.header.start_time_nsec = 1700000000000000000;
+  std::vector<int8_t> buff = sample.encode();
+
+  for (auto _ : state) {
+    T data(buff);
+    benchmark::DoNotOptimize(&data);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_SensorDecode, UdpPtsData);
+BENCHMARK_TEMPLATE(BM_SensorDecode, UdpImuData);
@@ -0,0 +1,103 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: bench_queue.cpp                                        */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+// tsQueue cost uncontended and under contention. Items are shared_ptr packets, as on
+// every queue in the pipeline.
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <thread>
+
+#include "benchmarks.h"
+
+// includes from within project
+#include "utils/thread_safe_queue.h"
+
+using AcoQueue = tsQueue<std::shared_ptr<UdpAcousticData>>;
+
+static void BM_QueuePushPop(benchmark::State &state) {
+  AcoQueue queue;
+  auto pkt = make_aco_stream(8, 32, 1).front();
+
+  for (auto _ : state) {
+    queue.push(pkt);
+    benchmark::DoNotOptimize(queue.pop());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueuePushPop);
+
+// Batched hand-off, as done by the consumers that drain with pop_all()
+static void BM_QueuePushPopAll(benchmark::State &state) {
+  AcoQueue queue(0);
+  auto pkt = make_aco_stream(8, 32, 1).front();
+  std::vector<std::shared_ptr<UdpAcousticData>> batch;
+  int batch_size = state.range(0);
+
+  for (auto _ : state) {
+    for (int ii = 0; ii < batch_size; ii++) {
+      queue.push(pkt);
+    }
+    queue.pop_all(batch);
+    benchmark::DoNotOptimize(batch.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_QueuePushPopAll)->ArgName("batch")->Arg(10)->Arg(100);
+
+// Every thread pushes and then pops, so the queue is never empty when pop() is called;
+// measures lock hand-off between threads hitting one queue.
+static void BM_QueueContention(benchmark::State &state) {
+  static std::shared_ptr<AcoQueue> queue;
+  static std::shared_ptr<UdpAcousticData> pkt;
+  if (state.thread_index() == 0) {
+    queue = std::make_shared<AcoQueue>(0);
+    pkt = make_aco_stream(8, 32, 1).front();
+  }
+
+  for (auto _ : state) {
+    queue->push(pkt);
+    benchmark::DoNotOptimize(queue->pop());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueueContention)->ThreadRange(1, 8)->UseRealTime();
+
+// One producer (the benchmark thread) feeding one consumer thread that drains in batches
+static void BM_QueueProducerConsumer(benchmark::State &state) {
+  AcoQueue queue(0);
+  auto pkt = make_aco_stream(8, 32, 1).front();
+  std::atomic<bool> keep_alive{true};
+  std::atomic<size_t> num_consumed{0};
+  std::atomic<size_t> num_batches{0};
+
+  std::thread consumer([&]() {
+    std::vector<std::shared_ptr<UdpAcousticData>> batch;
+    while (keep_alive || queue.size() > 0) {
+      if (queue.pop_all(batch)) {
+        num_consumed += batch.size();
+        num_batches++;
+      }
+    }
+  });
+
+  size_t num_produced = 0;
+  for (auto _ : state) {
+    queue.push(pkt);
+    num_produced++;
+  }
+  keep_alive = false;
+  // wake the consumer if it is waiting on an empty queue
+  queue.push(pkt);
+  consumer.join();
+
+  state.SetItemsProcessed(num_produced);
+  state.counters["avg_batch"] = num_batches > 0 ? (double)num_consumed / num_batches : 0;
+}
+BENCHMARK(BM_QueueProducerConsumer)->UseRealTime();
@@ -0,0 +1,35 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: benchmarks.h                                           */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef benchmarks_HEADER
+#define benchmarks_HEADER
+
+#include <gflags/gflags.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// includes from within project
+#include "udp_protocols/UdpAcousticData.h"
+
+DECLARE_string(test_data_dir);
+DECLARE_string(bench_out_dir);
+
+// Raw bytes of a sample packet from the test data directory; aborts if missing
+std::vector<int8_t> load_packet(const std::string &file_name);
+
+// Synthetic acoustic packets: a tone plus noise on every channel, with timestamps,
+// tick time and ADC count that continue seamlessly from packet to packet
+std::vector<std::shared_ptr<UdpAcousticData>>
+make_aco_stream(int num_channels, int num_frames, size_t num_packets, float sample_rate = 52734);
+
+// Fresh, empty scratch directory below --bench_out_dir
+std::string make_out_dir(const std::string &name);
+
+#endif
@@ -0,0 +1,174 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: flac_benchmark.cpp                                     */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+// Throughput and compression ratio of the FLAC logger across compression levels and
+// write block sizes. The input stream is synthesized from the sample acoustic packet:
+// its columns are cycled and per-channel Gaussian noise (scaled to each channel's std)
+// is added, so the encoder sees realistic spectra without a perfectly periodic signal.
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+// includes from within project
+#include "udp_protocols/UdpAcousticData.h"
+#include "utils/Logger_Acoustic.h"
+
+DEFINE_string(test_data_dir, "/tmp/", "Path to test data files");
+DEFINE_string(test_file_name, "sample_raw_acoustic_packet.dat", "Sample acoustic packet");
+DEFINE_string(out_dir, "/tmp/ac_flac_benchmark/", "Scratch directory for encoded files");
+DEFINE_double(duration_sec, 60, "Seconds of synthetic audio per configuration");
+DEFINE_int32(num_channels, 0, "Channels to synthesize (0 = same as the sample packet)");
+DEFINE_int32(frames_per_packet, 0, "Frames per synthetic packet (0 = same as the sample)");
+DEFINE_string(levels, "-1,0,5,8", "Comma-separated FLAC compression levels (-1 = default)");
+DEFINE_string(block_frames, "0,4096", "Comma-separated write block sizes in frames");
+DEFINE_int32(workers, 0, "FLAC encoder worker threads");
+DEFINE_double(noise_ratio, 0.1, "Added noise std relative to each channel's std");
+
+static std::vector<int> parse_list(const std::string &str) {
+  std::vector<int> out;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      out.push_back(std::stoi(item));
+    }
+  }
+  return out;
+}
+
+static std::shared_ptr<UdpAcousticData> load_sample(const std::string &path) {
+  std::ifstream ifil(path, std::ios::binary);
+  if (!ifil.is_open()) {
+    LOG(FATAL) << "Could not open sample packet " << path;
+  }
+  std::vector<char> raw((std::istreambuf_iterator<char>(ifil)), std::istreambuf_iterator<char>());
+  std::vector<int8_t> buff(raw.begin(), raw.end());
+  return std::make_shared<UdpAcousticData>(buff);
+}
+
+// Pre-generate the packet stream so that only logging is inside the timed loop
+static std::vector<std::shared_ptr<UdpAcousticData>>
+make_stream(const UdpAcousticData &sample, int num_channels, int num_frames, size_t num_packets) {
+  const Eigen::MatrixX<int16_t> &src = sample.data;
+  Eigen::ArrayXd ch_std(src.rows());
+  for (int ii = 0; ii < src.rows(); ii++) {
+    Eigen::ArrayXd row = src.row(ii).cast<double>().array();
+    ch_std(ii) = std::sqrt((row - row.mean()).square().mean());
+  }
+
+  std::mt19937 gen(1234);
+  std::normal_distribution<double> norm(0, 1);
+
+  std::vector<std::shared_ptr<UdpAcousticData>> stream;
+  stream.reserve(num_packets);
+  int64_t src_col = 0;
+  double dt_nsec = 1e9 / sample.header.sample_rate;
+  for (size_t pp = 0; pp < num_packets; pp++) {
+    Eigen::MatrixX<int16_t> data(num_channels, num_frames);
+    for (int cc = 0; cc < num_frames; cc++) {
+      for (int rr = 0; rr < num_channels; rr++) {
+        int src_row = rr % src.rows();
+        double val = src(src_row, (src_col + cc) % src.cols()) +
+                     FLAGS_noise_ratio * ch_std(src_row) * norm(gen);
+        data(rr, cc) = (int16_t)std::clamp(std::round(val), -32768.0, 32767.0);
+      }
+    }
+    int64_t t_nsec = sample.header.start_time_nsec + (int64_t)(src_col * dt_nsec);
+    stream.push_back(UdpAcousticData::create(
+        data, num_channels, num_channels * num_frames, sample.header.sample_rate, t_nsec,
+        sample.header.tick_time_nsec + (uint64_t)(src_col * dt_nsec),
+        sample.header.adc_count + (int32_t)src_col, sample.header.packet_num + (int32_t)pp));
+    src_col += num_frames;
+  }
+  return stream;
+}
+
+static uintmax_t dir_bytes(const std::filesystem::path &dir) {
+  uintmax_t total = 0;
+  for (auto &entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".flac") {
+      total += entry.file_size();
+    }
+  }
+  return total;
+}
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_alsologtostderr = 1;
+
+  gflags::SetUsageMessage("Usage:");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::shared_ptr<UdpAcousticData> sample =
+      load_sample(FLAGS_test_data_dir + FLAGS_test_file_name);
+  if (sample->data.size() == 0 || sample->header.sample_rate <= 0) {
+    LOG(FATAL) << "Sample packet could not be decoded";
+  }
+
+  int num_channels = FLAGS_num_channels > 0 ? FLAGS_num_channels : sample->data.rows();
+  int num_frames = FLAGS_frames_per_packet > 0 ? FLAGS_frames_per_packet : sample->data.cols();
+  size_t num_packets = std::ceil(FLAGS_duration_sec * sample->header.sample_rate / num_frames);
+
+  LOG(INFO) << "Synthesizing " << num_packets << " packets of " << num_channels << " x "
+            << num_frames << " at " << sample->header.sample_rate << " Hz";
+  auto stream = make_stream(*sample, num_channels, num_frames, num_packets);
+  const double raw_bytes = (double)num_packets * num_channels * num_frames * sizeof(int16_t);
+  const double audio_sec = (double)num_packets * num_frames / sample->header.sample_rate;
+
+  std::cout << std::setw(6) << "level" << std::setw(8) << "block" << std::setw(14) << "Msamples/s"
+            << std::setw(12) << "x realtime" << std::setw(10) << "ratio" << std::endl;
+
+  for (int level : parse_list(FLAGS_levels)) {
+    for (int block : parse_list(FLAGS_block_frames)) {
+      std::ostringstream name;
+      name << "L" << level << "_B" << block << "/";
+      std::filesystem::path dir = std::filesystem::path(FLAGS_out_dir) / name.str();
+      std::filesystem::remove_all(dir);
+      std::filesystem::create_directories(dir);
+
+      double elapsed;
+      {
+        Logger_Acoustic_FLAC logger;
+        logger.set_outdir(dir.string() + "/");
+        logger.set_fsync_policy(FSYNC_POLICY::NONE);
+        logger.set_num_workers(FLAGS_workers);
+        logger.set_compression_level(level);
+        logger.set_write_block_frames(block);
+
+        auto t_start = std::chrono::steady_clock::now();
+        logger.Initialize_from_aco(stream.front());
+        logger.Start();
+        for (auto &pkt : stream) {
+          logger.Log_ACO_Data(pkt);
+        }
+        logger.Stop();
+        logger.Shutdown();
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+      }
+
+      uintmax_t flac_bytes = dir_bytes(dir);
+      double msps = (double)num_packets * num_channels * num_frames / elapsed / 1e6;
+      std::cout << std::setw(6) << level << std::setw(8) << block << std::setw(14) << std::fixed
+                << std::setprecision(2) << msps << std::setw(12) << audio_sec / elapsed
+                << std::setw(10) << (flac_bytes > 0 ? raw_bytes / flac_bytes : 0.0) << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,91 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: run_benchmarks.cpp                                     */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+// Google Benchmark suite for protocol decoding and the processing / logging stages.
+// Benchmark options (--benchmark_filter, --benchmark_format=json, ...) are consumed
+// first; the remaining arguments are parsed as gflags.
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <glog/logging.h>
+#include <random>
+
+#include "benchmarks.h"
+
+#ifndef ACBOTICS_DATA_DIR
+#define ACBOTICS_DATA_DIR "/tmp/"
+#endif
+
+DEFINE_string(test_data_dir, ACBOTICS_DATA_DIR, "Path to test data files");
+DEFINE_string(bench_out_dir, "/tmp/ac_benchmarks/", "Scratch directory for logger output");
+
+std::vector<int8_t> load_packet(const std::string &file_name) {
+  std::string path = FLAGS_test_data_dir;
+  if (!path.empty() && path.back() != '/')
+    path += '/';
+  path += file_name;
+
+  std::ifstream ifil(path, std::ios::binary);
+  if (!ifil.is_open()) {
+    LOG(FATAL) << "Could not open sample packet " << path;
+  }
+  std::vector<char> raw((std::istreambuf_iterator<char>(ifil)), std::istreambuf_iterator<char>());
+  return std::vector<int8_t>(raw.begin(), raw.end());
+}
+
+std::vector<std::shared_ptr<UdpAcousticData>>
+make_aco_stream(int num_channels, int num_frames, size_t num_packets, float sample_rate) {
+  std::mt19937 gen(1234);
+  std::normal_distribution<double> norm(0, 500);
+
+  std::vector<std::shared_ptr<UdpAcousticData>> stream;
+  stream.reserve(num_packets);
+  int64_t t0_nsec = 1700000000000000000;
+  double dt_nsec = 1e9 / sample_rate;
+  for (size_t pp = 0; pp < num_packets; pp++) {
+    int64_t sample = pp * num_frames;
+    Eigen::MatrixX<int16_t> data(num_channels, num_frames);
+    for (int cc = 0; cc < num_frames; cc++) {
+      double tone = 8000 * std::sin(2 * M_PI * 1000 * (sample + cc) / sample_rate);
+      for (int rr = 0; rr < num_channels; rr++) {
+        data(rr, cc) = (int16_t)std::round(tone + norm(gen));
+      }
+    }
+    stream.push_back(UdpAcousticData::create(data, num_channels, num_channels * num_frames,
+                                             sample_rate, t0_nsec + (int64_t)(sample * dt_nsec),
+                                             (uint64_t)(sample * dt_nsec), sample, pp));
+  }
+  return stream;
+}
+
+std::string make_out_dir(const std::string &name) {
+  std::filesystem::path dir = std::filesystem::path(FLAGS_bench_out_dir) / name;
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  return dir.string() + "/";
+}
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_logtostderr = 1;
+  // keep logger chatter out of the timing output unless asked for
+  FLAGS_minloglevel = google::GLOG_WARNING;
+
+  benchmark::Initialize(&argc, argv);
+  gflags::SetUsageMessage("Usage:");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  std::filesystem::remove_all(FLAGS_bench_out_dir);
+  return 0;
+}
@@ -10,6 +10,9 @@
 #ifndef ipc_data_HEADER
 #define ipc_data_HEADER
 
+// includes from within project
+#include "utils/LatencyTracker.h"
+
 struct IpcData {
   struct __attribute__((__packed__)) Header {
     int64_t start_time_nsec;
@@ -20,6 +23,8 @@ struct IpcData {
       this->packet_num = 0;
     };
   } header;
+  // pipeline timestamps inherited from the packet(s) this frame was computed from
+  StageTimes stage_times;
 
   IpcData();
   virtual void csv_header(std::ostream &oss);
@@ -0,0 +1,49 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: IpcDetectionEvent.cpp                                  */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <glog/logging.h>
+#include <iomanip>
+
+// includes from within project
+#include "IpcDetectionEvent.h"
+
+IpcDetectionEvent::IpcDetectionEvent() {}
+
+std::ostream &operator<<(std::ostream &os, const IpcDetectionEvent &st) {
+  std::ostringstream oss;
+  oss << st;
+  os << oss.str();
+  return os;
+}
+std::ostringstream &operator<<(std::ostringstream &os, const IpcDetectionEvent &st) {
+
+  int width = 25;
+
+  os << "AcSense IPC protocol : Detection Event" << std::endl << st.header << std::endl;
+  os << std::endl;
+
+  os << "Detection Event Payload:" << std::endl;
+
+  os << std::left << std::setw(width) << std::setfill('.') << "DURATION (sec)"
+     << ": " << st.duration_sec() << std::endl;
+  os << std::left << std::setw(width) << std::setfill('.') << "FRAMES / CELLS"
+     << ": " << st.num_frames << " / " << st.num_cells << std::endl;
+  os << std::left << std::setw(width) << std::setfill('.') << "CHANNEL MASK"
+     << ": 0x" << std::hex << st.channel_mask << std::dec << " (" << st.num_channels()
+     << " channels)" << std::endl;
+  os << std::left << std::setw(width) << std::setfill('.') << "PEAK SNR (dB)"
+     << ": " << st.peak_snr_db << " (ch " << st.peak_channel << ", " << st.peak_frequency
+     << " Hz, band " << st.peak_band << ")" << std::endl;
+  os << std::left << std::setw(width) << std::setfill('.') << "FREQUENCY EXTENT (Hz)"
+     << ": " << st.f_low << " - " << st.f_high << std::endl
+     << std::endl
+     << std::endl;
+
+  return os;
+}
@@ -0,0 +1,40 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: IpcDetectionEvent.h                                    */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef ipc_detection_event_HEADER
+#define ipc_detection_event_HEADER
+
+#include <cstdint>
+
+#include "IpcData.h"
+
+// A run of consecutive detecting frames (see DetectionEventBuilder), summarized in a
+// fixed-size record. header.start_time_nsec is the start of the first detecting frame;
+// header.packet_num numbers the events.
+struct IpcDetectionEvent : virtual public IpcData {
+  int64_t end_time_nsec = -1; // end of the last detecting frame
+  uint64_t channel_mask = 0;  // bit c : channel c detected (channels past 63 set bit 63)
+  float peak_snr_db = 0;
+  float peak_frequency = 0; // Hz
+  float f_low = 0;          // frequency extent of the detecting cells, Hz
+  float f_high = 0;
+  int16_t peak_channel = -1;
+  int16_t peak_band = -1;
+  uint32_t num_frames = 0; // detecting frames merged into the event
+  uint32_t num_cells = 0;
+
+  IpcDetectionEvent();
+  double duration_sec() const { return (this->end_time_nsec - this->header.start_time_nsec) / 1e9; }
+  int num_channels() const { return __builtin_popcountll(this->channel_mask); }
+};
+
+std::ostream &operator<<(std::ostream &os, const IpcDetectionEvent &st);
+std::ostringstream &operator<<(std::ostringstream &os, const IpcDetectionEvent &st);
+
+#endif
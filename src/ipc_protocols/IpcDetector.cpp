@@ -7,6 +7,7 @@
 /*    For help, contact us at: support@acbotics.com                */
 /*******************************************************************/
 
+#include <algorithm>
 #include <byteswap.h>
 #include <cstring>
 #include <glog/logging.h>
@@ -15,7 +16,7 @@
 // includes from within project
 #include "IpcDetector.h"
 
-IpcDetector::IpcDetector() {}
+IpcDetector::IpcDetector() : detections(0) {}
 
 std::ostream &operator<<(std::ostream &os, const IpcDetector &st) {
   std::ostringstream oss;
@@ -34,9 +35,19 @@ std::ostringstream &operator<<(std::ostringstream &os, const IpcDetector &st) {
   os << "Detector Raw Data Payload (Summary):" << std::endl;
 
   os << std::left << std::setw(width) << std::setfill('.') << "DETECTIONS"
-     << ": " << st.detections << std::endl
-     << std::endl
-     << std::endl;
+     << ": " << st.detections << std::endl;
+  os << std::left << std::setw(width) << std::setfill('.') << "CELLS"
+     << ": " << st.cells.size() << std::endl;
+
+  size_t num_shown = std::min(st.cells.size(), (size_t)5);
+  for (size_t ii = 0; ii < num_shown; ii++) {
+    const DetectorCell &cell = st.cells[ii];
+    os << "  ch " << cell.channel << ", bin " << cell.bin << " (" << cell.frequency
+       << " Hz), band " << cell.band << " : " << cell.snr_db << " dB" << std::endl;
+  }
+  if (num_shown < st.cells.size())
+    os << "  ..." << std::endl;
+  os << std::endl << std::endl;
 
   return os;
 }
@@ -10,10 +10,23 @@
 #ifndef ipc_detector_HEADER
 #define ipc_detector_HEADER
 
+#include <vector>
+
 #include "IpcData.h"
 
+// One detecting time-frequency cell
+struct DetectorCell {
+  int channel;
+  int bin;          // FFT bin, within the full spectrum of the frame's NFFT
+  int band;         // index into the detector's frequency bands (-1 : none)
+  double frequency; // Hz
+  double snr_db;    // cell power over its noise estimate
+  int64_t time_nsec;
+};
+
 struct IpcDetector : virtual public IpcData {
-  int detections;
+  int detections; // number of channels with at least one detecting cell
+  std::vector<DetectorCell> cells;
 
   IpcDetector();
 };
@@ -36,7 +36,9 @@ std::ostringstream &operator<<(std::ostringstream &os, const IpcFFT &st) {
   os << "FFT Raw Data Payload (Summary):" << std::endl;
 
   os << std::left << std::setw(width) << std::setfill('.') << "FFT"
-     << ": (" << st.fft.rows() << " x " << st.fft.cols() << ")" << std::endl
+     << ": (" << st.fft.rows() << " x " << st.fft.cols() << ")" << std::endl;
+  os << std::left << std::setw(width) << std::setfill('.') << "BINS"
+     << ": " << (st.bins.empty() ? "all" : std::to_string(st.bins.size()) + " active") << std::endl
      << std::endl
      << std::endl;
 
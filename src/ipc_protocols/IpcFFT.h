@@ -11,12 +11,15 @@
 #define ipc_fft_HEADER
 
 #include <Eigen/Dense>
+#include <vector>
 
 #include "IpcData.h"
 
 struct IpcFFT : virtual public IpcData {
   Eigen::MatrixXcd fft;
   double FS=-1;
+  // FFT bin index of each column of fft; empty when fft holds the full spectrum
+  std::vector<int> bins;
 
   IpcFFT();
   IpcFFT(Eigen::MatrixXcd &fft);
@@ -0,0 +1,45 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: IpcPSD.cpp                                             */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <glog/logging.h>
+#include <iomanip>
+
+// includes from within project
+#include "IpcPSD.h"
+
+IpcPSD::IpcPSD() {}
+IpcPSD::IpcPSD(size_t rows, size_t cols) { this->psd = Eigen::MatrixXd::Zero(rows, cols); }
+
+std::ostream &operator<<(std::ostream &os, const IpcPSD &st) {
+  std::ostringstream oss;
+  oss << st;
+  os << oss.str();
+  return os;
+}
+std::ostringstream &operator<<(std::ostringstream &os, const IpcPSD &st) {
+
+  int width = 25;
+
+  os << "AcSense IPC protocol : PSD Data" << std::endl << st.header << std::endl;
+  os << std::endl;
+
+  // Don't use the full Payload operator<< -- use summary for a general packet view
+  os << "PSD Data Payload (Summary):" << std::endl;
+
+  os << std::left << std::setw(width) << std::setfill('.') << "PSD"
+     << ": (" << st.psd.rows() << " x " << st.psd.cols() << ")" << std::endl;
+  os << std::left << std::setw(width) << std::setfill('.') << "AVERAGES"
+     << ": " << st.num_averages << std::endl;
+  os << std::left << std::setw(width) << std::setfill('.') << "SPAN (sec)"
+     << ": " << (st.end_time_nsec - st.header.start_time_nsec) / 1e9 << std::endl
+     << std::endl
+     << std::endl;
+
+  return os;
+}
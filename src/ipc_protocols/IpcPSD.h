@@ -0,0 +1,33 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: IpcPSD.h                                               */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef ipc_psd_HEADER
+#define ipc_psd_HEADER
+
+#include <Eigen/Dense>
+
+#include "IpcData.h"
+
+// Welch-averaged power spectral density (channels x frequencies), in units^2 / Hz.
+// header.start_time_nsec is the start of the first averaged frame.
+struct IpcPSD : virtual public IpcData {
+  Eigen::MatrixXd psd;
+  double FS = -1;
+  int32_t num_averages = 0;
+  int64_t end_time_nsec = -1; // start of the last averaged frame
+
+  IpcPSD();
+  IpcPSD(size_t rows, size_t cols);
+  const Eigen::MatrixXd &viewData() { return psd; }
+};
+
+std::ostream &operator<<(std::ostream &os, const IpcPSD &st);
+std::ostringstream &operator<<(std::ostringstream &os, const IpcPSD &st);
+
+#endif
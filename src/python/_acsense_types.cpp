@@ -29,14 +29,19 @@ void _acsense_types(py::module_ &m) {
       .value("EPT", LOGGER::EPT)
       .value("RTC", LOGGER::RTC)
       .value("BNO", LOGGER::BNO)
-      .value("BNR", LOGGER::BNR);
+      .value("BNR", LOGGER::BNR)
+      .value("BEAM2D", LOGGER::BEAM2D)
+      .value("BEAMRAW", LOGGER::BEAMRAW);
 
   py::enum_<QUEUE>(m, "QUEUE")
       .value("UNKNOWN", QUEUE::UNKNOWN)
       .value("ACO", QUEUE::ACO)
       .value("FFT", QUEUE::FFT)
       .value("CBF", QUEUE::CBF)
+      .value("CBF_RAW", QUEUE::CBF_RAW)
       .value("DETECT", QUEUE::DETECT)
+      .value("PSD", QUEUE::PSD)
+      .value("EVENT", QUEUE::EVENT)
 
       .value("GPS", QUEUE::GPS)
       .value("PTS", QUEUE::PTS)
@@ -17,8 +17,10 @@
 #include "ipc_protocols/IpcData.h"
 
 #include "ipc_protocols/IpcBnoState.h"
+#include "ipc_protocols/IpcDetectionEvent.h"
 #include "ipc_protocols/IpcDetector.h"
 #include "ipc_protocols/IpcFFT.h"
+#include "ipc_protocols/IpcPSD.h"
 
 namespace py = pybind11;
 
@@ -51,11 +53,36 @@ void _ipc_protocol(py::module_ &m) {
              return oss.str();
            })
       .def_readonly("header", &IpcFFT::header)
+      .def_readonly("stage_times", &IpcFFT::stage_times)
       .def_readonly("fft", &IpcFFT::fft)
       .def_readonly("FS", &IpcFFT::FS)
+      .def_readonly("bins", &IpcFFT::bins)
       .def("viewData", &IpcFFT::viewData, py::return_value_policy::reference_internal);
 
-  py::class_<IpcDetector>(m, "IpcDetector")
+  py::class_<IpcPSD, std::shared_ptr<IpcPSD>>(m, "IpcPSD")
+      .def("__repr__",
+           [](const IpcPSD &st) {
+             std::ostringstream oss;
+             oss << st;
+             return oss.str();
+           })
+      .def_readonly("header", &IpcPSD::header)
+      .def_readonly("stage_times", &IpcPSD::stage_times)
+      .def_readonly("psd", &IpcPSD::psd)
+      .def_readonly("FS", &IpcPSD::FS)
+      .def_readonly("num_averages", &IpcPSD::num_averages)
+      .def_readonly("end_time_nsec", &IpcPSD::end_time_nsec)
+      .def("viewData", &IpcPSD::viewData, py::return_value_policy::reference_internal);
+
+  py::class_<DetectorCell>(m, "DetectorCell")
+      .def_readonly("channel", &DetectorCell::channel)
+      .def_readonly("bin", &DetectorCell::bin)
+      .def_readonly("band", &DetectorCell::band)
+      .def_readonly("frequency", &DetectorCell::frequency)
+      .def_readonly("snr_db", &DetectorCell::snr_db)
+      .def_readonly("time_nsec", &DetectorCell::time_nsec);
+
+  py::class_<IpcDetector, std::shared_ptr<IpcDetector>>(m, "IpcDetector")
       .def("__repr__",
            [](const IpcDetector &st) {
              std::ostringstream oss;
@@ -63,7 +90,31 @@ void _ipc_protocol(py::module_ &m) {
              return oss.str();
            })
       .def_readonly("header", &IpcDetector::header)
-      .def_readonly("detections", &IpcDetector::detections);
+      .def_readonly("stage_times", &IpcDetector::stage_times)
+      .def_readonly("detections", &IpcDetector::detections)
+      .def_readonly("cells", &IpcDetector::cells);
+
+  py::class_<IpcDetectionEvent, std::shared_ptr<IpcDetectionEvent>>(m, "IpcDetectionEvent")
+      .def("__repr__",
+           [](const IpcDetectionEvent &st) {
+             std::ostringstream oss;
+             oss << st;
+             return oss.str();
+           })
+      .def_readonly("header", &IpcDetectionEvent::header)
+      .def_readonly("stage_times", &IpcDetectionEvent::stage_times)
+      .def_readonly("end_time_nsec", &IpcDetectionEvent::end_time_nsec)
+      .def_readonly("channel_mask", &IpcDetectionEvent::channel_mask)
+      .def_readonly("peak_snr_db", &IpcDetectionEvent::peak_snr_db)
+      .def_readonly("peak_frequency", &IpcDetectionEvent::peak_frequency)
+      .def_readonly("f_low", &IpcDetectionEvent::f_low)
+      .def_readonly("f_high", &IpcDetectionEvent::f_high)
+      .def_readonly("peak_channel", &IpcDetectionEvent::peak_channel)
+      .def_readonly("peak_band", &IpcDetectionEvent::peak_band)
+      .def_readonly("num_frames", &IpcDetectionEvent::num_frames)
+      .def_readonly("num_cells", &IpcDetectionEvent::num_cells)
+      .def("duration_sec", &IpcDetectionEvent::duration_sec)
+      .def("num_channels", &IpcDetectionEvent::num_channels);
 
   py::class_<IpcBnoState>(m, "IpcBnoState")
       .def("__repr__",
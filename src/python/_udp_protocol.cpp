@@ -52,6 +52,7 @@ void _udp_protocol(py::module_ &m) {
 
   py::class_<UdpAcousticData, std::shared_ptr<UdpAcousticData>>(m, "UdpAcousticData")
       .def_readonly("header", &UdpAcousticData::header)
+      .def_readonly("stage_times", &UdpAcousticData::stage_times)
       .def_static("create",py::overload_cast<Eigen::MatrixX<int16_t>,
                     int8_t,
                     int32_t,
@@ -106,6 +107,111 @@ void _udp_protocol(py::module_ &m) {
         return os.str();
       });
 
+  py::enum_<BTR_REDUCTION>(m, "BTR_REDUCTION")
+      .value("MEAN", BTR_REDUCTION::MEAN)
+      .value("MAX", BTR_REDUCTION::MAX)
+      .value("POWER_SUM_DB", BTR_REDUCTION::POWER_SUM_DB);
+
+  py::enum_<BEAM_STORAGE>(m, "BEAM_STORAGE")
+      .value("FLOAT64", BEAM_STORAGE::FLOAT64)
+      .value("FLOAT32", BEAM_STORAGE::FLOAT32)
+      .value("FLOAT16", BEAM_STORAGE::FLOAT16)
+      .value("DB_U8", BEAM_STORAGE::DB_U8);
+  m.attr("BEAM_DB_U8_RANGE") = BEAM_DB_U8_RANGE;
+
+  py::class_<UdpBeamform2D, std::shared_ptr<UdpBeamform2D>>(m, "UdpBeamform2D")
+      .def("__repr__",
+           [](const UdpBeamform2D &st) {
+             std::ostringstream oss;
+             oss << st;
+             return oss.str();
+           })
+      .def_readonly("header", &UdpBeamform2D::header)
+      .def_property_readonly("array_x", [](const UdpBeamform2D &st) { return st.data.array_x; })
+      .def_property_readonly("array_y", [](const UdpBeamform2D &st) { return st.data.array_y; })
+      .def_property_readonly("array_z", [](const UdpBeamform2D &st) { return st.data.array_z; })
+      .def_property_readonly("frequencies",
+                             [](const UdpBeamform2D &st) { return st.data.frequencies; })
+      .def_property_readonly("element_mask",
+                             [](const UdpBeamform2D &st) { return st.data.element_mask; })
+      .def_property_readonly("element_weights",
+                             [](const UdpBeamform2D &st) { return st.data.element_weights; })
+      .def_property_readonly("bearings_rad",
+                             [](const UdpBeamform2D &st) { return st.data.bearings_rad; })
+      .def_property_readonly("elevations_rad",
+                             [](const UdpBeamform2D &st) { return st.data.elevations_rad; })
+      .def_property_readonly("beampattern", &UdpBeamform2D::get_beampattern,
+                             "Beampattern (bearings x elevations) as float64, from any storage")
+      .def("set_storage", &UdpBeamform2D::set_storage, py::arg("storage"),
+           py::arg("db_range") = BEAM_DB_U8_RANGE)
+      .def("get_storage", &UdpBeamform2D::get_storage)
+      .def("beampattern_bytes", &UdpBeamform2D::beampattern_bytes)
+      .def("get_1D", &UdpBeamform2D::get_1D)
+      .def(
+          "reduce_elevation",
+          [](const UdpBeamform2D &st, BTR_REDUCTION reduction) {
+            Eigen::VectorXd line(st.beampattern_rows());
+            st.reduce_elevation(line, reduction);
+            return line;
+          },
+          py::arg("reduction") = BTR_REDUCTION::MEAN, "Beampattern reduced over elevation");
+
+  py::class_<UdpBeamform2D::Header>(m, "UdpBeamform2D_Header")
+      .def("__repr__",
+           [](const UdpBeamform2D::Header &hh) {
+             std::ostringstream oss;
+             oss << hh;
+             return oss.str();
+           })
+      .def_readonly("num_elements", &UdpBeamform2D::Header::num_elements)
+      .def_readonly("num_frequencies", &UdpBeamform2D::Header::num_frequencies)
+      .def_readonly("num_bearings", &UdpBeamform2D::Header::num_bearings)
+      .def_readonly("num_elevations", &UdpBeamform2D::Header::num_elevations)
+      .def_readonly("sample_rate", &UdpBeamform2D::Header::sample_rate)
+      .def_readonly("window_length_sec", &UdpBeamform2D::Header::window_length_sec)
+      .def_readonly("start_time_nsec", &UdpBeamform2D::Header::start_time_nsec)
+      .def_readonly("packet_num", &UdpBeamform2D::Header::packet_num);
+
+  py::class_<UdpBeamformRaw, std::shared_ptr<UdpBeamformRaw>>(m, "UdpBeamformRaw")
+      .def("__repr__",
+           [](const UdpBeamformRaw &st) {
+             std::ostringstream oss;
+             oss << st;
+             return oss.str();
+           })
+      .def_readonly("header", &UdpBeamformRaw::header)
+      .def_property_readonly("array_x", [](const UdpBeamformRaw &st) { return st.data.array_x; })
+      .def_property_readonly("array_y", [](const UdpBeamformRaw &st) { return st.data.array_y; })
+      .def_property_readonly("array_z", [](const UdpBeamformRaw &st) { return st.data.array_z; })
+      .def_property_readonly("frequencies",
+                             [](const UdpBeamformRaw &st) { return st.data.frequencies; })
+      .def_property_readonly("element_mask",
+                             [](const UdpBeamformRaw &st) { return st.data.element_mask; })
+      .def_property_readonly("element_weights",
+                             [](const UdpBeamformRaw &st) { return st.data.element_weights; })
+      .def_property_readonly("bearings_rad",
+                             [](const UdpBeamformRaw &st) { return st.data.bearings_rad; })
+      .def_property_readonly("elevations_rad",
+                             [](const UdpBeamformRaw &st) { return st.data.elevations_rad; })
+      .def_property_readonly("beampattern",
+                             [](const UdpBeamformRaw &st) { return st.data.beampattern; });
+
+  py::class_<UdpBeamformRaw::Header>(m, "UdpBeamformRaw_Header")
+      .def("__repr__",
+           [](const UdpBeamformRaw::Header &hh) {
+             std::ostringstream oss;
+             oss << hh;
+             return oss.str();
+           })
+      .def_readonly("num_elements", &UdpBeamformRaw::Header::num_elements)
+      .def_readonly("num_frequencies", &UdpBeamformRaw::Header::num_frequencies)
+      .def_readonly("num_bearings", &UdpBeamformRaw::Header::num_bearings)
+      .def_readonly("num_elevations", &UdpBeamformRaw::Header::num_elevations)
+      .def_readonly("sample_rate", &UdpBeamformRaw::Header::sample_rate)
+      .def_readonly("window_length_sec", &UdpBeamformRaw::Header::window_length_sec)
+      .def_readonly("start_time_nsec", &UdpBeamformRaw::Header::start_time_nsec)
+      .def_readonly("packet_num", &UdpBeamformRaw::Header::packet_num);
+
   py::class_<UdpPtsData, std::shared_ptr<UdpPtsData>>(m, "UdpPtsData")
       .def("__repr__",
            [](const UdpPtsData &st) {
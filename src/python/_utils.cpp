@@ -29,6 +29,17 @@
 #include "utils/LoggerBlock.h"
 #include "utils/Logger_Sensor.h"
 #include "utils/Logger_GPS_Host.h"
+#include "utils/LatencyTracker.h"
+#include "utils/PacketCapture.h"
+#include "utils/AcousticLogReader.h"
+#include "utils/OfflineProcessor.h"
+#include "utils/MetricsExporter.h"
+#include "utils/ToneTracker.h"
+#include "utils/BearingTimeRecord.h"
+#include "utils/Beamformer.h"
+#include "utils/SteeringCache.h"
+#include "utils/BeamformLog.h"
+#include "utils/Logger_Beamform.h"
 
 namespace py = pybind11;
 
@@ -51,7 +62,11 @@ void _utils(py::module_ &m) {
 
   py::class_<tsQueue<std::shared_ptr<IpcFFT>>, std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>>>  (m, "Q_FFT")
     // .def(py::init<>(), py::return_value_policy::take_ownership)
-    .def("pop", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> &qfft) {return qfft->pop();})
+    .def("pop", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> &qfft) {
+      auto fft_frame = qfft->pop();
+      fft_frame->stage_times.mark(STAGE::DELIVERED);
+      return fft_frame;
+    })
     .def("push", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> &qfft, std::shared_ptr<IpcFFT> data_frame) {return qfft->push(data_frame);})
     .def("size", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> &qfft) {return qfft->size();})
     .def_static("create",py::overload_cast<>(
@@ -59,6 +74,32 @@ void _utils(py::module_ &m) {
        )  
     ;
 
+  py::class_<tsQueue<std::shared_ptr<IpcDetectionEvent>>, std::shared_ptr<tsQueue<std::shared_ptr<IpcDetectionEvent>>>>  (m, "Q_EVENT")
+    .def("pop", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcDetectionEvent>>> &qevent) {
+      auto event = qevent->pop();
+      event->stage_times.mark(STAGE::DELIVERED);
+      return event;
+    })
+    .def("push", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcDetectionEvent>>> &qevent, std::shared_ptr<IpcDetectionEvent> event) {return qevent->push(event);})
+    .def("size", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcDetectionEvent>>> &qevent) {return qevent->size();})
+    .def_static("create",py::overload_cast<>(
+       &tsQueue<std::shared_ptr<IpcDetectionEvent>>::create)
+       )  
+    ;
+
+  py::class_<tsQueue<std::shared_ptr<IpcPSD>>, std::shared_ptr<tsQueue<std::shared_ptr<IpcPSD>>>>  (m, "Q_PSD")
+    .def("pop", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcPSD>>> &qpsd) {
+      auto psd_frame = qpsd->pop();
+      psd_frame->stage_times.mark(STAGE::DELIVERED);
+      return psd_frame;
+    })
+    .def("push", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcPSD>>> &qpsd, std::shared_ptr<IpcPSD> data_frame) {return qpsd->push(data_frame);})
+    .def("size", [](std::shared_ptr<tsQueue<std::shared_ptr<IpcPSD>>> &qpsd) {return qpsd->size();})
+    .def_static("create",py::overload_cast<>(
+       &tsQueue<std::shared_ptr<IpcPSD>>::create)
+       )  
+    ;
+
   py::class_<tsQueue<std::shared_ptr<UdpPtsData>>, std::shared_ptr<tsQueue<std::shared_ptr<UdpPtsData>>>>  (m, "Q_PTS")
     // .def(py::init<>(), py::return_value_policy::take_ownership)
     .def("pop", [](std::shared_ptr<tsQueue<std::shared_ptr<UdpPtsData>>> &qpts) {return qpts->pop();})
@@ -126,6 +167,7 @@ void _utils(py::module_ &m) {
       .def("stop", &QueueClient::stop)
       .def("pop_aco", [](QueueClient &sst) { return *sst.q_aco->pop(); })
       .def("pop_fft", [](QueueClient &sst) { return *sst.q_fft->pop(); })
+      .def("pop_psd", [](QueueClient &sst) { return *sst.q_psd->pop(); })
       .def("pop_bno", [](QueueClient &sst) { return *sst.q_bno->pop(); })
       .def("pop_bnr", [](QueueClient &sst) { return *sst.q_bnr->pop(); })
       .def("pop_ept", [](QueueClient &sst) { return *sst.q_ept->pop(); })
@@ -134,6 +176,7 @@ void _utils(py::module_ &m) {
       .def("pop_rtc", [](QueueClient &sst) { return *sst.q_rtc->pop(); })
       .def("pop_beam2d", [](QueueClient &sst) { return *sst.q_beam2d->pop(); })
       .def("pop_detector", [](QueueClient &sst) { return *sst.q_detect->pop(); })
+      .def("pop_event", [](QueueClient &sst) { return *sst.q_event->pop(); })
       // .def("pop_detector_all", [](QueueClient &sst) { return sst.q_detect->pop_all(); })
       .def("size", [](QueueClient &sst, QUEUE q) {
         switch (q) {
@@ -146,9 +189,18 @@ void _utils(py::module_ &m) {
         case QUEUE::CBF:
           return sst.q_beam2d->size();
           break;
+        case QUEUE::CBF_RAW:
+          return sst.q_beamraw->size();
+          break;
         case QUEUE::DETECT:
           return sst.q_detect->size();
           break;
+        case QUEUE::PSD:
+          return sst.q_psd->size();
+          break;
+        case QUEUE::EVENT:
+          return sst.q_event->size();
+          break;
         case QUEUE::EPT:
           return sst.q_ept->size();
           break;
@@ -171,8 +223,52 @@ void _utils(py::module_ &m) {
           return (size_t)0;
           break;
         }
+      })
+      .def("register_queues", &QueueClient::register_queues,
+           "Name this client's queues and add them to the QueueRegistry")
+      .def("get_queue_stats", &QueueClient::get_queue_stats)
+      .def("queue_health", &QueueClient::queue_health);
+
+  py::class_<QueueStats>(m, "QueueStats")
+      .def_readonly("name", &QueueStats::name)
+      .def_readonly("depth", &QueueStats::depth)
+      .def_readonly("max_length", &QueueStats::max_length)
+      .def_readonly("high_water", &QueueStats::high_water)
+      .def_readonly("pushes", &QueueStats::pushes)
+      .def_readonly("pops", &QueueStats::pops)
+      .def_readonly("drops", &QueueStats::drops)
+      .def_readonly("cleared", &QueueStats::cleared)
+      .def_readonly("wait_nsec", &QueueStats::wait_nsec)
+      .def("__repr__", [](const QueueStats &st) {
+        std::ostringstream oss;
+        oss << st;
+        return oss.str();
       });
 
+  py::class_<QueueRegistry, std::unique_ptr<QueueRegistry, py::nodelete>>(m, "QueueRegistry")
+      .def_static("instance", &QueueRegistry::instance, py::return_value_policy::reference)
+      .def("snapshot", &QueueRegistry::snapshot, "Counters of every registered queue")
+      .def("summary", &QueueRegistry::summary)
+      .def("reset_stats", &QueueRegistry::reset_stats);
+
+  py::class_<MetricsExporter>(m, "MetricsExporter")
+      .def(py::init<>())
+      .def("add_socket", &MetricsExporter::add_socket)
+      .def("add_fft", &MetricsExporter::add_fft, py::arg("fft"), py::arg("name") = "fft",
+           py::keep_alive<1, 2>())
+      .def("add_detector", &MetricsExporter::add_detector, py::arg("detector"),
+           py::arg("name") = "detector", py::keep_alive<1, 2>())
+      .def("add_interface_helper", &MetricsExporter::add_interface_helper,
+           "Pull metrics from the helper's sockets, FFT, detector and loggers",
+           py::keep_alive<1, 2>())
+      .def("add_logger_block", &MetricsExporter::add_logger_block, py::keep_alive<1, 2>())
+      .def("serve_http", &MetricsExporter::serve_http, py::arg("port"),
+           py::arg("bind_ip") = "127.0.0.1", "Serve GET /metrics from a background thread")
+      .def("write_file", &MetricsExporter::write_file, py::arg("path"),
+           py::arg("period_sec") = 10.0, "Periodically rewrite the metrics to a text file")
+      .def("stop", &MetricsExporter::stop, py::call_guard<py::gil_scoped_release>())
+      .def("render", &MetricsExporter::render, "Metrics in Prometheus text format");
+
   py::class_<UdpSocketIn, std::shared_ptr<UdpSocketIn>>(m, "UdpSocketIn")
       .def(py::init<>())
       .def_static("create", py::overload_cast<bool,  std::string, int32_t , std::string>(  
@@ -199,6 +295,15 @@ void _utils(py::module_ &m) {
            "Run intake socket in separate thread")
       .def("run", &UdpSocketIn::run,
            "Run intake socket in separate thread")
+      .def("dispatch", &UdpSocketIn::dispatch, py::arg("msg"), py::arg("rx_nsec") = -1,
+           "Decode a raw datagram and push it to the registered queues")
+      .def("start_capture", &UdpSocketIn::start_capture, py::arg("path"),
+           "Record received datagrams to a capture file")
+      .def("stop_capture", &UdpSocketIn::stop_capture)
+      .def("get_num_captured", &UdpSocketIn::get_num_captured)
+      .def("set_beam_storage", &UdpSocketIn::set_beam_storage, py::arg("storage"),
+           "In-memory storage of received beampatterns")
+      .def("get_beam_storage", &UdpSocketIn::get_beam_storage)
 
       // pybind11 requires explicit typing;
       // cannot just use the parent class as in pure C++
@@ -243,6 +348,9 @@ void _utils(py::module_ &m) {
       .def(
           "register_client", [](UdpSocketIn &sst, Logger_Sensor_Block &cst) { sst.register_client(cst); },
           py::arg("client"), "Register client")
+      .def(
+          "register_client", [](UdpSocketIn &sst, Logger_Beamform_Block &cst) { sst.register_client(cst); },
+          py::arg("client"), "Register client")
       .def(
           "register_client",
           [](UdpSocketIn &sst, InterfaceHelper &cst) { sst.register_client(cst); },
@@ -250,6 +358,154 @@ void _utils(py::module_ &m) {
       // Per overload resolution order, we register the generic QueueClient form as the last choice
       //.def("register_client", &UdpSocketIn::register_client, py::arg("client"), "Register client");
 
+  py::enum_<REPLAY_PACING>(m, "REPLAY_PACING")
+      .value("AS_FAST_AS_POSSIBLE", REPLAY_PACING::AS_FAST_AS_POSSIBLE)
+      .value("REALTIME", REPLAY_PACING::REALTIME);
+
+  py::class_<PacketReplay, std::shared_ptr<PacketReplay>>(m, "PacketReplay")
+      .def(py::init<>())
+      .def("open", &PacketReplay::open, py::arg("path"))
+      .def("close", &PacketReplay::close)
+      .def("is_open", &PacketReplay::is_open)
+      .def("size", &PacketReplay::size)
+      .def("__len__", &PacketReplay::size)
+      .def("get_start_time_nsec", &PacketReplay::get_start_time_nsec)
+      .def("get_end_time_nsec", &PacketReplay::get_end_time_nsec)
+      .def("find", &PacketReplay::find, py::arg("arrival_nsec"))
+      .def(
+          "read",
+          [](PacketReplay &rp, size_t idx) {
+            std::vector<int8_t> msg;
+            int64_t arrival_nsec = -1;
+            if (!rp.read(idx, msg, arrival_nsec)) {
+              throw py::index_error("packet index out of range");
+            }
+            return py::make_tuple(arrival_nsec, py::bytes((const char *)msg.data(), msg.size()));
+          },
+          py::arg("idx"), "Returns (arrival_nsec, raw datagram bytes)")
+      .def("replay", &PacketReplay::replay, py::arg("socket"),
+           py::arg("pacing") = REPLAY_PACING::AS_FAST_AS_POSSIBLE, py::arg("speed") = 1.0,
+           py::arg("first") = 0, py::arg("last") = SIZE_MAX,
+           py::call_guard<py::gil_scoped_release>(), "Replay in the calling thread")
+      .def("run", &PacketReplay::run, py::arg("socket"),
+           py::arg("pacing") = REPLAY_PACING::AS_FAST_AS_POSSIBLE, py::arg("speed") = 1.0,
+           py::arg("loop") = false, py::keep_alive<1, 2>(), "Replay in a separate thread")
+      .def("stop", &PacketReplay::stop, py::call_guard<py::gil_scoped_release>())
+      .def("is_running", &PacketReplay::is_running)
+      .def("get_num_replayed", &PacketReplay::get_num_replayed);
+
+  py::class_<AcousticLogSegment>(m, "AcousticLogSegment")
+      .def_readonly("paths", &AcousticLogSegment::paths)
+      .def_readonly("format", &AcousticLogSegment::format)
+      .def_readonly("first_sample", &AcousticLogSegment::first_sample)
+      .def_readonly("num_samples", &AcousticLogSegment::num_samples)
+      .def_readonly("start_time_nsec", &AcousticLogSegment::start_time_nsec)
+      .def_readonly("sample_rate", &AcousticLogSegment::sample_rate)
+      .def_readonly("num_channels", &AcousticLogSegment::num_channels);
+
+  py::class_<AcousticLogReader, std::shared_ptr<AcousticLogReader>>(m, "AcousticLogReader")
+      .def(py::init<>())
+      .def("open", &AcousticLogReader::open, py::arg("path"), py::arg("format") = LOGGER::UNKNOWN,
+           "Open a WAV / FLAC / CSV acoustic log, or a directory of them")
+      .def("close", &AcousticLogReader::close)
+      .def("is_open", &AcousticLogReader::is_open)
+      .def("size", &AcousticLogReader::size)
+      .def("__len__", &AcousticLogReader::size)
+      .def("get_num_channels", &AcousticLogReader::get_num_channels)
+      .def("get_sample_rate", &AcousticLogReader::get_sample_rate)
+      .def("get_format", &AcousticLogReader::get_format)
+      .def("get_segments", &AcousticLogReader::get_segments)
+      .def("set_default_sample_rate", &AcousticLogReader::set_default_sample_rate,
+           py::arg("sample_rate"))
+      .def("get_start_time_nsec", &AcousticLogReader::get_start_time_nsec)
+      .def("get_end_time_nsec", &AcousticLogReader::get_end_time_nsec)
+      .def("get_time_nsec", &AcousticLogReader::get_time_nsec, py::arg("sample"))
+      .def("find", &AcousticLogReader::find, py::arg("time_nsec"),
+           "First sample at or after time_nsec (len() if none)")
+      .def(
+          "read",
+          [](AcousticLogReader &rd, size_t first, size_t count) { return rd.read(first, count); },
+          py::arg("first"), py::arg("count"), "Samples [first, first + count) as channels x samples")
+      .def("read_packet", &AcousticLogReader::read_packet, py::arg("first"), py::arg("count"))
+      .def("replay", &AcousticLogReader::replay, py::arg("socket"),
+           py::arg("pacing") = REPLAY_PACING::AS_FAST_AS_POSSIBLE, py::arg("speed") = 1.0,
+           py::arg("first") = 0, py::arg("last") = SIZE_MAX,
+           py::call_guard<py::gil_scoped_release>(), "Replay in the calling thread")
+      .def("stop", &AcousticLogReader::stop)
+      .def("set_samples_per_packet", &AcousticLogReader::set_samples_per_packet,
+           py::arg("samples_per_packet"))
+      .def("get_samples_per_packet", &AcousticLogReader::get_samples_per_packet)
+      .def("set_max_queue_depth", &AcousticLogReader::set_max_queue_depth,
+           py::arg("max_queue_depth"));
+
+  py::enum_<FSYNC_POLICY>(m, "FSYNC_POLICY")
+      .value("NONE", FSYNC_POLICY::NONE)
+      .value("ON_CLOSE", FSYNC_POLICY::ON_CLOSE)
+      .value("PERIODIC", FSYNC_POLICY::PERIODIC)
+      .value("EVERY_WRITE", FSYNC_POLICY::EVERY_WRITE);
+
+  py::enum_<STAGE>(m, "STAGE")
+      .value("RECEIVED", STAGE::RECEIVED)
+      .value("PARSED", STAGE::PARSED)
+      .value("ENQUEUED", STAGE::ENQUEUED)
+      .value("FFT_DEQUEUED", STAGE::FFT_DEQUEUED)
+      .value("FFT_EMITTED", STAGE::FFT_EMITTED)
+      .value("DETECTOR_EMITTED", STAGE::DETECTOR_EMITTED)
+      .value("LOGGED", STAGE::LOGGED)
+      .value("DELIVERED", STAGE::DELIVERED);
+
+  py::class_<StageTimes>(m, "StageTimes")
+      .def("get", &StageTimes::get, py::arg("stage"), "Monotonic nsec at stage, -1 if unset")
+      .def("has", &StageTimes::has, py::arg("stage"))
+      .def("__repr__", [](const StageTimes &st) {
+        std::ostringstream oss;
+        oss << st;
+        return oss.str();
+      });
+
+  py::class_<LatencyStats>(m, "LatencyStats")
+      .def_readonly("stage", &LatencyStats::stage)
+      .def_readonly("count", &LatencyStats::count)
+      .def_readonly("mean_nsec", &LatencyStats::mean_nsec)
+      .def_readonly("p50_nsec", &LatencyStats::p50_nsec)
+      .def_readonly("p99_nsec", &LatencyStats::p99_nsec)
+      .def_readonly("max_nsec", &LatencyStats::max_nsec)
+      .def("__repr__", [](const LatencyStats &st) {
+        std::ostringstream oss;
+        oss << st;
+        return oss.str();
+      });
+
+  py::class_<LatencyTracker, std::unique_ptr<LatencyTracker, py::nodelete>>(m, "LatencyTracker")
+      .def_static("instance", &LatencyTracker::instance, py::return_value_policy::reference)
+      .def_static("is_enabled", &LatencyTracker::is_enabled)
+      .def_static("set_enabled", &LatencyTracker::set_enabled, py::arg("enabled"))
+      .def("get_since_receive", &LatencyTracker::get_since_receive,
+           "Per-stage latency since the datagram was received")
+      .def("get_step", &LatencyTracker::get_step,
+           "Per-stage latency since the stage feeding it")
+      .def("reset", &LatencyTracker::reset)
+      .def("report", &LatencyTracker::report);
+
+  py::class_<WriterStats>(m, "WriterStats")
+      .def(py::init<>())
+      .def_readonly("bytes_written", &WriterStats::bytes_written)
+      .def_readonly("writes", &WriterStats::writes)
+      .def_readonly("write_errors", &WriterStats::write_errors)
+      .def_readonly("fsyncs", &WriterStats::fsyncs)
+      .def_readonly("files_opened", &WriterStats::files_opened)
+      .def_readonly("dropped", &WriterStats::dropped)
+      .def_readonly("max_write_nsec", &WriterStats::max_write_nsec)
+      .def_readonly("stalls", &WriterStats::stalls)
+      .def_readonly("stall_nsec", &WriterStats::stall_nsec)
+      .def_readonly("queue_depth", &WriterStats::queue_depth)
+      .def_readonly("max_queue_depth", &WriterStats::max_queue_depth)
+      .def("__repr__", [](const WriterStats &st) {
+        std::ostringstream oss;
+        oss << st;
+        return oss.str();
+      });
+
   py::class_<LoggerBlock>(m, "LoggerBlock")
       .def(py::init<>())
       // .def(py::init<bool, std::string, std::string>())
@@ -268,7 +524,16 @@ void _utils(py::module_ &m) {
       .def("start_logging", &LoggerBlock::start_logging)
       .def("stop_logging", &LoggerBlock::stop_logging)
       .def("get_current_paths", &LoggerBlock::get_current_paths)
-      
+      .def("set_write_behind", &LoggerBlock::set_write_behind, py::arg("max_depth"))
+      .def("set_flac_workers", &LoggerBlock::set_flac_workers, py::arg("num_workers"))
+      .def("set_flac_compression_level", &LoggerBlock::set_flac_compression_level,
+           py::arg("level"))
+      .def("set_flac_block_frames", &LoggerBlock::set_flac_block_frames,
+           py::arg("block_frames"))
+      .def("set_fsync_policy", &LoggerBlock::set_fsync_policy, py::arg("policy"),
+           py::arg("period_sec") = 5.0)
+      .def("get_writer_stats", &LoggerBlock::get_writer_stats, py::arg("logger"))
+
       .def("run", &LoggerBlock::run);
 
   py::class_<Logger_Sensor_Block>(m, "Logger_Sensor_Block")
@@ -287,7 +552,10 @@ void _utils(py::module_ &m) {
       .def("stop_logging", &Logger_Sensor_Block::stop_logging)
       .def("run", &Logger_Sensor_Block::run)
       .def("get_current_paths", &Logger_Sensor_Block::get_current_paths)
-      
+      .def("set_fsync_policy", &Logger_Sensor_Block::set_fsync_policy, py::arg("policy"),
+           py::arg("period_sec") = 5.0)
+      .def("get_writer_stats", &Logger_Sensor_Block::get_writer_stats, py::arg("logger"))
+
         ;
   py::class_<Logger_GPS_Host_Block>(m, "Logger_GPS_Host_Block")
       .def(py::init<>())
@@ -296,9 +564,27 @@ void _utils(py::module_ &m) {
       .def("stop_logging", &Logger_GPS_Host_Block::stop_logging)
       .def("run", &Logger_GPS_Host_Block::run)
       .def("get_current_paths", &Logger_GPS_Host_Block::get_current_paths)
-      
+      .def("set_fsync_policy", &Logger_GPS_Host_Block::set_fsync_policy, py::arg("policy"),
+           py::arg("period_sec") = 5.0)
+      .def("get_writer_stats", &Logger_GPS_Host_Block::get_writer_stats)
+
         ;
 
+  py::class_<Logger_Beamform_Block>(m, "Logger_Beamform_Block")
+      .def(py::init<>())
+      .def("set_outdir", &Logger_Beamform_Block::set_outdir, py::arg("outdir"))
+      .def("set_rollover_min", &Logger_Beamform_Block::set_rollover_min, py::arg("min"))
+      .def("set_storage", &Logger_Beamform_Block::set_storage, py::arg("storage"),
+           py::arg("db_range") = BEAM_DB_U8_RANGE)
+      .def("start_logging", &Logger_Beamform_Block::start_logging)
+      .def("stop_logging", &Logger_Beamform_Block::stop_logging)
+      .def("run", &Logger_Beamform_Block::run)
+      .def("stop", &Logger_Beamform_Block::stop)
+      .def("get_current_paths", &Logger_Beamform_Block::get_current_paths)
+      .def("set_fsync_policy", &Logger_Beamform_Block::set_fsync_policy, py::arg("policy"),
+           py::arg("period_sec") = 5.0)
+      .def("get_writer_stats", &Logger_Beamform_Block::get_writer_stats, py::arg("logger"));
+
   py::class_<FreqDomainBase, QueueClient, std::shared_ptr<FreqDomainBase>>(m, "FreqDomainBase")
       .def(py::init<>())
       .def("set_sample_rate", &FreqDomainBase::set_sample_rate, py::arg("sample_rate"))
@@ -333,6 +619,22 @@ void _utils(py::module_ &m) {
           py::arg("start_time_nsec"), py::arg("time_series"),
           "Add time-series data to acoustic queue");
 
+  py::class_<Decimator>(m, "Decimator")
+      .def(py::init<>())
+      .def("configure_lowpass", &Decimator::configure_lowpass, py::arg("fs_in"),
+           py::arg("f_high"), "Returns the decimation factor")
+      .def("process", &Decimator::process, py::arg("data"))
+      .def("reset", &Decimator::reset)
+      .def("get_factor", &Decimator::get_factor)
+      .def("get_num_taps", &Decimator::get_num_taps)
+      .def("get_output_rate", &Decimator::get_output_rate)
+      .def("get_delay", &Decimator::get_delay);
+
+  py::enum_<FFT_MODE>(m, "FFT_MODE")
+      .value("SPECTRUM", FFT_MODE::SPECTRUM)
+      .value("ACTIVE_BINS", FFT_MODE::ACTIVE_BINS)
+      .value("WELCH_PSD", FFT_MODE::WELCH_PSD);
+
   py::class_<FFT, FreqDomainBase, std::shared_ptr<FFT>>(m, "FFT")
       //.def(py::init<>())
       .def(
@@ -349,21 +651,319 @@ void _utils(py::module_ &m) {
       .def("set_channel_filter", py::overload_cast<std::vector<int>>(&FFT::set_channel_filter),
            py::arg("ch_filter"))
       .def("run", &FFT::run)
+      .def("process",
+           py::overload_cast<const std::vector<std::shared_ptr<UdpAcousticData>> &>(&FFT::process),
+           py::arg("packets"), "Append packets and return the completed FFT frames")
+      .def("process", py::overload_cast<std::shared_ptr<UdpAcousticData>>(&FFT::process),
+           py::arg("aco_pkt"), "Append a packet and return the completed FFT frames")
+      .def("reset", &FFT::reset)
+      .def(
+          "register_psd_client",
+          [](FFT &sst, std::shared_ptr<tsQueue<std::shared_ptr<IpcPSD>>> cst) {
+            sst.register_client(cst);
+          },
+          py::arg("client"), "Register a Welch PSD client")
+      .def("set_mode", &FFT::set_mode, py::arg("mode"))
+      .def("set_decimation", &FFT::set_decimation, py::arg("enable"),
+           "Decimate ahead of the FFT, down to the highest frequency band")
+      .def("get_decimation", &FFT::get_decimation)
+      .def("get_decimation_factor", &FFT::get_decimation_factor)
+      .def("get_mode", &FFT::get_mode)
+      .def("set_psd_averages", &FFT::set_psd_averages, py::arg("num_frames"))
+      .def("set_psd_average_sec", &FFT::set_psd_average_sec, py::arg("span_sec"))
+      .def("get_psd_averages", &FFT::get_psd_averages)
+      .def("process_psd", &FFT::process_psd, py::arg("packets"),
+           "Append packets and return the completed Welch PSD averages")
 
       .def_static("create", py::overload_cast<>(  
           &FFT::create)
        ) 
       ;
+  py::enum_<TONE_METHOD>(m, "TONE_METHOD")
+      .value("GOERTZEL", TONE_METHOD::GOERTZEL)
+      .value("SLIDING_DFT", TONE_METHOD::SLIDING_DFT);
+
+  py::class_<ToneTracker, FreqDomainBase, std::shared_ptr<ToneTracker>>(m, "ToneTracker")
+      .def(
+          "register_client",
+          [](ToneTracker &sst, std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> cst) {
+            sst.register_client(cst);
+          },
+          py::arg("client"), "Register client")
+      .def("get_input_queue", &ToneTracker::get_input_queue)
+      .def("set_adc_scale", &ToneTracker::set_adc_scale, py::arg("adc_scale"))
+      .def("set_method", &ToneTracker::set_method, py::arg("method"))
+      .def("get_method", &ToneTracker::get_method)
+      .def("run", &ToneTracker::run)
+      .def("process", &ToneTracker::process, py::arg("packets"),
+           "Append packets and return the completed frames of the active bins")
+      .def("reset", &ToneTracker::reset)
+      .def_static("create", &ToneTracker::create);
+
+  py::class_<Beamformer, FreqDomainBase, std::shared_ptr<Beamformer>>(m, "Beamformer")
+      .def(
+          "register_client",
+          [](Beamformer &sst, ptr_tsQ<UdpBeamform2D> cst) { sst.register_client(cst); },
+          py::arg("client"), "Register client")
+      .def(
+          "register_client",
+          [](Beamformer &sst, Logger_Beamform_Block &cst) { sst.register_client(cst); },
+          py::arg("client"), "Register client")
+      .def("get_input_queue", &Beamformer::get_input_queue)
+      .def("set_array", &Beamformer::set_array, py::arg("array_x"), py::arg("array_y"),
+           py::arg("array_z"))
+      .def("set_element_weights", &Beamformer::set_element_weights, py::arg("element_weights"))
+      .def("set_element_mask", &Beamformer::set_element_mask, py::arg("element_mask"))
+      .def("set_bearings_rad", &Beamformer::set_bearings_rad, py::arg("bearings_rad"))
+      .def("set_elevations_rad", &Beamformer::set_elevations_rad, py::arg("elevations_rad"))
+      .def("set_sound_speed", &Beamformer::set_sound_speed, py::arg("sound_speed"))
+      .def("get_num_elements", &Beamformer::get_num_elements)
+      .def("get_bearings_rad", &Beamformer::get_bearings_rad)
+      .def("get_elevations_rad", &Beamformer::get_elevations_rad)
+      .def("get_sound_speed", &Beamformer::get_sound_speed)
+      .def("run", &Beamformer::run)
+      .def("process", &Beamformer::process, py::arg("frames"),
+           "Beamform FFT frames (one channel per element) into one beampattern each")
+      .def("reset", &Beamformer::reset)
+      .def_static("create", &Beamformer::create);
+
+  py::class_<BearingPeak>(m, "BearingPeak")
+      .def_readonly("index", &BearingPeak::index)
+      .def_readonly("bearing_rad", &BearingPeak::bearing_rad)
+      .def_readonly("level", &BearingPeak::level)
+      .def_readonly("time_nsec", &BearingPeak::time_nsec);
+
+  py::class_<BearingTimeRecord, std::shared_ptr<BearingTimeRecord>>(m, "BearingTimeRecord")
+      .def(py::init<size_t>(), py::arg("history") = 1000)
+      .def("set_history", &BearingTimeRecord::set_history, py::arg("history"))
+      .def("set_reduction", &BearingTimeRecord::set_reduction, py::arg("reduction"))
+      .def("get_reduction", &BearingTimeRecord::get_reduction)
+      .def("set_num_peaks", &BearingTimeRecord::set_num_peaks, py::arg("num_peaks"))
+      .def("get_num_peaks", &BearingTimeRecord::get_num_peaks)
+      .def("add", &BearingTimeRecord::add, py::arg("beam"))
+      .def("clear", &BearingTimeRecord::clear)
+      .def("size", &BearingTimeRecord::size)
+      .def("get_bearings_rad", &BearingTimeRecord::get_bearings_rad)
+      .def("get_btr", &BearingTimeRecord::get_btr, "num_bearings x frames, oldest first")
+      .def("get_times", &BearingTimeRecord::get_times)
+      .def("get_latest_peaks", &BearingTimeRecord::get_latest_peaks);
+
+  py::class_<SteeringTensor, std::shared_ptr<SteeringTensor>>(m, "SteeringTensor")
+      .def_readonly("num_beams", &SteeringTensor::num_beams)
+      .def_readonly("num_elements", &SteeringTensor::num_elements)
+      .def_readonly("num_frequencies", &SteeringTensor::num_frequencies)
+      .def_readonly("hash", &SteeringTensor::hash)
+      .def_readonly("data", &SteeringTensor::data,
+                    "Conjugated steering vectors, num_beams x (num_elements * num_frequencies)")
+      .def(
+          "frequency",
+          [](const SteeringTensor &st, Eigen::Index kk) -> Eigen::MatrixXcd {
+            return st.frequency(kk);
+          },
+          py::arg("index"), "num_beams x num_elements block of one frequency");
+
+  py::class_<SteeringCache, std::unique_ptr<SteeringCache, py::nodelete>>(m, "SteeringCache")
+      .def_static("instance", &SteeringCache::instance, py::return_value_policy::reference)
+      .def(
+          "get",
+          [](SteeringCache &sc, const UdpBeamform2D &beam, double sound_speed) {
+            return std::const_pointer_cast<SteeringTensor>(
+                sc.get(SteeringGrid(beam.data, sound_speed)));
+          },
+          py::arg("beam"), py::arg("sound_speed") = 1500,
+          "Steering tensor for the geometry and grid of a beampattern")
+      .def("size", &SteeringCache::size)
+      .def("clear", &SteeringCache::clear)
+      .def("get_hits", &SteeringCache::get_hits)
+      .def("get_misses", &SteeringCache::get_misses);
+
+  py::enum_<BEAM_LOG_KIND>(m, "BEAM_LOG_KIND")
+      .value("BEAM_2D", BEAM_LOG_KIND::BEAM_2D)
+      .value("BEAM_RAW", BEAM_LOG_KIND::BEAM_RAW);
+  py::enum_<BEAM_LOG_WRITE>(m, "BEAM_LOG_WRITE")
+      .value("WRITTEN", BEAM_LOG_WRITE::WRITTEN)
+      .value("NEW_FILE", BEAM_LOG_WRITE::NEW_FILE)
+      .value("DROPPED", BEAM_LOG_WRITE::DROPPED);
+
+  py::class_<BeamLogGeometry>(m, "BeamLogGeometry")
+      .def_readonly("kind", &BeamLogGeometry::kind)
+      .def_readonly("array_x", &BeamLogGeometry::array_x)
+      .def_readonly("array_y", &BeamLogGeometry::array_y)
+      .def_readonly("array_z", &BeamLogGeometry::array_z)
+      .def_readonly("frequencies", &BeamLogGeometry::frequencies)
+      .def_readonly("element_weights", &BeamLogGeometry::element_weights)
+      .def_readonly("element_mask", &BeamLogGeometry::element_mask)
+      .def_readonly("bearings_rad", &BeamLogGeometry::bearings_rad)
+      .def_readonly("elevations_rad", &BeamLogGeometry::elevations_rad)
+      .def_readonly("dims", &BeamLogGeometry::dims);
+
+  py::class_<BeamformLogWriter>(m, "BeamformLogWriter")
+      .def(py::init<>())
+      .def("set_storage", &BeamformLogWriter::set_storage, py::arg("storage"),
+           py::arg("db_range") = BEAM_DB_U8_RANGE)
+      .def("get_storage", &BeamformLogWriter::get_storage)
+      .def("open", &BeamformLogWriter::open, py::arg("path"))
+      .def("close", &BeamformLogWriter::close, "Append the time index and close the file")
+      .def("is_open", &BeamformLogWriter::is_open)
+      .def("get_path", &BeamformLogWriter::get_path)
+      .def("get_num_frames", &BeamformLogWriter::get_num_frames)
+      .def("write", py::overload_cast<const UdpBeamform2D &>(&BeamformLogWriter::write),
+           py::arg("beam"), "NEW_FILE when the frame's geometry does not belong in this file")
+      .def("write", py::overload_cast<const UdpBeamformRaw &>(&BeamformLogWriter::write),
+           py::arg("beam"), "NEW_FILE when the frame's geometry does not belong in this file")
+      .def("flush", &BeamformLogWriter::flush)
+      .def("set_fsync_policy", &BeamformLogWriter::set_fsync_policy, py::arg("policy"),
+           py::arg("period_sec") = 5.0)
+      .def("get_stats", &BeamformLogWriter::get_stats);
+
+  py::class_<BeamformLogReader>(m, "BeamformLogReader")
+      .def(py::init<>())
+      .def(py::init<const std::string &>(), py::arg("path"))
+      .def("open", &BeamformLogReader::open, py::arg("path"))
+      .def("close", &BeamformLogReader::close)
+      .def("is_open", &BeamformLogReader::is_open)
+      .def("get_kind", &BeamformLogReader::get_kind)
+      .def("get_storage", &BeamformLogReader::get_storage)
+      .def("get_geometry", &BeamformLogReader::get_geometry,
+           py::return_value_policy::reference_internal)
+      .def("size", &BeamformLogReader::size)
+      .def("__len__", &BeamformLogReader::size)
+      .def("is_indexed", &BeamformLogReader::is_indexed)
+      .def("get_times", &BeamformLogReader::get_times)
+      .def("find", &BeamformLogReader::find, py::arg("time_nsec"),
+           "First frame at or after time_nsec (len() if none)")
+      .def("read_2d", &BeamformLogReader::read_2d, py::arg("frame"))
+      .def("read_raw", &BeamformLogReader::read_raw, py::arg("frame"));
+
+  py::class_<DetectionEventBuilder>(m, "DetectionEventBuilder")
+      .def(py::init<>())
+      .def("set_max_gap_frames", &DetectionEventBuilder::set_max_gap_frames,
+           py::arg("max_gap_frames"))
+      .def("set_max_duration_sec", &DetectionEventBuilder::set_max_duration_sec,
+           py::arg("max_duration_sec"))
+      .def("set_frame_duration_nsec", &DetectionEventBuilder::set_frame_duration_nsec,
+           py::arg("frame_duration_nsec"))
+      .def(
+          "add",
+          [](DetectionEventBuilder &sst, const IpcDetector &frame) {
+            std::vector<std::shared_ptr<IpcDetectionEvent>> out;
+            sst.add(frame, out);
+            return out;
+          },
+          py::arg("frame"), "Feed one detector frame; returns the events it completes")
+      .def(
+          "flush",
+          [](DetectionEventBuilder &sst) {
+            std::vector<std::shared_ptr<IpcDetectionEvent>> out;
+            sst.flush(out);
+            return out;
+          },
+          "Close the open event, if any")
+      .def("reset", &DetectionEventBuilder::reset)
+      .def("is_open", &DetectionEventBuilder::is_open);
+
+  py::enum_<DETECTOR_ALGORITHM>(m, "DETECTOR_ALGORITHM")
+      .value("EMA_RATIO", DETECTOR_ALGORITHM::EMA_RATIO)
+      .value("CA_CFAR", DETECTOR_ALGORITHM::CA_CFAR)
+      .value("OS_CFAR", DETECTOR_ALGORITHM::OS_CFAR)
+      .value("MEDIAN_FLOOR", DETECTOR_ALGORITHM::MEDIAN_FLOOR);
+
   py::class_<EnergyDetector, FreqDomainBase, QueueClient, std::shared_ptr<EnergyDetector>>(m, "EnergyDetector")
       // .def(py::init<>())
       .def("register_client", &EnergyDetector::register_client, py::arg("client"),
            "Register client")
       .def("get_input_queue", py::overload_cast<>(&EnergyDetector::get_input_queue)
            )
+      .def("process", &EnergyDetector::process, py::arg("ipc_fft"),
+           "Run the detector on one FFT frame")
+      .def(
+          "process_batch",
+          [](EnergyDetector &sst, const std::vector<std::shared_ptr<IpcFFT>> &frames) {
+            std::vector<std::shared_ptr<IpcDetector>> out;
+            sst.process_batch(frames, out);
+            return out;
+          },
+          py::arg("frames"), "Run the detector on several FFT frames, in order")
+      .def("set_threshold", &EnergyDetector::set_threshold, py::arg("threshold"))
+      .def("get_threshold", &EnergyDetector::get_threshold)
+      .def(
+          "register_event_client",
+          [](EnergyDetector &sst, std::shared_ptr<tsQueue<std::shared_ptr<IpcDetectionEvent>>> cst) {
+            sst.register_client(cst);
+          },
+          py::arg("client"), "Register a detection event client")
+      .def(
+          "process_events",
+          [](EnergyDetector &sst, const std::vector<std::shared_ptr<IpcDetector>> &detections) {
+            std::vector<std::shared_ptr<IpcDetectionEvent>> out;
+            sst.process_events(detections, out);
+            return out;
+          },
+          py::arg("detections"), "Merge detector frames into events; returns completed events")
+      .def(
+          "flush_events",
+          [](EnergyDetector &sst) {
+            std::vector<std::shared_ptr<IpcDetectionEvent>> out;
+            sst.flush_events(out);
+            return out;
+          })
+      .def("set_event_merge", &EnergyDetector::set_event_merge, py::arg("max_gap_frames"),
+           py::arg("max_duration_sec"))
+      .def("set_algorithm", &EnergyDetector::set_algorithm, py::arg("algorithm"))
+      .def("get_algorithm", &EnergyDetector::get_algorithm)
+      .def("set_averaging", &EnergyDetector::set_averaging, py::arg("alpha_st"),
+           py::arg("alpha_lt"), "EMA_RATIO short / long term EMA weights")
+      .def("set_cfar_window", &EnergyDetector::set_cfar_window, py::arg("num_train"),
+           py::arg("num_guard"), "Training / guard bins each side of the bin under test")
+      .def("set_os_rank", &EnergyDetector::set_os_rank, py::arg("rank"))
+      .def("set_threshold_db", &EnergyDetector::set_threshold_db, py::arg("threshold_db"))
+      .def("get_threshold_db", &EnergyDetector::get_threshold_db)
+      .def("set_band_threshold_db", &EnergyDetector::set_band_threshold_db, py::arg("band"),
+           py::arg("threshold_db"))
+      .def("get_band_threshold_db", &EnergyDetector::get_band_threshold_db, py::arg("band"))
+      .def("reset", &EnergyDetector::reset)
       .def_static("create", py::overload_cast<>(  
           &EnergyDetector::create)
        );
 
+  py::class_<OfflineResult>(m, "OfflineResult")
+      .def_readonly("fft", &OfflineResult::fft)
+      .def_readonly("psd", &OfflineResult::psd)
+      .def_readonly("detections", &OfflineResult::detections)
+      .def_readonly("events", &OfflineResult::events)
+      .def_readonly("num_samples", &OfflineResult::num_samples)
+      .def_readonly("num_chunks", &OfflineResult::num_chunks)
+      .def_readonly("elapsed_sec", &OfflineResult::elapsed_sec);
+
+  py::class_<OfflineProcessor, std::shared_ptr<OfflineProcessor>>(m, "OfflineProcessor")
+      .def(py::init<>())
+      .def("open_log", &OfflineProcessor::open_log, py::arg("path"),
+           py::arg("format") = LOGGER::UNKNOWN, "Acoustic log, or directory of rolled-over logs")
+      .def("open_capture", &OfflineProcessor::open_capture, py::arg("path"))
+      .def("close", &OfflineProcessor::close)
+      .def("is_open", &OfflineProcessor::is_open)
+      .def("size", &OfflineProcessor::size)
+      .def("__len__", &OfflineProcessor::size)
+      .def("get_sample_rate", &OfflineProcessor::get_sample_rate)
+      .def("get_num_channels", &OfflineProcessor::get_num_channels)
+      .def("get_time_nsec", &OfflineProcessor::get_time_nsec, py::arg("sample"))
+      .def("find", &OfflineProcessor::find, py::arg("time_nsec"),
+           "First sample at or after time_nsec (len() if none)")
+      .def("set_fft", &OfflineProcessor::set_fft, py::arg("fft"), "FFT settings template")
+      .def("set_detector", &OfflineProcessor::set_detector, py::arg("detector"),
+           "EnergyDetector settings template")
+      .def("set_num_threads", &OfflineProcessor::set_num_threads, py::arg("num_threads"))
+      .def("set_chunk_sec", &OfflineProcessor::set_chunk_sec, py::arg("chunk_sec"))
+      .def("set_detector_warmup_frames", &OfflineProcessor::set_detector_warmup_frames,
+           py::arg("num_frames"))
+      .def("set_samples_per_packet", &OfflineProcessor::set_samples_per_packet,
+           py::arg("samples_per_packet"))
+      .def("set_keep_fft", &OfflineProcessor::set_keep_fft, py::arg("keep_fft"))
+      .def("process", &OfflineProcessor::process, py::arg("first") = 0,
+           py::arg("last") = SIZE_MAX, py::call_guard<py::gil_scoped_release>(),
+           "Process samples [first, last) across the worker threads")
+      .def("stop", &OfflineProcessor::stop);
+
   py::class_<InterfaceHelper, QueueClient, std::shared_ptr<InterfaceHelper>>(m, "InterfaceHelper")
       .def(py::init<>())
       .def_readwrite("fft", &InterfaceHelper::_fft_helper)
@@ -416,11 +1016,21 @@ void _utils(py::module_ &m) {
              }
              return py::none();
            })
+      .def("get_bearing_peaks",
+           [](InterfaceHelper &sst) {
+             sst.q_request_peaks->push(true);
+             return sst.q_peaks_out->pop();
+           })
       .def("get_detection_data",
            [](InterfaceHelper &sst) {
              sst.q_request_detections->push(true);
              return sst.q_detections_out->pop();
            })
+      .def("get_detection_events",
+           [](InterfaceHelper &sst) {
+             sst.q_request_events->push(true);
+             return sst.q_events_out->pop();
+           })
       .def("aco_size", [](InterfaceHelper &sst) { return sst.q_aco->size(); })
       .def("fft_size", [](InterfaceHelper &sst) { return sst.q_fft->size(); })
       .def("aco_front", [](InterfaceHelper &sst) { return sst.q_aco->front(); })
@@ -446,7 +1056,12 @@ void _utils(py::module_ &m) {
       .def("enable_logger", &InterfaceHelper::enable_logger, py::arg("logger"), py::arg("enable"))
       .def("start_logging", &InterfaceHelper::start_logging, py::arg("logger"))
       .def("stop_logging", &InterfaceHelper::stop_logging, py::arg("logger"))
+      .def("set_fsync_policy", &InterfaceHelper::set_fsync_policy, py::arg("policy"),
+           py::arg("period_sec") = 5.0)
+      .def("get_writer_stats", &InterfaceHelper::get_writer_stats, py::arg("logger"))
 
+      .def("set_btr_reduction", &InterfaceHelper::set_btr_reduction, py::arg("reduction"))
+      .def("set_btr_peaks", &InterfaceHelper::set_btr_peaks, py::arg("num_peaks"))
       .def("set_adc_scale", &InterfaceHelper::set_adc_scale, py::arg("adc_scale"))
       .def("set_phone_sensitivity_V_uPa", &InterfaceHelper::set_phone_sensitivity_V_uPa,
            py::arg("sensitivity_V_uPa"))
@@ -47,6 +47,28 @@ int main(int argc, char *argv[]) {
   run_bf_raw_tests(FLAGS_test_data_dir, "sample_beamformer_raw_packet.dat");
   run_bf_2d_tests(FLAGS_test_data_dir, "sample_beamformer_2d_packet.dat");
   run_pts_tests();
+  run_imu_tests();
+  run_capture_tests(FLAGS_test_data_dir);
+  run_latency_tests(FLAGS_test_data_dir);
+  run_queue_tests();
+  run_metrics_tests(FLAGS_test_data_dir);
+  run_psd_tests(FLAGS_test_data_dir);
+  run_active_bins_tests(FLAGS_test_data_dir);
+  run_tone_tests(FLAGS_test_data_dir);
+  run_decimation_tests();
+  run_detector_algorithm_tests();
+  run_detection_event_tests();
+  run_beamformer_tests();
+  run_steering_cache_tests();
+  run_btr_tests();
+  run_beam_storage_tests();
+  run_beam_log_tests(FLAGS_test_data_dir);
+  run_aco_log_reader_tests();
+  run_offline_tests();
+  run_csv_tests(FLAGS_test_data_dir);
+  run_aco_logger_tests(FLAGS_test_data_dir);
+  run_bf_raw_reassembly_tests(FLAGS_test_data_dir);
+  run_encoder_tests(FLAGS_test_data_dir);
 
   return 0;
 }
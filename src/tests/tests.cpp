@@ -9,20 +9,72 @@
 
 #include <algorithm>
 #include <arpa/inet.h>
+#include <chrono>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <thread>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <sys/socket.h>
+#include <unistd.h>
 #include <vector>
 
 #include "tests.h"
+#include "utils/AcousticLogReader.h"
+#include "utils/BeamformLog.h"
+#include "utils/BearingTimeRecord.h"
+#include "utils/Beamformer.h"
+#include "utils/DetectionEventBuilder.h"
+#include "utils/EnergyDetector.h"
+#include "utils/FFT.h"
+#include "utils/LatencyTracker.h"
+#include "utils/Logger_Acoustic.h"
+#include "utils/MetricsExporter.h"
+#include "utils/OfflineProcessor.h"
+#include "utils/P2Quantile.h"
+#include "utils/PacketCapture.h"
+#include "utils/QueueRegistry.h"
+#include "utils/SteeringCache.h"
+#include "utils/ToneTracker.h"
+#include "utils/UdpSocketIn.h"
 #include "udp_protocols/UdpAcousticData.h"
 #include "udp_protocols/UdpBeamform2D.h"
 #include "udp_protocols/UdpBeamformRaw.h"
+#include "udp_protocols/UdpBnoData.h"
+#include "udp_protocols/UdpBnrData.h"
 #include "udp_protocols/UdpData.h"
+#include "udp_protocols/UdpEptData.h"
+#include "udp_protocols/UdpImuData.h"
+#include "udp_protocols/UdpPtsData.h"
+#include "udp_protocols/UdpRtcData.h"
 
 #include <Eigen/Dense>
 
+// One of the sample datagrams in test_file_dir, as received (empty if missing)
+static std::vector<int8_t>
+load_sample_packet(const std::string &test_file_dir,
+                   const std::string &name = "sample_raw_acoustic_packet.dat") {
+  std::ifstream ifil(test_file_dir + name, std::ios::binary);
+  std::vector<char> raw((std::istreambuf_iterator<char>(ifil)), std::istreambuf_iterator<char>());
+  return std::vector<int8_t>(raw.begin(), raw.end());
+}
+
+// num_packets decodes of an acoustic datagram, each step_nsec later than the one before
+// (0 : all stamped alike)
+static std::vector<std::shared_ptr<UdpAcousticData>>
+make_packet_train(std::vector<int8_t> &buff, size_t num_packets, int64_t step_nsec = 0) {
+  std::vector<std::shared_ptr<UdpAcousticData>> packets;
+  for (size_t ii = 0; ii < num_packets; ii++) {
+    packets.push_back(std::make_shared<UdpAcousticData>(buff));
+    packets.back()->header.start_time_nsec += ii * step_nsec;
+  }
+  return packets;
+}
+
 void run_aco_tests(std::string test_file_dir, std::string test_file_name) {
   // Test UdpAcousticData
   LOG(INFO) << "Checking Acoustic Data protocol";
@@ -250,3 +302,1670 @@ void run_pts_tests() {
             << std::endl
             << test2;
 }
+
+void run_imu_tests() {
+  LOG(INFO) << "Checking IMU Data protocol";
+
+  // > IM datagram built by hand: pitch / roll as int32 hundredths of a degree, then
+  //   accel x/y/z and gyro x/y/z as int16
+  UdpData::Header header;
+  header.start_time_nsec = 1760000000000000000;
+  header.id[0] = 'I';
+  header.id[1] = 'M';
+  header.num_bytes = 20;
+  std::vector<int8_t> buff = header.encode();
+  int32_t pitch_x100 = 1234, roll_x100 = -567;
+  int16_t motion[6] = {-32768, 12345, 1, -2, 300, 32767};
+  buff.resize(sizeof(UdpData::Header) + 20);
+  std::memcpy(buff.data() + sizeof(UdpData::Header), &pitch_x100, sizeof(pitch_x100));
+  std::memcpy(buff.data() + sizeof(UdpData::Header) + 4, &roll_x100, sizeof(roll_x100));
+  std::memcpy(buff.data() + sizeof(UdpData::Header) + 8, motion, sizeof(motion));
+
+  UdpImuData imu(buff);
+  bool attitude_ok = std::abs(imu.pitch_ned_deg - 12.34f) < 1e-4 &&
+                     std::abs(imu.roll_ned_deg + 5.67f) < 1e-4;
+  bool motion_ok = imu.accel_x == motion[0] && imu.accel_y == motion[1] &&
+                   imu.accel_z == motion[2] && imu.gyro_x == motion[3] &&
+                   imu.gyro_y == motion[4] && imu.gyro_z == motion[5];
+  LOG(INFO) << "Pitch / roll : " << imu.pitch_ned_deg << " / " << imu.roll_ned_deg << " deg : "
+            << (attitude_ok ? "OK" : "FAILED");
+  LOG(INFO) << "Accel / gyro : " << (motion_ok ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of IMU test" << std::endl << std::endl;
+}
+
+void run_capture_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking packet capture and replay";
+
+  // the raw beamformer sample is a reassembled multi-datagram packet; only single
+  // datagrams (<= 64 KiB) can be captured
+  std::vector<std::string> names = {"sample_raw_acoustic_packet.dat",
+                                    "sample_beamformer_2d_packet.dat"};
+  std::vector<std::vector<int8_t>> packets;
+  for (auto &name : names) {
+    packets.push_back(load_sample_packet(test_file_dir, name));
+  }
+
+  // > Record each sample a few times, 1 ms apart
+  std::string capture_path = "/tmp/ac_test_capture.pcap";
+  int num_repeats = 5;
+  {
+    PacketRecorder recorder;
+    recorder.open(capture_path);
+    int64_t t_nsec = 1000000000;
+    for (int ii = 0; ii < num_repeats; ii++) {
+      for (auto &pkt : packets) {
+        recorder.record(pkt.data(), pkt.size(), t_nsec);
+        t_nsec += 1000000;
+      }
+    }
+    LOG(INFO) << "Recorded " << recorder.get_num_packets() << " packets";
+  }
+
+  // > Replay as fast as possible through the socket's dispatch path
+  UdpSocketIn socket;
+  auto q_aco = std::make_shared<tsQueue<std::shared_ptr<UdpAcousticData>>>();
+  auto q_beam2d = std::make_shared<tsQueue<std::shared_ptr<UdpBeamform2D>>>();
+  socket.register_client_aco(q_aco);
+  socket.register_client_beam2d(q_beam2d);
+
+  PacketReplay replay;
+  replay.open(capture_path);
+  size_t num_replayed = replay.replay(socket);
+  LOG(INFO) << "Replayed " << num_replayed << " of " << replay.size() << " packets : "
+            << (num_replayed == packets.size() * num_repeats ? "OK" : "FAILED");
+  LOG(INFO) << "Queue sizes (ACO, ACB2) : " << q_aco->size() << ", " << q_beam2d->size();
+
+  int64_t arrival_nsec;
+  std::vector<int8_t> msg;
+  replay.read(1, msg, arrival_nsec);
+  LOG(INFO) << "Packet round trip comparison result : " << std::boolalpha
+            << (msg == packets.at(1));
+  LOG(INFO) << "Seek to t=1.004 s gives packet " << replay.find(1004000000) << " (expect 4)";
+
+  // > Real-time pacing reproduces the recorded 1 ms gaps
+  auto t_start = std::chrono::steady_clock::now();
+  replay.replay(socket, REPLAY_PACING::REALTIME);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t_start;
+  LOG(INFO) << "Real-time replay took " << elapsed.count() << " s (expect ~"
+            << (packets.size() * num_repeats - 1) * 1e-3 << " s)";
+  replay.close();
+
+  // > A capture without its index (e.g. after a crash) is re-indexed on open
+  std::ifstream ifil(capture_path, std::ios::binary);
+  std::vector<char> raw((std::istreambuf_iterator<char>(ifil)), std::istreambuf_iterator<char>());
+  size_t index_bytes = packets.size() * num_repeats * sizeof(pcap_format::IndexEntry) +
+                       sizeof(pcap_format::Trailer);
+  std::ofstream ofil(capture_path, std::ios::binary | std::ios::trunc);
+  ofil.write(raw.data(), raw.size() - index_bytes);
+  ofil.close();
+
+  replay.open(capture_path);
+  LOG(INFO) << "Rebuilt index has " << replay.size() << " packets : "
+            << (replay.size() == packets.size() * num_repeats ? "OK" : "FAILED");
+  replay.close();
+
+  LOG(INFO) << "End of capture test" << std::endl << std::endl;
+}
+
+void run_latency_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking latency tracking";
+
+  // > Histogram percentiles, 1..1000 nsec
+  LatencyHistogram hist;
+  for (int64_t ii = 1; ii <= 1000; ii++) {
+    hist.record(ii);
+  }
+  LatencyStats stats = hist.get_stats();
+  LOG(INFO) << "Histogram of 1..1000 : " << stats;
+  LOG(INFO) << "Percentiles within 1/16 : "
+            << (std::abs(stats.p50_nsec - 500) <= 500 / 16 &&
+                        std::abs(stats.p99_nsec - 990) <= 990 / 16 && stats.max_nsec == 1000
+                    ? "OK"
+                    : "FAILED");
+
+  // > Stamps along socket -> FFT, for packets dispatched as if just received
+  std::vector<int8_t> buff = load_sample_packet(test_file_dir);
+
+  LatencyTracker::set_enabled(true);
+  LatencyTracker::instance().reset();
+
+  UdpSocketIn socket;
+  auto q_aco = std::make_shared<tsQueue<std::shared_ptr<UdpAcousticData>>>(0);
+  socket.register_client_aco(q_aco);
+  for (int ii = 0; ii < 100; ii++) {
+    socket.dispatch(buff);
+  }
+
+  std::vector<std::shared_ptr<UdpAcousticData>> packets;
+  q_aco->pop_all(packets);
+  for (auto &aco_pkt : packets) {
+    aco_pkt->stage_times.mark(STAGE::FFT_DEQUEUED);
+  }
+  FFT fft;
+  std::vector<std::shared_ptr<IpcFFT>> frames = fft.process(packets);
+  for (auto &fft_frame : frames) {
+    fft_frame->stage_times.mark(STAGE::FFT_EMITTED);
+  }
+
+  LOG(INFO) << "Packet " << packets.back()->stage_times;
+  LOG(INFO) << "Frames carry their packet's stamps : "
+            << (!frames.empty() && frames.back()->stage_times.has(STAGE::RECEIVED) &&
+                        frames.back()->stage_times.has(STAGE::FFT_EMITTED)
+                    ? "OK"
+                    : "FAILED");
+  LOG(INFO) << std::endl << LatencyTracker::instance().report();
+
+  LatencyTracker::set_enabled(false);
+  LatencyTracker::instance().reset();
+
+  LOG(INFO) << "End of latency test" << std::endl << std::endl;
+}
+
+void run_queue_tests() {
+  LOG(INFO) << "Checking queue metrics";
+
+  // > Overfill a bounded queue, then drain it in two steps
+  auto queue = std::make_shared<tsQueue<int>>(100);
+  queue->warn_dropped_data(true);
+  QueueRegistry::instance().add(queue, "test.int");
+  for (int ii = 0; ii < 150; ii++) {
+    queue->push(ii);
+  }
+  std::vector<int> items = queue->pop_limit(30);
+  queue->pop_all(items);
+
+  QueueStats stats = queue->get_stats();
+  LOG(INFO) << "Stats : " << stats;
+  LOG(INFO) << "Counters match : "
+            << (stats.pushes == 150 && stats.drops == 50 && stats.pops == 100 &&
+                        stats.high_water == 100 && stats.depth == 0 && items.front() == 80
+                    ? "OK"
+                    : "FAILED");
+
+  // > clear() accounts for what it discards
+  for (int ii = 0; ii < 20; ii++) {
+    queue->push(ii);
+  }
+  queue->clear();
+  stats = queue->get_stats();
+  LOG(INFO) << "Cleared items counted : "
+            << (stats.cleared == 20 && stats.depth == 0 &&
+                        stats.pushes - stats.pops - stats.drops - stats.cleared == stats.depth
+                    ? "OK"
+                    : "FAILED");
+
+  // > Empty pop(dst) waits out its 1 s timeout, which counts as wait time
+  int item;
+  queue->pop(item);
+  LOG(INFO) << "Wait time after timed-out pop : " << queue->get_stats().wait_nsec / 1e9
+            << " s (expect ~1 s)";
+
+  std::vector<QueueStats> snapshot = QueueRegistry::instance().snapshot();
+  bool found = std::any_of(snapshot.begin(), snapshot.end(),
+                           [](const QueueStats &st) { return st.name == "test.int"; });
+  LOG(INFO) << "Registry lists the queue : " << (found ? "OK" : "FAILED");
+  queue.reset();
+  LOG(INFO) << "Registry prunes destroyed queues : "
+            << (QueueRegistry::instance().snapshot().size() == snapshot.size() - 1 ? "OK"
+                                                                                   : "FAILED");
+
+  LOG(INFO) << "End of queue test" << std::endl << std::endl;
+}
+
+void run_metrics_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking metrics exporter";
+
+  std::vector<int8_t> buff = load_sample_packet(test_file_dir);
+
+  UdpSocketIn socket;
+  socket.port = 9760;
+  auto q_aco = std::make_shared<tsQueue<std::shared_ptr<UdpAcousticData>>>(0);
+  socket.register_client_aco(q_aco);
+  QueueRegistry::instance().add(q_aco, "test.aco");
+  for (int ii = 0; ii < 10; ii++) {
+    socket.dispatch(buff);
+  }
+
+  // > Rendered text carries the socket, queue and thread families
+  MetricsExporter metrics;
+  metrics.add_socket(socket);
+  std::string text = metrics.render();
+  LOG(INFO) << "Metrics text : " << std::endl << text;
+  LOG(INFO) << "Packet counter : "
+            << (text.find("acsense_udp_packets_total{port=\"9760\",type=\"ACO\"} 10") !=
+                        std::string::npos
+                    ? "OK"
+                    : "FAILED");
+  LOG(INFO) << "Queue depth : "
+            << (text.find("acsense_queue_depth{queue=\"test.aco\"} 10") != std::string::npos
+                    ? "OK"
+                    : "FAILED");
+  LOG(INFO) << "Thread CPU time : "
+            << (text.find("# TYPE acsense_thread_cpu_seconds_total counter") != std::string::npos
+                    ? "OK"
+                    : "FAILED");
+
+  // > Scrape over loopback
+  const int port = 19761;
+  std::string response;
+  if (metrics.serve_http(port)) {
+    int sock = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(sock, (sockaddr *)&addr, sizeof(addr)) == 0) {
+      std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+      send(sock, request.data(), request.size(), 0);
+      char chunk[4096];
+      ssize_t len;
+      while ((len = recv(sock, chunk, sizeof(chunk), 0)) > 0) {
+        response.append(chunk, len);
+      }
+    }
+    close(sock);
+    metrics.stop();
+  }
+  LOG(INFO) << "HTTP scrape : "
+            << (response.compare(0, 15, "HTTP/1.0 200 OK") == 0 &&
+                        response.find("acsense_udp_packets_total") != std::string::npos
+                    ? "OK"
+                    : "FAILED");
+
+  LOG(INFO) << "End of metrics test" << std::endl << std::endl;
+}
+
+void run_psd_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking Welch PSD averaging";
+
+  std::vector<int8_t> buff = load_sample_packet(test_file_dir);
+  std::vector<std::shared_ptr<UdpAcousticData>> packets = make_packet_train(buff, 80, 1000000);
+
+  FFT fft;
+  fft.set_NFFT(256);
+  std::vector<std::shared_ptr<IpcFFT>> frames = fft.process(packets);
+
+  FFT welch;
+  welch.set_NFFT(256);
+  welch.set_psd_averages(4);
+  std::vector<std::shared_ptr<IpcPSD>> averages = welch.process_psd(packets);
+  LOG(INFO) << "Frames : " << frames.size() << ", averages : " << averages.size();
+  LOG(INFO) << "One average per 4 frames : "
+            << (!averages.empty() && averages.size() == frames.size() / 4 ? "OK" : "FAILED");
+
+  // > First average matches the mean |X|^2 of the first 4 spectra
+  double max_error = std::numeric_limits<double>::infinity();
+  if (!averages.empty() && frames.size() >= 4) {
+    Eigen::MatrixXd expected = Eigen::MatrixXd::Zero(frames[0]->fft.rows(), frames[0]->fft.cols());
+    for (int ii = 0; ii < 4; ii++) {
+      expected += frames[ii]->fft.cwiseAbs2() / 4;
+    }
+    max_error = (averages[0]->psd - expected).cwiseAbs().maxCoeff() / expected.maxCoeff();
+  }
+  LOG(INFO) << "PSD matches averaged spectra : " << (max_error < 1e-9 ? "OK" : "FAILED");
+  LOG(INFO) << "Average spans its frames : "
+            << (!averages.empty() &&
+                        averages[0]->header.start_time_nsec == frames[0]->header.start_time_nsec &&
+                        averages[0]->end_time_nsec == frames[3]->header.start_time_nsec
+                    ? "OK"
+                    : "FAILED");
+
+  LOG(INFO) << "End of PSD test" << std::endl << std::endl;
+}
+
+void run_active_bins_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking band-limited FFT output";
+
+  std::vector<int8_t> buff = load_sample_packet(test_file_dir);
+  std::vector<std::shared_ptr<UdpAcousticData>> packets = make_packet_train(buff, 40);
+
+  FFT fft;
+  fft.set_NFFT(256);
+  fft.add_frequency_band_min_max(2000, 8000);
+  std::vector<std::shared_ptr<IpcFFT>> full = fft.process(packets);
+
+  FFT fft_bins;
+  fft_bins.set_NFFT(256);
+  fft_bins.add_frequency_band_min_max(2000, 8000);
+  fft_bins.set_mode(FFT_MODE::ACTIVE_BINS);
+  std::vector<std::shared_ptr<IpcFFT>> banded = fft_bins.process(packets);
+
+  bool same_bins = !banded.empty() && banded.size() == full.size() &&
+                   !banded[0]->bins.empty() &&
+                   banded[0]->fft.cols() == (int)banded[0]->bins.size() &&
+                   banded[0]->fft.isApprox(full[0]->fft(Eigen::all, banded[0]->bins));
+  LOG(INFO) << "Frames hold " << (banded.empty() ? 0 : banded[0]->fft.cols()) << " of "
+            << (full.empty() ? 0 : full[0]->fft.cols()) << " bins";
+  LOG(INFO) << "Active bins match the full spectrum : " << (same_bins ? "OK" : "FAILED");
+
+  // > The detector gives the same output on either frame layout
+  EnergyDetector detector, detector_bins;
+  for (EnergyDetector *det : {&detector, &detector_bins}) {
+    det->set_NFFT(256);
+    det->set_sample_rate(packets.front()->header.sample_rate);
+    det->add_frequency_band_min_max(2000, 8000);
+  }
+  bool same_detections = true;
+  for (size_t ii = 0; ii < std::min(full.size(), banded.size()); ii++) {
+    same_detections &= detector.process(full[ii])->detections ==
+                       detector_bins.process(banded[ii])->detections;
+  }
+  LOG(INFO) << "Detector agrees on both layouts : " << (same_detections ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of band-limited FFT test" << std::endl << std::endl;
+}
+
+void run_tone_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking tone tracker";
+
+  std::vector<int8_t> buff = load_sample_packet(test_file_dir);
+  std::vector<std::shared_ptr<UdpAcousticData>> packets = make_packet_train(buff, 40);
+  double fs = packets.front()->header.sample_rate;
+
+  FFT fft;
+  fft.set_NFFT(256);
+  fft.set_sample_rate(fs);
+  fft.add_frequency_bin_closest(3000);
+  fft.add_frequency_bin_closest(12000);
+  fft.set_mode(FFT_MODE::ACTIVE_BINS);
+  std::vector<std::shared_ptr<IpcFFT>> expected = fft.process(packets);
+
+  // > Goertzel reproduces the FFT bins frame by frame
+  ToneTracker tones;
+  tones.set_NFFT(256);
+  tones.set_sample_rate(fs);
+  tones.add_frequency_bin_closest(3000);
+  tones.add_frequency_bin_closest(12000);
+  std::vector<std::shared_ptr<IpcFFT>> frames = tones.process(packets);
+
+  bool same_frames = !frames.empty() && frames.size() == expected.size();
+  for (size_t ii = 0; same_frames && ii < frames.size(); ii++) {
+    same_frames &= frames[ii]->bins == expected[ii]->bins &&
+                   frames[ii]->header.start_time_nsec == expected[ii]->header.start_time_nsec &&
+                   frames[ii]->fft.isApprox(expected[ii]->fft, 1e-9);
+  }
+  LOG(INFO) << "Frames : " << frames.size() << " x " << (frames.empty() ? 0 : frames[0]->fft.cols())
+            << " bins";
+  LOG(INFO) << "Goertzel matches FFT : " << (same_frames ? "OK" : "FAILED");
+
+  // > Sliding DFT tracks the same bins, up to the periodic vs symmetric Hann window
+  ToneTracker sliding;
+  sliding.set_NFFT(256);
+  sliding.set_sample_rate(fs);
+  sliding.add_frequency_bin_closest(3000);
+  sliding.add_frequency_bin_closest(12000);
+  sliding.set_method(TONE_METHOD::SLIDING_DFT);
+  std::vector<std::shared_ptr<IpcFFT>> sdft_frames = sliding.process(packets);
+
+  double error = 0, norm = 0;
+  for (size_t ii = 0; ii < std::min(sdft_frames.size(), expected.size()); ii++) {
+    error += (sdft_frames[ii]->fft.cwiseAbs() - expected[ii]->fft.cwiseAbs()).squaredNorm();
+    norm += expected[ii]->fft.squaredNorm();
+  }
+  double rel_error = norm > 0 ? std::sqrt(error / norm) : 1;
+  LOG(INFO) << "Sliding DFT magnitude error vs FFT : " << std::scientific << rel_error;
+  LOG(INFO) << "Sliding DFT matches FFT : "
+            << (sdft_frames.size() == expected.size() && rel_error < 0.05 ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of tone tracker test" << std::endl << std::endl;
+}
+
+void run_decimation_tests() {
+  LOG(INFO) << "Checking decimating FFT front end";
+
+  // > 1 kHz tone at 52734 Hz, 2 channels, 64 packets of 256 samples
+  const float fs = 52734;
+  const double f_tone = 1000;
+  std::vector<std::shared_ptr<UdpAcousticData>> packets;
+  for (int pp = 0; pp < 64; pp++) {
+    Eigen::MatrixX<int16_t> data(2, 256);
+    for (int nn = 0; nn < 256; nn++) {
+      double t = (pp * 256 + nn) / fs;
+      data(0, nn) = data(1, nn) = (int16_t)(10000 * std::sin(2 * M_PI * f_tone * t));
+    }
+    packets.push_back(
+        std::make_shared<UdpAcousticData>(data, 2, data.size(), fs, pp * 256 * 1e9 / fs, 0, 0, pp));
+  }
+
+  FFT decimated;
+  decimated.set_NFFT(256);
+  decimated.add_frequency_band_min_max(500, 2000);
+  decimated.set_decimation(true);
+  std::vector<std::shared_ptr<IpcFFT>> frames = decimated.process(packets);
+  size_t factor = decimated.get_decimation_factor();
+
+  FFT full;
+  full.set_NFFT(256 * factor);
+  std::vector<std::shared_ptr<IpcFFT>> full_frames = full.process(packets);
+
+  LOG(INFO) << "Decimation factor : " << factor << ", frames : " << frames.size() << " vs "
+            << full_frames.size();
+  LOG(INFO) << "Decimation applied : "
+            << (factor > 1 && !frames.empty() && frames.back()->FS == fs / factor ? "OK"
+                                                                                  : "FAILED");
+
+  // > Same resolution: the tone peaks at the same frequency and level
+  auto peak = [](const std::shared_ptr<IpcFFT> &frame, double &f_peak) {
+    Eigen::Index idx;
+    double level = frame->fft.row(0).cwiseAbs2().maxCoeff(&idx);
+    f_peak = idx * frame->FS / ((frame->fft.cols() - 1) * 2);
+    return 10 * std::log10(level);
+  };
+  double f_dec = 0, f_full = 0;
+  double db_dec = frames.empty() ? 0 : peak(frames.back(), f_dec);
+  double db_full = full_frames.empty() ? 0 : peak(full_frames.back(), f_full);
+  LOG(INFO) << "Peak : " << f_dec << " Hz / " << db_dec << " dB (decimated), " << f_full
+            << " Hz / " << db_full << " dB (full rate)";
+  LOG(INFO) << "Tone preserved : "
+            << (!frames.empty() && std::abs(f_dec - f_full) < fs / (256.0 * factor) &&
+                        std::abs(db_dec - db_full) < 0.5
+                    ? "OK"
+                    : "FAILED");
+
+  LOG(INFO) << "End of decimation test" << std::endl << std::endl;
+}
+
+void run_detector_algorithm_tests() {
+  LOG(INFO) << "Checking detector algorithms";
+
+  // > Streaming median of a uniform variable
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  P2Quantile median(0.5);
+  for (int ii = 0; ii < 10000; ii++) {
+    median.add(uniform(gen));
+  }
+  LOG(INFO) << "P2 median of U(0,1) : " << median.value();
+  LOG(INFO) << "Streaming median : " << (std::abs(median.value() - 0.5) < 0.02 ? "OK" : "FAILED");
+
+  // > Noise frames (4 channels, 100 Hz bins) with tones on channel 1 in both bands
+  size_t NFFT = 256;
+  double FS = 25600;
+  int tone_bin_0 = 30, tone_bin_1 = 75;
+  std::normal_distribution<double> normal(0, 1);
+  std::vector<std::shared_ptr<IpcFFT>> frames;
+  for (int ii = 0; ii < 40; ii++) {
+    auto frame = std::make_shared<IpcFFT>(4, NFFT / 2 + 1);
+    for (int rr = 0; rr < frame->fft.rows(); rr++) {
+      for (int cc = 0; cc < frame->fft.cols(); cc++) {
+        frame->fft(rr, cc) = std::complex<double>(normal(gen), normal(gen));
+      }
+    }
+    if (ii >= 30) {
+      frame->fft(1, tone_bin_0) = 40;
+      frame->fft(1, tone_bin_1) = 40;
+    }
+    frame->FS = FS;
+    frame->header.start_time_nsec = ii * 1000000;
+    frames.push_back(frame);
+  }
+
+  for (DETECTOR_ALGORITHM algorithm :
+       {DETECTOR_ALGORITHM::CA_CFAR, DETECTOR_ALGORITHM::OS_CFAR,
+        DETECTOR_ALGORITHM::MEDIAN_FLOOR}) {
+    EnergyDetector detector;
+    detector.set_NFFT(NFFT);
+    detector.set_sample_rate(FS);
+    detector.add_frequency_band_min_max(1000, 5000);
+    detector.add_frequency_band_min_max(6000, 9000);
+    detector.set_algorithm(algorithm);
+    detector.set_threshold_db(15);
+    // no detections wanted in the second band
+    detector.set_band_threshold_db(1, 60);
+
+    size_t false_alarms = 0;
+    bool found_tone = true, band_quiet = true;
+    for (size_t ii = 0; ii < frames.size(); ii++) {
+      auto detect = detector.process(frames[ii]);
+      bool hit = false;
+      for (const DetectorCell &cell : detect->cells) {
+        bool on_tone = ii >= 30 && cell.channel == 1 && cell.bin == tone_bin_0;
+        hit |= on_tone && cell.band == 0 && cell.snr_db > 20 &&
+               cell.time_nsec == frames[ii]->header.start_time_nsec &&
+               std::abs(cell.frequency - tone_bin_0 * FS / NFFT) < 1e-6;
+        false_alarms += on_tone ? 0 : 1;
+        band_quiet &= cell.band != 1;
+      }
+      if (ii >= 30)
+        found_tone &= hit && detect->detections >= 1;
+    }
+    int alg = static_cast<int>(algorithm);
+    LOG(INFO) << "Algorithm " << alg << " : " << false_alarms << " false alarms";
+    LOG(INFO) << "Algorithm " << alg << " finds tone : " << (found_tone ? "OK" : "FAILED");
+    LOG(INFO) << "Algorithm " << alg << " band threshold : " << (band_quiet ? "OK" : "FAILED");
+    LOG(INFO) << "Algorithm " << alg << " false alarms : " << (false_alarms < 5 ? "OK" : "FAILED");
+  }
+
+  // > EMA_RATIO: the band's magnitude peak-over-mean, short against long term. Long-term
+  //   average sped up so it settles within the test; tone on channel 1 from frame 300
+  size_t num_noise = 300, num_frames = 340;
+  EnergyDetector ema_tone, ema_noise;
+  for (EnergyDetector *det : {&ema_tone, &ema_noise}) {
+    det->set_NFFT(NFFT);
+    det->set_sample_rate(FS);
+    det->add_frequency_band_min_max(1000, 5000);
+    det->set_algorithm(DETECTOR_ALGORITHM::EMA_RATIO);
+    det->set_averaging(0.1, 0.01);
+  }
+  size_t ema_false_alarms = 0, noise_detections = 0, tone_frames = 0;
+  for (size_t ii = 0; ii < num_frames; ii++) {
+    auto frame = std::make_shared<IpcFFT>(4, NFFT / 2 + 1);
+    for (int rr = 0; rr < frame->fft.rows(); rr++) {
+      for (int cc = 0; cc < frame->fft.cols(); cc++) {
+        frame->fft(rr, cc) = std::complex<double>(normal(gen), normal(gen));
+      }
+    }
+    frame->FS = FS;
+    frame->header.start_time_nsec = ii * 1000000;
+    auto noise = std::make_shared<IpcFFT>(*frame);
+    if (ii >= num_noise) {
+      frame->fft(1, tone_bin_0) = 40;
+    }
+
+    auto detect = ema_tone.process(frame);
+    bool hit = false;
+    for (const DetectorCell &cell : detect->cells) {
+      bool on_tone = ii >= num_noise && cell.channel == 1 && cell.bin == tone_bin_0;
+      hit |= on_tone && cell.band == 0 && cell.snr_db > 10;
+      // the first frames only seed the averages
+      ema_false_alarms += on_tone || ii < 100 ? 0 : 1;
+    }
+    tone_frames += hit ? 1 : 0;
+    if (ii >= 100)
+      noise_detections += ema_noise.process(noise)->detections;
+    else
+      ema_noise.process(noise);
+  }
+  LOG(INFO) << "EMA_RATIO finds tone in " << tone_frames << " / " << num_frames - num_noise;
+  LOG(INFO) << "EMA_RATIO finds tone : "
+            << (tone_frames == num_frames - num_noise ? "OK" : "FAILED");
+  LOG(INFO) << "EMA_RATIO false alarms : " << (ema_false_alarms == 0 ? "OK" : "FAILED");
+  LOG(INFO) << "EMA_RATIO quiet on noise : " << (noise_detections == 0 ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of detector algorithm test" << std::endl << std::endl;
+}
+
+void run_detection_event_tests() {
+  LOG(INFO) << "Checking detection events";
+
+  // > Frames every 10 ms; detections on 10-14 and 16-17 (one gap frame), then 30-31
+  int64_t dt_nsec = 10000000;
+  auto make_frame = [dt_nsec](int ii, std::vector<DetectorCell> cells) {
+    IpcDetector frame;
+    frame.header.start_time_nsec = ii * dt_nsec;
+    frame.cells = cells;
+    frame.detections = cells.empty() ? 0 : 1;
+    return frame;
+  };
+  DetectionEventBuilder builder;
+  builder.set_frame_duration_nsec(dt_nsec);
+  std::vector<std::shared_ptr<IpcDetectionEvent>> events;
+  for (int ii = 0; ii < 40; ii++) {
+    std::vector<DetectorCell> cells;
+    if ((ii >= 10 && ii <= 14) || ii == 16 || ii == 17 || ii == 30 || ii == 31)
+      cells.push_back({1, 20 + ii, 0, 100.0 * (20 + ii), 10.0 + ii, ii * dt_nsec});
+    if (ii == 12)
+      cells.push_back({3, 12, 0, 1200.0, 40.0, ii * dt_nsec});
+    builder.add(make_frame(ii, cells), events);
+  }
+  bool open_at_end = builder.is_open();
+  builder.flush(events);
+
+  bool merged = events.size() == 2 && !open_at_end && events[0]->num_frames == 7 &&
+                events[0]->header.start_time_nsec == 10 * dt_nsec &&
+                events[0]->end_time_nsec == 18 * dt_nsec && events[1]->num_frames == 2;
+  LOG(INFO) << "Events : " << events.size();
+  LOG(INFO) << "Consecutive frames merged : " << (merged ? "OK" : "FAILED");
+
+  bool summary = !events.empty() && events[0]->channel_mask == 0b1010 &&
+                 events[0]->peak_snr_db == 40.0f && events[0]->peak_channel == 3 &&
+                 events[0]->f_low == 1200.0f && events[0]->f_high == 3700.0f &&
+                 events[0]->num_cells == 8;
+  LOG(INFO) << "Event summary : " << (summary ? "OK" : "FAILED");
+
+  // > A persistent detection is reported once per max duration
+  DetectionEventBuilder builder_split;
+  builder_split.set_max_duration_sec(0.1);
+  std::vector<std::shared_ptr<IpcDetectionEvent>> split;
+  for (int ii = 0; ii < 25; ii++) {
+    builder_split.add(make_frame(ii, {{0, 5, 0, 500.0, 20.0, ii * dt_nsec}}), split);
+  }
+  builder_split.flush(split);
+  LOG(INFO) << "Long detection split : "
+            << (split.size() == 3 && split[0]->num_frames == 10 ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of detection event test" << std::endl << std::endl;
+}
+
+void run_beamformer_tests() {
+  LOG(INFO) << "Checking beamformer";
+
+  // > 8-element ring (0.5 m radius) in the x-y plane; plane wave from 60 deg bearing,
+  //   30 deg elevation over the 1-2 kHz band
+  size_t NFFT = 256;
+  double FS = 25600;
+  double c = 1500;
+  int num_elements = 8;
+  Eigen::VectorXd angle = Eigen::VectorXd::LinSpaced(num_elements, 0, 2 * M_PI * 7 / 8);
+  Eigen::VectorXd array_x = 0.5 * angle.array().cos();
+  Eigen::VectorXd array_y = 0.5 * angle.array().sin();
+  Eigen::VectorXd array_z = Eigen::VectorXd::Zero(num_elements);
+
+  double brg = 60 * M_PI / 180;
+  double el = 30 * M_PI / 180;
+  Eigen::Vector3d u(std::cos(el) * std::cos(brg), std::cos(el) * std::sin(brg), std::sin(el));
+  Eigen::VectorXd advance = array_x * u[0] + array_y * u[1] + array_z * u[2];
+
+  std::vector<std::shared_ptr<IpcFFT>> frames;
+  for (int ii = 0; ii < 3; ii++) {
+    auto ipc_fft = std::make_shared<IpcFFT>(num_elements, NFFT / 2 + 1);
+    ipc_fft->FS = FS;
+    ipc_fft->header.start_time_nsec = ii * 10000000;
+    for (size_t bin = 0; bin <= NFFT / 2; bin++) {
+      double k_wave = 2 * M_PI * (FS * bin / NFFT) / c;
+      for (int ch = 0; ch < num_elements; ch++) {
+        ipc_fft->fft(ch, bin) = std::polar(1.0, k_wave * advance[ch]);
+      }
+    }
+    frames.push_back(ipc_fft);
+  }
+
+  Beamformer beamformer;
+  beamformer.set_NFFT(NFFT);
+  beamformer.add_frequency_band_min_max(1000, 2000);
+  beamformer.set_array(array_x, array_y, array_z);
+  beamformer.set_sound_speed(c);
+  beamformer.set_bearings_rad(Eigen::VectorXd::LinSpaced(72, 0, 2 * M_PI * 71 / 72));
+  Eigen::VectorXd elevations(4);
+  elevations << 0, 15, 30, 45;
+  beamformer.set_elevations_rad(elevations * M_PI / 180);
+
+  auto patterns = beamformer.process(frames);
+  LOG(INFO) << "Beampatterns : " << patterns.size();
+  LOG(INFO) << "One beampattern per frame : " << (patterns.size() == 3 ? "OK" : "FAILED");
+  if (patterns.empty())
+    return;
+
+  UdpBeamform2D &pattern = *patterns.back();
+  bool header = pattern.header.num_elements == 8 && pattern.header.num_bearings == 72 &&
+                pattern.header.num_elevations == 4 && pattern.header.num_frequencies == 11 &&
+                pattern.data.beampattern.rows() == 72 && pattern.data.beampattern.cols() == 4 &&
+                pattern.header.start_time_nsec == 20000000;
+  LOG(INFO) << "Beampattern layout : " << (header ? "OK" : "FAILED");
+
+  Eigen::Index ibrg, iel;
+  double peak_db = pattern.data.beampattern.maxCoeff(&ibrg, &iel);
+  LOG(INFO) << "Peak : " << peak_db << " dB at " << ibrg * 5 << " deg bearing, "
+            << elevations[iel] << " deg elevation";
+  LOG(INFO) << "Peak on the source : "
+            << (ibrg == 12 && iel == 2 && std::abs(peak_db) < 0.01 ? "OK" : "FAILED");
+  double back_db = pattern.data.beampattern(48, 2);
+  LOG(INFO) << "Rejects the opposite bearing : " << (back_db < -3 ? "OK" : "FAILED");
+
+  // > Masking elements keeps a unit response on the source
+  Eigen::VectorX<bool> mask = Eigen::VectorX<bool>::Constant(num_elements, true);
+  mask[1] = false;
+  mask[5] = false;
+  beamformer.set_element_mask(mask);
+  auto masked = beamformer.process({frames.front()});
+  bool masked_ok = masked.size() == 1 && std::abs(masked[0]->data.beampattern(12, 2)) < 0.01 &&
+                   !masked[0]->data.element_mask[1];
+  LOG(INFO) << "Element mask : " << (masked_ok ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of beamformer test" << std::endl << std::endl;
+}
+
+void run_steering_cache_tests() {
+  LOG(INFO) << "Checking steering cache";
+
+  // > Grid of an incoming beampattern: 4-element line along x, 3 frequencies, 3 bearings
+  UdpBeamform2D beam;
+  beam.data.array_x = Eigen::VectorXd::LinSpaced(4, 0, 1.5);
+  beam.data.array_y = Eigen::VectorXd::Zero(4);
+  beam.data.array_z = Eigen::VectorXd::Zero(4);
+  beam.data.frequencies = Eigen::Vector3d(250, 500, 1000);
+  beam.data.bearings_rad = Eigen::Vector3d(0, M_PI / 4, M_PI / 2);
+  beam.data.elevations_rad = Eigen::VectorXd::Zero(1);
+
+  SteeringCache &cache = SteeringCache::instance();
+  cache.clear();
+  std::shared_ptr<const SteeringTensor> current;
+  bool first = cache.refresh(current, beam.data, 1500);
+  bool second = cache.refresh(current, beam.data, 1500);
+  auto shared = cache.get(SteeringGrid(beam.data, 1500));
+  LOG(INFO) << "Built once, then reused : "
+            << (first && !second && shared == current && cache.size() == 1 ? "OK" : "FAILED");
+
+  // element 3 (x = 1.5 m) at 1000 Hz towards 45 deg: conj(exp(j 2 pi f x cos(45) / c))
+  std::complex<double> expected =
+      std::polar(1.0, -2 * M_PI * 1000 * 1.5 * std::cos(M_PI / 4) / 1500);
+  bool values = current->num_beams == 3 && current->num_elements == 4 &&
+                current->num_frequencies == 3 && current->data.cols() == 12 &&
+                std::abs(current->frequency(2)(1, 3) - expected) < 1e-12 &&
+                std::abs(current->frequency(0)(2, 3) - 1.0) < 1e-12;
+  LOG(INFO) << "Steering values : " << (values ? "OK" : "FAILED");
+
+  // > A changed frequency grid in the header invalidates; returning to it hits the cache
+  auto previous = current;
+  beam.data.frequencies[2] = 2000;
+  bool changed = cache.refresh(current, beam.data, 1500) && current != previous;
+  beam.data.frequencies[2] = 1000;
+  bool restored = cache.refresh(current, beam.data, 1500) && current == previous;
+  LOG(INFO) << "Invalidated on grid change : " << (changed && restored ? "OK" : "FAILED");
+  LOG(INFO) << "Entries : " << cache.size() << ", hits : " << cache.get_hits()
+            << ", misses : " << cache.get_misses();
+  LOG(INFO) << "Cache counts : "
+            << (cache.size() == 2 && cache.get_misses() == 2 ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of steering cache test" << std::endl << std::endl;
+}
+
+void run_btr_tests() {
+  LOG(INFO) << "Checking bearing-time record";
+
+  // > 72 bearings x 2 elevations; elevation 1 is 3 dB above elevation 0
+  UdpBeamform2D beam;
+  beam.data.bearings_rad = Eigen::VectorXd::LinSpaced(72, 0, 2 * M_PI * 71 / 72);
+  beam.data.elevations_rad = Eigen::Vector2d(0, M_PI / 6);
+  beam.data.beampattern.resize(72, 2);
+  // parabolic main lobe centred on 62 deg (between the 60 and 65 deg bearings), and a
+  // weaker one across 0 deg at 358 deg
+  for (int ii = 0; ii < 72; ii++) {
+    double brg = ii * 5.0;
+    double d_main = brg - 62;
+    double d_wrap = std::remainder(brg - 358, 360);
+    double level = std::max({-20.0, -0.1 * d_main * d_main, -6 - 0.1 * d_wrap * d_wrap});
+    beam.data.beampattern(ii, 0) = level;
+    beam.data.beampattern(ii, 1) = level + 3;
+  }
+
+  Eigen::VectorXd line(72);
+  beam.reduce_elevation(line, BTR_REDUCTION::MEAN);
+  bool mean_ok = line.isApprox(beam.get_1D().col(0));
+  beam.reduce_elevation(line, BTR_REDUCTION::MAX);
+  bool max_ok = line.isApprox(beam.data.beampattern.col(1));
+  beam.reduce_elevation(line, BTR_REDUCTION::POWER_SUM_DB);
+  double expected = 10 * std::log10(std::pow(10, beam.data.beampattern(3, 0) / 10) +
+                                    std::pow(10, beam.data.beampattern(3, 1) / 10));
+  bool sum_ok = std::abs(line[3] - expected) < 1e-9;
+  LOG(INFO) << "Reduction over elevation : "
+            << (mean_ok && max_ok && sum_ok ? "OK" : "FAILED");
+
+  // > Ring of 4 frames, fed 6: the last 4 in order
+  BearingTimeRecord btr(4);
+  btr.set_reduction(BTR_REDUCTION::MAX);
+  btr.set_num_peaks(2);
+  for (int ii = 0; ii < 6; ii++) {
+    beam.header.start_time_nsec = ii;
+    beam.data.beampattern.array() += 1;
+    btr.add(beam);
+  }
+  Eigen::MatrixXd record = btr.get_btr();
+  std::vector<int64_t> times = btr.get_times();
+  bool ring_ok = record.rows() == 72 && record.cols() == 4 && times.front() == 2 &&
+                 times.back() == 5 && record(12, 3) - record(12, 0) == 3;
+  LOG(INFO) << "Ring keeps the latest frames : " << (ring_ok ? "OK" : "FAILED");
+
+  const std::vector<BearingPeak> &peaks = btr.get_latest_peaks();
+  double main_deg = peaks.empty() ? 0 : peaks[0].bearing_rad * 180 / M_PI;
+  double wrap_deg = peaks.size() < 2 ? 0 : peaks[1].bearing_rad * 180 / M_PI;
+  LOG(INFO) << "Peaks : " << main_deg << " deg / " << (peaks.empty() ? 0 : peaks[0].level)
+            << ", " << wrap_deg << " deg";
+  bool peaks_ok = peaks.size() == 2 && std::abs(main_deg - 62) < 0.01 &&
+                  std::abs(peaks[0].level - 9) < 0.01 && std::abs(wrap_deg - 358) < 0.01 &&
+                  peaks[0].time_nsec == 5;
+  LOG(INFO) << "Interpolated peaks : " << (peaks_ok ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of bearing-time record test" << std::endl << std::endl;
+}
+
+void run_beam_storage_tests() {
+  LOG(INFO) << "Checking compact beampattern storage";
+
+  // > A 72 x 4 beampattern in dB, through the wire format
+  UdpBeamform2D beam;
+  beam.data.array_x = Eigen::VectorXd::LinSpaced(4, 0, 1.5);
+  beam.data.array_y = Eigen::VectorXd::Zero(4);
+  beam.data.array_z = Eigen::VectorXd::Zero(4);
+  beam.data.element_mask = Eigen::VectorX<bool>::Constant(4, true);
+  beam.data.element_weights = Eigen::VectorXd::Ones(4);
+  beam.data.frequencies = Eigen::VectorXd::LinSpaced(8, 1000, 2000);
+  beam.data.bearings_rad = Eigen::VectorXd::LinSpaced(72, 0, 2 * M_PI * 71 / 72);
+  beam.data.elevations_rad = Eigen::VectorXd::LinSpaced(4, 0, M_PI / 4);
+  beam.data.beampattern = 60 + 20 * Eigen::MatrixXd::Random(72, 4).array();
+  beam.header.num_elements = 4;
+  beam.header.num_frequencies = 8;
+  beam.header.num_bearings = 72;
+  beam.header.num_elevations = 4;
+  std::vector<int8_t> buff = beam.encode();
+  Eigen::MatrixXd reference = beam.data.beampattern;
+
+  std::vector<std::pair<BEAM_STORAGE, double>> storages = {{BEAM_STORAGE::FLOAT64, 0},
+                                                           {BEAM_STORAGE::FLOAT32, 1e-5},
+                                                           {BEAM_STORAGE::FLOAT16, 0.05},
+                                                           {BEAM_STORAGE::DB_U8, 40.0 / 255}};
+  for (auto &storage : storages) {
+    UdpBeamform2D decoded(buff, storage.first);
+    double error = (decoded.get_beampattern() - reference).cwiseAbs().maxCoeff();
+    bool sized = decoded.beampattern_rows() == 72 && decoded.beampattern_cols() == 4 &&
+                 decoded.data.beampattern.size() ==
+                     (storage.first == BEAM_STORAGE::FLOAT64 ? 288 : 0);
+    LOG(INFO) << "Storage " << (int)storage.first << " : " << decoded.beampattern_bytes()
+              << " bytes, max error " << error;
+    LOG(INFO) << "Storage " << (int)storage.first << " decode : "
+              << (sized && error <= storage.second ? "OK" : "FAILED");
+
+    // reductions and re-encoding work on the compact copy
+    Eigen::VectorXd line(72);
+    decoded.reduce_elevation(line, BTR_REDUCTION::MAX);
+    bool reduced =
+        (line - reference.rowwise().maxCoeff()).cwiseAbs().maxCoeff() <= storage.second;
+    std::vector<int8_t> rebuff = decoded.encode();
+    UdpBeamform2D reencoded(rebuff);
+    double reencoded_error = (reencoded.get_beampattern() - reference).cwiseAbs().maxCoeff();
+    bool encoded = rebuff.size() == buff.size() && reencoded_error <= storage.second;
+    LOG(INFO) << "Storage " << (int)storage.first << " reduce / encode : "
+              << (reduced && encoded ? "OK" : "FAILED");
+  }
+
+  // > In-place conversion drops the double copy; the DB_U8 floor clips to the range
+  UdpBeamform2D converted(buff);
+  converted.set_storage(BEAM_STORAGE::DB_U8, 10);
+  double floor_db = reference.maxCoeff() - 10;
+  Eigen::MatrixXd clipped = reference.array().max(floor_db);
+  bool converted_ok = converted.data.beampattern.size() == 0 &&
+                      converted.beampattern_bytes() == 288 &&
+                      (converted.get_beampattern() - clipped).cwiseAbs().maxCoeff() <= 10.0 / 255;
+  LOG(INFO) << "In-place DB_U8 conversion : " << (converted_ok ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of compact beampattern storage test" << std::endl << std::endl;
+}
+
+void run_beam_log_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking beamformer logging";
+
+  // > 50 frames of a 36 x 3 beampattern, 100 ms apart, logged as FLOAT32
+  UdpBeamform2D beam;
+  beam.data.array_x = Eigen::VectorXd::LinSpaced(4, 0, 1.5);
+  beam.data.array_y = Eigen::VectorXd::Zero(4);
+  beam.data.array_z = Eigen::VectorXd::Zero(4);
+  beam.data.element_mask = Eigen::VectorX<bool>::Constant(4, true);
+  beam.data.element_weights = Eigen::VectorXd::Ones(4);
+  beam.data.frequencies = Eigen::VectorXd::LinSpaced(8, 1000, 2000);
+  beam.data.bearings_rad = Eigen::VectorXd::LinSpaced(36, 0, 2 * M_PI * 35 / 36);
+  beam.data.elevations_rad = Eigen::VectorXd::LinSpaced(3, 0, M_PI / 4);
+  beam.header.num_elements = 4;
+  beam.header.num_frequencies = 8;
+  beam.header.num_bearings = 36;
+  beam.header.num_elevations = 3;
+
+  std::string log_path = "/tmp/ac_test_beam.acbl";
+  int num_frames = 50;
+  int64_t t0_nsec = 1700000000000000000;
+  int64_t step_nsec = 100000000;
+  std::vector<Eigen::MatrixXd> patterns;
+  BeamformLogWriter writer;
+  writer.set_storage(BEAM_STORAGE::FLOAT32);
+  writer.open(log_path);
+  bool written = true;
+  for (int ii = 0; ii < num_frames; ii++) {
+    beam.header.start_time_nsec = t0_nsec + ii * step_nsec;
+    beam.header.packet_num = ii;
+    beam.data.beampattern = 60 + 20 * Eigen::MatrixXd::Random(36, 3).array();
+    patterns.push_back(beam.data.beampattern);
+    written &= writer.write(beam) == BEAM_LOG_WRITE::WRITTEN;
+  }
+  // another grid does not belong in this file
+  UdpBeamform2D regridded = beam;
+  regridded.data.bearings_rad = Eigen::VectorXd::LinSpaced(36, 0, M_PI);
+  bool rejected = writer.write(regridded) == BEAM_LOG_WRITE::NEW_FILE;
+  writer.close();
+  LOG(INFO) << "Beamformer log write : " << (written && rejected ? "OK" : "FAILED");
+
+  // > Read back: geometry once, frames in order, O(log n) seeks by time
+  BeamformLogReader reader(log_path);
+  const BeamLogGeometry &geometry = reader.get_geometry();
+  bool opened = reader.is_open() && reader.is_indexed() && reader.size() == num_frames &&
+                reader.get_storage() == BEAM_STORAGE::FLOAT32 &&
+                geometry.kind == BEAM_LOG_KIND::BEAM_2D &&
+                geometry.bearings_rad == beam.data.bearings_rad &&
+                geometry.array_x == beam.data.array_x;
+  LOG(INFO) << "Beamformer log open : " << (opened ? "OK" : "FAILED");
+
+  bool frames_ok = true;
+  for (int ii = 0; ii < num_frames && opened; ii++) {
+    auto frame = reader.read_2d(ii);
+    frames_ok &= frame != nullptr && frame->header.packet_num == ii &&
+                 frame->header.start_time_nsec == t0_nsec + ii * step_nsec &&
+                 frame->data.elevations_rad == beam.data.elevations_rad &&
+                 (frame->get_beampattern() - patterns[ii]).cwiseAbs().maxCoeff() < 1e-4;
+  }
+  frames_ok &= reader.read_2d(num_frames) == nullptr && reader.read_raw(0) == nullptr;
+  LOG(INFO) << "Beamformer log frames : " << (frames_ok ? "OK" : "FAILED");
+
+  bool seek_ok = reader.find(t0_nsec) == 0 && reader.find(t0_nsec - 1) == 0 &&
+                 reader.find(t0_nsec + 17 * step_nsec) == 17 &&
+                 reader.find(t0_nsec + 17 * step_nsec + 1) == 18 &&
+                 reader.find(t0_nsec + num_frames * step_nsec) == num_frames;
+  LOG(INFO) << "Beamformer log seek : " << (seek_ok ? "OK" : "FAILED");
+  reader.close();
+
+  // > A file cut short (writer never closed) is re-indexed from its frames
+  std::ifstream ifil(log_path, std::ios::binary);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(ifil)), std::istreambuf_iterator<char>());
+  ifil.close();
+  size_t frame_bytes = sizeof(BeamLogFrameHeader) + 36 * 3 * sizeof(float);
+  size_t index_bytes = num_frames * sizeof(BeamLogIndexEntry) + sizeof(BeamLogTrailer);
+  std::string cut_path = "/tmp/ac_test_beam_cut.acbl";
+  std::ofstream ofil(cut_path, std::ios::binary);
+  ofil.write(bytes.data(), bytes.size() - index_bytes - frame_bytes / 2);
+  ofil.close();
+  BeamformLogReader recovered(cut_path);
+  auto last = recovered.read_2d(recovered.size() - 1);
+  bool recovered_ok = !recovered.is_indexed() && recovered.size() == num_frames - 1 &&
+                      recovered.find(t0_nsec + 20 * step_nsec) == 20 && last != nullptr &&
+                      last->header.packet_num == num_frames - 2;
+  LOG(INFO) << "Beamformer log recovery : " << (recovered_ok ? "OK" : "FAILED");
+
+  // > Raw (3D) beamformer frames round trip as float64
+  std::vector<int8_t> buff = load_sample_packet(test_file_dir, "sample_beamformer_raw_packet.dat");
+  UdpBeamformRaw beam_raw(buff);
+  std::string raw_path = "/tmp/ac_test_beam_raw.acbl";
+  BeamformLogWriter raw_writer;
+  raw_writer.open(raw_path);
+  bool raw_written = raw_writer.write(beam_raw) == BEAM_LOG_WRITE::WRITTEN &&
+                     raw_writer.write(beam_raw) == BEAM_LOG_WRITE::WRITTEN;
+  // a ragged beampattern is dropped, not mistaken for a geometry change
+  UdpBeamformRaw ragged = beam_raw;
+  ragged.data.beampattern.back().back().pop_back();
+  bool raw_dropped = raw_writer.write(ragged) == BEAM_LOG_WRITE::DROPPED &&
+                     raw_writer.get_stats().dropped == 1 && raw_writer.get_num_frames() == 2;
+  raw_writer.close();
+  BeamformLogReader raw_reader(raw_path);
+  auto raw_frame = raw_reader.read_raw(1);
+  bool raw_ok = raw_written && raw_reader.size() == 2 && raw_frame != nullptr &&
+                raw_frame->data.beampattern == beam_raw.data.beampattern &&
+                raw_frame->data.frequencies == beam_raw.data.frequencies &&
+                raw_frame->header.start_time_nsec == beam_raw.header.start_time_nsec;
+  LOG(INFO) << "Beamformer log raw frames : " << (raw_ok ? "OK" : "FAILED");
+  LOG(INFO) << "Beamformer log ragged frame dropped : " << (raw_dropped ? "OK" : "FAILED");
+
+  std::remove(log_path.c_str());
+  std::remove(cut_path.c_str());
+  std::remove(raw_path.c_str());
+  LOG(INFO) << "End of beamformer logging test" << std::endl << std::endl;
+}
+
+// 16-bit PCM WAV with the canonical 44-byte header; data_bytes 0 leaves the size unset, as
+// a writer that never closed would
+static void write_test_wav(const std::string &path, const Eigen::MatrixX<int16_t> &data,
+                           uint32_t sample_rate, bool set_size = true) {
+  uint16_t num_channels = data.rows();
+  uint32_t data_bytes = data.size() * sizeof(int16_t);
+  uint32_t riff_bytes = 36 + data_bytes;
+  uint32_t fmt_bytes = 16;
+  uint16_t pcm = 1, block_align = num_channels * 2, bits = 16;
+  uint32_t byte_rate = sample_rate * block_align;
+  uint32_t data_field = set_size ? data_bytes : 0;
+
+  std::ofstream ofil(path, std::ios::binary);
+  ofil.write("RIFF", 4).write((char *)&riff_bytes, 4).write("WAVE", 4);
+  ofil.write("fmt ", 4).write((char *)&fmt_bytes, 4).write((char *)&pcm, 2);
+  ofil.write((char *)&num_channels, 2).write((char *)&sample_rate, 4);
+  ofil.write((char *)&byte_rate, 4).write((char *)&block_align, 2).write((char *)&bits, 2);
+  ofil.write("data", 4).write((char *)&data_field, 4);
+  ofil.write((char *)data.data(), data_bytes);
+}
+
+void run_aco_log_reader_tests() {
+  LOG(INFO) << "Checking acoustic log reader";
+
+  // > Two rolled-over WAV files, 1 s apart: 8000 + 4000 samples of 2 channels at 8 kHz;
+  //   the second never had its size written
+  int fs = 8000;
+  std::string wav_dir = "/tmp/ac_test_aco_log/";
+  std::filesystem::remove_all(wav_dir);
+  std::filesystem::create_directories(wav_dir);
+  Eigen::MatrixX<int16_t> signal(2, 12000);
+  for (int ii = 0; ii < signal.cols(); ii++) {
+    signal(0, ii) = ii % 30000;
+    signal(1, ii) = -(ii % 30000);
+  }
+  write_test_wav(wav_dir + "ACO_20260101-000000.wav", signal.leftCols(8000), fs);
+  write_test_wav(wav_dir + "ACO_20260101-000001.wav", signal.rightCols(4000), fs, false);
+  int64_t t0_nsec = 1767225600000000000; // 2026-01-01 00:00:00 UTC
+  int64_t dt_nsec = 1000000000 / fs;
+
+  AcousticLogReader reader;
+  bool opened = reader.open(wav_dir) && reader.get_format() == LOGGER::ACO_WAV &&
+                reader.get_segments().size() == 2 && reader.size() == 12000 &&
+                reader.get_num_channels() == 2 && reader.get_sample_rate() == fs;
+  LOG(INFO) << "Acoustic log open : " << (opened ? "OK" : "FAILED");
+
+  // > Random access across the file boundary, by sample and by time
+  Eigen::MatrixX<int16_t> out;
+  size_t got = reader.read(7990, 20, out);
+  bool read_ok = got == 20 && out == signal.middleCols(7990, 20) &&
+                 reader.read(11990, 100, out) == 10 && out == signal.rightCols(10);
+  LOG(INFO) << "Acoustic log read : " << (read_ok ? "OK" : "FAILED");
+
+  bool time_ok = reader.get_start_time_nsec() == t0_nsec &&
+                 reader.get_time_nsec(8001) == t0_nsec + 8001 * dt_nsec &&
+                 reader.find(t0_nsec + 100 * dt_nsec) == 100 &&
+                 reader.find(t0_nsec + 100 * dt_nsec + 1) == 101 &&
+                 reader.find(t0_nsec + 9000 * dt_nsec) == 9000 &&
+                 reader.find(t0_nsec - 1) == 0 && reader.find(reader.get_end_time_nsec()) == 12000;
+  LOG(INFO) << "Acoustic log time : " << (time_ok ? "OK" : "FAILED");
+
+  // > Replay through the socket's dispatch path, as packets of 1000 samples
+  UdpSocketIn socket;
+  auto q_aco = std::make_shared<tsQueue<std::shared_ptr<UdpAcousticData>>>();
+  socket.register_client_aco(q_aco);
+  reader.set_samples_per_packet(1000);
+  size_t num_replayed = reader.replay(socket);
+  std::vector<std::shared_ptr<UdpAcousticData>> packets;
+  q_aco->pop_all(packets);
+  bool replay_ok = num_replayed == 12 && packets.size() == 12;
+  for (size_t ii = 0; replay_ok && ii < packets.size(); ii++) {
+    replay_ok &= packets[ii]->data == signal.middleCols(ii * 1000, 1000) &&
+                 packets[ii]->header.start_time_nsec == t0_nsec + (int64_t)ii * 1000 * dt_nsec &&
+                 packets[ii]->header.sample_rate == fs && packets[ii]->header.packet_num == ii;
+  }
+  LOG(INFO) << "Acoustic log replay : " << (replay_ok ? "OK" : "FAILED");
+  reader.close();
+
+  // > CSV logs carry their own start time and sample rate
+  std::string csv_path = "/tmp/ac_test_aco_log.csv";
+  std::ofstream ofil(csv_path);
+  ofil << "host_epoch_sec,packet_epoch_nsec,frame_tick_time_nsec,sample_tick_interp_nsec,"
+          "adc_count,packet_num,0,1,2\n";
+  for (int ii = 0; ii < 100; ii++) {
+    // packets of 10 samples at 1 kHz
+    ofil << 1767225600 << "," << t0_nsec + (ii / 10) * 10000000 << "," << 5000 + (ii / 10) * 10000000
+         << "," << std::fixed << 5000 + ii * 1e6 << "," << 400 + ii << "," << ii / 10 << "," << ii
+         << "," << -ii << "," << 2 * ii << "\n";
+  }
+  ofil.close();
+  bool csv_ok = reader.open(csv_path) && reader.size() == 100 && reader.get_num_channels() == 3 &&
+                std::abs(reader.get_sample_rate() - 1000) < 1e-6 &&
+                reader.get_start_time_nsec() == t0_nsec && reader.find(t0_nsec + 42000000) == 42;
+  reader.read(40, 5, out);
+  csv_ok &= out.cols() == 5 && out(0, 0) == 40 && out(1, 4) == -44 && out(2, 2) == 84;
+  LOG(INFO) << "Acoustic log CSV : " << (csv_ok ? "OK" : "FAILED");
+  reader.close();
+
+  std::filesystem::remove_all(wav_dir);
+  std::remove(csv_path.c_str());
+  LOG(INFO) << "End of acoustic log reader test" << std::endl << std::endl;
+}
+
+void run_offline_tests() {
+  LOG(INFO) << "Checking offline processing";
+
+  // > 3 s of noise on 2 channels at 8 kHz, in three 1 s WAV files, with a 1500 Hz tone on
+  //   channel 0 from 1.2 to 1.8 s
+  int fs = 8000;
+  std::string wav_dir = "/tmp/ac_test_offline/";
+  std::filesystem::remove_all(wav_dir);
+  std::filesystem::create_directories(wav_dir);
+  std::mt19937 gen(11);
+  std::normal_distribution<double> normal(0, 300);
+  Eigen::MatrixX<int16_t> signal(2, 3 * fs);
+  for (int ii = 0; ii < signal.cols(); ii++) {
+    bool on = ii >= 1.2 * fs && ii < 1.8 * fs;
+    double tone = on ? 8000 * std::sin(2 * M_PI * 1500 * ii / fs) : 0;
+    signal(0, ii) = (int16_t)(normal(gen) + tone);
+    signal(1, ii) = (int16_t)normal(gen);
+  }
+  for (int ff = 0; ff < 3; ff++) {
+    write_test_wav(wav_dir + "ACO_20260101-00000" + std::to_string(ff) + ".wav",
+                   signal.middleCols(ff * fs, fs), fs);
+  }
+
+  OfflineProcessor offline;
+  bool opened = offline.open_log(wav_dir) && offline.size() == signal.cols();
+  LOG(INFO) << "Offline open : " << (opened ? "OK" : "FAILED");
+
+  auto fft = FFT::create();
+  fft->set_NFFT(256);
+  fft->set_noverlap(128);
+  auto detector = EnergyDetector::create();
+  detector->set_NFFT(256);
+  detector->set_noverlap(128);
+  detector->set_sample_rate(fs);
+  detector->add_frequency_band_min_max(1000, 2000);
+  detector->set_algorithm(DETECTOR_ALGORITHM::CA_CFAR);
+  detector->set_threshold_db(15);
+  offline.set_fft(fft);
+  offline.set_detector(detector);
+  // CA_CFAR keeps no state across frames; a short warm-up keeps the chunks starting
+  // mid-recording (the default would start every chunk at the top of this one)
+  offline.set_detector_warmup_frames(4);
+  offline.set_samples_per_packet(500);
+  offline.set_keep_fft(true);
+
+  // single pass vs. 0.25 s chunks on 4 threads
+  auto run = [&](size_t num_threads, double chunk_sec) {
+    offline.set_num_threads(num_threads);
+    offline.set_chunk_sec(chunk_sec);
+    return offline.process();
+  };
+  auto same = [](const OfflineResult &a, const OfflineResult &b) {
+    bool ok = a.fft.size() == b.fft.size() && a.psd.size() == b.psd.size() &&
+              a.detections.size() == b.detections.size() && a.events.size() == b.events.size();
+    for (size_t ii = 0; ok && ii < a.fft.size(); ii++) {
+      ok &= a.fft[ii]->header.start_time_nsec == b.fft[ii]->header.start_time_nsec &&
+            a.fft[ii]->header.packet_num == b.fft[ii]->header.packet_num &&
+            (a.fft[ii]->fft - b.fft[ii]->fft).cwiseAbs().maxCoeff() < 1e-9;
+    }
+    for (size_t ii = 0; ok && ii < a.psd.size(); ii++) {
+      ok &= a.psd[ii]->header.start_time_nsec == b.psd[ii]->header.start_time_nsec &&
+            (a.psd[ii]->psd - b.psd[ii]->psd).cwiseAbs().maxCoeff() < 1e-9;
+    }
+    for (size_t ii = 0; ok && ii < a.detections.size(); ii++) {
+      ok &= a.detections[ii]->cells.size() == b.detections[ii]->cells.size();
+    }
+    return ok;
+  };
+
+  OfflineResult serial = run(1, 100);
+  OfflineResult parallel = run(4, 0.25);
+  bool tone_found = !serial.events.empty() && serial.events.front()->header.start_time_nsec >=
+                                                  offline.get_time_nsec(1.1 * fs);
+  LOG(INFO) << "Offline frames : " << serial.fft.size() << " in " << serial.num_chunks << " / "
+            << parallel.num_chunks << " chunks, " << serial.events.size() << " events";
+  LOG(INFO) << "Offline detection : " << (tone_found ? "OK" : "FAILED");
+  LOG(INFO) << "Offline chunks match single pass : "
+            << (serial.fft.size() == (3 * fs - 256) / 128 + 1 && parallel.num_chunks > 4 &&
+                        same(serial, parallel)
+                    ? "OK"
+                    : "FAILED");
+
+  // > Decimated front end: chunks start early enough to fill the filter history. FFT only,
+  //   so the lead-in is the filter's alone
+  offline.set_detector(nullptr);
+  fft->add_frequency_band_min_max(100, 800);
+  fft->set_decimation(true);
+  serial = run(1, 100);
+  parallel = run(4, 0.25);
+  bool decimated = !serial.fft.empty() && serial.fft.size() * 2 < (3 * fs) / 128;
+  LOG(INFO) << "Offline decimated chunks match single pass : "
+            << (decimated && same(serial, parallel) ? "OK" : "FAILED");
+  fft->set_decimation(false);
+  fft->clear_frequency_bands();
+
+  // > Welch PSDs: chunks hold whole averages
+  fft->set_mode(FFT_MODE::WELCH_PSD);
+  fft->set_psd_averages(5);
+  serial = run(1, 100);
+  parallel = run(4, 0.25);
+  LOG(INFO) << "Offline PSD chunks match single pass : "
+            << (!serial.psd.empty() && serial.fft.empty() && same(serial, parallel) ? "OK"
+                                                                                    : "FAILED");
+  fft->set_mode(FFT_MODE::SPECTRUM);
+
+  // > A packet capture of the same recording gives the same frames
+  std::string capture_path = "/tmp/ac_test_offline.pcap";
+  {
+    AcousticLogReader reader;
+    reader.open(wav_dir);
+    PacketRecorder recorder;
+    recorder.open(capture_path);
+    for (size_t ii = 0; ii < reader.size();) {
+      auto aco_data = reader.read_packet(ii, 700);
+      std::vector<int8_t> msg = aco_data->encode();
+      recorder.record(msg.data(), msg.size(), ii);
+      ii += aco_data->data.cols();
+    }
+  }
+  serial = run(1, 100);
+  bool capture_ok = offline.open_capture(capture_path) && offline.size() == signal.cols();
+  parallel = run(3, 0.4);
+  LOG(INFO) << "Offline capture matches log : "
+            << (capture_ok && same(serial, parallel) ? "OK" : "FAILED");
+  offline.close();
+
+  std::filesystem::remove_all(wav_dir);
+  std::remove(capture_path.c_str());
+  LOG(INFO) << "End of offline processing test" << std::endl << std::endl;
+}
+
+// CSV rows without their first field (the host epoch, which may tick between two rows)
+static std::string strip_host_epoch(const std::string &rows) {
+  std::string out;
+  size_t pos = 0;
+  while (pos < rows.size()) {
+    size_t eol = rows.find('\n', pos);
+    eol = eol == std::string::npos ? rows.size() : eol + 1;
+    size_t sep = rows.find(',', pos);
+    out += rows.substr(sep < eol ? sep : pos, eol - (sep < eol ? sep : pos));
+    pos = eol;
+  }
+  return out;
+}
+
+void run_csv_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking CSV formatting";
+
+  // Each case formats the same values as the loggers did with iostreams (std::fixed, default
+  // precision 6) and through CsvWriter; the bytes must match.
+  float awkward[] = {1.0f / 3, -2.5e-7f, 123456.789f, -0.0f, 1e10f,
+                     std::numeric_limits<float>::quiet_NaN()};
+  int64_t t_nsec = 1760000000123456789;
+  bool sensors_ok = true;
+  auto check = [&](const char *name, UdpData &data, const std::ostringstream &ref) {
+    std::ostringstream out;
+    data.csv_serialize(out);
+    bool same = strip_host_epoch(out.str()) == strip_host_epoch(ref.str());
+    if (!same)
+      LOG(INFO) << name << " row differs :" << std::endl << ref.str() << out.str();
+    sensors_ok &= same;
+  };
+  for (float value : awkward) {
+    std::ostringstream ref;
+    UdpImuData imu;
+    imu.header.start_time_nsec = t_nsec;
+    imu.accel_x = -32768;
+    imu.accel_y = 12345;
+    imu.gyro_z = -1;
+    ref << std::time(nullptr) << "," << std::fixed << imu.header.start_time_nsec << ","
+        << imu.accel_x << "," << imu.accel_y << "," << imu.accel_z << "," << imu.gyro_x << ","
+        << imu.gyro_y << "," << imu.gyro_z << std::endl;
+    check("IMU", imu, ref);
+
+    ref.str("");
+    UdpBnoData bno;
+    bno.header.start_time_nsec = t_nsec;
+    bno.sense_char = 'A';
+    bno.status = 3;
+    bno.sense_x = value;
+    bno.sense_y = -value;
+    bno.sense_z = value * 1000;
+    ref << std::time(nullptr) << "," << std::fixed << bno.header.start_time_nsec << ","
+        << (char)bno.sense_char << "," << (int)bno.status << "," << bno.sense_x << ","
+        << bno.sense_y << "," << bno.sense_z << std::endl;
+    check("BNO", bno, ref);
+
+    ref.str("");
+    UdpBnrData bnr;
+    bnr.header.start_time_nsec = t_nsec;
+    bnr.status = 255;
+    bnr.quat_i = value;
+    bnr.quat_j = 0.5f;
+    bnr.quat_k = -value;
+    bnr.quat_r = 0.999999f;
+    bnr.accuracy = value / 7;
+    ref << std::time(nullptr) << "," << std::fixed << bnr.header.start_time_nsec << ","
+        << (int)bnr.status << "," << bnr.quat_i << "," << bnr.quat_j << "," << bnr.quat_k << ","
+        << bnr.quat_r << "," << bnr.accuracy << std::endl;
+    check("BNR", bnr, ref);
+
+    ref.str("");
+    UdpEptData ept;
+    ept.header.start_time_nsec = t_nsec;
+    ept.pressure_mbar = 1013.25f + value;
+    ept.temperature_c = value;
+    ref << std::time(nullptr) << "," << std::fixed << ept.header.start_time_nsec << ","
+        << ept.pressure_mbar << "," << ept.temperature_c << std::endl;
+    check("EPT", ept, ref);
+
+    ref.str("");
+    UdpPtsData pts;
+    pts.header.start_time_nsec = t_nsec;
+    pts.pressure_mbar = value * 3;
+    pts.temperature_c = -value;
+    ref << std::time(nullptr) << "," << std::fixed << pts.header.start_time_nsec << ","
+        << pts.pressure_mbar << "," << pts.temperature_c << std::endl;
+    check("PTS", pts, ref);
+  }
+  std::ostringstream ref;
+  UdpRtcData rtc;
+  rtc.header.start_time_nsec = t_nsec;
+  rtc.rtc_time = 1760000000;
+  ref << std::time(nullptr) << "," << std::fixed << rtc.header.start_time_nsec << ","
+      << rtc.rtc_time << std::endl;
+  check("RTC", rtc, ref);
+  LOG(INFO) << "Sensor rows match iostream output : " << (sensors_ok ? "OK" : "FAILED");
+
+  // > GPS fields: std::fixed with std::setprecision(8)
+  double gps_values[] = {47.60621234567, -122.3320708, 0, 1e-9, 12345678.123456789, -0.000000005,
+                         std::numeric_limits<double>::quiet_NaN()};
+  std::ostringstream gps_ref;
+  CsvWriter gps(64);
+  gps_ref << std::fixed << std::setprecision(8);
+  for (double value : gps_values) {
+    gps_ref << value << ",";
+    gps.put(value, 8).sep();
+  }
+  bool gps_ok = gps_ref.str() == std::string(gps.data(), gps.size());
+  LOG(INFO) << "GPS fields match iostream output : " << (gps_ok ? "OK" : "FAILED");
+
+  // > Integer types: long long / unsigned long long are neither int64_t nor uint64_t on LP64
+  CsvWriter ints(64);
+  ints.put(-9000000000000000000LL).sep().put(18000000000000000000ULL).sep();
+  ints.put((uint8_t)200).sep().put((int8_t)-5).sep().put((short)-3).sep().put(true);
+  bool ints_ok = std::string(ints.data(), ints.size()) ==
+                 "-9000000000000000000,18000000000000000000,200,-5,-3,1";
+  LOG(INFO) << "Integer overloads : " << (ints_ok ? "OK" : "FAILED");
+
+  // > Acoustic logger rows, against the iostream row format, over a decoded sample packet
+  std::vector<int8_t> buff = load_sample_packet(test_file_dir);
+  std::vector<std::shared_ptr<UdpAcousticData>> packets = make_packet_train(buff, 3, 1000000);
+  std::string csv_dir = "/tmp/ac_test_csv/";
+  std::filesystem::remove_all(csv_dir);
+  std::filesystem::create_directories(csv_dir);
+  {
+    Logger_Acoustic_CSV logger;
+    logger.set_outdir(csv_dir);
+    logger.Initialize_from_aco(packets.front());
+    logger.Start();
+    for (auto &aco_data : packets) {
+      logger.Log_ACO_Data(aco_data);
+    }
+    logger.Stop();
+    logger.Shutdown();
+  }
+  std::ostringstream aco_ref;
+  int64_t adc_count_file_start = packets.front()->header.adc_count;
+  int64_t tick_file_start_ns = packets.front()->header.tick_time_nsec;
+  for (auto &aco_data : packets) {
+    int num_channels = aco_data->header.num_channels;
+    for (int ii = 0; ii < aco_data->header.num_values / num_channels; ii++) {
+      aco_ref << std::time(nullptr) << ",";
+      aco_ref << std::fixed << aco_data->header.start_time_nsec << ",";
+      aco_ref << std::fixed << aco_data->header.tick_time_nsec << ",";
+      aco_ref << std::fixed
+              << ((aco_data->header.adc_count + ii - adc_count_file_start) /
+                  (double)aco_data->header.sample_rate) *
+                         1e9 +
+                     tick_file_start_ns
+              << ",";
+      aco_ref << std::fixed << aco_data->header.adc_count + ii << ",";
+      aco_ref << aco_data->header.packet_num << ",";
+      for (int ch = 0; ch < num_channels - 1; ch++) {
+        aco_ref << aco_data->data(ch, ii) << ",";
+      }
+      aco_ref << aco_data->data(num_channels - 1, ii) << std::endl;
+    }
+  }
+  std::string aco_rows;
+  size_t num_files = 0;
+  for (auto &entry : std::filesystem::directory_iterator(csv_dir)) {
+    std::ifstream ifil(entry.path());
+    std::string header;
+    std::getline(ifil, header);
+    aco_rows.assign((std::istreambuf_iterator<char>(ifil)), std::istreambuf_iterator<char>());
+    num_files++;
+  }
+  bool aco_ok = num_files == 1 && !aco_rows.empty() &&
+                strip_host_epoch(aco_rows) == strip_host_epoch(aco_ref.str());
+  LOG(INFO) << "Acoustic rows match iostream output : " << (aco_ok ? "OK" : "FAILED");
+  std::filesystem::remove_all(csv_dir);
+
+  LOG(INFO) << "End of CSV formatting test" << std::endl << std::endl;
+}
+
+void run_aco_logger_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking acoustic logger round trips";
+
+  // 24 consecutive packets with distinct samples; logging stops after 12 and restarts in
+  // the next second (file names have 1 s resolution), so each log splits in two files
+  std::vector<int8_t> buff = load_sample_packet(test_file_dir);
+  auto first = std::make_shared<UdpAcousticData>(buff);
+  size_t num_packets = 24;
+  int64_t num_samples = first->data.cols();
+  int64_t step_nsec = num_samples * 1000000000LL / first->header.sample_rate;
+  std::vector<std::shared_ptr<UdpAcousticData>> packets =
+      make_packet_train(buff, num_packets, step_nsec);
+  std::mt19937 gen(27);
+  std::uniform_int_distribution<int> pcm(-32768, 32767);
+  Eigen::MatrixX<int16_t> expected(first->data.rows(), num_samples * num_packets);
+  for (size_t ii = 0; ii < num_packets; ii++) {
+    UdpAcousticData &packet = *packets[ii];
+    packet.data = packet.data.unaryExpr([&](int16_t) { return (int16_t)pcm(gen); });
+    packet.header.packet_num = first->header.packet_num + ii;
+    packet.header.adc_count = first->header.adc_count + ii * num_samples;
+    expected.middleCols(ii * num_samples, num_samples) = packet.data;
+  }
+
+  std::string log_dir = "/tmp/ac_test_aco_logger/";
+  auto round_trip = [&](const std::string &name, Logger_Acoustic &logger) {
+    std::filesystem::remove_all(log_dir);
+    std::filesystem::create_directories(log_dir);
+    logger.set_outdir(log_dir);
+    logger.Initialize_from_aco(packets.front());
+    logger.Start();
+    for (size_t ii = 0; ii < num_packets; ii++) {
+      if (ii == num_packets / 2) {
+        logger.Stop();
+        std::time_t stopped = std::time(nullptr);
+        while (std::time(nullptr) == stopped) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        logger.Start();
+      }
+      logger.Log_ACO_Data(packets[ii]);
+    }
+    logger.Stop();
+    logger.Shutdown();
+
+    AcousticLogReader reader;
+    bool ok = reader.open(log_dir) && reader.size() == (size_t)expected.cols() &&
+              reader.get_num_channels() == expected.rows();
+    std::vector<AcousticLogSegment> segments = reader.get_segments();
+    ok &= segments.size() == 2;
+    for (auto &segment : segments) {
+      ok &= segment.num_samples == (size_t)expected.cols() / 2;
+    }
+    ok = ok && reader.read(0, reader.size()) == expected;
+    LOG(INFO) << name << " : " << segments.size() << " files, " << reader.size()
+              << " frames : " << (ok ? "OK" : "FAILED");
+    reader.close();
+    std::filesystem::remove_all(log_dir);
+  };
+
+  {
+    Logger_Acoustic_WAV logger;
+    round_trip("WAV", logger);
+  }
+  {
+    Logger_Acoustic_WAV logger;
+    logger.set_write_behind(4);
+    logger.set_fsync_policy(FSYNC_POLICY::EVERY_WRITE);
+    round_trip("WAV, write-behind, fsync every write", logger);
+  }
+  {
+    Logger_Acoustic_FLAC logger;
+    logger.set_num_workers(2);
+    logger.set_write_block_frames(300);
+    round_trip("FLAC, 2 encoder workers, 300 frame blocks", logger);
+  }
+  {
+    Logger_Acoustic_FLAC logger;
+    logger.set_num_workers(0);
+    logger.set_write_behind(8);
+    logger.set_fsync_policy(FSYNC_POLICY::PERIODIC, 0);
+    round_trip("FLAC, inline, write-behind, periodic fsync", logger);
+  }
+  {
+    Logger_Acoustic_CSV logger;
+    logger.set_write_behind(4);
+    round_trip("CSV, write-behind", logger);
+  }
+
+  LOG(INFO) << "End of acoustic logger test" << std::endl << std::endl;
+}
+
+void run_bf_raw_reassembly_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking ACBR / ACBC reassembly";
+
+  std::vector<int8_t> buff = load_sample_packet(test_file_dir, "sample_beamformer_raw_packet.dat");
+  UdpBeamformRaw original(buff);
+
+  UdpSocketIn socket;
+  auto q_beamraw = std::make_shared<tsQueue<std::shared_ptr<UdpBeamformRaw>>>();
+  socket.register_client_beamraw(q_beamraw);
+
+  // > A series split over an ACBR primary and ACBC continuations is pushed exactly once,
+  //   complete, when its last part arrives
+  std::vector<std::vector<int8_t>> datagrams = original.encode_datagrams(buff.size() / 3);
+  size_t pushed_early = 0;
+  for (auto &datagram : datagrams) {
+    socket.dispatch(datagram);
+    if (&datagram != &datagrams.back())
+      pushed_early += q_beamraw->size();
+  }
+  std::vector<std::shared_ptr<UdpBeamformRaw>> received;
+  q_beamraw->pop_all(received);
+  bool multi_ok = datagrams.size() > 2 && pushed_early == 0 && received.size() == 1 &&
+                  received.front()->data.beampattern == original.data.beampattern &&
+                  received.front()->data.frequencies == original.data.frequencies;
+  LOG(INFO) << "Series of " << datagrams.size() << " datagrams pushed " << received.size()
+            << " time(s) : " << (multi_ok ? "OK" : "FAILED");
+
+  // > A single-datagram series is pushed on the primary
+  datagrams = original.encode_datagrams(buff.size() * 2);
+  for (auto &datagram : datagrams) {
+    socket.dispatch(datagram);
+  }
+  received.clear();
+  q_beamraw->pop_all(received);
+  bool single_ok = datagrams.size() == 1 && received.size() == 1 &&
+                   received.front()->data.beampattern == original.data.beampattern;
+  LOG(INFO) << "Single datagram series pushed once : " << (single_ok ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of ACBR reassembly test" << std::endl << std::endl;
+}
+
+void run_encoder_tests(std::string test_file_dir) {
+  LOG(INFO) << "Checking packet encoders against the decoders";
+
+  // > Sensor packets, as the traffic generator builds them; values on the wire are scaled
+  //   integers, so compare to the encoding resolution
+  int64_t t_nsec = 1760000000123456780; // headers carry 10 ns ticks
+  auto near = [](double a, double b, double resolution) {
+    return std::abs(a - b) <= resolution / 2 + 1e-6;
+  };
+
+  UdpPtsData pts;
+  pts.header.start_time_nsec = t_nsec;
+  pts.pressure_mbar = 1013.25;
+  pts.temperature_c = -1.87;
+  std::vector<int8_t> buff = pts.encode();
+  UdpPtsData pts2(buff);
+  bool pts_ok = pts2.header.start_time_nsec == t_nsec &&
+                near(pts2.pressure_mbar, pts.pressure_mbar, 0.01) &&
+                near(pts2.temperature_c, pts.temperature_c, 0.01);
+  LOG(INFO) << "PTS round trip : " << (pts_ok ? "OK" : "FAILED");
+
+  UdpImuData imu;
+  imu.header.start_time_nsec = t_nsec;
+  imu.pitch_ned_deg = -8.41;
+  imu.roll_ned_deg = 3.3;
+  imu.accel_x = -32768;
+  imu.accel_y = 512;
+  imu.accel_z = 1000;
+  imu.gyro_x = 7;
+  imu.gyro_y = -7;
+  imu.gyro_z = 32767;
+  buff = imu.encode();
+  UdpImuData imu2(buff);
+  bool imu_ok = imu2.header.start_time_nsec == t_nsec &&
+                near(imu2.pitch_ned_deg, imu.pitch_ned_deg, 0.01) &&
+                near(imu2.roll_ned_deg, imu.roll_ned_deg, 0.01) && imu2.accel_x == imu.accel_x &&
+                imu2.accel_y == imu.accel_y && imu2.accel_z == imu.accel_z &&
+                imu2.gyro_x == imu.gyro_x && imu2.gyro_y == imu.gyro_y &&
+                imu2.gyro_z == imu.gyro_z;
+  LOG(INFO) << "IMU round trip : " << (imu_ok ? "OK" : "FAILED");
+
+  // EP packets carry mbar x10, ED packets mbar x100
+  bool ept_ok = true;
+  for (char sid : {'P', 'D'}) {
+    UdpEptData ept;
+    ept.header.start_time_nsec = t_nsec;
+    ept.header.id[1] = sid;
+    ept.pressure_mbar = 2047.53;
+    ept.temperature_c = 12.5;
+    buff = ept.encode();
+    UdpEptData ept2(buff);
+    ept_ok &= ept2.header.id[1] == sid && ept2.header.start_time_nsec == t_nsec &&
+              near(ept2.pressure_mbar, ept.pressure_mbar, sid == 'D' ? 0.01 : 0.1) &&
+              near(ept2.temperature_c, ept.temperature_c, 0.01);
+  }
+  LOG(INFO) << "EPT round trip (EP, ED) : " << (ept_ok ? "OK" : "FAILED");
+
+  UdpRtcData rtc;
+  rtc.header.start_time_nsec = t_nsec;
+  rtc.rtc_time = 1760000000;
+  buff = rtc.encode();
+  UdpRtcData rtc2(buff);
+  bool rtc_ok = rtc2.header.start_time_nsec == t_nsec && rtc2.rtc_time == rtc.rtc_time;
+  LOG(INFO) << "RTC round trip : " << (rtc_ok ? "OK" : "FAILED");
+
+  bool bno_ok = true;
+  for (char sense_char : {'A', 'G', 'M'}) {
+    UdpBnoData bno;
+    bno.header.start_time_nsec = t_nsec;
+    bno.sense_char = sense_char;
+    bno.status = 3;
+    bno.sense_x = 0.3;
+    bno.sense_y = -0.95;
+    bno.sense_z = 9.81;
+    buff = bno.encode();
+    UdpBnoData bno2(buff);
+    bno_ok &= bno2.header.start_time_nsec == t_nsec && bno2.sense_char == sense_char &&
+              bno2.sense_type == BNO_TYPE_CHAR.at(sense_char) && bno2.status == bno.status &&
+              near(bno2.sense_x, bno.sense_x, 1.0 / (1 << 8)) &&
+              near(bno2.sense_y, bno.sense_y, 1.0 / (1 << 8)) &&
+              near(bno2.sense_z, bno.sense_z, 1.0 / (1 << 8));
+  }
+  LOG(INFO) << "BNO round trip : " << (bno_ok ? "OK" : "FAILED");
+
+  UdpBnrData bnr;
+  bnr.header.start_time_nsec = t_nsec;
+  bnr.status = 2;
+  bnr.quat_i = 0.1;
+  bnr.quat_j = -0.2;
+  bnr.quat_k = std::sin(0.6);
+  bnr.quat_r = std::cos(0.6);
+  bnr.accuracy = 0.1;
+  buff = bnr.encode();
+  UdpBnrData bnr2(buff);
+  bool bnr_ok = bnr2.header.start_time_nsec == t_nsec && bnr2.status == bnr.status &&
+                near(bnr2.quat_i, bnr.quat_i, 1.0 / (1 << 14)) &&
+                near(bnr2.quat_j, bnr.quat_j, 1.0 / (1 << 14)) &&
+                near(bnr2.quat_k, bnr.quat_k, 1.0 / (1 << 14)) &&
+                near(bnr2.quat_r, bnr.quat_r, 1.0 / (1 << 14)) &&
+                near(bnr2.accuracy, bnr.accuracy, 1.0 / (1 << 12));
+  LOG(INFO) << "BNR round trip : " << (bnr_ok ? "OK" : "FAILED");
+
+  // > Acoustic and beamformer packets: the sample datagrams re-encode byte for byte, and a
+  //   synthetic acoustic packet decodes to what was encoded
+  bool samples_ok = true;
+  buff = load_sample_packet(test_file_dir);
+  samples_ok &= !buff.empty() && UdpAcousticData(buff).encode() == buff;
+  buff = load_sample_packet(test_file_dir, "sample_beamformer_2d_packet.dat");
+  samples_ok &= !buff.empty() && UdpBeamform2D(buff).encode() == buff;
+  buff = load_sample_packet(test_file_dir, "sample_beamformer_raw_packet.dat");
+  samples_ok &= !buff.empty() && UdpBeamformRaw(buff).encode() == buff;
+  LOG(INFO) << "Sample AC / ACB2 / ACBR packets re-encode identically : "
+            << (samples_ok ? "OK" : "FAILED");
+
+  Eigen::MatrixX<int16_t> samples(4, 64);
+  samples.setRandom();
+  auto aco =
+      UdpAcousticData::create(samples, 4, samples.size(), 64000, t_nsec, 123456780, 640, 10);
+  buff = aco->encode();
+  UdpAcousticData aco2(buff);
+  bool aco_ok = aco2.header.start_time_nsec == t_nsec &&
+                aco2.header.tick_time_nsec == aco->header.tick_time_nsec &&
+                aco2.header.adc_count == aco->header.adc_count &&
+                aco2.header.packet_num == aco->header.packet_num &&
+                aco2.header.sample_rate == 64000 && aco2.header.num_channels == 4 &&
+                aco2.data == samples;
+  LOG(INFO) << "AC round trip : " << (aco_ok ? "OK" : "FAILED");
+
+  LOG(INFO) << "End of encoder round trip test" << std::endl << std::endl;
+}
@@ -15,3 +15,25 @@ void run_aco_tests(std::string test_file_dir, std::string test_file_name);
 void run_bf_raw_tests(std::string test_file_dir, std::string test_file_name);
 void run_bf_2d_tests(std::string test_file_dir, std::string test_file_name);
 void run_pts_tests();
+void run_imu_tests();
+void run_capture_tests(std::string test_file_dir);
+void run_latency_tests(std::string test_file_dir);
+void run_queue_tests();
+void run_metrics_tests(std::string test_file_dir);
+void run_psd_tests(std::string test_file_dir);
+void run_active_bins_tests(std::string test_file_dir);
+void run_tone_tests(std::string test_file_dir);
+void run_decimation_tests();
+void run_detector_algorithm_tests();
+void run_detection_event_tests();
+void run_beamformer_tests();
+void run_steering_cache_tests();
+void run_btr_tests();
+void run_beam_storage_tests();
+void run_beam_log_tests(std::string test_file_dir);
+void run_aco_log_reader_tests();
+void run_offline_tests();
+void run_csv_tests(std::string test_file_dir);
+void run_aco_logger_tests(std::string test_file_dir);
+void run_bf_raw_reassembly_tests(std::string test_file_dir);
+void run_encoder_tests(std::string test_file_dir);
@@ -106,6 +106,63 @@ void UdpAcousticData::Header::decode(std::vector<int8_t> &buff) {
   this->packet_num = packet_num;
 }
 
+std::vector<int8_t> UdpAcousticData::Header::encode() {
+  // inverse of decode(), following the same firmware version rules
+  std::vector<int8_t> buff(sizeof(Header));
+  auto buff_raw = buff.data();
+
+  size_t offset;
+  int32_t num_values = bswap_32(this->num_values);
+  int32_t sample_rate_buff;
+  int64_t start_time_nsec = bswap_64(this->start_time_nsec);
+  uint64_t tick_time_10nsec = bswap_64(this->tick_time_nsec / 10);
+  int32_t adc_count = bswap_32(this->adc_count);
+  int32_t packet_num = bswap_32(this->packet_num);
+
+  if (this->ver_maj > 4 || (this->ver_maj == 4 && this->ver_min >= 1)) {
+    std::memcpy(&sample_rate_buff, &this->sample_rate, sizeof(sample_rate_buff));
+  } else {
+    // pre-v4.1 float encodings are not reproducible; use the int32 form of v2
+    sample_rate_buff = (int32_t)this->sample_rate;
+  }
+  sample_rate_buff = bswap_32(sample_rate_buff);
+
+  buff[0] = this->id[0];
+  buff[1] = this->id[1];
+  buff[2] = this->ver_maj;
+  buff[3] = this->ver_min;
+  buff[4] = this->endian;
+  buff[5] = this->num_channels;
+  buff[6] = this->data_size_bits;
+
+  offset = 7;
+
+  std::memcpy(buff_raw + offset, &num_values, sizeof(num_values));
+  offset += sizeof(num_values);
+
+  std::memcpy(buff_raw + offset, &sample_rate_buff, sizeof(sample_rate_buff));
+  offset += sizeof(sample_rate_buff);
+
+  std::memcpy(buff_raw + offset, &start_time_nsec, sizeof(start_time_nsec));
+  offset += sizeof(start_time_nsec);
+
+  if (this->ver_maj >= 4) {
+    std::memcpy(buff_raw + offset, &tick_time_10nsec, sizeof(tick_time_10nsec));
+    offset += sizeof(tick_time_10nsec);
+  }
+  std::memcpy(buff_raw + offset, &adc_count, sizeof(adc_count));
+  offset += sizeof(adc_count);
+
+  std::memcpy(buff_raw + offset, &this->scale, sizeof(this->scale));
+  offset += sizeof(this->scale);
+
+  std::memcpy(buff_raw + offset, &packet_num, sizeof(packet_num));
+  offset += sizeof(packet_num);
+
+  buff.resize(offset);
+  return buff;
+}
+
 UdpAcousticData::UdpAcousticData(std::vector<int8_t> &buff) {
   std::string buff_start(buff.begin(), buff.end());
   buff_start = buff_start.substr(0, 6);
@@ -167,6 +224,22 @@ UdpAcousticData::UdpAcousticData(  Eigen::MatrixX<int16_t> data,
 }
 
 
+std::vector<int8_t> UdpAcousticData::encode() {
+  Header _header = this->header;
+  _header.num_channels = this->data.rows();
+  _header.num_values = this->data.size();
+  _header.data_size_bits = 16;
+
+  std::vector<int8_t> buff = _header.encode();
+  size_t offset = buff.size();
+  size_t sz_data = this->data.size() * sizeof(int16_t);
+
+  // column-major channels x samples is the on-wire interleaved sample order
+  buff.resize(offset + sz_data);
+  std::memcpy(buff.data() + offset, this->data.data(), sz_data);
+  return buff;
+}
+
 bool UdpAcousticData::unpack_data(std::vector<int8_t> &buff) {
   size_t _v4_correction = this->header.ver_maj >= 4 ? 0 : sizeof(Header::tick_time_nsec);
   size_t offset = sizeof(Header) - _v4_correction;
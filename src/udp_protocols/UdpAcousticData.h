@@ -56,6 +56,7 @@ struct UdpAcousticData : public UdpData {
     };
     Header(std::vector<int8_t> &buff);
     void decode(std::vector<int8_t> &buff);
+    std::vector<int8_t> encode();
   } header;
 
   // May need better way to allocate this, if data_size becomes configurable
@@ -91,6 +92,7 @@ struct UdpAcousticData : public UdpData {
   }
 
   bool unpack_data(std::vector<int8_t> &buff);
+  std::vector<int8_t> encode();
 };
 
 std::ostream &operator<<(std::ostream &os, const UdpAcousticData &st);
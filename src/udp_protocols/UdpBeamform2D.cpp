@@ -15,6 +15,70 @@
 // includes from within project
 #include "UdpBeamform2D.h"
 
+namespace {
+// Calls f with the beampattern as a double-valued Eigen expression, whatever the storage
+template <typename F> auto visit_beampattern(const UdpBeamform2D::Payload &d, F f) {
+  switch (d.storage) {
+  case BEAM_STORAGE::FLOAT32:
+    return f(d.beampattern_f32.cast<double>());
+  case BEAM_STORAGE::FLOAT16:
+    return f(d.beampattern_f16.cast<double>());
+  case BEAM_STORAGE::DB_U8:
+    return f((d.beampattern_u8.cast<double>().array() * (double)d.db_step + (double)d.db_min)
+                 .matrix());
+  default:
+    return f(d.beampattern);
+  }
+}
+
+// Store src (bearings x elevations, double-valued) in the given storage, then release the
+// other stores. src may refer to the current store.
+template <typename Derived>
+void store_beampattern(UdpBeamform2D::Payload &d, const Eigen::MatrixBase<Derived> &src,
+                       BEAM_STORAGE storage, double db_range) {
+  switch (storage) {
+  case BEAM_STORAGE::FLOAT32:
+    d.beampattern_f32 = src.template cast<float>();
+    break;
+  case BEAM_STORAGE::FLOAT16:
+    d.beampattern_f16 = src.template cast<Eigen::half>();
+    break;
+  case BEAM_STORAGE::DB_U8: {
+    Eigen::MatrixX<uint8_t> quantized(src.rows(), src.cols());
+    d.db_min = 0;
+    d.db_step = 0;
+    if (src.size() > 0) {
+      double db_max = src.maxCoeff();
+      d.db_min = std::max(src.minCoeff(), db_max - db_range);
+      d.db_step = (db_max - d.db_min) / 255;
+    }
+    if (d.db_step > 0) {
+      quantized = ((src.array().max((double)d.db_min) - (double)d.db_min) / (double)d.db_step)
+                      .round()
+                      .min(255)
+                      .template cast<uint8_t>();
+    } else {
+      quantized.setZero();
+    }
+    d.beampattern_u8.swap(quantized);
+    break;
+  }
+  default:
+    d.beampattern = src;
+    break;
+  }
+  d.storage = storage;
+  if (storage != BEAM_STORAGE::FLOAT64)
+    d.beampattern.resize(0, 0);
+  if (storage != BEAM_STORAGE::FLOAT32)
+    d.beampattern_f32.resize(0, 0);
+  if (storage != BEAM_STORAGE::FLOAT16)
+    d.beampattern_f16.resize(0, 0);
+  if (storage != BEAM_STORAGE::DB_U8)
+    d.beampattern_u8.resize(0, 0);
+}
+} // namespace
+
 UdpBeamform2D::UdpBeamform2D() {}
 
 UdpBeamform2D::Header::Header(std::vector<int8_t> &buff) { this->decode(buff); }
@@ -134,20 +198,22 @@ void UdpBeamform2D::Header::decode(std::vector<int8_t> &buff) {
   this->packet_num = packet_num;
 }
 
-UdpBeamform2D::UdpBeamform2D(std::vector<int8_t> &buff) {
+UdpBeamform2D::UdpBeamform2D(std::vector<int8_t> &buff, BEAM_STORAGE storage,
+                             double db_range) {
   std::string buff_start(buff.begin(), buff.end());
   buff_start = buff_start.substr(0, 6);
 
   if (buff[0] == 'A' && buff[1] == 'C' && buff[2] == 'B' && buff[3] == '2' &&
       buff.size() >= sizeof(Header)) {
     this->header = Header(buff);
-    this->unpack_data(buff);
+    this->unpack_data(buff, storage, db_range);
   } else {
     log_invalid_buffer(buff_start);
   }
 }
 
-bool UdpBeamform2D::unpack_data(std::vector<int8_t> &buff) {
+bool UdpBeamform2D::unpack_data(std::vector<int8_t> &buff, BEAM_STORAGE storage,
+                                double db_range) {
 
   // set the offset to skip over the primary packet's header
   size_t offset = sizeof(Header);
@@ -191,10 +257,12 @@ bool UdpBeamform2D::unpack_data(std::vector<int8_t> &buff) {
   offset += sizeof(double) * this->header.num_elevations;
 
   // Load the beampattern itself
-  this->data.beampattern =
-      Eigen::Map<Eigen::MatrixXd>(reinterpret_cast<double *>(buff.data() + offset),
-                                  this->header.num_elevations, this->header.num_bearings)
-          .transpose();
+  store_beampattern(this->data,
+                    Eigen::Map<Eigen::MatrixXd>(reinterpret_cast<double *>(buff.data() + offset),
+                                                this->header.num_elevations,
+                                                this->header.num_bearings)
+                        .transpose(),
+                    storage, db_range);
 
   return true;
 }
@@ -261,8 +329,10 @@ std::vector<int8_t> UdpBeamform2D::encode() {
   size_t sz_bearings_rad = d.bearings_rad.size() * sizeof(d.bearings_rad(0));
   size_t sz_elevations_rad = d.elevations_rad.size() * sizeof(d.elevations_rad(0));
 
-  size_t sz_beampattern_items = d.beampattern.size();
-  size_t sz_beampattern_val = sizeof(d.beampattern(0, 0));
+  // on the wire as float64, elevation-major
+  Eigen::MatrixXd mm = this->get_beampattern().transpose();
+  size_t sz_beampattern_items = mm.size();
+  size_t sz_beampattern_val = sizeof(double);
   size_t sz_beampattern = sz_beampattern_items * sz_beampattern_val;
 
   size_t sz_all = sz_header + sz_coords * 3 + sz_frequencies + sz_element_mask +
@@ -297,13 +367,74 @@ std::vector<int8_t> UdpBeamform2D::encode() {
   std::memcpy(buff.data() + offset, d.elevations_rad.data(), sz_elevations_rad);
   offset += sz_elevations_rad;
 
-  Eigen::MatrixXd mm = d.beampattern.transpose();
   std::memcpy(buff.data() + offset, mm.data(), sz_beampattern);
 
   return buff;
 }
 
-Eigen::MatrixXd UdpBeamform2D::get_1D() { return this->data.beampattern.rowwise().mean(); }
+Eigen::MatrixXd UdpBeamform2D::get_1D() {
+  return visit_beampattern(this->data,
+                           [](const auto &bp) -> Eigen::MatrixXd { return bp.rowwise().mean(); });
+}
+
+void UdpBeamform2D::set_storage(BEAM_STORAGE storage, double db_range) {
+  if (storage == this->data.storage)
+    return;
+  if (this->data.storage == BEAM_STORAGE::FLOAT64) {
+    store_beampattern(this->data, this->data.beampattern, storage, db_range);
+  } else {
+    store_beampattern(this->data, this->get_beampattern(), storage, db_range);
+  }
+}
+
+Eigen::MatrixXd UdpBeamform2D::get_beampattern() const {
+  return visit_beampattern(this->data, [](const auto &bp) -> Eigen::MatrixXd { return bp; });
+}
+
+Eigen::Index UdpBeamform2D::beampattern_rows() const {
+  return visit_beampattern(this->data, [](const auto &bp) { return bp.rows(); });
+}
+
+Eigen::Index UdpBeamform2D::beampattern_cols() const {
+  return visit_beampattern(this->data, [](const auto &bp) { return bp.cols(); });
+}
+
+size_t UdpBeamform2D::beampattern_bytes() const {
+  const Payload &d = this->data;
+  return d.beampattern.size() * sizeof(double) + d.beampattern_f32.size() * sizeof(float) +
+         d.beampattern_f16.size() * sizeof(Eigen::half) + d.beampattern_u8.size();
+}
+
+void UdpBeamform2D::reduce_elevation(Eigen::Ref<Eigen::VectorXd> line,
+                                     BTR_REDUCTION reduction) const {
+  visit_beampattern(this->data, [&line, reduction](const auto &bp) {
+    if (line.size() != bp.rows()) {
+      LOG(WARNING) << "Cannot reduce beampattern with " << bp.rows() << " bearings into "
+                   << line.size();
+      return;
+    }
+    if (bp.cols() == 0) {
+      line.setConstant(-std::numeric_limits<double>::infinity());
+      return;
+    }
+    switch (reduction) {
+    case BTR_REDUCTION::MEAN:
+      line.noalias() = bp.rowwise().sum() / (double)bp.cols();
+      break;
+    case BTR_REDUCTION::MAX:
+      line.noalias() = bp.rowwise().maxCoeff();
+      break;
+    case BTR_REDUCTION::POWER_SUM_DB:
+      // relative to each bearing's max, so large levels do not overflow
+      for (Eigen::Index ii = 0; ii < bp.rows(); ii++) {
+        double peak = bp.row(ii).maxCoeff();
+        line[ii] =
+            peak + 10 * std::log10(((bp.row(ii).array() - peak) * (M_LN10 / 10)).exp().sum());
+      }
+      break;
+    }
+  });
+}
 
 std::ostream &operator<<(std::ostream &os, const UdpBeamform2D::Header &st) {
   std::ostringstream oss;
@@ -395,8 +526,8 @@ std::ostringstream &operator<<(std::ostringstream &os, const UdpBeamform2D &st)
   os << std::left << std::setw(width) << std::setfill('.') << "ELEVATIONS"
      << ": (" << st.data.elevations_rad.size() << ")" << std::endl;
 
-  int beam_d1 = st.data.beampattern.rows();
-  int beam_d2 = st.data.beampattern.cols();
+  int beam_d1 = st.beampattern_rows();
+  int beam_d2 = st.beampattern_cols();
 
   os << std::left << std::setw(width) << std::setfill('.') << "BEAMPATTERN"
      << ": (" << beam_d1 << " x " << beam_d2 << ")" << std::endl
@@ -485,8 +616,8 @@ std::ostringstream &operator<<(std::ostringstream &os, const UdpBeamform2D::Payl
   /*===============================*/
   /*===============================*/
 
-  int beam_d1 = st.beampattern.rows();
-  int beam_d2 = st.beampattern.cols();
+  int beam_d1 = visit_beampattern(st, [](const auto &bp) { return bp.rows(); });
+  int beam_d2 = visit_beampattern(st, [](const auto &bp) { return bp.cols(); });
 
   os << std::left << std::setw(width) << std::setfill('.') << "BEAMPATTERN"
      << ": (" << beam_d1 << " x " << beam_d2 << ")" << std::endl
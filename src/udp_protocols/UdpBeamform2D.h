@@ -14,6 +14,21 @@
 
 #include "UdpData.h"
 
+// Reduction of a beampattern over elevation into one bearing-time record (BTR) line.
+// POWER_SUM_DB reads the beampattern as dB and sums power: 10 log10(sum 10^(b / 10)).
+enum class BTR_REDUCTION { MEAN, MAX, POWER_SUM_DB };
+
+// In-memory storage of the beampattern (the wire format is always float64):
+//  FLOAT64      : Payload::beampattern (the default)
+//  FLOAT32      : Payload::beampattern_f32, 1/2 the size
+//  FLOAT16      : Payload::beampattern_f16 (IEEE half), 1/4; ~3 significant digits
+//  DB_U8        : Payload::beampattern_u8, 1/8; reads the beampattern as dB and quantizes
+//                 the top db_range of each frame into 256 levels (lower values clip)
+// Compact modes leave Payload::beampattern empty; get_beampattern() converts on demand.
+enum class BEAM_STORAGE { FLOAT64, FLOAT32, FLOAT16, DB_U8 };
+// dB kept by DB_U8 storage unless a caller asks otherwise (~16 bit dynamic range)
+constexpr double BEAM_DB_U8_RANGE = 96;
+
 struct UdpBeamform2D : public UdpData {
   struct __attribute__((__packed__)) Header {
     char id[2];
@@ -92,13 +107,35 @@ struct UdpBeamform2D : public UdpData {
 
     Eigen::MatrixXd beampattern;
 
+    BEAM_STORAGE storage = BEAM_STORAGE::FLOAT64;
+    Eigen::MatrixXf beampattern_f32;
+    Eigen::MatrixX<Eigen::half> beampattern_f16;
+    Eigen::MatrixX<uint8_t> beampattern_u8; // dB = db_min + db_step * value
+    float db_min = 0;
+    float db_step = 0;
+
   } data;
 
   UdpBeamform2D();
-  UdpBeamform2D(std::vector<int8_t> &buff);
-  bool unpack_data(std::vector<int8_t> &buff);
+  UdpBeamform2D(std::vector<int8_t> &buff, BEAM_STORAGE storage = BEAM_STORAGE::FLOAT64,
+                double db_range = BEAM_DB_U8_RANGE);
+  // decodes the beampattern straight into the given storage
+  bool unpack_data(std::vector<int8_t> &buff, BEAM_STORAGE storage = BEAM_STORAGE::FLOAT64,
+                   double db_range = BEAM_DB_U8_RANGE);
   std::vector<int8_t> encode();
+
+  // Convert the beampattern to another storage mode (DB_U8 keeps db_range dB)
+  void set_storage(BEAM_STORAGE storage, double db_range = BEAM_DB_U8_RANGE);
+  BEAM_STORAGE get_storage() const { return this->data.storage; }
+  // The beampattern as double, whatever the storage (a copy)
+  Eigen::MatrixXd get_beampattern() const;
+  Eigen::Index beampattern_rows() const;
+  Eigen::Index beampattern_cols() const;
+  size_t beampattern_bytes() const;
   Eigen::MatrixXd get_1D();
+  // Same, into a preallocated line of num_bearings (e.g. one column of a BTR buffer)
+  void reduce_elevation(Eigen::Ref<Eigen::VectorXd> line,
+                        BTR_REDUCTION reduction = BTR_REDUCTION::MEAN) const;
 };
 
 std::ostream &operator<<(std::ostream &os, const UdpBeamform2D &st);
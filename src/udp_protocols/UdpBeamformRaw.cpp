@@ -451,6 +451,55 @@ std::vector<int8_t> UdpBeamformRaw::encode() {
   return buff;
 }
 
+std::vector<std::vector<int8_t>> UdpBeamformRaw::encode_datagrams(size_t max_datagram_bytes) {
+  const size_t contd_header_size = 4 + sizeof(int32_t) * 2;
+  std::vector<std::vector<int8_t>> datagrams;
+  if (max_datagram_bytes <= sizeof(Header)) {
+    LOG(ERROR) << "Datagram size must exceed the " << sizeof(Header) << " byte ACBR header";
+    return datagrams;
+  }
+
+  std::vector<int8_t> full = this->encode();
+  size_t payload_size = full.size() - sizeof(Header);
+  size_t primary_payload = std::min(payload_size, max_datagram_bytes - sizeof(Header));
+  size_t contd_payload = max_datagram_bytes - contd_header_size;
+  size_t num_subpackets =
+      1 + (payload_size - primary_payload + contd_payload - 1) / contd_payload;
+
+  // the primary header announces how many sub-packets make up this series
+  Header _header = this->header;
+  _header.sid[0] = 'B';
+  _header.sid[1] = 'R';
+  _header.num_subpackets = num_subpackets;
+  std::vector<int8_t> header_buff = _header.encode();
+  std::memcpy(full.data(), header_buff.data(), sizeof(Header));
+
+  datagrams.reserve(num_subpackets);
+  datagrams.push_back(
+      std::vector<int8_t>(full.begin(), full.begin() + sizeof(Header) + primary_payload));
+
+  size_t offset = sizeof(Header) + primary_payload;
+  for (int32_t ii = 1; ii < (int32_t)num_subpackets; ii++) {
+    size_t nn = std::min(contd_payload, full.size() - offset);
+    // ACBC header: ID + sub-packet index + packet number, big endian like the primary
+    int32_t index_buff = bswap_32(ii);
+    int32_t packet_num_buff = bswap_32(this->header.packet_num);
+
+    std::vector<int8_t> buff(contd_header_size + nn);
+    buff[0] = 'A';
+    buff[1] = 'C';
+    buff[2] = 'B';
+    buff[3] = 'C';
+    std::memcpy(buff.data() + 4, &index_buff, sizeof(index_buff));
+    std::memcpy(buff.data() + 4 + sizeof(index_buff), &packet_num_buff, sizeof(packet_num_buff));
+    std::memcpy(buff.data() + contd_header_size, full.data() + offset, nn);
+    offset += nn;
+
+    datagrams.push_back(std::move(buff));
+  }
+  return datagrams;
+}
+
 std::ostream &operator<<(std::ostream &os, const UdpBeamformRaw::Header &st) {
   std::ostringstream oss;
   oss << st;
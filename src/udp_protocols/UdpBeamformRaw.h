@@ -107,6 +107,9 @@ struct UdpBeamformRaw : public UdpData {
   bool add_cont_packet(std::vector<int8_t> &buff, int32_t index);
   bool unpack_data();
   std::vector<int8_t> encode();
+  // Split encode() into an ACBR primary packet plus ACBC continuation packets,
+  // none larger than `max_datagram_bytes`
+  std::vector<std::vector<int8_t>> encode_datagrams(size_t max_datagram_bytes = 65000);
 
 protected:
   std::vector<std::vector<int8_t>> binary_payload;
@@ -8,6 +8,7 @@
 /*******************************************************************/
 
 #include <byteswap.h>
+#include <cmath>
 #include <cstring>
 #include <glog/logging.h>
 #include <iomanip>
@@ -68,14 +69,43 @@ bool UdpBnoData::unpack_data(std::vector<int8_t> &buff) {
   return true;
 }
 
+std::vector<int8_t> UdpBnoData::encode() {
+  Header _header = this->header;
+  _header.id[0] = 'B';
+  _header.id[1] = 'N';
+  _header.num_bytes = 8;
+
+  std::vector<int8_t> buff = _header.encode();
+  size_t offset = sizeof(Header);
+  buff.resize(offset + 8);
+
+  char sense_key = this->sense_char;
+  int16_t sense_x = std::round(this->sense_x * (1 << 8));
+  int16_t sense_y = std::round(this->sense_y * (1 << 8));
+  int16_t sense_z = std::round(this->sense_z * (1 << 8));
+
+  std::memcpy(buff.data() + offset, &sense_key, sizeof(sense_key));
+  offset += sizeof(sense_key);
+  std::memcpy(buff.data() + offset, &this->status, sizeof(this->status));
+  offset += sizeof(this->status);
+  std::memcpy(buff.data() + offset, &sense_x, sizeof(sense_x));
+  offset += sizeof(sense_x);
+  std::memcpy(buff.data() + offset, &sense_y, sizeof(sense_y));
+  offset += sizeof(sense_y);
+  std::memcpy(buff.data() + offset, &sense_z, sizeof(sense_z));
+  offset += sizeof(sense_z);
+
+  return buff;
+}
+
 void UdpBnoData::csv_header(std::ostream &oss) {
   oss << "host_epoch_sec,data_epoch_nsec,sense_type,status,sense_x,sense_y,sense_z" << std::endl;
 }
 
-void UdpBnoData::csv_serialize(std::ostream &oss) {
-  oss << std::time(nullptr) << "," << std::fixed << this->header.start_time_nsec << ","
-      << (char)this->sense_char << "," << (int)this->status << "," << this->sense_x << ","
-      << this->sense_y << "," << this->sense_z << std::endl;
+void UdpBnoData::csv_serialize(CsvWriter &csv) {
+  csv.put(std::time(nullptr)).sep().put(this->header.start_time_nsec).sep();
+  csv.put((char)this->sense_char).sep().put((int)this->status).sep();
+  csv.put(this->sense_x).sep().put(this->sense_y).sep().put(this->sense_z).eol();
 }
 
 std::ostream &operator<<(std::ostream &os, const UdpBnoData &st) {
@@ -8,6 +8,7 @@
 /*******************************************************************/
 
 #include <byteswap.h>
+#include <cmath>
 #include <cstring>
 #include <glog/logging.h>
 #include <iomanip>
@@ -65,14 +66,46 @@ bool UdpBnrData::unpack_data(std::vector<int8_t> &buff) {
   return true;
 }
 
+std::vector<int8_t> UdpBnrData::encode() {
+  Header _header = this->header;
+  _header.id[0] = 'B';
+  _header.id[1] = 'R';
+  _header.num_bytes = 11;
+
+  std::vector<int8_t> buff = _header.encode();
+  size_t offset = sizeof(Header);
+  buff.resize(offset + 11);
+
+  int16_t quat_i = std::round(this->quat_i * (1 << 14));
+  int16_t quat_j = std::round(this->quat_j * (1 << 14));
+  int16_t quat_k = std::round(this->quat_k * (1 << 14));
+  int16_t quat_r = std::round(this->quat_r * (1 << 14));
+  int16_t accuracy = std::round(this->accuracy * (1 << 12));
+
+  std::memcpy(buff.data() + offset, &this->status, sizeof(this->status));
+  offset += sizeof(this->status);
+  std::memcpy(buff.data() + offset, &quat_i, sizeof(quat_i));
+  offset += sizeof(quat_i);
+  std::memcpy(buff.data() + offset, &quat_j, sizeof(quat_j));
+  offset += sizeof(quat_j);
+  std::memcpy(buff.data() + offset, &quat_k, sizeof(quat_k));
+  offset += sizeof(quat_k);
+  std::memcpy(buff.data() + offset, &quat_r, sizeof(quat_r));
+  offset += sizeof(quat_r);
+  std::memcpy(buff.data() + offset, &accuracy, sizeof(accuracy));
+  offset += sizeof(accuracy);
+
+  return buff;
+}
+
 void UdpBnrData::csv_header(std::ostream &oss) {
   oss << "host_epoch_sec,data_epoch_nsec,status,quat_i,quat_j,quat_k,quat_r,accuracy" << std::endl;
 }
 
-void UdpBnrData::csv_serialize(std::ostream &oss) {
-  oss << std::time(nullptr) << "," << std::fixed << this->header.start_time_nsec << ","
-      << (int)this->status << "," << this->quat_i << "," << this->quat_j << "," << this->quat_k
-      << "," << this->quat_r << "," << this->accuracy << std::endl;
+void UdpBnrData::csv_serialize(CsvWriter &csv) {
+  csv.put(std::time(nullptr)).sep().put(this->header.start_time_nsec).sep();
+  csv.put((int)this->status).sep().put(this->quat_i).sep().put(this->quat_j).sep();
+  csv.put(this->quat_k).sep().put(this->quat_r).sep().put(this->accuracy).eol();
 }
 
 std::ostream &operator<<(std::ostream &os, const UdpBnrData &st) {
@@ -45,6 +45,23 @@ void UdpData::Header::decode(std::vector<int8_t> &buff) {
   this->num_bytes = num_bytes;
 }
 
+std::vector<int8_t> UdpData::Header::encode() {
+  std::vector<int8_t> buff(sizeof(Header));
+  auto buff_raw = buff.data();
+
+  size_t offset = 0;
+  int64_t start_time_10nsec = this->start_time_nsec / 10;
+  std::memcpy(buff_raw + offset, &start_time_10nsec, sizeof(start_time_10nsec));
+  offset += sizeof(start_time_10nsec);
+
+  buff[offset] = this->id[0];
+  buff[offset + 1] = this->id[1];
+  offset += 2;
+
+  std::memcpy(buff_raw + offset, &this->num_bytes, sizeof(this->num_bytes));
+  return buff;
+}
+
 UdpData::UdpData(std::vector<int8_t> &buff) {
   std::string buff_start(buff.begin(), buff.end());
   buff_start = buff_start.substr(0, 6);
@@ -63,13 +80,22 @@ bool UdpData::unpack_data(std::vector<int8_t> &buff) {
   return false;
 }
 
+std::vector<int8_t> UdpData::encode() { return this->header.encode(); }
+
 void UdpData::csv_header(std::ostream &oss) {
   oss << "host_epoch_sec,data_epoch_nsec,header_ID,header_numBytes" << std::endl;
 }
 
+void UdpData::csv_serialize(CsvWriter &csv) {
+  csv.put(std::time(nullptr)).sep().put(this->header.start_time_nsec).sep();
+  csv.put(this->header.id[0]).put(this->header.id[1]).sep().put(this->header.num_bytes).eol();
+}
+
 void UdpData::csv_serialize(std::ostream &oss) {
-  oss << std::time(nullptr) << "," << std::fixed << this->header.start_time_nsec << ","
-      << this->header.id[0] << this->header.id[1] << "," << this->header.num_bytes << std::endl;
+  // convenience path for one-off rows; loggers should batch rows into a shared CsvWriter
+  CsvWriter csv(256);
+  this->csv_serialize(csv);
+  csv.write_to(oss);
 }
 
 void UdpData::log_invalid_buffer(std::string &buff_start) {
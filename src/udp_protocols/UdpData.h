@@ -12,6 +12,10 @@
 
 #include <gflags/gflags.h>
 
+// includes from within project
+#include "utils/CsvWriter.h"
+#include "utils/LatencyTracker.h"
+
 DECLARE_bool(debug_udp_data);
 
 struct UdpData {
@@ -28,13 +32,19 @@ struct UdpData {
     };
     Header(std::vector<int8_t> &buff);
     void decode(std::vector<int8_t> &buff);
+    std::vector<int8_t> encode();
   } header;
+  // host-side pipeline timestamps; not part of the datagram
+  StageTimes stage_times;
 
   UdpData();
   UdpData(std::vector<int8_t> &buff);
   virtual bool unpack_data(std::vector<int8_t> &buff);
+  // Serialize to the on-wire datagram format; the generic form carries the header only
+  virtual std::vector<int8_t> encode();
   virtual void csv_header(std::ostream &oss);
-  virtual void csv_serialize(std::ostream &oss);
+  virtual void csv_serialize(CsvWriter &csv);
+  void csv_serialize(std::ostream &oss);
 
   void log_invalid_buffer(std::string &buff_start);
 };
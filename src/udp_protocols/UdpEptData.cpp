@@ -8,6 +8,7 @@
 /*******************************************************************/
 
 #include <byteswap.h>
+#include <cmath>
 #include <cstring>
 #include <glog/logging.h>
 #include <iomanip>
@@ -54,13 +55,36 @@ bool UdpEptData::unpack_data(std::vector<int8_t> &buff) {
   return true;
 }
 
+std::vector<int8_t> UdpEptData::encode() {
+  // "EP" packets carry pressure in mbar x10, "ED" in mbar x100
+  Header _header = this->header;
+  _header.id[0] = 'E';
+  _header.id[1] = this->header.id[1] == 'D' ? 'D' : 'P';
+  _header.num_bytes = 8;
+  int mbar_coeff = _header.id[1] == 'D' ? 100 : 10;
+
+  std::vector<int8_t> buff = _header.encode();
+  size_t offset = sizeof(Header);
+  buff.resize(offset + 8);
+
+  u_int32_t pressure_mbar_xN = std::round(this->pressure_mbar * mbar_coeff);
+  int32_t temperature_c_x100 = std::round(this->temperature_c * 100.0);
+
+  std::memcpy(buff.data() + offset, &pressure_mbar_xN, sizeof(pressure_mbar_xN));
+  offset += sizeof(pressure_mbar_xN);
+  std::memcpy(buff.data() + offset, &temperature_c_x100, sizeof(temperature_c_x100));
+  offset += sizeof(temperature_c_x100);
+
+  return buff;
+}
+
 void UdpEptData::csv_header(std::ostream &oss) {
   oss << "host_epoch_sec,data_epoch_nsec,pressure_mbar,temperature_C" << std::endl;
 }
 
-void UdpEptData::csv_serialize(std::ostream &oss) {
-  oss << std::time(nullptr) << "," << std::fixed << this->header.start_time_nsec << ","
-      << this->pressure_mbar << "," << this->temperature_c << std::endl;
+void UdpEptData::csv_serialize(CsvWriter &csv) {
+  csv.put(std::time(nullptr)).sep().put(this->header.start_time_nsec).sep();
+  csv.put(this->pressure_mbar).sep().put(this->temperature_c).eol();
 }
 
 std::ostream &operator<<(std::ostream &os, const UdpEptData &st) {
@@ -8,6 +8,7 @@
 /*******************************************************************/
 
 #include <byteswap.h>
+#include <cmath>
 #include <cstring>
 #include <glog/logging.h>
 #include <iomanip>
@@ -64,8 +65,8 @@ bool UdpImuData::unpack_data(std::vector<int8_t> &buff) {
   std::memcpy(&gyro_z, buff.data() + offset, sizeof(gyro_z));
   offset += sizeof(gyro_z);
 
-  this->pitch_ned_deg = pitch_ned_deg / 100.0;
-  this->roll_ned_deg = roll_ned_deg / 100.0;
+  this->pitch_ned_deg = pitch_ned_deg_x100 / 100.0;
+  this->roll_ned_deg = roll_ned_deg_x100 / 100.0;
 
   this->accel_x = accel_x;
   this->accel_y = accel_y;
@@ -78,14 +79,49 @@ bool UdpImuData::unpack_data(std::vector<int8_t> &buff) {
   return true;
 }
 
+std::vector<int8_t> UdpImuData::encode() {
+  Header _header = this->header;
+  _header.id[0] = 'I';
+  _header.id[1] = 'M';
+  _header.num_bytes = 20;
+
+  std::vector<int8_t> buff = _header.encode();
+  size_t offset = sizeof(Header);
+  buff.resize(offset + 20);
+
+  int32_t pitch_ned_deg_x100 = std::round(this->pitch_ned_deg * 100.0);
+  int32_t roll_ned_deg_x100 = std::round(this->roll_ned_deg * 100.0);
+
+  std::memcpy(buff.data() + offset, &pitch_ned_deg_x100, sizeof(pitch_ned_deg_x100));
+  offset += sizeof(pitch_ned_deg_x100);
+  std::memcpy(buff.data() + offset, &roll_ned_deg_x100, sizeof(roll_ned_deg_x100));
+  offset += sizeof(roll_ned_deg_x100);
+
+  std::memcpy(buff.data() + offset, &this->accel_x, sizeof(this->accel_x));
+  offset += sizeof(this->accel_x);
+  std::memcpy(buff.data() + offset, &this->accel_y, sizeof(this->accel_y));
+  offset += sizeof(this->accel_y);
+  std::memcpy(buff.data() + offset, &this->accel_z, sizeof(this->accel_z));
+  offset += sizeof(this->accel_z);
+
+  std::memcpy(buff.data() + offset, &this->gyro_x, sizeof(this->gyro_x));
+  offset += sizeof(this->gyro_x);
+  std::memcpy(buff.data() + offset, &this->gyro_y, sizeof(this->gyro_y));
+  offset += sizeof(this->gyro_y);
+  std::memcpy(buff.data() + offset, &this->gyro_z, sizeof(this->gyro_z));
+  offset += sizeof(this->gyro_z);
+
+  return buff;
+}
+
 void UdpImuData::csv_header(std::ostream &oss) {
   oss << "host_epoch_sec,data_epoch_nsec,accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z" << std::endl;
 }
 
-void UdpImuData::csv_serialize(std::ostream &oss) {
-  oss << std::time(nullptr) << "," << std::fixed << this->header.start_time_nsec << ","
-      << this->accel_x << "," << this->accel_y << "," << this->accel_z << "," << this->gyro_x << ","
-      << this->gyro_y << "," << this->gyro_z << std::endl;
+void UdpImuData::csv_serialize(CsvWriter &csv) {
+  csv.put(std::time(nullptr)).sep().put(this->header.start_time_nsec).sep();
+  csv.put(this->accel_x).sep().put(this->accel_y).sep().put(this->accel_z).sep();
+  csv.put(this->gyro_x).sep().put(this->gyro_y).sep().put(this->gyro_z).eol();
 }
 
 std::ostream &operator<<(std::ostream &os, const UdpImuData &st) {
@@ -8,6 +8,7 @@
 /*******************************************************************/
 
 #include <byteswap.h>
+#include <cmath>
 #include <cstring>
 #include <glog/logging.h>
 #include <iomanip>
@@ -49,13 +50,34 @@ bool UdpPtsData::unpack_data(std::vector<int8_t> &buff) {
   return true;
 }
 
+std::vector<int8_t> UdpPtsData::encode() {
+  Header _header = this->header;
+  _header.id[0] = 'P';
+  _header.id[1] = 'T';
+  _header.num_bytes = 8;
+
+  std::vector<int8_t> buff = _header.encode();
+  size_t offset = sizeof(Header);
+  buff.resize(offset + 8);
+
+  u_int32_t pressure_mbar_x100 = std::round(this->pressure_mbar * 100.0);
+  int32_t temperature_c_x100 = std::round(this->temperature_c * 100.0);
+
+  std::memcpy(buff.data() + offset, &pressure_mbar_x100, sizeof(pressure_mbar_x100));
+  offset += sizeof(pressure_mbar_x100);
+  std::memcpy(buff.data() + offset, &temperature_c_x100, sizeof(temperature_c_x100));
+  offset += sizeof(temperature_c_x100);
+
+  return buff;
+}
+
 void UdpPtsData::csv_header(std::ostream &oss) {
   oss << "host_epoch_sec,data_epoch_nsec,pressure_mbar,temperature_C" << std::endl;
 }
 
-void UdpPtsData::csv_serialize(std::ostream &oss) {
-  oss << std::time(nullptr) << "," << std::fixed << this->header.start_time_nsec << ","
-      << this->pressure_mbar << "," << this->temperature_c << std::endl;
+void UdpPtsData::csv_serialize(CsvWriter &csv) {
+  csv.put(std::time(nullptr)).sep().put(this->header.start_time_nsec).sep();
+  csv.put(this->pressure_mbar).sep().put(this->temperature_c).eol();
 }
 
 std::ostream &operator<<(std::ostream &os, const UdpPtsData &st) {
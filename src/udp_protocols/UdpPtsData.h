@@ -20,8 +20,10 @@ struct UdpPtsData : UdpData {
   UdpPtsData() {};
   UdpPtsData(std::vector<int8_t> &buff);
   bool unpack_data(std::vector<int8_t> &buff);
+  std::vector<int8_t> encode();
   void csv_header(std::ostream &oss);
-  void csv_serialize(std::ostream &oss);
+  using UdpData::csv_serialize;
+  void csv_serialize(CsvWriter &csv);
 };
 
 std::ostream &operator<<(std::ostream &os, const UdpPtsData &st);
@@ -8,6 +8,7 @@
 /*******************************************************************/
 
 #include <byteswap.h>
+#include <cmath>
 #include <cstring>
 #include <glog/logging.h>
 #include <iomanip>
@@ -61,13 +62,40 @@ bool UdpRtcData::unpack_data(std::vector<int8_t> &buff) {
   return true;
 }
 
+std::vector<int8_t> UdpRtcData::encode() {
+  Header _header = this->header;
+  _header.id[0] = 'R';
+  _header.id[1] = 'T';
+  _header.num_bytes = 8;
+
+  std::vector<int8_t> buff = _header.encode();
+  size_t offset = sizeof(Header);
+  buff.resize(offset + 8);
+
+  // BCD-coded fields, as sent by the RTC: sec, min, hour, weekday, day, month, year
+  std::tm time = *std::gmtime(&this->rtc_time);
+  auto to_bcd = [](int val) { return (int8_t)(((val / 10) << 4) | (val % 10)); };
+
+  buff[offset + 0] = to_bcd(time.tm_sec);
+  buff[offset + 1] = to_bcd(time.tm_min);
+  buff[offset + 2] = to_bcd(time.tm_hour);
+  buff[offset + 3] = to_bcd(time.tm_wday);
+  buff[offset + 4] = to_bcd(time.tm_mday);
+  buff[offset + 5] = to_bcd(time.tm_mon + 1);
+  buff[offset + 6] = to_bcd(time.tm_year % 100);
+  buff[offset + 7] = 0;
+  offset += 8;
+
+  return buff;
+}
+
 void UdpRtcData::csv_header(std::ostream &oss) {
   oss << "host_epoch_sec,data_epoch_nsec,rtc_time" << std::endl;
 }
 
-void UdpRtcData::csv_serialize(std::ostream &oss) {
-  oss << std::time(nullptr) << "," << std::fixed << this->header.start_time_nsec << ","
-      << this->rtc_time << std::endl;
+void UdpRtcData::csv_serialize(CsvWriter &csv) {
+  csv.put(std::time(nullptr)).sep().put(this->header.start_time_nsec).sep();
+  csv.put((int64_t)this->rtc_time).eol();
 }
 
 std::ostream &operator<<(std::ostream &os, const UdpRtcData &st) {
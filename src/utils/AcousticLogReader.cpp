@@ -0,0 +1,554 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: AcousticLogReader.cpp                                  */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <glog/logging.h>
+#include <map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// includes from within project
+#include "utils/AcousticLogReader.h"
+#include "utils/UdpSocketIn.h"
+
+DEFINE_bool(debug_acoustic_log_reader, false, "Enable expanded debug for the acoustic log reader");
+
+// leading columns of a Logger_Acoustic_CSV row, before the channels
+static const int CSV_META_COLUMNS = 6;
+
+static LOGGER format_of(const std::filesystem::path &path) {
+  std::string ext = path.extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  if (ext == ".wav")
+    return LOGGER::ACO_WAV;
+  if (ext == ".flac")
+    return LOGGER::ACO_FLAC;
+  if (ext == ".csv")
+    return LOGGER::ACO_CSV;
+  return LOGGER::UNKNOWN;
+}
+
+// ACO_<%Y%m%d-%H%M%S>... (UTC, see FilenameTime); -1 when the name holds no time
+static int64_t filename_time_nsec(const std::string &path) {
+  std::string name = std::filesystem::path(path).filename().string();
+  size_t pos = name.find("ACO_");
+  if (pos == std::string::npos || name.size() < pos + 4 + 15) {
+    return -1;
+  }
+  std::tm tm = {};
+  const char *end = strptime(name.substr(pos + 4, 15).c_str(), "%Y%m%d-%H%M%S", &tm);
+  if (end == nullptr || *end != '\0') {
+    return -1;
+  }
+  return (int64_t)timegm(&tm) * 1000000000;
+}
+
+template <typename T> static T read_le(const char *ptr) {
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+AcousticLogReader::Source::~Source() {
+  if (this->map != nullptr) {
+    munmap((void *)this->map, this->map_bytes);
+  }
+}
+
+bool AcousticLogReader::open(const std::string &path, LOGGER format) {
+  this->close();
+
+  std::error_code ec;
+  std::vector<std::string> files;
+  if (std::filesystem::is_directory(path, ec)) {
+    std::map<LOGGER, std::vector<std::string>> by_format;
+    for (auto &entry : std::filesystem::directory_iterator(path, ec)) {
+      if (entry.is_regular_file(ec)) {
+        by_format[format_of(entry.path())].push_back(entry.path().string());
+      }
+    }
+    if (format == LOGGER::UNKNOWN) {
+      for (LOGGER L : {LOGGER::ACO_WAV, LOGGER::ACO_FLAC, LOGGER::ACO_CSV}) {
+        if (!by_format[L].empty()) {
+          format = L;
+          break;
+        }
+      }
+    }
+    files = by_format[format];
+  } else {
+    format = format == LOGGER::UNKNOWN ? format_of(path) : format;
+    files.push_back(path);
+  }
+  if (files.empty() || format == LOGGER::UNKNOWN) {
+    LOG(WARNING) << "No acoustic logs found at " << path;
+    return false;
+  }
+  // names carry the file's start time, so name order is time order
+  std::sort(files.begin(), files.end());
+  this->format = format;
+
+  if (format == LOGGER::ACO_FLAC) {
+    // ACO_<time>_<n>.flac : the channel groups of one recording, in n order
+    std::map<std::string, std::map<int, std::string>> groups;
+    for (auto &file : files) {
+      std::string stem = std::filesystem::path(file).stem().string();
+      size_t pos = stem.rfind('_');
+      int part = 0;
+      if (pos != std::string::npos && pos + 1 < stem.size() &&
+          std::all_of(stem.begin() + pos + 1, stem.end(), ::isdigit)) {
+        part = std::stoi(stem.substr(pos + 1));
+        stem = stem.substr(0, pos);
+      }
+      groups[(std::filesystem::path(file).parent_path() / stem).string()][part] = file;
+    }
+    for (auto &group : groups) {
+      std::vector<std::string> paths;
+      for (auto &part : group.second) {
+        paths.push_back(part.second);
+      }
+      this->add_flac(paths);
+    }
+  } else {
+    for (auto &file : files) {
+      if (format == LOGGER::ACO_WAV) {
+        this->add_wav(file);
+      } else {
+        this->add_csv(file);
+      }
+    }
+  }
+
+  if (this->sources.empty()) {
+    LOG(WARNING) << "No readable acoustic logs at " << path;
+    this->close();
+    return false;
+  }
+  if (FLAGS_debug_acoustic_log_reader) {
+    VLOG(3) << "Opened " << this->sources.size() << " " << LOGGER_NAME[format] << " files at "
+            << path << " : " << this->num_samples << " samples of " << this->num_channels
+            << " channels at " << this->sample_rate << " Hz";
+  }
+  return true;
+}
+
+void AcousticLogReader::close() {
+  this->sources.clear();
+  this->format = LOGGER::UNKNOWN;
+  this->num_samples = 0;
+  this->num_channels = 0;
+  this->sample_rate = 0;
+}
+
+bool AcousticLogReader::map_file(const std::string &path, Source &source) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(WARNING) << "Could not open " << path << " : " << std::strerror(errno);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+  void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping holds its own reference to the file
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    LOG(WARNING) << "Could not map " << path << " : " << std::strerror(errno);
+    return false;
+  }
+  source.map = (const char *)map;
+  source.map_bytes = st.st_size;
+  return true;
+}
+
+bool AcousticLogReader::add_wav(const std::string &path) {
+  auto source = std::make_unique<Source>();
+  if (!this->map_file(path, *source)) {
+    return false;
+  }
+  const char *map = source->map;
+  const size_t bytes = source->map_bytes;
+  if (bytes < 12 || std::memcmp(map, "RIFF", 4) != 0 || std::memcmp(map + 8, "WAVE", 4) != 0) {
+    LOG(WARNING) << path << " is not a WAV file";
+    return false;
+  }
+
+  int num_channels = 0;
+  int bits = 0;
+  double sample_rate = 0;
+  size_t data_offset = 0;
+  size_t data_bytes = 0;
+  for (size_t pos = 12; pos + 8 <= bytes;) {
+    uint32_t chunk_bytes = read_le<uint32_t>(map + pos + 4);
+    if (std::memcmp(map + pos, "fmt ", 4) == 0 && pos + 8 + 16 <= bytes) {
+      num_channels = read_le<uint16_t>(map + pos + 10);
+      sample_rate = read_le<uint32_t>(map + pos + 12);
+      bits = read_le<uint16_t>(map + pos + 22);
+    } else if (std::memcmp(map + pos, "data", 4) == 0) {
+      data_offset = pos + 8;
+      // a writer that never closed leaves the size unset; take the rest of the file
+      data_bytes = (chunk_bytes == 0 || chunk_bytes > bytes - data_offset) ? bytes - data_offset
+                                                                           : chunk_bytes;
+      break;
+    }
+    pos += 8 + (size_t)chunk_bytes + (chunk_bytes & 1);
+  }
+  if (data_offset == 0 || num_channels == 0 || bits != 16 || sample_rate <= 0 ||
+      data_offset % sizeof(int16_t) != 0) {
+    LOG(WARNING) << path << " is not a 16-bit PCM WAV file";
+    return false;
+  }
+
+  source->pcm = reinterpret_cast<const int16_t *>(map + data_offset);
+  source->segment.paths = {path};
+  source->segment.format = LOGGER::ACO_WAV;
+  source->segment.num_samples = data_bytes / (sizeof(int16_t) * num_channels);
+  source->segment.num_channels = num_channels;
+  source->segment.sample_rate = sample_rate;
+  source->segment.start_time_nsec = filename_time_nsec(path);
+  return this->add_source(std::move(source));
+}
+
+bool AcousticLogReader::add_csv(const std::string &path) {
+  auto source = std::make_unique<Source>();
+  if (!this->map_file(path, *source)) {
+    return false;
+  }
+  const char *map = source->map;
+  const char *end = map + source->map_bytes;
+
+  const char *eol = (const char *)std::memchr(map, '\n', end - map);
+  if (eol == nullptr) {
+    LOG(WARNING) << path << " has no CSV header";
+    return false;
+  }
+  int num_channels = std::count(map, eol, ',') + 1 - CSV_META_COLUMNS;
+  if (num_channels <= 0) {
+    LOG(WARNING) << path << " is not an acoustic CSV log";
+    return false;
+  }
+
+  // only complete rows; the last may have been cut short by the writer stopping
+  for (const char *row = eol + 1; row < end;) {
+    eol = (const char *)std::memchr(row, '\n', end - row);
+    if (eol == nullptr)
+      break;
+    if (eol > row)
+      source->rows.push_back(row - map);
+    row = eol + 1;
+  }
+  if (source->rows.empty()) {
+    LOG(WARNING) << path << " holds no samples";
+    return false;
+  }
+
+  // packet_epoch_nsec of the first row is the time of the first sample; the sample rate
+  // follows from the adc counts and their interpolated tick times
+  auto meta = [&](size_t row, int64_t &epoch_nsec, double &interp_nsec, int64_t &adc) {
+    char *ptr = const_cast<char *>(map + source->rows[row]);
+    std::strtoll(ptr, &ptr, 10);
+    epoch_nsec = std::strtoll(ptr + 1, &ptr, 10);
+    std::strtoull(ptr + 1, &ptr, 10);
+    interp_nsec = std::strtod(ptr + 1, &ptr);
+    adc = std::strtoll(ptr + 1, &ptr, 10);
+  };
+  int64_t epoch0, epoch1, adc0, adc1;
+  double interp0, interp1;
+  meta(0, epoch0, interp0, adc0);
+  meta(source->rows.size() - 1, epoch1, interp1, adc1);
+  double sample_rate =
+      (adc1 > adc0 && interp1 > interp0) ? (adc1 - adc0) * 1e9 / (interp1 - interp0) : 0;
+  if (sample_rate <= 0) {
+    sample_rate = this->default_sample_rate;
+  }
+  if (sample_rate <= 0) {
+    LOG(WARNING) << "Could not find the sample rate of " << path
+                 << "; see set_default_sample_rate()";
+    return false;
+  }
+
+  source->segment.paths = {path};
+  source->segment.format = LOGGER::ACO_CSV;
+  source->segment.num_samples = source->rows.size();
+  source->segment.num_channels = num_channels;
+  source->segment.sample_rate = sample_rate;
+  source->segment.start_time_nsec = epoch0;
+  return this->add_source(std::move(source));
+}
+
+bool AcousticLogReader::add_flac(const std::vector<std::string> &paths) {
+  auto source = std::make_unique<Source>();
+  size_t num_samples = SIZE_MAX;
+  double sample_rate = 0;
+  int num_channels = 0;
+  for (auto &path : paths) {
+    SndfileHandle flac(path, SFM_READ);
+    if (flac.error() || flac.channels() <= 0) {
+      LOG(WARNING) << "Could not open " << path << " : " << flac.strError();
+      return false;
+    }
+    if (sample_rate > 0 && flac.samplerate() != sample_rate) {
+      LOG(WARNING) << path << " does not match the sample rate of " << paths.front();
+      return false;
+    }
+    sample_rate = flac.samplerate();
+    num_samples = std::min(num_samples, (size_t)std::max<sf_count_t>(flac.frames(), 0));
+    num_channels += flac.channels();
+    source->flac_channels.push_back(flac.channels());
+    source->flac.push_back(flac);
+  }
+
+  source->segment.paths = paths;
+  source->segment.format = LOGGER::ACO_FLAC;
+  source->segment.num_samples = num_samples;
+  source->segment.num_channels = num_channels;
+  source->segment.sample_rate = sample_rate;
+  source->segment.start_time_nsec = filename_time_nsec(paths.front());
+  return this->add_source(std::move(source));
+}
+
+bool AcousticLogReader::add_source(std::unique_ptr<Source> source) {
+  AcousticLogSegment &segment = source->segment;
+  if (segment.num_samples == 0) {
+    LOG(WARNING) << segment.paths.front() << " holds no samples";
+    return false;
+  }
+  if (this->sources.empty()) {
+    this->num_channels = segment.num_channels;
+    this->sample_rate = segment.sample_rate;
+  } else if (segment.num_channels != this->num_channels ||
+             std::abs(segment.sample_rate - this->sample_rate) > 1e-4 * this->sample_rate) {
+    LOG(WARNING) << segment.paths.front() << " has " << segment.num_channels << " channels at "
+                 << segment.sample_rate << " Hz; expected " << this->num_channels
+                 << " channels at " << this->sample_rate << " Hz. Skipping";
+    return false;
+  }
+  if (segment.start_time_nsec < 0) {
+    // no time in the name: carry on from the previous file
+    segment.start_time_nsec = this->sources.empty() ? 0 : this->get_end_time_nsec();
+  }
+  segment.first_sample = this->num_samples;
+  this->num_samples += segment.num_samples;
+  this->sources.push_back(std::move(source));
+  return true;
+}
+
+std::vector<AcousticLogSegment> AcousticLogReader::get_segments() {
+  std::vector<AcousticLogSegment> segments;
+  for (auto &source : this->sources) {
+    segments.push_back(source->segment);
+  }
+  return segments;
+}
+
+size_t AcousticLogReader::source_of(size_t sample) {
+  auto it = std::upper_bound(this->sources.begin(), this->sources.end(), sample,
+                             [](size_t value, const std::unique_ptr<Source> &source) {
+                               return value < source->segment.first_sample;
+                             });
+  return (it - this->sources.begin()) - 1;
+}
+
+int64_t AcousticLogReader::get_start_time_nsec() {
+  return this->sources.empty() ? 0 : this->sources.front()->segment.start_time_nsec;
+}
+
+int64_t AcousticLogReader::get_end_time_nsec() {
+  if (this->sources.empty()) {
+    return 0;
+  }
+  const AcousticLogSegment &segment = this->sources.back()->segment;
+  return segment.start_time_nsec +
+         (int64_t)std::llround(segment.num_samples * 1e9 / segment.sample_rate);
+}
+
+int64_t AcousticLogReader::get_time_nsec(size_t sample) {
+  if (this->sources.empty()) {
+    return 0;
+  }
+  const AcousticLogSegment &segment =
+      this->sources.at(this->source_of(std::min(sample, this->num_samples - 1)))->segment;
+  return segment.start_time_nsec +
+         (int64_t)std::llround((double)(sample - segment.first_sample) * 1e9 / segment.sample_rate);
+}
+
+size_t AcousticLogReader::find(int64_t time_nsec) {
+  // the file recording at time_nsec; a time between files maps to the start of the next one
+  auto it = std::upper_bound(this->sources.begin(), this->sources.end(), time_nsec,
+                             [](int64_t value, const std::unique_ptr<Source> &source) {
+                               return value < source->segment.start_time_nsec;
+                             });
+  if (it != this->sources.begin()) {
+    const AcousticLogSegment &segment = (*(it - 1))->segment;
+    double offset = std::ceil((time_nsec - segment.start_time_nsec) * segment.sample_rate / 1e9);
+    if (offset < segment.num_samples) {
+      return segment.first_sample + (size_t)offset;
+    }
+  }
+  return it == this->sources.end() ? this->num_samples : (*it)->segment.first_sample;
+}
+
+void AcousticLogReader::read_source(Source &source, size_t local, size_t count,
+                                    Eigen::MatrixX<int16_t> &out, Eigen::Index col) {
+  const int num_channels = source.segment.num_channels;
+  switch (source.segment.format) {
+  case LOGGER::ACO_WAV:
+    // interleaved frames are channels x samples, column-major
+    std::memcpy(out.col(col).data(), source.pcm + local * num_channels,
+                count * num_channels * sizeof(int16_t));
+    break;
+  case LOGGER::ACO_CSV:
+    for (size_t ii = 0; ii < count; ii++) {
+      char *ptr = const_cast<char *>(source.map + source.rows[local + ii]);
+      const char *eol = (const char *)std::memchr(ptr, '\n', source.map + source.map_bytes - ptr);
+      for (int skip = 0; skip < CSV_META_COLUMNS && ptr != nullptr; skip++) {
+        ptr = (char *)std::memchr(ptr, ',', eol - ptr);
+        ptr = ptr != nullptr ? ptr + 1 : nullptr;
+      }
+      for (int ch = 0; ch < num_channels; ch++) {
+        // a short row reads as zeros
+        out(ch, col + ii) = (ptr != nullptr && ptr < eol) ? (int16_t)std::strtol(ptr, &ptr, 10) : 0;
+        ptr = ptr != nullptr ? ptr + 1 : nullptr;
+      }
+    }
+    break;
+  case LOGGER::ACO_FLAC: {
+    int row = 0;
+    for (size_t ff = 0; ff < source.flac.size(); ff++) {
+      const int file_channels = source.flac_channels[ff];
+      this->flac_buff.resize(count * file_channels);
+      source.flac[ff].seek(local, SEEK_SET);
+      sf_count_t got = source.flac[ff].readf(this->flac_buff.data(), count);
+      for (size_t ii = 0; ii < count; ii++) {
+        for (int ch = 0; ch < file_channels; ch++) {
+          out(row + ch, col + ii) =
+              (sf_count_t)ii < got ? this->flac_buff[ii * file_channels + ch] : 0;
+        }
+      }
+      row += file_channels;
+    }
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+size_t AcousticLogReader::read(size_t first, size_t count, Eigen::MatrixX<int16_t> &out) {
+  if (first >= this->num_samples) {
+    out.resize(this->num_channels, 0);
+    return 0;
+  }
+  count = std::min(count, this->num_samples - first);
+  out.resize(this->num_channels, count);
+
+  size_t done = 0;
+  for (size_t ss = this->source_of(first); done < count; ss++) {
+    Source &source = *this->sources.at(ss);
+    size_t local = first + done - source.segment.first_sample;
+    size_t n = std::min(count - done, source.segment.num_samples - local);
+    this->read_source(source, local, n, out, done);
+    done += n;
+  }
+  return count;
+}
+
+Eigen::MatrixX<int16_t> AcousticLogReader::read(size_t first, size_t count) {
+  Eigen::MatrixX<int16_t> out;
+  this->read(first, count, out);
+  return out;
+}
+
+std::shared_ptr<UdpAcousticData> AcousticLogReader::read_packet(size_t first, size_t count) {
+  if (first >= this->num_samples || count == 0) {
+    return nullptr;
+  }
+  Source &source = *this->sources.at(this->source_of(first));
+  const AcousticLogSegment &segment = source.segment;
+  size_t local = first - segment.first_sample;
+  count = std::min(count, segment.num_samples - local);
+
+  auto aco_data = std::make_shared<UdpAcousticData>();
+  aco_data->data.resize(this->num_channels, count);
+  this->read_source(source, local, count, aco_data->data, 0);
+
+  UdpAcousticData::Header &hdr = aco_data->header;
+  // v4.1 carries the float sample rate and the tick time
+  hdr.ver_maj = 4;
+  hdr.ver_min = 1;
+  hdr.num_channels = this->num_channels;
+  hdr.num_values = this->num_channels * count;
+  hdr.sample_rate = segment.sample_rate;
+  hdr.start_time_nsec = this->get_time_nsec(first);
+  hdr.tick_time_nsec = hdr.start_time_nsec - segment.start_time_nsec;
+  hdr.adc_count = (int32_t)local;
+  hdr.packet_num = (int32_t)(first / this->samples_per_packet);
+  return aco_data;
+}
+
+void AcousticLogReader::set_samples_per_packet(size_t samples_per_packet) {
+  this->samples_per_packet = std::max<size_t>(samples_per_packet, 1);
+}
+
+size_t AcousticLogReader::replay(UdpSocketIn &socket, REPLAY_PACING pacing, double speed,
+                                 size_t first, size_t last) {
+  this->keep_alive = true;
+  last = std::min(last, this->num_samples);
+
+  size_t count = 0;
+  auto t_start = std::chrono::steady_clock::now();
+  int64_t t0_nsec = first < last ? this->get_time_nsec(first) : 0;
+  speed = speed > 0 ? speed : 1.0;
+
+  auto backlog = [&]() {
+    for (auto &q_aco : socket.v_q_aco) {
+      if (q_aco->size() > this->max_queue_depth)
+        return true;
+    }
+    return false;
+  };
+
+  for (size_t ii = first; ii < last && this->keep_alive;) {
+    auto aco_data = this->read_packet(ii, std::min(this->samples_per_packet, last - ii));
+    if (aco_data == nullptr)
+      break;
+    if (pacing == REPLAY_PACING::REALTIME) {
+      // schedule against the replay start, so per-packet sleep jitter does not accumulate
+      auto offset = std::chrono::nanoseconds(
+          (int64_t)((aco_data->header.start_time_nsec - t0_nsec) / speed));
+      std::this_thread::sleep_until(t_start + offset);
+    } else if (this->max_queue_depth > 0) {
+      // let the consumers keep up, rather than have the queues drop packets
+      while (this->keep_alive && backlog()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    }
+    std::vector<int8_t> msg = aco_data->encode();
+    socket.dispatch(msg);
+    ii += aco_data->data.cols();
+    count++;
+  }
+
+  if (FLAGS_debug_acoustic_log_reader) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t_start;
+    VLOG(3) << "Replayed " << count << " packets (" << last - std::min(first, last)
+            << " samples) in " << elapsed.count() << " s";
+  }
+  return count;
+}
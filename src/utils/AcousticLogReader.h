@@ -0,0 +1,145 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: AcousticLogReader.h                                    */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef acoustic_log_reader_HEADER
+#define acoustic_log_reader_HEADER
+
+#include <Eigen/Dense>
+#include <atomic>
+#include <gflags/gflags.h>
+#include <memory>
+#include <sndfile.hh>
+#include <string>
+#include <vector>
+
+// includes from within project
+#include "udp_protocols/UdpAcousticData.h"
+#include "utils/PacketCapture.h"
+#include "utils/Types.h"
+
+DECLARE_bool(debug_acoustic_log_reader);
+
+struct UdpSocketIn;
+
+// One recorded file on the reader's timeline. The FLAC logger splits the channels over
+// side-by-side files (ACO_<time>_<n>.flac); those make up a single segment.
+struct AcousticLogSegment {
+  std::vector<std::string> paths;
+  LOGGER format = LOGGER::UNKNOWN;
+  size_t first_sample = 0; // on the timeline
+  size_t num_samples = 0;
+  int64_t start_time_nsec = 0;
+  double sample_rate = 0;
+  int num_channels = 0;
+};
+
+// Reads acoustic logs written by Logger_Acoustic (ACO_<time>.wav / .csv, ACO_<time>_<n>.flac),
+// either one file or a directory of rolled-over files, as one continuous timeline of
+// int16 samples (channels x samples, as in UdpAcousticData).
+//
+//  WAV  : memory-mapped; samples are read straight out of the mapping
+//  CSV  : memory-mapped; a row offset table built on open makes every row addressable
+//  FLAC : compressed, so not mappable; decoded through libsndfile's seek + read
+//
+// Sample index -> file is a binary search over the segments (a handful per directory),
+// then O(1) within the file. Sample times: CSV files carry the packet epoch of their
+// first row and the sample rate (from the interpolated tick times); WAV / FLAC files
+// start at the UTC time in their name. Files are taken in name (= time) order and
+// must share the channel count and sample rate.
+//
+// Reads reposition the FLAC decoders, so one reader serves one thread at a time.
+class AcousticLogReader {
+public:
+  AcousticLogReader() {}
+  ~AcousticLogReader() { this->close(); }
+
+  AcousticLogReader(const AcousticLogReader &) = delete;
+  AcousticLogReader &operator=(const AcousticLogReader &) = delete;
+
+  // format LOGGER::UNKNOWN: from the file extension; in a directory holding several
+  // formats of the same recording, WAV first, then FLAC, then CSV
+  bool open(const std::string &path, LOGGER format = LOGGER::UNKNOWN);
+  void close();
+  bool is_open() { return !this->sources.empty(); }
+
+  size_t size() { return this->num_samples; }
+  int get_num_channels() { return this->num_channels; }
+  double get_sample_rate() { return this->sample_rate; }
+  LOGGER get_format() { return this->format; }
+  std::vector<AcousticLogSegment> get_segments();
+  // Sample rate for CSV logs too short to estimate it from (set before open)
+  void set_default_sample_rate(double sample_rate) { this->default_sample_rate = sample_rate; }
+
+  int64_t get_start_time_nsec();
+  int64_t get_end_time_nsec();
+  int64_t get_time_nsec(size_t sample);
+  // First sample at or after time_nsec (size() if none)
+  size_t find(int64_t time_nsec);
+
+  // Samples [first, first + count), clipped to the end of the timeline, into out
+  // (channels x samples); returns the number read
+  size_t read(size_t first, size_t count, Eigen::MatrixX<int16_t> &out);
+  Eigen::MatrixX<int16_t> read(size_t first, size_t count);
+  // The packet UdpSocketIn would have delivered for samples [first, first + count);
+  // clipped to the file holding `first`, nullptr past the end
+  std::shared_ptr<UdpAcousticData> read_packet(size_t first, size_t count);
+
+  // Replay samples [first, last) into `socket` through UdpSocketIn::dispatch(), in the
+  // calling thread, as packets of set_samples_per_packet() samples. REALTIME keeps the
+  // recorded pace (scaled by 1/speed); AS_FAST_AS_POSSIBLE waits while any of the socket's
+  // acoustic queues holds more than set_max_queue_depth() packets (0 : never). Returns the
+  // number of packets dispatched.
+  size_t replay(UdpSocketIn &socket, REPLAY_PACING pacing = REPLAY_PACING::AS_FAST_AS_POSSIBLE,
+                double speed = 1.0, size_t first = 0, size_t last = SIZE_MAX);
+  // ends a replay() running in another thread
+  void stop() { this->keep_alive = false; }
+  void set_samples_per_packet(size_t samples_per_packet);
+  size_t get_samples_per_packet() { return this->samples_per_packet; }
+  void set_max_queue_depth(size_t max_queue_depth) { this->max_queue_depth = max_queue_depth; }
+
+protected:
+  struct Source {
+    AcousticLogSegment segment;
+    // WAV / CSV mapping
+    const char *map = nullptr;
+    size_t map_bytes = 0;
+    const int16_t *pcm = nullptr; // WAV: interleaved samples
+    std::vector<size_t> rows;     // CSV: offset of each sample row
+    // FLAC: one decoder per file, and the channels each holds
+    std::vector<SndfileHandle> flac;
+    std::vector<int> flac_channels;
+
+    ~Source();
+  };
+
+  bool add_wav(const std::string &path);
+  bool add_csv(const std::string &path);
+  bool add_flac(const std::vector<std::string> &paths);
+  bool map_file(const std::string &path, Source &source);
+  // append a source to the timeline (false if it does not match the others)
+  bool add_source(std::unique_ptr<Source> source);
+  size_t source_of(size_t sample);
+  // samples [local, local + count) of one source into out, starting at column col
+  void read_source(Source &source, size_t local, size_t count, Eigen::MatrixX<int16_t> &out,
+                   Eigen::Index col);
+
+  std::vector<std::unique_ptr<Source>> sources;
+  LOGGER format = LOGGER::UNKNOWN;
+  size_t num_samples = 0;
+  int num_channels = 0;
+  double sample_rate = 0;
+  double default_sample_rate = 0;
+
+  size_t samples_per_packet = 1024;
+  size_t max_queue_depth = 64;
+  std::atomic<bool> keep_alive{false};
+  std::vector<int16_t> flac_buff;
+};
+
+#endif
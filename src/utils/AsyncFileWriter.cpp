@@ -0,0 +1,268 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: AsyncFileWriter.cpp                                    */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+// includes from within project
+#include "utils/AsyncFileWriter.h"
+
+DEFINE_bool(debug_async_writer, false, "Enable expanded debug for AsyncFileWriter");
+
+WriterStats &WriterStats::operator+=(const WriterStats &other) {
+  this->bytes_written += other.bytes_written;
+  this->writes += other.writes;
+  this->write_errors += other.write_errors;
+  this->fsyncs += other.fsyncs;
+  this->files_opened += other.files_opened;
+  this->dropped += other.dropped;
+  this->max_write_nsec = std::max(this->max_write_nsec, other.max_write_nsec);
+  this->stalls += other.stalls;
+  this->stall_nsec += other.stall_nsec;
+  this->queue_depth += other.queue_depth;
+  this->max_queue_depth = std::max(this->max_queue_depth, other.max_queue_depth);
+  return *this;
+}
+
+std::ostream &operator<<(std::ostream &os, const WriterStats &st) {
+  os << "bytes=" << st.bytes_written << " writes=" << st.writes << " errors=" << st.write_errors
+     << " fsyncs=" << st.fsyncs << " files=" << st.files_opened << " dropped=" << st.dropped
+     << " max_write_ms=" << st.max_write_nsec / 1e6 << " depth=" << st.queue_depth
+     << " max_depth=" << st.max_queue_depth << " stalls=" << st.stalls
+     << " stall_ms=" << st.stall_nsec / 1e6;
+  return os;
+}
+
+AsyncFileWriter::AsyncFileWriter(size_t buffer_bytes, size_t num_buffers) {
+  this->buffer_bytes = buffer_bytes > 0 ? buffer_bytes : 1 << 20;
+  // at least one buffer being filled while another is written out
+  num_buffers = num_buffers < 2 ? 2 : num_buffers;
+
+  this->buffers.resize(num_buffers);
+  for (size_t ii = 0; ii < num_buffers; ii++) {
+    this->buffers.at(ii).reserve(this->buffer_bytes);
+  }
+  this->fill_idx = 0;
+  for (size_t ii = num_buffers - 1; ii > 0; ii--) {
+    this->free_buffers.push_back(ii);
+  }
+  this->fill_start = std::chrono::steady_clock::now();
+  this->last_fsync = this->fill_start;
+}
+
+AsyncFileWriter::~AsyncFileWriter() { this->close(); }
+
+bool AsyncFileWriter::open(const std::string &path) {
+  if (this->is_open()) {
+    this->close();
+  }
+
+  this->fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (this->fd < 0) {
+    LOG(ERROR) << "Could not open " << path << " for writing: " << std::strerror(errno);
+    return false;
+  }
+  this->path = path;
+
+  {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    this->stats.files_opened++;
+    this->io_keep_alive = true;
+  }
+  this->fill_start = std::chrono::steady_clock::now();
+  this->last_fsync = this->fill_start;
+
+  pthread_create(&this->io_thread, NULL, _run_io_thread, this);
+  this->io_running = true;
+  return true;
+}
+
+void AsyncFileWriter::close() {
+  if (!this->is_open()) {
+    return;
+  }
+
+  this->flush();
+  {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    this->io_keep_alive = false;
+  }
+  this->m_cond_ready.notify_all();
+  if (this->io_running) {
+    pthread_join(this->io_thread, NULL);
+    this->io_running = false;
+  }
+
+  if (this->fsync_policy != FSYNC_POLICY::NONE) {
+    ::fsync(this->fd);
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    this->stats.fsyncs++;
+  }
+  ::close(this->fd);
+  this->fd = -1;
+}
+
+void AsyncFileWriter::write(const char *data, size_t len) {
+  if (!this->is_open()) {
+    return;
+  }
+
+  while (len > 0) {
+    std::vector<char> &buff = this->buffers.at(this->fill_idx);
+    if (buff.empty()) {
+      this->fill_start = std::chrono::steady_clock::now();
+    }
+
+    size_t n = std::min(len, this->buffer_bytes - buff.size());
+    buff.insert(buff.end(), data, data + n);
+    data += n;
+    len -= n;
+
+    if (buff.size() >= this->buffer_bytes) {
+      this->submit_fill_buffer();
+    }
+  }
+
+  // bound the time data can sit in a partially filled buffer
+  std::chrono::duration<double> pending = std::chrono::steady_clock::now() - this->fill_start;
+  if (!this->buffers.at(this->fill_idx).empty() && pending.count() > this->flush_interval_sec) {
+    this->submit_fill_buffer();
+  }
+}
+
+void AsyncFileWriter::flush() {
+  if (this->is_open() && !this->buffers.at(this->fill_idx).empty()) {
+    this->submit_fill_buffer();
+  }
+}
+
+void AsyncFileWriter::submit_fill_buffer() {
+  std::unique_lock<std::mutex> lock(this->m_mutex);
+
+  this->ready_buffers.push_back(this->fill_idx);
+  this->stats.queue_depth = this->ready_buffers.size();
+  this->stats.max_queue_depth = std::max(this->stats.max_queue_depth, this->stats.queue_depth);
+  this->m_cond_ready.notify_one();
+
+  if (this->free_buffers.empty()) {
+    // all spare buffers are waiting on the disk; block the producer and account for it
+    auto t_start = std::chrono::steady_clock::now();
+    this->m_cond_free.wait(lock, [this] { return !this->free_buffers.empty(); });
+    auto stall_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - t_start)
+                          .count();
+    this->stats.stalls++;
+    this->stats.stall_nsec += stall_nsec;
+    if (FLAGS_debug_async_writer) {
+      LOG(WARNING) << "Writer for " << this->path << " stalled for " << stall_nsec / 1e6 << " ms";
+    }
+  }
+
+  this->fill_idx = this->free_buffers.back();
+  this->free_buffers.pop_back();
+}
+
+bool AsyncFileWriter::write_fully(const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t res = ::write(this->fd, data, len);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << "Write to " << this->path << " failed: " << std::strerror(errno);
+      return false;
+    }
+    data += res;
+    len -= res;
+  }
+  return true;
+}
+
+void *AsyncFileWriter::_run_io_thread(void *ptr) {
+  AsyncFileWriter *argPtr = static_cast<AsyncFileWriter *>(ptr);
+  argPtr->run_io_thread();
+  pthread_exit(NULL);
+}
+
+void AsyncFileWriter::run_io_thread() {
+  prctl(PR_SET_NAME, "ac_log_io");
+  VLOG(3) << "Starting write-behind I/O for " << this->path << " in thread " << pthread_self();
+
+  size_t idx;
+  FSYNC_POLICY policy;
+  double period_sec;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(this->m_mutex);
+      this->m_cond_ready.wait(
+          lock, [this] { return !this->ready_buffers.empty() || !this->io_keep_alive; });
+      if (this->ready_buffers.empty()) {
+        // only exit once everything handed off has been written
+        break;
+      }
+      idx = this->ready_buffers.front();
+      policy = this->fsync_policy;
+      period_sec = this->fsync_period_sec;
+    }
+
+    std::vector<char> &buff = this->buffers.at(idx);
+
+    auto t_start = std::chrono::steady_clock::now();
+    bool ok = this->write_fully(buff.data(), buff.size());
+
+    bool do_fsync = (policy == FSYNC_POLICY::EVERY_WRITE);
+    if (policy == FSYNC_POLICY::PERIODIC) {
+      std::chrono::duration<double> since_fsync = t_start - this->last_fsync;
+      do_fsync = since_fsync.count() >= period_sec;
+    }
+    if (do_fsync) {
+      ::fsync(this->fd);
+      this->last_fsync = std::chrono::steady_clock::now();
+    }
+    uint64_t write_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - t_start)
+                              .count();
+
+    {
+      std::lock_guard<std::mutex> lock(this->m_mutex);
+      this->stats.writes++;
+      if (ok) {
+        this->stats.bytes_written += buff.size();
+      } else {
+        this->stats.write_errors++;
+      }
+      this->stats.fsyncs += do_fsync ? 1 : 0;
+      this->stats.max_write_nsec = std::max(this->stats.max_write_nsec, write_nsec);
+
+      buff.clear();
+      this->ready_buffers.pop_front();
+      this->stats.queue_depth = this->ready_buffers.size();
+      this->free_buffers.push_back(idx);
+    }
+    this->m_cond_free.notify_one();
+  }
+
+  VLOG(3) << "Write-behind I/O for " << this->path << " exited";
+}
+
+void AsyncFileWriter::set_fsync_policy(FSYNC_POLICY policy, double period_sec) {
+  std::lock_guard<std::mutex> lock(this->m_mutex);
+  this->fsync_policy = policy;
+  this->fsync_period_sec = period_sec;
+}
+
+WriterStats AsyncFileWriter::get_stats() {
+  std::lock_guard<std::mutex> lock(this->m_mutex);
+  return this->stats;
+}
@@ -0,0 +1,114 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: AsyncFileWriter.h                                      */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef async_file_writer_HEADER
+#define async_file_writer_HEADER
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <gflags/gflags.h>
+#include <mutex>
+#include <ostream>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+DECLARE_bool(debug_async_writer);
+
+// When (if ever) logger output is forced to stable storage with fsync()
+enum class FSYNC_POLICY { NONE, ON_CLOSE, PERIODIC, EVERY_WRITE };
+
+// Counters shared by all write-behind loggers
+struct WriterStats {
+  uint64_t bytes_written = 0;
+  uint64_t writes = 0;
+  uint64_t write_errors = 0;
+  uint64_t fsyncs = 0;
+  uint64_t files_opened = 0;
+  uint64_t dropped = 0; // packets / frames the logger could not write, and discarded
+  uint64_t max_write_nsec = 0;
+
+  // producer side: time spent blocked because the I/O side had no free buffer / slot
+  uint64_t stalls = 0;
+  uint64_t stall_nsec = 0;
+
+  // buffers (or packets) handed off but not yet written
+  size_t queue_depth = 0;
+  size_t max_queue_depth = 0;
+
+  WriterStats &operator+=(const WriterStats &other);
+};
+
+std::ostream &operator<<(std::ostream &os, const WriterStats &st);
+
+// Write-behind file output with a dedicated I/O thread.
+//
+// The producer appends bytes into the current fill buffer; full buffers (or buffers
+// pending longer than the flush interval) are handed to the I/O thread, which issues
+// the write() and applies the fsync policy. With N buffers (2 = double buffering,
+// 3 = triple buffering) the producer only blocks when all N-1 spare buffers are
+// queued for I/O; every such wait is counted in the stall metrics.
+//
+// write()/flush() must be called from a single producer thread.
+class AsyncFileWriter {
+public:
+  AsyncFileWriter(size_t buffer_bytes = 1 << 20, size_t num_buffers = 3);
+  ~AsyncFileWriter();
+
+  AsyncFileWriter(const AsyncFileWriter &) = delete;
+  AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+
+  bool open(const std::string &path);
+  void close();
+  bool is_open() { return this->fd >= 0; }
+  std::string get_path() { return this->path; }
+
+  void write(const char *data, size_t len);
+  void write(const std::string &str) { this->write(str.data(), str.size()); }
+  // hand the partially filled buffer to the I/O thread without waiting for the write
+  void flush();
+
+  void set_fsync_policy(FSYNC_POLICY policy, double period_sec = 5.0);
+  void set_flush_interval(double interval_sec) { this->flush_interval_sec = interval_sec; }
+  WriterStats get_stats();
+
+protected:
+  static void *_run_io_thread(void *ptr);
+  void run_io_thread();
+  void submit_fill_buffer();
+  bool write_fully(const char *data, size_t len);
+
+  int fd = -1;
+  std::string path;
+
+  size_t buffer_bytes;
+  std::vector<std::vector<char>> buffers;
+  std::deque<size_t> ready_buffers;
+  std::vector<size_t> free_buffers;
+  size_t fill_idx = 0;
+  std::chrono::steady_clock::time_point fill_start;
+
+  FSYNC_POLICY fsync_policy = FSYNC_POLICY::ON_CLOSE;
+  double fsync_period_sec = 5.0;
+  double flush_interval_sec = 1.0;
+  std::chrono::steady_clock::time_point last_fsync;
+
+  pthread_t io_thread;
+  bool io_keep_alive = false;
+  bool io_running = false;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond_ready;
+  std::condition_variable m_cond_free;
+
+  WriterStats stats;
+};
+
+#endif
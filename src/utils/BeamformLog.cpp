@@ -0,0 +1,543 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: BeamformLog.cpp                                        */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <glog/logging.h>
+
+// includes from within project
+#include "utils/BeamformLog.h"
+
+namespace {
+const char BEAM_LOG_MAGIC[4] = {'A', 'C', 'B', 'L'};
+const char BEAM_LOG_INDEX_MAGIC[4] = {'A', 'C', 'B', 'X'};
+const uint16_t BEAM_LOG_VERSION = 1;
+
+size_t value_bytes(BEAM_STORAGE storage) {
+  switch (storage) {
+  case BEAM_STORAGE::FLOAT32:
+    return sizeof(float);
+  case BEAM_STORAGE::FLOAT16:
+    return sizeof(Eigen::half);
+  case BEAM_STORAGE::DB_U8:
+    return sizeof(uint8_t);
+  default:
+    return sizeof(double);
+  }
+}
+
+const char *beampattern_data(const UdpBeamform2D::Payload &d) {
+  switch (d.storage) {
+  case BEAM_STORAGE::FLOAT32:
+    return reinterpret_cast<const char *>(d.beampattern_f32.data());
+  case BEAM_STORAGE::FLOAT16:
+    return reinterpret_cast<const char *>(d.beampattern_f16.data());
+  case BEAM_STORAGE::DB_U8:
+    return reinterpret_cast<const char *>(d.beampattern_u8.data());
+  default:
+    return reinterpret_cast<const char *>(d.beampattern.data());
+  }
+}
+
+template <typename T> bool same(const T &a, const T &b) {
+  return a.size() == b.size() && a == b;
+}
+
+void append(std::vector<char> &buff, const void *data, size_t len) {
+  const char *bytes = static_cast<const char *>(data);
+  buff.insert(buff.end(), bytes, bytes + len);
+}
+
+template <typename T> Eigen::VectorXd to_eigen(const std::vector<T> &vec) {
+  Eigen::VectorXd out(vec.size());
+  for (size_t ii = 0; ii < vec.size(); ii++)
+    out[ii] = vec[ii];
+  return out;
+}
+
+std::vector<double> to_std(const Eigen::VectorXd &vec) {
+  return std::vector<double>(vec.data(), vec.data() + vec.size());
+}
+
+// weights / mask missing from a frame default to 1 / true, so the file layout only
+// depends on the element count
+void conform_elements(BeamLogGeometry &g) {
+  Eigen::Index num_elements = g.array_x.size();
+  if (g.element_weights.size() != num_elements)
+    g.element_weights = Eigen::VectorXd::Ones(num_elements);
+  if (g.element_mask.size() != num_elements)
+    g.element_mask = Eigen::VectorX<bool>::Constant(num_elements, true);
+}
+} // namespace
+
+BeamLogFileHeader::BeamLogFileHeader() {
+  std::memcpy(this->magic, BEAM_LOG_MAGIC, sizeof(this->magic));
+  this->version = BEAM_LOG_VERSION;
+  this->kind = (int8_t)BEAM_LOG_KIND::BEAM_2D;
+  this->storage = (int8_t)BEAM_STORAGE::FLOAT64;
+  this->value_bytes = sizeof(double);
+  this->num_elements = 0;
+  this->num_frequencies = 0;
+  this->num_bearings = 0;
+  this->num_elevations = 0;
+  this->dims[0] = 0;
+  this->dims[1] = 0;
+  this->dims[2] = 0;
+  this->frame_bytes = 0;
+}
+
+// Geometry
+// ========
+BeamLogGeometry::BeamLogGeometry(const UdpBeamform2D &beam) {
+  const UdpBeamform2D::Payload &d = beam.data;
+  this->kind = BEAM_LOG_KIND::BEAM_2D;
+  this->array_x = d.array_x;
+  this->array_y = d.array_y;
+  this->array_z = d.array_z;
+  this->frequencies = d.frequencies;
+  this->element_weights = d.element_weights;
+  this->element_mask = d.element_mask;
+  this->bearings_rad = d.bearings_rad;
+  this->elevations_rad = d.elevations_rad;
+  this->dims = {(int32_t)beam.beampattern_rows(), (int32_t)beam.beampattern_cols(), 1};
+  conform_elements(*this);
+}
+
+BeamLogGeometry::BeamLogGeometry(const UdpBeamformRaw &beam) {
+  const UdpBeamformRaw::Payload &d = beam.data;
+  this->kind = BEAM_LOG_KIND::BEAM_RAW;
+  this->array_x = to_eigen(d.array_x);
+  this->array_y = to_eigen(d.array_y);
+  this->array_z = to_eigen(d.array_z);
+  this->frequencies = to_eigen(d.frequencies);
+  this->element_weights = to_eigen(d.element_weights);
+  this->element_mask.resize(d.element_mask.size());
+  for (size_t ii = 0; ii < d.element_mask.size(); ii++)
+    this->element_mask[ii] = d.element_mask[ii];
+  this->bearings_rad = to_eigen(d.bearings_rad);
+  this->elevations_rad = to_eigen(d.elevations_rad);
+  this->dims[0] = d.beampattern.size();
+  this->dims[1] = d.beampattern.empty() ? 0 : d.beampattern[0].size();
+  this->dims[2] = this->dims[1] == 0 ? 0 : d.beampattern[0][0].size();
+  conform_elements(*this);
+}
+
+bool BeamLogGeometry::operator==(const BeamLogGeometry &other) const {
+  return this->kind == other.kind && this->dims == other.dims &&
+         same(this->array_x, other.array_x) && same(this->array_y, other.array_y) &&
+         same(this->array_z, other.array_z) && same(this->frequencies, other.frequencies) &&
+         same(this->element_weights, other.element_weights) &&
+         same(this->element_mask, other.element_mask) &&
+         same(this->bearings_rad, other.bearings_rad) &&
+         same(this->elevations_rad, other.elevations_rad);
+}
+
+// Writer
+// ======
+void BeamformLogWriter::set_storage(BEAM_STORAGE storage, double db_range) {
+  this->storage = storage;
+  this->db_range = db_range;
+}
+
+bool BeamformLogWriter::open(const std::string &path) {
+  this->close();
+  this->has_header = false;
+  this->offset = 0;
+  this->index.clear();
+  return this->file.open(path);
+}
+
+void BeamformLogWriter::close() {
+  if (!this->file.is_open())
+    return;
+  if (this->has_header) {
+    BeamLogTrailer trailer;
+    trailer.index_offset = this->offset;
+    trailer.num_frames = this->index.size();
+    std::memcpy(trailer.magic, BEAM_LOG_INDEX_MAGIC, sizeof(trailer.magic));
+    this->file.write(reinterpret_cast<const char *>(this->index.data()),
+                     this->index.size() * sizeof(BeamLogIndexEntry));
+    this->file.write(reinterpret_cast<const char *>(&trailer), sizeof(trailer));
+  }
+  this->file.close();
+  this->has_header = false;
+  this->index.clear();
+}
+
+bool BeamformLogWriter::begin_frame(const BeamLogGeometry &geometry, BEAM_STORAGE storage,
+                                    int64_t time_nsec) {
+  if (this->has_header) {
+    if (geometry != this->geometry)
+      return false;
+    this->index.push_back({time_nsec, this->offset});
+    return true;
+  }
+
+  BeamLogFileHeader &hdr = this->header;
+  hdr = BeamLogFileHeader();
+  hdr.kind = (int8_t)geometry.kind;
+  hdr.storage = (int8_t)storage;
+  hdr.value_bytes = value_bytes(storage);
+  hdr.num_elements = geometry.array_x.size();
+  hdr.num_frequencies = geometry.frequencies.size();
+  hdr.num_bearings = geometry.bearings_rad.size();
+  hdr.num_elevations = geometry.elevations_rad.size();
+  for (int ii = 0; ii < 3; ii++)
+    hdr.dims[ii] = geometry.dims[ii];
+  hdr.frame_bytes = sizeof(BeamLogFrameHeader) +
+                    (uint64_t)hdr.dims[0] * hdr.dims[1] * hdr.dims[2] * hdr.value_bytes;
+
+  std::vector<char> buff;
+  append(buff, &hdr, sizeof(hdr));
+  for (auto *vec : {&geometry.array_x, &geometry.array_y, &geometry.array_z,
+                    &geometry.frequencies, &geometry.element_weights}) {
+    append(buff, vec->data(), vec->size() * sizeof(double));
+  }
+  Eigen::VectorX<uint8_t> mask = geometry.element_mask.cast<uint8_t>();
+  append(buff, mask.data(), mask.size());
+  append(buff, geometry.bearings_rad.data(), geometry.bearings_rad.size() * sizeof(double));
+  append(buff, geometry.elevations_rad.data(), geometry.elevations_rad.size() * sizeof(double));
+  this->file.write(buff.data(), buff.size());
+
+  this->geometry = geometry;
+  this->offset = buff.size();
+  this->has_header = true;
+  this->index.push_back({time_nsec, this->offset});
+  return true;
+}
+
+void BeamformLogWriter::write_frame_header(const BeamLogFrameHeader &hdr) {
+  this->file.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+}
+
+BEAM_LOG_WRITE BeamformLogWriter::write(const UdpBeamform2D &beam) {
+  if (!this->file.is_open()) {
+    LOG_EVERY_N(WARNING, 1000) << "Beamformer log not open; dropping frame";
+    this->frames_dropped++;
+    return BEAM_LOG_WRITE::DROPPED;
+  }
+  BEAM_STORAGE storage = this->has_header ? (BEAM_STORAGE)this->header.storage : this->storage;
+  if (!this->begin_frame(BeamLogGeometry(beam), storage, beam.header.start_time_nsec))
+    return BEAM_LOG_WRITE::NEW_FILE;
+
+  const UdpBeamform2D *src = &beam;
+  if (beam.get_storage() != storage) {
+    this->scratch.data.storage = BEAM_STORAGE::FLOAT64;
+    this->scratch.data.beampattern = beam.get_beampattern();
+    this->scratch.set_storage(storage, this->db_range);
+    src = &this->scratch;
+  }
+
+  const UdpBeamform2D::Header &bh = beam.header;
+  BeamLogFrameHeader hdr;
+  hdr.start_time_nsec = bh.start_time_nsec;
+  hdr.packet_num = bh.packet_num;
+  hdr.sample_rate = bh.sample_rate;
+  hdr.window_length_sec = bh.window_length_sec;
+  hdr.xform_pitch_deg = bh.xform_pitch_deg;
+  hdr.xform_roll_deg = bh.xform_roll_deg;
+  hdr.xform_yaw_deg = bh.xform_yaw_deg;
+  hdr.mode = bh.mode;
+  hdr.weighting_type = bh.weighting_type;
+  hdr.db_min = src->data.db_min;
+  hdr.db_step = src->data.db_step;
+  this->write_frame_header(hdr);
+  this->file.write(beampattern_data(src->data), this->header.frame_bytes - sizeof(hdr));
+  this->offset += this->header.frame_bytes;
+  return BEAM_LOG_WRITE::WRITTEN;
+}
+
+BEAM_LOG_WRITE BeamformLogWriter::write(const UdpBeamformRaw &beam) {
+  if (!this->file.is_open()) {
+    LOG_EVERY_N(WARNING, 1000) << "Beamformer log not open; dropping frame";
+    this->frames_dropped++;
+    return BEAM_LOG_WRITE::DROPPED;
+  }
+  BeamLogGeometry geometry(beam);
+  // ragged beampatterns do not fit a fixed-size frame
+  for (auto &slice : beam.data.beampattern) {
+    bool ragged = slice.size() != (size_t)geometry.dims[1];
+    for (auto &row : slice)
+      ragged |= row.size() != (size_t)geometry.dims[2];
+    if (ragged) {
+      LOG_EVERY_N(WARNING, 1000) << "Dropping ragged raw beampattern from the beamformer log";
+      this->frames_dropped++;
+      return BEAM_LOG_WRITE::DROPPED;
+    }
+  }
+  if (!this->begin_frame(geometry, BEAM_STORAGE::FLOAT64, beam.header.start_time_nsec))
+    return BEAM_LOG_WRITE::NEW_FILE;
+
+  const UdpBeamformRaw::Header &bh = beam.header;
+  BeamLogFrameHeader hdr;
+  hdr.start_time_nsec = bh.start_time_nsec;
+  hdr.packet_num = bh.packet_num;
+  hdr.sample_rate = bh.sample_rate;
+  hdr.window_length_sec = bh.window_length_sec;
+  hdr.xform_pitch_deg = bh.xform_pitch_deg;
+  hdr.xform_roll_deg = bh.xform_roll_deg;
+  hdr.xform_yaw_deg = bh.xform_yaw_deg;
+  hdr.mode = bh.mode;
+  hdr.weighting_type = bh.weighting_type;
+  hdr.db_min = 0;
+  hdr.db_step = 0;
+  this->write_frame_header(hdr);
+  for (auto &slice : beam.data.beampattern) {
+    for (auto &row : slice) {
+      this->file.write(reinterpret_cast<const char *>(row.data()), row.size() * sizeof(double));
+    }
+  }
+  this->offset += this->header.frame_bytes;
+  return BEAM_LOG_WRITE::WRITTEN;
+}
+
+// Reader
+// ======
+bool BeamformLogReader::open(const std::string &path) {
+  this->close();
+  this->file.open(path, std::ios::binary);
+  if (!this->file.is_open()) {
+    LOG(WARNING) << "Cannot open beamformer log " << path;
+    return false;
+  }
+  this->file.seekg(0, std::ios::end);
+  uint64_t file_bytes = this->file.tellg();
+
+  if (!this->read_at(0, reinterpret_cast<char *>(&this->header), sizeof(this->header)) ||
+      std::memcmp(this->header.magic, BEAM_LOG_MAGIC, sizeof(BEAM_LOG_MAGIC)) != 0 ||
+      this->header.version != BEAM_LOG_VERSION || this->header.frame_bytes == 0) {
+    LOG(WARNING) << "Not a beamformer log (or unsupported version): " << path;
+    this->close();
+    return false;
+  }
+  if (!this->read_geometry()) {
+    LOG(WARNING) << "Truncated beamformer log geometry: " << path;
+    this->close();
+    return false;
+  }
+
+  this->indexed = this->read_index(file_bytes);
+  if (!this->indexed) {
+    LOG(WARNING) << "Beamformer log " << path << " has no index; rebuilding from frames";
+    this->rebuild_index(file_bytes);
+  }
+  // frames are normally written in time order; keep file order among equal times
+  std::stable_sort(this->index.begin(), this->index.end(),
+                   [](const BeamLogIndexEntry &a, const BeamLogIndexEntry &b) {
+                     return a.start_time_nsec < b.start_time_nsec;
+                   });
+  return true;
+}
+
+void BeamformLogReader::close() {
+  if (this->file.is_open())
+    this->file.close();
+  this->file.clear();
+  this->header = BeamLogFileHeader();
+  this->geometry = BeamLogGeometry();
+  this->index.clear();
+  this->indexed = false;
+  this->data_offset = 0;
+}
+
+bool BeamformLogReader::read_at(uint64_t offset, char *data, size_t len) {
+  this->file.clear();
+  this->file.seekg(offset);
+  this->file.read(data, len);
+  return (size_t)this->file.gcount() == len;
+}
+
+bool BeamformLogReader::read_geometry() {
+  const BeamLogFileHeader &hdr = this->header;
+  BeamLogGeometry &g = this->geometry;
+  g.kind = (BEAM_LOG_KIND)hdr.kind;
+  for (int ii = 0; ii < 3; ii++)
+    g.dims[ii] = hdr.dims[ii];
+
+  uint64_t offset = sizeof(hdr);
+  for (auto *vec : {&g.array_x, &g.array_y, &g.array_z, &g.frequencies, &g.element_weights}) {
+    vec->resize(vec == &g.frequencies ? hdr.num_frequencies : hdr.num_elements);
+    if (!this->read_at(offset, reinterpret_cast<char *>(vec->data()), vec->size() * sizeof(double)))
+      return false;
+    offset += vec->size() * sizeof(double);
+  }
+  Eigen::VectorX<uint8_t> mask(hdr.num_elements);
+  if (!this->read_at(offset, reinterpret_cast<char *>(mask.data()), mask.size()))
+    return false;
+  g.element_mask = mask.cast<bool>();
+  offset += mask.size();
+  g.bearings_rad.resize(hdr.num_bearings);
+  g.elevations_rad.resize(hdr.num_elevations);
+  for (auto *vec : {&g.bearings_rad, &g.elevations_rad}) {
+    if (!this->read_at(offset, reinterpret_cast<char *>(vec->data()), vec->size() * sizeof(double)))
+      return false;
+    offset += vec->size() * sizeof(double);
+  }
+  this->data_offset = offset;
+  return true;
+}
+
+bool BeamformLogReader::read_index(uint64_t file_bytes) {
+  BeamLogTrailer trailer;
+  if (file_bytes < this->data_offset + sizeof(trailer) ||
+      !this->read_at(file_bytes - sizeof(trailer), reinterpret_cast<char *>(&trailer),
+                     sizeof(trailer)) ||
+      std::memcmp(trailer.magic, BEAM_LOG_INDEX_MAGIC, sizeof(BEAM_LOG_INDEX_MAGIC)) != 0 ||
+      trailer.index_offset < this->data_offset ||
+      trailer.index_offset + trailer.num_frames * sizeof(BeamLogIndexEntry) + sizeof(trailer) !=
+          file_bytes) {
+    return false;
+  }
+  this->index.resize(trailer.num_frames);
+  return this->read_at(trailer.index_offset, reinterpret_cast<char *>(this->index.data()),
+                       this->index.size() * sizeof(BeamLogIndexEntry));
+}
+
+void BeamformLogReader::rebuild_index(uint64_t file_bytes) {
+  // a partially written last frame is left out
+  size_t num_frames = file_bytes > this->data_offset
+                          ? (file_bytes - this->data_offset) / this->header.frame_bytes
+                          : 0;
+  this->index.resize(num_frames);
+  for (size_t ii = 0; ii < num_frames; ii++) {
+    BeamLogIndexEntry &entry = this->index[ii];
+    entry.offset = this->data_offset + ii * this->header.frame_bytes;
+    this->read_at(entry.offset, reinterpret_cast<char *>(&entry.start_time_nsec),
+                  sizeof(entry.start_time_nsec));
+  }
+}
+
+std::vector<int64_t> BeamformLogReader::get_times() {
+  std::vector<int64_t> times(this->index.size());
+  for (size_t ii = 0; ii < this->index.size(); ii++)
+    times[ii] = this->index[ii].start_time_nsec;
+  return times;
+}
+
+size_t BeamformLogReader::find(int64_t time_nsec) {
+  auto it = std::lower_bound(this->index.begin(), this->index.end(), time_nsec,
+                             [](const BeamLogIndexEntry &entry, int64_t time_nsec) {
+                               return entry.start_time_nsec < time_nsec;
+                             });
+  return it - this->index.begin();
+}
+
+bool BeamformLogReader::read_frame(size_t frame, BeamLogFrameHeader &hdr) {
+  if (frame >= this->index.size())
+    return false;
+  this->frame_buff.resize(this->header.frame_bytes);
+  if (!this->read_at(this->index[frame].offset, this->frame_buff.data(), this->frame_buff.size())) {
+    LOG_EVERY_N(WARNING, 1000) << "Cannot read beamformer log frame " << frame;
+    return false;
+  }
+  std::memcpy(&hdr, this->frame_buff.data(), sizeof(hdr));
+  return true;
+}
+
+std::shared_ptr<UdpBeamform2D> BeamformLogReader::read_2d(size_t frame) {
+  BeamLogFrameHeader hdr;
+  if (this->geometry.kind != BEAM_LOG_KIND::BEAM_2D || !this->read_frame(frame, hdr))
+    return nullptr;
+
+  auto beam = std::make_shared<UdpBeamform2D>();
+  UdpBeamform2D::Header &bh = beam->header;
+  bh.num_elements = this->header.num_elements;
+  bh.num_frequencies = this->header.num_frequencies;
+  bh.num_bearings = this->header.num_bearings;
+  bh.num_elevations = this->header.num_elevations;
+  bh.sample_rate = hdr.sample_rate;
+  bh.window_length_sec = hdr.window_length_sec;
+  bh.start_time_nsec = hdr.start_time_nsec;
+  bh.xform_pitch_deg = hdr.xform_pitch_deg;
+  bh.xform_roll_deg = hdr.xform_roll_deg;
+  bh.xform_yaw_deg = hdr.xform_yaw_deg;
+  bh.mode = hdr.mode;
+  bh.weighting_type = hdr.weighting_type;
+  bh.packet_num = hdr.packet_num;
+
+  UdpBeamform2D::Payload &d = beam->data;
+  const BeamLogGeometry &g = this->geometry;
+  d.array_x = g.array_x;
+  d.array_y = g.array_y;
+  d.array_z = g.array_z;
+  d.frequencies = g.frequencies;
+  d.element_mask = g.element_mask;
+  d.element_weights = g.element_weights;
+  d.bearings_rad = g.bearings_rad;
+  d.elevations_rad = g.elevations_rad;
+
+  const char *values = this->frame_buff.data() + sizeof(hdr);
+  Eigen::Index rows = g.dims[0];
+  Eigen::Index cols = g.dims[1];
+  d.storage = this->get_storage();
+  switch (d.storage) {
+  case BEAM_STORAGE::FLOAT32:
+    d.beampattern_f32 =
+        Eigen::Map<const Eigen::MatrixXf>(reinterpret_cast<const float *>(values), rows, cols);
+    break;
+  case BEAM_STORAGE::FLOAT16:
+    d.beampattern_f16 = Eigen::Map<const Eigen::MatrixX<Eigen::half>>(
+        reinterpret_cast<const Eigen::half *>(values), rows, cols);
+    break;
+  case BEAM_STORAGE::DB_U8:
+    d.beampattern_u8 = Eigen::Map<const Eigen::MatrixX<uint8_t>>(
+        reinterpret_cast<const uint8_t *>(values), rows, cols);
+    d.db_min = hdr.db_min;
+    d.db_step = hdr.db_step;
+    break;
+  default:
+    d.beampattern =
+        Eigen::Map<const Eigen::MatrixXd>(reinterpret_cast<const double *>(values), rows, cols);
+  }
+  return beam;
+}
+
+std::shared_ptr<UdpBeamformRaw> BeamformLogReader::read_raw(size_t frame) {
+  BeamLogFrameHeader hdr;
+  if (this->geometry.kind != BEAM_LOG_KIND::BEAM_RAW || !this->read_frame(frame, hdr))
+    return nullptr;
+
+  auto beam = std::make_shared<UdpBeamformRaw>();
+  UdpBeamformRaw::Header &bh = beam->header;
+  bh.num_elements = this->header.num_elements;
+  bh.num_frequencies = this->header.num_frequencies;
+  bh.num_bearings = this->header.num_bearings;
+  bh.num_elevations = this->header.num_elevations;
+  bh.sample_rate = hdr.sample_rate;
+  bh.window_length_sec = hdr.window_length_sec;
+  bh.start_time_nsec = hdr.start_time_nsec;
+  bh.xform_pitch_deg = hdr.xform_pitch_deg;
+  bh.xform_roll_deg = hdr.xform_roll_deg;
+  bh.xform_yaw_deg = hdr.xform_yaw_deg;
+  bh.mode = hdr.mode;
+  bh.weighting_type = hdr.weighting_type;
+  bh.packet_num = hdr.packet_num;
+
+  UdpBeamformRaw::Payload &d = beam->data;
+  const BeamLogGeometry &g = this->geometry;
+  d.array_x = to_std(g.array_x);
+  d.array_y = to_std(g.array_y);
+  d.array_z = to_std(g.array_z);
+  d.frequencies = to_std(g.frequencies);
+  d.element_mask.assign(g.element_mask.data(), g.element_mask.data() + g.element_mask.size());
+  d.element_weights = to_std(g.element_weights);
+  d.bearings_rad = to_std(g.bearings_rad);
+  d.elevations_rad = to_std(g.elevations_rad);
+
+  const double *values = reinterpret_cast<const double *>(this->frame_buff.data() + sizeof(hdr));
+  d.beampattern.resize(g.dims[0]);
+  for (auto &slice : d.beampattern) {
+    slice.resize(g.dims[1]);
+    for (auto &row : slice) {
+      row.assign(values, values + g.dims[2]);
+      values += g.dims[2];
+    }
+  }
+  return beam;
+}
@@ -0,0 +1,218 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: BeamformLog.h                                          */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef beamform_log_HEADER
+#define beamform_log_HEADER
+
+#include <Eigen/Dense>
+#include <array>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// includes from within project
+#include "udp_protocols/UdpBeamform2D.h"
+#include "udp_protocols/UdpBeamformRaw.h"
+#include "utils/AsyncFileWriter.h"
+
+// Beamformer log (.acbl): one stream of UdpBeamform2D or UdpBeamformRaw frames per file,
+// little endian.
+//
+//   BeamLogFileHeader | geometry | frame 0 | ... | frame N-1 | index | BeamLogTrailer
+//
+// geometry : array_x, array_y, array_z, frequencies, element_weights (float64),
+//            element_mask (uint8), bearings_rad, elevations_rad (float64); once per file
+// frame    : BeamLogFrameHeader + the beampattern, dims[0] x dims[1] x dims[2] values of
+//            value_bytes each. UdpBeamform2D: column-major bearings x elevations (x 1),
+//            in the file's BEAM_STORAGE; UdpBeamformRaw: the nested vectors, last index
+//            fastest, float64
+// index    : one BeamLogIndexEntry per frame in file order, written on close
+//
+// Frames all have the same size, so a file whose writer never closed (no trailer) is
+// still readable: the reader rebuilds the index from the frame headers.
+enum class BEAM_LOG_KIND : int8_t { BEAM_2D, BEAM_RAW };
+
+// Outcome of BeamformLogWriter::write(); nothing is written unless WRITTEN
+enum class BEAM_LOG_WRITE {
+  WRITTEN,
+  NEW_FILE, // another kind or geometry than the file holds; the caller starts a new file
+  DROPPED   // cannot be logged (log not open, ragged beampattern); counted in the stats
+};
+
+struct __attribute__((__packed__)) BeamLogFileHeader {
+  char magic[4]; // "ACBL"
+  uint16_t version;
+  int8_t kind;    // BEAM_LOG_KIND
+  int8_t storage; // BEAM_STORAGE of the beampatterns (FLOAT64 for BEAM_RAW)
+  int8_t value_bytes;
+
+  int32_t num_elements;
+  int32_t num_frequencies;
+  int32_t num_bearings;
+  int32_t num_elevations;
+  int32_t dims[3];
+
+  uint64_t frame_bytes; // frame header included
+
+  BeamLogFileHeader();
+};
+
+// 64 bytes, so the beampattern is aligned within a frame buffer
+struct __attribute__((__packed__)) BeamLogFrameHeader {
+  int64_t start_time_nsec;
+  int32_t packet_num;
+  int32_t sample_rate;
+  double window_length_sec;
+
+  double xform_pitch_deg;
+  double xform_roll_deg;
+  double xform_yaw_deg;
+
+  char mode;
+  char weighting_type;
+
+  float db_min; // DB_U8 only
+  float db_step;
+
+  char reserved[6] = {0, 0, 0, 0, 0, 0};
+};
+
+struct __attribute__((__packed__)) BeamLogIndexEntry {
+  int64_t start_time_nsec;
+  uint64_t offset;
+};
+
+struct __attribute__((__packed__)) BeamLogTrailer {
+  uint64_t index_offset;
+  uint64_t num_frames;
+  char magic[4]; // "ACBX"
+};
+
+// The static part of a beamformer stream: what a file stores once
+struct BeamLogGeometry {
+  BEAM_LOG_KIND kind = BEAM_LOG_KIND::BEAM_2D;
+  Eigen::VectorXd array_x;
+  Eigen::VectorXd array_y;
+  Eigen::VectorXd array_z;
+  Eigen::VectorXd frequencies;
+  Eigen::VectorXd element_weights;
+  Eigen::VectorX<bool> element_mask;
+  Eigen::VectorXd bearings_rad;
+  Eigen::VectorXd elevations_rad;
+  std::array<int32_t, 3> dims = {0, 0, 0}; // beampattern extent
+
+  BeamLogGeometry() {}
+  BeamLogGeometry(const UdpBeamform2D &beam);
+  BeamLogGeometry(const UdpBeamformRaw &beam);
+
+  bool operator==(const BeamLogGeometry &other) const;
+  bool operator!=(const BeamLogGeometry &other) const { return !(*this == other); }
+};
+
+// Writes one .acbl file at a time through an AsyncFileWriter. The file header and geometry
+// go out with the first frame; close() appends the time index.
+//
+// write() must be called from a single producer thread.
+class BeamformLogWriter {
+public:
+  BeamformLogWriter(size_t buffer_bytes = 1 << 20, size_t num_buffers = 3)
+      : file(buffer_bytes, num_buffers) {}
+  ~BeamformLogWriter() { this->close(); }
+
+  // Storage of UdpBeamform2D beampatterns in files opened from now on (DB_U8 keeps
+  // db_range dB); UdpBeamformRaw beampatterns are always float64
+  void set_storage(BEAM_STORAGE storage, double db_range = BEAM_DB_U8_RANGE);
+  BEAM_STORAGE get_storage() { return this->storage; }
+
+  bool open(const std::string &path);
+  void close();
+  bool is_open() { return this->file.is_open(); }
+  std::string get_path() { return this->file.get_path(); }
+  size_t get_num_frames() { return this->index.size(); }
+
+  BEAM_LOG_WRITE write(const UdpBeamform2D &beam);
+  BEAM_LOG_WRITE write(const UdpBeamformRaw &beam);
+  // hand buffered frames to the I/O thread
+  void flush() { this->file.flush(); }
+
+  void set_fsync_policy(FSYNC_POLICY policy, double period_sec = 5.0) {
+    this->file.set_fsync_policy(policy, period_sec);
+  }
+  WriterStats get_stats() {
+    WriterStats stats = this->file.get_stats();
+    stats.dropped += this->frames_dropped;
+    return stats;
+  }
+
+protected:
+  // true when the frame belongs in this file; writes the file header on the first frame
+  bool begin_frame(const BeamLogGeometry &geometry, BEAM_STORAGE storage, int64_t time_nsec);
+  void write_frame_header(const BeamLogFrameHeader &hdr);
+
+  AsyncFileWriter file;
+  uint64_t frames_dropped = 0;
+  BEAM_STORAGE storage = BEAM_STORAGE::FLOAT64;
+  double db_range = BEAM_DB_U8_RANGE;
+
+  // current file
+  BeamLogFileHeader header;
+  BeamLogGeometry geometry;
+  bool has_header = false;
+  uint64_t offset = 0;
+  std::vector<BeamLogIndexEntry> index;
+
+  // beampatterns not already in the file's storage are converted here
+  UdpBeamform2D scratch;
+};
+
+// Random access to the frames of one .acbl file. Frames are numbered in time order;
+// find() is a binary search of the time index, read_*() a single seek and read.
+class BeamformLogReader {
+public:
+  BeamformLogReader() {}
+  BeamformLogReader(const std::string &path) { this->open(path); }
+
+  bool open(const std::string &path);
+  void close();
+  bool is_open() { return this->file.is_open(); }
+
+  BEAM_LOG_KIND get_kind() { return this->geometry.kind; }
+  BEAM_STORAGE get_storage() { return (BEAM_STORAGE)this->header.storage; }
+  const BeamLogGeometry &get_geometry() { return this->geometry; }
+  size_t size() { return this->index.size(); }
+  // false when the index was rebuilt from the frames (the writer never closed the file)
+  bool is_indexed() { return this->indexed; }
+
+  std::vector<int64_t> get_times();
+  // First frame at or after time_nsec (size() if none)
+  size_t find(int64_t time_nsec);
+
+  // nullptr when out of range, or when the file holds the other kind of frame
+  std::shared_ptr<UdpBeamform2D> read_2d(size_t frame);
+  std::shared_ptr<UdpBeamformRaw> read_raw(size_t frame);
+
+protected:
+  bool read_at(uint64_t offset, char *data, size_t len);
+  bool read_geometry();
+  bool read_index(uint64_t file_bytes);
+  void rebuild_index(uint64_t file_bytes);
+  // frame header and beampattern bytes into this->frame_buff
+  bool read_frame(size_t frame, BeamLogFrameHeader &hdr);
+
+  std::ifstream file;
+  BeamLogFileHeader header;
+  BeamLogGeometry geometry;
+  uint64_t data_offset = 0;
+  std::vector<BeamLogIndexEntry> index; // sorted by time
+  bool indexed = false;
+  std::vector<char> frame_buff;
+};
+
+#endif
@@ -0,0 +1,270 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: Beamformer.cpp                                         */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <chrono>
+#include <complex>
+#include <glog/logging.h>
+#include <thread>
+
+// includes from within project
+#include "utils/Beamformer.h"
+
+DEFINE_bool(debug_beamformer, false, "Enable expanded debug for Beamformer");
+
+bool Beamformer::steering_is_current(const IpcFFT &ipc_fft, const std::vector<int> &columns) {
+  if (this->steering == nullptr || this->_geometry_update || this->_rx_runtime_update ||
+      ipc_fft.FS != this->steering_fs || this->steering_bins.size() != columns.size()) {
+    return false;
+  }
+  for (size_t kk = 0; kk < columns.size(); kk++) {
+    int bin = ipc_fft.bins.empty() ? columns[kk] : ipc_fft.bins[columns[kk]];
+    if (bin != this->steering_bins[kk])
+      return false;
+  }
+  return true;
+}
+
+void Beamformer::update_steering(const IpcFFT &ipc_fft, const std::vector<int> &columns) {
+  SteeringGrid grid;
+  grid.array_x = this->array_x;
+  grid.array_y = this->array_y;
+  grid.array_z = this->array_z;
+  grid.bearings_rad = this->bearings_rad;
+  grid.elevations_rad = this->elevations_rad;
+  grid.sound_speed = this->sound_speed;
+  grid.frequencies.resize(columns.size());
+  this->steering_bins.resize(columns.size());
+  for (size_t kk = 0; kk < columns.size(); kk++) {
+    int bin = ipc_fft.bins.empty() ? columns[kk] : ipc_fft.bins[columns[kk]];
+    grid.frequencies[kk] = ipc_fft.FS * bin / this->NFFT;
+    this->steering_bins[kk] = bin;
+  }
+  this->steering = SteeringCache::instance().get(grid);
+  this->steering_fs = ipc_fft.FS;
+
+  // Bartlett weights, normalized so a unit plane wave has unit response
+  this->weights = this->element_weights.cwiseProduct(this->element_mask.cast<double>());
+  if (this->weights.sum() > 0)
+    this->weights /= this->weights.sum();
+  this->_geometry_update = false;
+  this->_rx_runtime_update = false;
+
+  if (FLAGS_debug_beamformer)
+    VLOG(3) << this->thread_name << " :: Steering " << this->steering->num_beams << " beams x "
+            << this->steering->num_elements << " elements at " << columns.size()
+            << " frequencies";
+}
+
+std::vector<std::shared_ptr<UdpBeamform2D>>
+Beamformer::process(const std::vector<std::shared_ptr<IpcFFT>> &frames) {
+  std::vector<std::shared_ptr<UdpBeamform2D>> patterns;
+  Eigen::Index num_elements = this->array_x.size();
+
+  // only frames matching the array take part
+  this->batch.clear();
+  for (auto &ipc_fft : frames) {
+    if (num_elements == 0 || ipc_fft->fft.rows() != num_elements) {
+      LOG_EVERY_N(WARNING, 1000) << this->thread_name << " :: Dropping FFT frame with "
+                                 << ipc_fft->fft.rows() << " channels; array has "
+                                 << num_elements << " elements";
+      continue;
+    }
+    this->batch.push_back(ipc_fft.get());
+  }
+
+  // runs of frames sharing a layout (bins, FS) are beamformed together
+  size_t run_start = 0;
+  for (size_t ii = 1; ii <= this->batch.size(); ii++) {
+    if (ii == this->batch.size() || this->batch[ii]->bins != this->batch[run_start]->bins ||
+        this->batch[ii]->FS != this->batch[run_start]->FS) {
+      this->beamform(run_start, ii, patterns);
+      run_start = ii;
+    }
+  }
+  return patterns;
+}
+
+void Beamformer::beamform(size_t first, size_t last,
+                          std::vector<std::shared_ptr<UdpBeamform2D>> &patterns) {
+  const IpcFFT &layout = *this->batch[first];
+  // the sample rate comes with the frames, so set_sample_rate() is optional
+  if (layout.FS > 0 && layout.FS != this->sample_rate) {
+    this->set_sample_rate(layout.FS);
+  }
+  const std::vector<int> &columns = this->active_columns(layout);
+  if (columns.empty()) {
+    LOG_EVERY_N(WARNING, 1000) << this->thread_name << " :: No active frequencies to beamform";
+    return;
+  }
+  if (!this->steering_is_current(layout, columns)) {
+    this->update_steering(layout, columns);
+  }
+
+  // Beam power summed over frequency: per frequency, one GEMM over the whole run
+  Eigen::Index num_elements = this->array_x.size();
+  Eigen::Index num_frames = last - first;
+  this->snapshots.resize(num_elements, num_frames);
+  this->beam_power.setZero(this->steering->num_beams, num_frames);
+  for (size_t kk = 0; kk < columns.size(); kk++) {
+    for (Eigen::Index ii = 0; ii < num_frames; ii++) {
+      this->snapshots.col(ii) =
+          this->batch[first + ii]->fft.col(columns[kk]).cwiseProduct(this->weights);
+    }
+    this->beams.noalias() = this->steering->frequency(kk) * this->snapshots;
+    this->beam_power += this->beams.cwiseAbs2();
+  }
+  this->beam_power /= (double)columns.size();
+
+  Eigen::Index num_bearings = this->bearings_rad.size();
+  Eigen::Index num_elevations = this->elevations_rad.size();
+  for (Eigen::Index ii = 0; ii < num_frames; ii++) {
+    const IpcFFT &ipc_fft = *this->batch[first + ii];
+    auto pattern = std::make_shared<UdpBeamform2D>();
+    UdpBeamform2D::Header &hdr = pattern->header;
+    hdr.num_elements = num_elements;
+    hdr.num_frequencies = columns.size();
+    hdr.num_bearings = num_bearings;
+    hdr.num_elevations = num_elevations;
+    hdr.sample_rate = (int32_t)ipc_fft.FS;
+    hdr.window_length_sec = ipc_fft.FS > 0 ? this->NFFT / ipc_fft.FS : 0;
+    hdr.start_time_nsec = ipc_fft.header.start_time_nsec;
+    hdr.packet_num = this->packet_num;
+    this->packet_num =
+        this->packet_num == std::numeric_limits<int>::max() ? 0 : this->packet_num + 1;
+
+    UdpBeamform2D::Payload &d = pattern->data;
+    d.array_x = this->array_x;
+    d.array_y = this->array_y;
+    d.array_z = this->array_z;
+    d.frequencies = this->steering->grid.frequencies;
+    d.element_mask = this->element_mask;
+    d.element_weights = this->element_weights;
+    d.bearings_rad = this->bearings_rad;
+    d.elevations_rad = this->elevations_rad;
+    // beams run bearing-major within each elevation: a column-major bearings x elevations
+    d.beampattern = 10 * Eigen::Map<const Eigen::MatrixXd>(this->beam_power.col(ii).data(),
+                                                           num_bearings, num_elevations)
+                             .array()
+                             .max(std::numeric_limits<double>::min())
+                             .log10();
+    pattern->stage_times = ipc_fft.stage_times;
+    patterns.push_back(pattern);
+  }
+}
+
+void Beamformer::run_beamformer_thread() {
+  prctl(PR_SET_NAME, this->thread_name.substr(0, 15).c_str());
+  VLOG(3) << "Starting beamformer in thread " << pthread_self();
+  this->_is_running = true;
+
+  std::vector<std::shared_ptr<IpcFFT>> new_frames;
+  std::vector<std::shared_ptr<UdpBeamform2D>> patterns;
+
+  while (this->keep_alive) {
+    if (this->q_fft->pop_all(new_frames)) {
+      auto t_start = std::chrono::steady_clock::now();
+      patterns = this->process(new_frames);
+      this->processing_stats->add_busy(t_start);
+      this->processing_stats->items_in += new_frames.size();
+      this->processing_stats->items_out += patterns.size();
+      for (auto &pattern : patterns) {
+        for (auto q_beam2d : this->v_q_beam2d) {
+          q_beam2d->push(pattern);
+        }
+      }
+    }
+    this->log_queue_health();
+
+    std::this_thread::sleep_for(std::chrono::microseconds(1000));
+  }
+
+  this->_is_running = false;
+}
+
+void *Beamformer::_run_beamformer_thread(void *ptr) {
+  Beamformer *argPtr = static_cast<Beamformer *>(ptr);
+  argPtr->run_beamformer_thread();
+  pthread_exit(NULL);
+}
+
+void Beamformer::run() {
+  pthread_t thread;
+  this->keep_alive = true;
+  this->register_queues();
+  if (!this->is_running()) {
+    pthread_create(&thread, NULL, _run_beamformer_thread, this);
+    this->own_thread = thread;
+  } else {
+    LOG(WARNING) << "Beamformer thread already running";
+  }
+}
+
+void Beamformer::register_client(QueueClient &client) {
+  if (client.q_beam2d != nullptr) {
+    this->v_q_beam2d.push_back(client.q_beam2d);
+  } else {
+    LOG(WARNING) << "Cannot register beamformer data queue; received nullptr!";
+  }
+}
+
+void Beamformer::register_client(ptr_tsQ<UdpBeamform2D> q_beam2d) {
+  this->v_q_beam2d.push_back(q_beam2d);
+}
+
+// Array and look direction configuration
+// ======================================
+void Beamformer::set_array(const Eigen::VectorXd &array_x, const Eigen::VectorXd &array_y,
+                           const Eigen::VectorXd &array_z) {
+  if (array_x.size() != array_y.size() || array_x.size() != array_z.size()) {
+    LOG(WARNING) << this->thread_name << " :: Element coordinates differ in length ("
+                 << array_x.size() << ", " << array_y.size() << ", " << array_z.size() << ")";
+    return;
+  }
+  this->array_x = array_x;
+  this->array_y = array_y;
+  this->array_z = array_z;
+  this->element_weights = Eigen::VectorXd::Ones(array_x.size());
+  this->element_mask = Eigen::VectorX<bool>::Constant(array_x.size(), true);
+  this->_geometry_update = true;
+}
+
+void Beamformer::set_element_weights(const Eigen::VectorXd &element_weights) {
+  if (element_weights.size() != this->array_x.size()) {
+    LOG(WARNING) << this->thread_name << " :: Expected " << this->array_x.size()
+                 << " element weights; received " << element_weights.size();
+    return;
+  }
+  this->element_weights = element_weights;
+  this->_geometry_update = true;
+}
+
+void Beamformer::set_element_mask(const Eigen::VectorX<bool> &element_mask) {
+  if (element_mask.size() != this->array_x.size()) {
+    LOG(WARNING) << this->thread_name << " :: Expected " << this->array_x.size()
+                 << " element mask entries; received " << element_mask.size();
+    return;
+  }
+  this->element_mask = element_mask;
+  this->_geometry_update = true;
+}
+
+void Beamformer::set_bearings_rad(const Eigen::VectorXd &bearings_rad) {
+  this->bearings_rad = bearings_rad;
+  this->_geometry_update = true;
+}
+
+void Beamformer::set_elevations_rad(const Eigen::VectorXd &elevations_rad) {
+  this->elevations_rad = elevations_rad;
+  this->_geometry_update = true;
+}
+
+void Beamformer::set_sound_speed(double sound_speed) {
+  this->sound_speed = sound_speed;
+  this->_geometry_update = true;
+}
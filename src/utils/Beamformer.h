@@ -0,0 +1,106 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: Beamformer.h                                           */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef beamformer_HEADER
+#define beamformer_HEADER
+
+#include <Eigen/Dense>
+#include <pthread.h>
+
+// includes from within project
+#include "utils/FreqDomainBase.h"
+#include "utils/SteeringCache.h"
+
+DECLARE_bool(debug_beamformer);
+
+// Frequency-domain conventional (Bartlett) beamformer over IpcFFT frames, one channel
+// per array element. The active frequencies (add_frequency_band_*) are beamformed and
+// their beam powers averaged into a UdpBeamform2D-compatible beampattern
+// (num_bearings x num_elevations, dB re 1 unit^2/Hz given the FFT's PSD scaling).
+//
+// Look directions: bearing in the x-y plane from +x towards +y, elevation up from that
+// plane (+z), so u = (cos(el) cos(brg), cos(el) sin(brg), sin(el)); coordinates in m.
+//
+// Steering vectors come from the process-wide SteeringCache (shared with any other
+// beamformer on the same array and grid) and are only looked up again when the geometry,
+// grid or frame layout changes; each frequency of a batch of frames is a single complex
+// GEMM (beams x elements) * (elements x frames), the element weights applied to the
+// snapshots.
+class Beamformer : public FreqDomainBase {
+public:
+  std::vector<ptr_tsQ<UdpBeamform2D>> v_q_beam2d;
+
+  Beamformer() : FreqDomainBase() {
+    this->thread_name = "beam_thr";
+    this->bearings_rad = Eigen::VectorXd::LinSpaced(72, 0, 2 * M_PI * 71 / 72);
+    this->elevations_rad = Eigen::VectorXd::Zero(1);
+  };
+  static std::shared_ptr<Beamformer> create() { return std::make_shared<Beamformer>(); }
+
+  void run() override;
+  void register_client(QueueClient &client);
+  void register_client(ptr_tsQ<UdpBeamform2D> q_beam2d);
+
+  std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> get_input_queue() { return this->q_fft; };
+
+  // Element coordinates; resets the weights to 1 and the mask to all elements
+  void set_array(const Eigen::VectorXd &array_x, const Eigen::VectorXd &array_y,
+                 const Eigen::VectorXd &array_z);
+  void set_element_weights(const Eigen::VectorXd &element_weights);
+  void set_element_mask(const Eigen::VectorX<bool> &element_mask);
+  void set_bearings_rad(const Eigen::VectorXd &bearings_rad);
+  void set_elevations_rad(const Eigen::VectorXd &elevations_rad);
+  void set_sound_speed(double sound_speed);
+
+  size_t get_num_elements() { return this->array_x.size(); }
+  Eigen::VectorXd get_bearings_rad() { return this->bearings_rad; }
+  Eigen::VectorXd get_elevations_rad() { return this->elevations_rad; }
+  double get_sound_speed() { return this->sound_speed; }
+
+  // Synchronous processing: one beampattern per frame (frames whose channel count does
+  // not match the array are dropped). The sample rate is taken from the frames.
+  std::vector<std::shared_ptr<UdpBeamform2D>>
+  process(const std::vector<std::shared_ptr<IpcFFT>> &frames);
+  void reset() { this->steering = nullptr; }
+
+protected:
+  static void *_run_beamformer_thread(void *arg);
+  void run_beamformer_thread();
+  // beamform batch[first, last), which share one frame layout
+  void beamform(size_t first, size_t last, std::vector<std::shared_ptr<UdpBeamform2D>> &patterns);
+  void update_steering(const IpcFFT &ipc_fft, const std::vector<int> &columns);
+  bool steering_is_current(const IpcFFT &ipc_fft, const std::vector<int> &columns);
+
+  // configuration
+  Eigen::VectorXd array_x;
+  Eigen::VectorXd array_y;
+  Eigen::VectorXd array_z;
+  Eigen::VectorXd element_weights;
+  Eigen::VectorX<bool> element_mask;
+  Eigen::VectorXd bearings_rad;
+  Eigen::VectorXd elevations_rad;
+  double sound_speed = 1500;
+  bool _geometry_update = true;
+
+  // processing state, owned by whichever thread calls process()
+  int32_t packet_num = 0;
+  // steering tensor of the active frequencies, the frame layout it was looked up for, and
+  // the normalized element weights
+  std::shared_ptr<const SteeringTensor> steering;
+  std::vector<int> steering_bins;
+  double steering_fs = -1;
+  Eigen::VectorXd weights;
+  // per batch: the frames, element snapshots of one frequency, beam outputs, summed power
+  std::vector<const IpcFFT *> batch;
+  Eigen::MatrixXcd snapshots;
+  Eigen::MatrixXcd beams;
+  Eigen::MatrixXd beam_power;
+};
+
+#endif
@@ -0,0 +1,126 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: BearingTimeRecord.cpp                                  */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <glog/logging.h>
+
+// includes from within project
+#include "utils/BearingTimeRecord.h"
+
+void BearingTimeRecord::set_history(size_t history) {
+  this->history = std::max<size_t>(history, 1);
+  this->bearings_rad.resize(0); // resized on the next frame
+  this->clear();
+}
+
+void BearingTimeRecord::clear() {
+  this->head = 0;
+  this->count = 0;
+  this->peaks.clear();
+}
+
+void BearingTimeRecord::add(const UdpBeamform2D &beam) {
+  const Eigen::VectorXd &bearings = beam.data.bearings_rad;
+  if (beam.beampattern_rows() != bearings.size()) {
+    LOG_EVERY_N(WARNING, 1000) << "BTR :: Dropping beampattern with " << beam.beampattern_rows()
+                               << " rows for " << bearings.size() << " bearings";
+    return;
+  }
+  if (bearings.size() != this->bearings_rad.size() || bearings != this->bearings_rad) {
+    this->bearings_rad = bearings;
+    this->ring.resize(bearings.size(), std::max<size_t>(this->history, 1));
+    this->times.assign(this->ring.cols(), 0);
+    this->clear();
+    VLOG(3) << "BTR :: " << bearings.size() << " bearings x " << this->ring.cols() << " frames";
+  }
+
+  beam.reduce_elevation(this->ring.col(this->head), this->reduction);
+  this->times[this->head] = beam.header.start_time_nsec;
+  if (this->num_peaks > 0) {
+    this->find_peaks(this->ring.col(this->head), this->bearings_rad, this->num_peaks,
+                     this->peaks);
+    for (auto &peak : this->peaks) {
+      peak.time_nsec = beam.header.start_time_nsec;
+    }
+  }
+  this->head = (this->head + 1) % this->ring.cols();
+  this->count = std::min<size_t>(this->count + 1, this->ring.cols());
+}
+
+size_t BearingTimeRecord::oldest() {
+  return this->count == 0 ? 0 : (this->head + this->ring.cols() - this->count) % this->ring.cols();
+}
+
+Eigen::MatrixXd BearingTimeRecord::get_btr() {
+  Eigen::MatrixXd btr(this->ring.rows(), this->count);
+  // the ring wraps at most once
+  size_t first = this->oldest();
+  size_t num_tail = std::min<size_t>(this->count, this->ring.cols() - first);
+  btr.leftCols(num_tail) = this->ring.middleCols(first, num_tail);
+  btr.rightCols(this->count - num_tail) = this->ring.leftCols(this->count - num_tail);
+  return btr;
+}
+
+std::vector<int64_t> BearingTimeRecord::get_times() {
+  std::vector<int64_t> times;
+  times.reserve(this->count);
+  size_t first = this->oldest();
+  for (size_t ii = 0; ii < this->count; ii++) {
+    times.push_back(this->times[(first + ii) % this->ring.cols()]);
+  }
+  return times;
+}
+
+void BearingTimeRecord::find_peaks(const Eigen::Ref<const Eigen::VectorXd> &line,
+                                   const Eigen::VectorXd &bearings_rad, size_t num_peaks,
+                                   std::vector<BearingPeak> &peaks) {
+  peaks.clear();
+  int n = line.size();
+  if (n == 0 || bearings_rad.size() != n)
+    return;
+
+  // a uniform grid whose next step would land back on the first bearing wraps around
+  double step = n > 1 ? (bearings_rad[n - 1] - bearings_rad[0]) / (n - 1) : 0;
+  bool circular = n > 2 && std::abs(n * step - 2 * M_PI) < std::abs(step) / 2;
+
+  this->candidates.clear();
+  for (int ii = 0; ii < n; ii++) {
+    int left = ii > 0 ? ii - 1 : (circular ? n - 1 : -1);
+    int right = ii < n - 1 ? ii + 1 : (circular ? 0 : -1);
+    // plateaus report their last bearing
+    if ((left < 0 || line[ii] >= line[left]) && (right < 0 || line[ii] > line[right]))
+      this->candidates.push_back(ii);
+  }
+  size_t num_kept = std::min(num_peaks, this->candidates.size());
+  std::partial_sort(this->candidates.begin(), this->candidates.begin() + num_kept,
+                    this->candidates.end(), [&line](int a, int b) { return line[a] > line[b]; });
+
+  for (size_t kk = 0; kk < num_kept; kk++) {
+    int ii = this->candidates[kk];
+    BearingPeak peak{ii, bearings_rad[ii], line[ii], 0};
+    int left = ii > 0 ? ii - 1 : (circular ? n - 1 : -1);
+    int right = ii < n - 1 ? ii + 1 : (circular ? 0 : -1);
+    if (left >= 0 && right >= 0) {
+      // vertex of the parabola through the peak and its neighbours, within half a step
+      double curvature = line[left] - 2 * line[ii] + line[right];
+      if (curvature < 0) {
+        double offset = 0.5 * (line[left] - line[right]) / curvature;
+        double spacing = circular ? step : 0.5 * (bearings_rad[right] - bearings_rad[left]);
+        peak.bearing_rad += offset * spacing;
+        peak.level -= 0.25 * (line[left] - line[right]) * offset;
+        if (circular) {
+          peak.bearing_rad = bearings_rad[0] +
+                             std::fmod(peak.bearing_rad - bearings_rad[0] + 2 * M_PI, 2 * M_PI);
+        }
+      }
+    }
+    peaks.push_back(peak);
+  }
+}
@@ -0,0 +1,75 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: BearingTimeRecord.h                                    */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef bearing_time_record_HEADER
+#define bearing_time_record_HEADER
+
+#include <Eigen/Dense>
+#include <vector>
+
+// includes from within project
+#include "udp_protocols/UdpBeamform2D.h"
+
+// One local maximum of a BTR line, parabolically interpolated between bearings
+struct BearingPeak {
+  int32_t index;      // nearest bearing of the grid
+  double bearing_rad; // interpolated
+  double level;       // interpolated, in the beampattern's units
+  int64_t time_nsec;
+};
+
+// Bearing-time record: the last `history` beampatterns reduced over elevation, kept in a
+// preallocated ring (one column per frame), plus the strongest peaks of the latest frame.
+// Once sized for the bearing grid, add() allocates nothing.
+class BearingTimeRecord {
+public:
+  BearingTimeRecord(size_t history = 1000) : history(history) {}
+
+  void set_history(size_t history);
+  void set_reduction(BTR_REDUCTION reduction) { this->reduction = reduction; }
+  BTR_REDUCTION get_reduction() { return this->reduction; }
+  // strongest peaks picked per frame; 0 disables peak picking
+  void set_num_peaks(size_t num_peaks) { this->num_peaks = num_peaks; }
+  size_t get_num_peaks() { return this->num_peaks; }
+
+  // Reduce one beampattern into the next column; a new bearing grid restarts the record
+  void add(const UdpBeamform2D &beam);
+  void clear();
+
+  size_t size() { return this->count; }
+  Eigen::VectorXd get_bearings_rad() { return this->bearings_rad; }
+  // num_bearings x size(), oldest frame first, and the frames' start times
+  Eigen::MatrixXd get_btr();
+  std::vector<int64_t> get_times();
+  // peaks of the latest frame, strongest first
+  const std::vector<BearingPeak> &get_latest_peaks() { return this->peaks; }
+
+  // Up to num_peaks local maxima of line (over bearings_rad), strongest first. The grid
+  // wraps around when it spans the full circle.
+  void find_peaks(const Eigen::Ref<const Eigen::VectorXd> &line,
+                  const Eigen::VectorXd &bearings_rad, size_t num_peaks,
+                  std::vector<BearingPeak> &peaks);
+
+protected:
+  size_t oldest(); // ring column of the oldest frame
+
+  size_t history;
+  BTR_REDUCTION reduction = BTR_REDUCTION::MEAN;
+  size_t num_peaks = 0;
+
+  Eigen::VectorXd bearings_rad;
+  Eigen::MatrixXd ring;       // num_bearings x history
+  std::vector<int64_t> times; // per ring column
+  size_t head = 0;            // next column written
+  size_t count = 0;
+  std::vector<BearingPeak> peaks;
+  std::vector<int> candidates;
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: CsvWriter.h                                            */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef csv_writer_HEADER
+#define csv_writer_HEADER
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Row formatter for the CSV loggers.
+//
+// Values are appended with std::to_chars into a single reusable buffer, bypassing
+// iostream formatting and locale handling entirely. Callers format a whole batch of
+// rows and then hand the buffer to the output in one write() call; no std::endl,
+// no per-row flush. Floating point values use fixed notation with 6 decimals by
+// default, to match the previous `ofil << std::fixed << value` output.
+class CsvWriter {
+public:
+  CsvWriter(size_t reserve_bytes = 1 << 20) {
+    this->buff.resize(reserve_bytes > 64 ? reserve_bytes : 64);
+    this->len = 0;
+  }
+
+  // Append values
+  // =============
+  // any integer type (int64_t, long long, uint8_t, ...) prints as a number; char and bool
+  // have overloads of their own
+  template <typename T,
+            typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value &&
+                                        !std::is_same<T, bool>::value,
+                                    int>::type = 0>
+  inline CsvWriter &put(T value) {
+    this->reserve(24);
+    auto res = std::to_chars(this->buff.data() + this->len, this->buff.data() + this->buff.size(),
+                             value);
+    this->len = res.ptr - this->buff.data();
+    return *this;
+  }
+
+  inline CsvWriter &put(double value, int precision = 6) {
+    // fixed notation of a double can be up to ~310 integer digits
+    this->reserve(330 + precision);
+    auto res = std::to_chars(this->buff.data() + this->len, this->buff.data() + this->buff.size(),
+                             value, std::chars_format::fixed, precision);
+    this->len = res.ptr - this->buff.data();
+    return *this;
+  }
+  inline CsvWriter &put(float value, int precision = 6) {
+    this->reserve(60 + precision);
+    auto res = std::to_chars(this->buff.data() + this->len, this->buff.data() + this->buff.size(),
+                             value, std::chars_format::fixed, precision);
+    this->len = res.ptr - this->buff.data();
+    return *this;
+  }
+
+  inline CsvWriter &put(bool value) { return this->put(value ? '1' : '0'); }
+  inline CsvWriter &put(char value) {
+    this->reserve(1);
+    this->buff[this->len++] = value;
+    return *this;
+  }
+  inline CsvWriter &put(const char *value, size_t n) {
+    this->reserve(n);
+    std::memcpy(this->buff.data() + this->len, value, n);
+    this->len += n;
+    return *this;
+  }
+  inline CsvWriter &put(const std::string &value) { return this->put(value.data(), value.size()); }
+
+  inline CsvWriter &sep() { return this->put(','); }
+  inline CsvWriter &eol() { return this->put('\n'); }
+
+  // Access formatted batch
+  // ======================
+  const char *data() const { return this->buff.data(); }
+  size_t size() const { return this->len; }
+  bool empty() const { return this->len == 0; }
+  void clear() { this->len = 0; }
+
+  // Single write of the accumulated rows; buffer is reset afterwards
+  template <typename OUT> void write_to(OUT &out) {
+    if (this->len > 0) {
+      out.write(this->buff.data(), this->len);
+    }
+    this->len = 0;
+  }
+
+protected:
+  inline void reserve(size_t n) {
+    if (this->len + n > this->buff.size()) {
+      this->buff.resize(2 * (this->len + n));
+    }
+  }
+
+  std::vector<char> buff;
+  size_t len;
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: Decimator.cpp                                          */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <cmath>
+#include <glog/logging.h>
+
+// includes from within project
+#include "utils/Decimator.h"
+
+// Output rate margin over the bandwidth; the transition band is the
+// margin, so a larger value means fewer taps but less decimation
+static const double RATE_MARGIN = 1.25;
+
+size_t Decimator::configure_lowpass(double fs_in, double f_high) {
+  // components above fs_out - f_high fold outside 0..f_high, so the stopband starts there
+  size_t factor = f_high > 0 ? (size_t)std::floor(fs_in / (2 * RATE_MARGIN * f_high)) : 1;
+  double fs_out = fs_in / std::max<size_t>(factor, 1);
+  return this->design(fs_in, f_high, fs_out - f_high, factor);
+}
+
+size_t Decimator::design(double fs_in, double f_pass, double f_stop, size_t factor) {
+  this->fs_in = fs_in;
+  this->factor = std::max<size_t>(factor, 1);
+  this->reset();
+
+  if (this->factor < 2) {
+    this->factor = 1;
+    this->taps = Eigen::VectorXd::Ones(1);
+    return this->factor;
+  }
+
+  // Hamming-windowed sinc: transition width ~ 3.3 fs / num_taps
+  size_t num_taps = (size_t)std::ceil(3.3 * fs_in / (f_stop - f_pass)) | 1;
+  double fc = (f_pass + f_stop) / 2 / fs_in;
+  double mid = (num_taps - 1) / 2.0;
+  this->taps.resize(num_taps);
+  for (size_t nn = 0; nn < num_taps; nn++) {
+    double t = nn - mid;
+    double sinc = t == 0 ? 2 * fc : std::sin(2 * M_PI * fc * t) / (M_PI * t);
+    this->taps[nn] = sinc * (0.54 - 0.46 * std::cos(2 * M_PI * nn / (num_taps - 1)));
+  }
+  // unity gain at DC; symmetric, so already time-reversed
+  this->taps /= this->taps.sum();
+
+  VLOG(1) << "Decimator :: " << fs_in << " Hz / " << this->factor << " = "
+          << fs_in / this->factor << " Hz, " << num_taps << " taps";
+  return this->factor;
+}
+
+void Decimator::reset() {
+  this->phase = 0;
+  this->history.resize(0, 0);
+}
+
+size_t Decimator::count_outputs(size_t n_in, size_t &phase) const {
+  size_t count = n_in > phase ? (n_in - 1 - phase) / this->factor + 1 : 0;
+  phase = phase + count * this->factor - n_in;
+  return count;
+}
+
+Eigen::MatrixXd Decimator::process(const Eigen::MatrixXd &in) {
+  size_t num_taps = this->taps.size();
+  if (this->history.rows() != in.rows() || (size_t)this->history.cols() != num_taps - 1) {
+    this->history = Eigen::MatrixXd::Zero(in.rows(), num_taps - 1);
+  }
+
+  // [last num_taps-1 samples, new samples]; output at input p uses columns p .. p+num_taps-1
+  Eigen::MatrixXd extended(in.rows(), this->history.cols() + in.cols());
+  extended << this->history, in;
+
+  size_t phase = this->phase;
+  size_t count = this->count_outputs(in.cols(), phase);
+  Eigen::MatrixXd out(in.rows(), count);
+  for (size_t ii = 0; ii < count; ii++) {
+    out.col(ii) = extended.middleCols(this->phase + ii * this->factor, num_taps) * this->taps;
+  }
+
+  this->phase = phase;
+  this->history = extended.rightCols(num_taps - 1);
+  return out;
+}
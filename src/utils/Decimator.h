@@ -0,0 +1,55 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: Decimator.h                                            */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef decimator_HEADER
+#define decimator_HEADER
+
+#include <Eigen/Dense>
+#include <vector>
+
+// Streaming multi-channel FIR decimator (channels x samples in, channels x samples/D out).
+// Only every D-th output is evaluated, which is the polyphase form of filter-then-drop.
+// Filter state carries across calls, so packets can be fed one at a time.
+//
+// configure_lowpass(fs, f_high) keeps 0..f_high, with the largest factor D that keeps that
+// band clear of aliases with a Hamming-windowed sinc (~53 dB stopband); D = 1 means no
+// decimation is worthwhile.
+class Decimator {
+public:
+  Decimator() {}
+
+  size_t configure_lowpass(double fs_in, double f_high);
+  void reset();
+
+  Eigen::MatrixXd process(const Eigen::MatrixXd &in);
+
+  // Number of outputs the next n_in input samples yield, advancing phase as process() would
+  size_t count_outputs(size_t n_in, size_t &phase) const;
+
+  bool is_enabled() const { return this->factor > 1; }
+  size_t get_factor() const { return this->factor; }
+  size_t get_num_taps() const { return this->taps.size(); }
+  // input sample (within the next block) that the next output lines up with
+  size_t get_phase() const { return this->phase; }
+  double get_output_rate() const { return this->fs_in / this->factor; }
+  // filter group delay, in input samples
+  double get_delay() const { return (this->taps.size() - 1) / 2.0; }
+
+protected:
+  size_t design(double fs_in, double f_pass, double f_stop, size_t factor);
+
+  double fs_in = 0;
+  size_t factor = 1;
+  Eigen::VectorXd taps; // time-reversed, so an output is a block of samples times taps
+
+  size_t phase = 0;
+  Eigen::MatrixXd history;
+};
+
+#endif
@@ -0,0 +1,85 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: DetectionEventBuilder.cpp                              */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <glog/logging.h>
+#include <limits>
+
+// includes from within project
+#include "utils/DetectionEventBuilder.h"
+
+void DetectionEventBuilder::set_max_duration_sec(double max_duration_sec) {
+  this->max_duration_nsec = (int64_t)(max_duration_sec * 1e9);
+}
+
+void DetectionEventBuilder::add(const IpcDetector &frame,
+                                std::vector<std::shared_ptr<IpcDetectionEvent>> &out) {
+  if (frame.detections <= 0) {
+    if (this->event != nullptr && ++this->gap_frames > this->max_gap_frames) {
+      this->flush(out);
+    }
+    return;
+  }
+
+  if (this->event != nullptr &&
+      frame.header.start_time_nsec - this->event->header.start_time_nsec >=
+          this->max_duration_nsec) {
+    this->flush(out);
+  }
+  if (this->event == nullptr) {
+    this->event = std::make_shared<IpcDetectionEvent>();
+    this->event->header.start_time_nsec = frame.header.start_time_nsec;
+    this->event->header.packet_num = this->event_num;
+    this->event_num =
+        this->event_num == std::numeric_limits<int32_t>::max() ? 0 : this->event_num + 1;
+    this->event->stage_times = frame.stage_times;
+    this->event->f_low = std::numeric_limits<float>::max();
+    this->event->f_high = std::numeric_limits<float>::lowest();
+    this->event->peak_snr_db = std::numeric_limits<float>::lowest();
+  }
+  this->merge(frame);
+  this->gap_frames = 0;
+}
+
+void DetectionEventBuilder::merge(const IpcDetector &frame) {
+  IpcDetectionEvent &ev = *this->event;
+  ev.end_time_nsec = frame.header.start_time_nsec + this->frame_duration_nsec;
+  ev.num_frames++;
+  ev.num_cells += frame.cells.size();
+  for (const DetectorCell &cell : frame.cells) {
+    ev.channel_mask |= 1ULL << std::min(cell.channel, 63);
+    ev.f_low = std::min(ev.f_low, (float)cell.frequency);
+    ev.f_high = std::max(ev.f_high, (float)cell.frequency);
+    if (cell.snr_db > ev.peak_snr_db) {
+      ev.peak_snr_db = cell.snr_db;
+      ev.peak_frequency = cell.frequency;
+      ev.peak_channel = cell.channel;
+      ev.peak_band = cell.band;
+    }
+  }
+}
+
+void DetectionEventBuilder::flush(std::vector<std::shared_ptr<IpcDetectionEvent>> &out) {
+  if (this->event == nullptr) {
+    return;
+  }
+  if (this->event->num_cells == 0) {
+    // frames counted detections without cells; there is no extent or peak to report
+    this->event->f_low = this->event->f_high = 0;
+    this->event->peak_snr_db = 0;
+  }
+  out.push_back(this->event);
+  this->event.reset();
+  this->gap_frames = 0;
+}
+
+void DetectionEventBuilder::reset() {
+  this->event.reset();
+  this->gap_frames = 0;
+}
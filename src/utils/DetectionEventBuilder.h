@@ -0,0 +1,55 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: DetectionEventBuilder.h                                */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef detection_event_builder_HEADER
+#define detection_event_builder_HEADER
+
+#include <memory>
+#include <vector>
+
+// includes from within project
+#include "ipc_protocols/IpcDetectionEvent.h"
+#include "ipc_protocols/IpcDetector.h"
+
+// Merges consecutive detecting IpcDetector frames into IpcDetectionEvent records. An
+// event stays open across up to max_gap_frames frames without detections, and is
+// closed (and a new one opened) once it spans max_duration_sec, so a persistent source
+// still reports periodically.
+class DetectionEventBuilder {
+public:
+  DetectionEventBuilder() {}
+
+  void set_max_gap_frames(size_t max_gap_frames) { this->max_gap_frames = max_gap_frames; }
+  void set_max_duration_sec(double max_duration_sec);
+  // frame length, so an event ends where its last frame does rather than where it starts
+  void set_frame_duration_nsec(int64_t frame_duration_nsec) {
+    this->frame_duration_nsec = frame_duration_nsec;
+  }
+
+  // Feed one frame, in time order; completed events are appended to out
+  void add(const IpcDetector &frame, std::vector<std::shared_ptr<IpcDetectionEvent>> &out);
+  // Close the open event, if any (e.g. at the end of a file)
+  void flush(std::vector<std::shared_ptr<IpcDetectionEvent>> &out);
+  void reset();
+
+  bool is_open() const { return this->event != nullptr; }
+
+protected:
+  void merge(const IpcDetector &frame);
+
+  size_t max_gap_frames = 2;
+  int64_t max_duration_nsec = 60000000000;
+  int64_t frame_duration_nsec = 0;
+
+  std::shared_ptr<IpcDetectionEvent> event;
+  size_t gap_frames = 0;
+  int32_t event_num = 0;
+};
+
+#endif
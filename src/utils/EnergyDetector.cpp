@@ -7,114 +7,349 @@
 /*    For help, contact us at: support@acbotics.com                */
 /*******************************************************************/
 
-#include <glog/logging.h>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <glog/logging.h>
 // includes from within project
 #include "utils/EnergyDetector.h"
 
 DEFINE_bool(debug_energy_detector, false, "Enable expanded debug for Energy Detector");
 
-void *EnergyDetector::_run_detector_thread(void *ptr) {
+void EnergyDetector::update_bands() {
+  this->bin_band.assign(this->frequency_vector.size(), -1);
+  for (Eigen::Index bin = 0; bin < this->frequency_vector.size(); bin++) {
+    for (size_t band = 0; band < this->frequency_bands.size(); band++) {
+      if (this->frequency_vector[bin] >= this->frequency_bands[band].first &&
+          this->frequency_vector[bin] <= this->frequency_bands[band].second) {
+        this->bin_band[bin] = band;
+        break;
+      }
+    }
+  }
+}
 
-  EnergyDetector *argPtr = static_cast<EnergyDetector *>(ptr);
-  prctl(PR_SET_NAME, argPtr->thread_name.substr(0, 15).c_str());
-  VLOG(3) << "Starting energy detector utility in thread " << pthread_self();
-  argPtr->_is_running = true;
+void EnergyDetector::detect(const IpcFFT &ipc_fft, IpcDetector &out) {
+  out.detections = 0;
+  const std::vector<int> &columns = this->active_columns(ipc_fft);
+  if (columns.empty()) {
+    return;
+  }
 
-  std::vector<std::shared_ptr<IpcFFT>> new_packets;
-  std::shared_ptr<IpcFFT> ipc_fft;
-  Eigen::ArrayXXd fft_buffer_in;
-  Eigen::ArrayXXd fft_buffer;
+  Eigen::Index num_channels = ipc_fft.fft.rows();
+  if (this->band_peak.size() != num_channels) {
+    this->bin_mag.resize(num_channels);
+    this->band_peak.resize(num_channels);
+    this->band_sum.resize(num_channels);
+    this->Sxx_ratio.resize(num_channels);
+    this->initialized = false;
+  }
+  bool seed = !this->initialized || this->_rx_runtime_update;
+  if (seed) {
+    this->update_bands();
+    if (this->sample_rate > 0)
+      this->event_builder.set_frame_duration_nsec((int64_t)(this->NFFT / this->sample_rate * 1e9));
+    this->_rx_runtime_update = false;
+    this->initialized = true;
+  }
 
-  // Sxx is using peak-over-mean per ch
-  // (NOT median; due to Eigen built-in convenience)
-  Eigen::ArrayXd Sxx_ratio;
+  if (this->algorithm == DETECTOR_ALGORITHM::EMA_RATIO) {
+    this->detect_ema(ipc_fft, columns, seed, out);
+    return;
+  }
 
-  // Use distict prior / new; Eigen does not like in-place/self-referencing assignment
-  Eigen::ArrayXd ema_st_old;
-  Eigen::ArrayXd ema_lt_old;
-  Eigen::ArrayXd ema_st_new;
-  Eigen::ArrayXd ema_lt_new;
+  // |X|^2 of the active columns, and the band each falls in
+  this->power.resize(num_channels, columns.size());
+  this->column_band.resize(columns.size());
+  for (size_t jj = 0; jj < columns.size(); jj++) {
+    int icol = columns[jj];
+    int bin = ipc_fft.bins.empty() ? icol : ipc_fft.bins[icol];
+    this->power.col(jj) = ipc_fft.fft.col(icol).cwiseAbs2().array();
+    this->column_band[jj] = bin < (int)this->bin_band.size() ? this->bin_band[bin] : -1;
+  }
+  // thresholds as power ratios; the last entry is for bins outside every band
+  this->band_threshold.resize(this->frequency_bands.size() + 1);
+  for (size_t band = 0; band < this->band_threshold.size(); band++) {
+    double threshold_db = band < this->frequency_bands.size() ? this->get_band_threshold_db(band)
+                                                              : this->threshold_db;
+    this->band_threshold[band] = std::pow(10, threshold_db / 10);
+  }
 
-  std::shared_ptr<IpcDetector> detect;
+  if (this->algorithm == DETECTOR_ALGORITHM::MEDIAN_FLOOR) {
+    this->detect_median(ipc_fft, columns, seed, out);
+  } else {
+    this->detect_cfar(ipc_fft, columns, out);
+  }
+}
 
-  double alpha_st = 0.1;    // 2/(N+1) : N=19 (20 points produce >90% of weight distrib)
-  double alpha_lt = 0.0001; // 2/(N+1) : N~20k (20k points produce >90% of weight distrib)
+void EnergyDetector::detect_ema(const IpcFFT &ipc_fft, const std::vector<int> &columns,
+                                bool seed, IpcDetector &out) {
+  // Peak and sum of |X| across the band, one column (all channels) at a time. The
+  // phone sensitivity scales peak and mean alike, so it drops out of the ratio.
+  this->band_peak.setZero();
+  this->band_sum.setZero();
+  for (int icol : columns) {
+    this->bin_mag = ipc_fft.fft.col(icol).cwiseAbs().array();
+    this->band_peak = this->band_peak.max(this->bin_mag);
+    this->band_sum += this->bin_mag;
+  }
+  // (silent input : 0 rather than NaN, which would stick in the averages)
+  this->Sxx_ratio = this->band_peak * (double)columns.size() /
+                    this->band_sum.max(std::numeric_limits<double>::min());
 
-  double threshold = 1.2;
+  if (seed) {
+    this->ema_st = this->Sxx_ratio;
+    this->ema_lt = this->Sxx_ratio;
+  }
 
-  bool initialized = false;
+  // coefficient-wise, so updating in place is alias-free
+  this->ema_st = this->alpha_st * this->Sxx_ratio + (1.0 - this->alpha_st) * this->ema_st;
+  this->ema_lt = this->alpha_lt * this->Sxx_ratio + (1.0 - this->alpha_lt) * this->ema_lt;
 
-  while (argPtr->sample_rate <= 0 && argPtr->keep_alive) {
-    //usleep(100000);
-    std::this_thread::sleep_for(std::chrono::microseconds(100000));
+  for (Eigen::Index ch = 0; ch < this->ema_st.size(); ch++) {
+    if (!(this->ema_st[ch] > this->threshold * this->ema_lt[ch])) {
+      continue;
+    }
+    // report the band peak, with its peak-over-mean as the SNR
+    int peak_col = columns[0];
+    for (int icol : columns) {
+      if (std::norm(ipc_fft.fft(ch, icol)) > std::norm(ipc_fft.fft(ch, peak_col)))
+        peak_col = icol;
+    }
+    int bin = ipc_fft.bins.empty() ? peak_col : ipc_fft.bins[peak_col];
+    int band = bin < (int)this->bin_band.size() ? this->bin_band[bin] : -1;
+    // a magnitude ratio, in dB
+    this->add_cell(ipc_fft, ch, peak_col, band, 20 * std::log10(this->Sxx_ratio[ch]), out);
+    out.detections++;
   }
+}
+
+void EnergyDetector::detect_cfar(const IpcFFT &ipc_fft, const std::vector<int> &columns,
+                                 IpcDetector &out) {
+  long num_cols = columns.size();
+  long num_train = this->num_train;
+  long num_guard = this->num_guard;
+  bool ordered = this->algorithm == DETECTOR_ALGORITHM::OS_CFAR;
+  this->cumsum.resize(num_cols + 1);
+
+  for (Eigen::Index ch = 0; ch < this->power.rows(); ch++) {
+    bool hit = false;
+    if (!ordered) {
+      this->cumsum[0] = 0;
+      for (long jj = 0; jj < num_cols; jj++) {
+        this->cumsum[jj + 1] = this->cumsum[jj] + this->power(ch, jj);
+      }
+    }
+
+    // one band at a time, so training bins stay within the bin under test's band
+    for (long seg_start = 0, seg_end = 0; seg_start < num_cols; seg_start = seg_end) {
+      while (seg_end < num_cols &&
+             this->column_band[seg_end] == this->column_band[seg_start]) {
+        seg_end++;
+      }
+      int band = this->column_band[seg_start];
+      double threshold =
+          this->band_threshold[band < 0 ? this->band_threshold.size() - 1 : band];
+
+      for (long jj = seg_start; jj < seg_end; jj++) {
+        // training bins either side of the guard bins, cut short at the band edges
+        long left_lo = std::max(seg_start, jj - num_guard - num_train);
+        long left_hi = std::max(seg_start, jj - num_guard);
+        long right_lo = std::min(seg_end, jj + num_guard + 1);
+        long right_hi = std::min(seg_end, jj + num_guard + num_train + 1);
+        long count = (left_hi - left_lo) + (right_hi - right_lo);
+        if (count <= 0) {
+          continue;
+        }
+
+        double noise;
+        if (ordered) {
+          this->training.clear();
+          for (long kk = left_lo; kk < left_hi; kk++) {
+            this->training.push_back(this->power(ch, kk));
+          }
+          for (long kk = right_lo; kk < right_hi; kk++) {
+            this->training.push_back(this->power(ch, kk));
+          }
+          long rank = std::min(count - 1, (long)(this->os_rank * count));
+          std::nth_element(this->training.begin(), this->training.begin() + rank,
+                           this->training.end());
+          noise = this->training[rank];
+        } else {
+          noise = (this->cumsum[left_hi] - this->cumsum[left_lo] + this->cumsum[right_hi] -
+                   this->cumsum[right_lo]) /
+                  count;
+        }
+        noise = std::max(noise, std::numeric_limits<double>::min());
 
-  while (argPtr->keep_alive && !initialized) {
-    if (argPtr->q_fft->size() > 0) {
-      fft_buffer_in = (*argPtr->q_fft->front()).fft.array().abs();
-      argPtr->_rx_runtime_update = true;
-      initialized = true;
-    } else {
-      //usleep(10000);
-      std::this_thread::sleep_for(std::chrono::microseconds(10000));
+        if (this->power(ch, jj) > threshold * noise) {
+          this->add_cell(ipc_fft, ch, columns[jj], band,
+                         10 * std::log10(this->power(ch, jj) / noise), out);
+          hit = true;
+        }
+      }
     }
+    out.detections += hit ? 1 : 0;
   }
+}
 
-  while (argPtr->keep_alive) {
-    if (argPtr->_rx_runtime_update) {
-      fft_buffer = fft_buffer_in(Eigen::all, argPtr->active_frequencies) *
-                   std::pow(10, -argPtr->phone_sensitivity_V_uPa / 20);
-      if (argPtr->active_frequencies.size() > 0) {
-        Sxx_ratio = fft_buffer.rowwise().maxCoeff() / fft_buffer.rowwise().mean();
-        ema_st_old = Sxx_ratio;
-        ema_lt_old = Sxx_ratio;
+void EnergyDetector::detect_median(const IpcFFT &ipc_fft, const std::vector<int> &columns,
+                                   bool seed, IpcDetector &out) {
+  // one noise floor per channel and band; the last band slot is for bins outside every band
+  Eigen::Index num_channels = this->power.rows();
+  size_t num_slots = this->band_threshold.size();
+  if (seed || this->noise_floor.size() != num_channels * num_slots) {
+    this->noise_floor.assign(num_channels * num_slots, P2Quantile(0.5));
+  }
+
+  this->band_mean.setZero(num_channels, num_slots);
+  this->band_count.setZero(num_slots);
+  for (size_t jj = 0; jj < columns.size(); jj++) {
+    int slot = this->column_band[jj] < 0 ? num_slots - 1 : this->column_band[jj];
+    this->band_mean.col(slot) += this->power.col(jj);
+    this->band_count[slot] += 1;
+  }
+
+  for (Eigen::Index ch = 0; ch < num_channels; ch++) {
+    bool hit = false;
+    for (size_t jj = 0; jj < columns.size(); jj++) {
+      int slot = this->column_band[jj] < 0 ? num_slots - 1 : this->column_band[jj];
+      const P2Quantile &floor = this->noise_floor[ch * num_slots + slot];
+      // wait until the estimator holds its five markers
+      if (floor.count() < 5) {
+        continue;
+      }
+      double noise = std::max(floor.value(), std::numeric_limits<double>::min());
+      if (this->power(ch, jj) > this->band_threshold[slot] * noise) {
+        this->add_cell(ipc_fft, ch, columns[jj], this->column_band[jj],
+                       10 * std::log10(this->power(ch, jj) / noise), out);
+        hit = true;
       }
-      argPtr->_rx_runtime_update = false;
     }
+    out.detections += hit ? 1 : 0;
+  }
 
-    if (argPtr->sample_rate > 0 && argPtr->q_fft->pop_all(new_packets)) {
+  // the floor follows the band's mean power, including this frame
+  for (Eigen::Index ch = 0; ch < num_channels; ch++) {
+    for (size_t slot = 0; slot < num_slots; slot++) {
+      if (this->band_count[slot] > 0)
+        this->noise_floor[ch * num_slots + slot].add(this->band_mean(ch, slot) /
+                                                     this->band_count[slot]);
+    }
+  }
+}
 
-      for (int ii = 0; ii < new_packets.size(); ii++) {
+void EnergyDetector::add_cell(const IpcFFT &ipc_fft, int channel, int icol, int band,
+                              double snr_db, IpcDetector &out) {
+  DetectorCell cell;
+  cell.channel = channel;
+  cell.bin = ipc_fft.bins.empty() ? icol : ipc_fft.bins[icol];
+  cell.band = band;
+  cell.frequency = ipc_fft.FS * cell.bin / this->NFFT;
+  cell.snr_db = snr_db;
+  cell.time_nsec = ipc_fft.header.start_time_nsec;
+  out.cells.push_back(cell);
+}
 
-        ipc_fft = new_packets.at(ii);
-        fft_buffer_in = ipc_fft->fft.array().abs();
-        fft_buffer = fft_buffer_in(Eigen::all, argPtr->active_frequencies) *
-                     std::pow(10, -argPtr->phone_sensitivity_V_uPa / 20);
+std::shared_ptr<IpcDetector> EnergyDetector::process(const std::shared_ptr<IpcFFT> &ipc_fft) {
+  auto detect = std::make_shared<IpcDetector>();
+  detect->header.start_time_nsec = ipc_fft->header.start_time_nsec;
+  detect->header.packet_num = ipc_fft->header.packet_num;
+  detect->stage_times = ipc_fft->stage_times;
+  this->detect(*ipc_fft, *detect);
+  return detect;
+}
 
-        detect = std::make_shared<IpcDetector>();
-        detect->header.start_time_nsec = ipc_fft->header.start_time_nsec;
-        detect->header.packet_num = ipc_fft->header.packet_num;
+void EnergyDetector::process_batch(const std::vector<std::shared_ptr<IpcFFT>> &frames,
+                                   std::vector<std::shared_ptr<IpcDetector>> &out) {
+  out.reserve(out.size() + frames.size());
+  for (auto &ipc_fft : frames) {
+    out.push_back(this->process(ipc_fft));
+  }
+}
 
-        if (argPtr->active_frequencies.size() > 0) {
-          Sxx_ratio = fft_buffer.rowwise().maxCoeff() / fft_buffer.rowwise().mean();
+void EnergyDetector::process_events(const std::vector<std::shared_ptr<IpcDetector>> &detections,
+                                    std::vector<std::shared_ptr<IpcDetectionEvent>> &events) {
+  for (auto &detect : detections) {
+    this->event_builder.add(*detect, events);
+  }
+}
 
-          ema_st_new = (alpha_st * Sxx_ratio) + (1.0 - alpha_st) * ema_st_old;
-          ema_lt_new = (alpha_lt * Sxx_ratio) + (1.0 - alpha_lt) * ema_lt_old;
+void EnergyDetector::flush_events(std::vector<std::shared_ptr<IpcDetectionEvent>> &events) {
+  this->event_builder.flush(events);
+}
 
-          detect->detections = ((ema_st_new / ema_lt_new) > threshold).cast<int>().sum();
+void EnergyDetector::set_event_merge(size_t max_gap_frames, double max_duration_sec) {
+  this->event_builder.set_max_gap_frames(max_gap_frames);
+  this->event_builder.set_max_duration_sec(max_duration_sec);
+}
 
-          ema_st_old = ema_st_new;
-          ema_lt_old = ema_lt_new;
-        } else {
-          detect->detections = 0;
-        }
+void *EnergyDetector::_run_detector_thread(void *ptr) {
+
+  EnergyDetector *argPtr = static_cast<EnergyDetector *>(ptr);
+  prctl(PR_SET_NAME, argPtr->thread_name.substr(0, 15).c_str());
+  VLOG(3) << "Starting energy detector utility in thread " << pthread_self();
+  argPtr->_is_running = true;
+
+  std::vector<std::shared_ptr<IpcFFT>> new_packets;
+  std::vector<std::shared_ptr<IpcDetector>> detections;
+  std::vector<std::shared_ptr<IpcDetectionEvent>> events;
+
+  while (argPtr->sample_rate <= 0 && argPtr->keep_alive) {
+    //usleep(100000);
+    std::this_thread::sleep_for(std::chrono::microseconds(100000));
+  }
+
+  while (argPtr->keep_alive) {
+    if (argPtr->sample_rate > 0 && argPtr->q_fft->pop_all(new_packets)) {
+
+      auto t_start = std::chrono::steady_clock::now();
+      detections.clear();
+      argPtr->process_batch(new_packets, detections);
+      argPtr->processing_stats->add_busy(t_start);
+      argPtr->processing_stats->items_in += new_packets.size();
+      argPtr->processing_stats->items_out += detections.size();
+      for (auto &detect : detections) {
+        argPtr->processing_stats->events += detect->detections > 0 ? 1 : 0;
         for (auto q_detect : argPtr->v_q_detect) {
           q_detect->push(detect);
         }
+        detect->stage_times.mark(STAGE::DETECTOR_EMITTED);
+      }
+      if (!argPtr->v_q_event.empty()) {
+        events.clear();
+        argPtr->process_events(detections, events);
+        argPtr->push_events(events);
       }
     }
+    argPtr->log_queue_health();
     //usleep(1000);
     std::this_thread::sleep_for(std::chrono::microseconds(1000));
   }
 
+  // report a detection still in progress
+  if (!argPtr->v_q_event.empty()) {
+    events.clear();
+    argPtr->flush_events(events);
+    argPtr->push_events(events);
+  }
+
   argPtr->_is_running = false;
   pthread_exit(NULL);
 }
 
+void EnergyDetector::push_events(const std::vector<std::shared_ptr<IpcDetectionEvent>> &events) {
+  for (auto &event : events) {
+    for (auto q_event : this->v_q_event) {
+      q_event->push(event);
+    }
+  }
+}
+
 void EnergyDetector::run() {
   pthread_t thread;
   this->keep_alive = true;
+  this->register_queues();
   if (!this->is_running()) {
     pthread_create(&thread, NULL, this->_run_detector_thread, this);
     this->own_thread = thread;
@@ -133,3 +368,47 @@ void EnergyDetector::register_client(QueueClient &client) {
     LOG(WARNING) << "Cannot register DETECT data queue; received nullptr!";
   }
 }
+
+void EnergyDetector::register_client(ptr_tsQ<IpcDetectionEvent> q_event) {
+  if (q_event != nullptr) {
+    this->v_q_event.push_back(q_event);
+  } else {
+    LOG(WARNING) << "Cannot register detection event queue; received nullptr!";
+  }
+}
+
+// Detector configuration
+// ======================
+void EnergyDetector::set_algorithm(DETECTOR_ALGORITHM algorithm) {
+  this->algorithm = algorithm;
+  // state of the previous algorithm doesn't carry over; reseed on the next frame
+  this->initialized = false;
+}
+
+void EnergyDetector::set_averaging(double alpha_st, double alpha_lt) {
+  this->alpha_st = alpha_st;
+  this->alpha_lt = alpha_lt;
+}
+
+void EnergyDetector::set_cfar_window(size_t num_train, size_t num_guard) {
+  if (num_train == 0) {
+    LOG(WARNING) << this->thread_name << " :: CFAR needs at least one training bin; using 1";
+    num_train = 1;
+  }
+  this->num_train = num_train;
+  this->num_guard = num_guard;
+}
+
+void EnergyDetector::set_band_threshold_db(size_t band, double threshold_db) {
+  if (band >= this->band_threshold_db.size()) {
+    this->band_threshold_db.resize(band + 1, std::numeric_limits<double>::quiet_NaN());
+  }
+  this->band_threshold_db[band] = threshold_db;
+}
+
+double EnergyDetector::get_band_threshold_db(size_t band) {
+  if (band < this->band_threshold_db.size() && !std::isnan(this->band_threshold_db[band])) {
+    return this->band_threshold_db[band];
+  }
+  return this->threshold_db;
+}
@@ -13,13 +13,28 @@
 #include <pthread.h>
 
 // includes from within project
+#include "utils/DetectionEventBuilder.h"
 #include "utils/FreqDomainBase.h"
+#include "utils/P2Quantile.h"
 
 DECLARE_bool(debug_energy_detector);
 
+// Detection rule, applied per channel:
+//  EMA_RATIO    : short / long term EMAs of the band's power peak-over-mean; one cell per
+//                 detecting channel, at the band peak (the original detector)
+//  CA_CFAR      : each active bin against the mean of its training bins across frequency
+//  OS_CFAR      : same, against an order statistic of the training bins (robust to
+//                 neighbouring tones)
+//  MEDIAN_FLOOR : each active bin against the running median of its band's mean power
+//                 (streaming P^2 estimate per channel and band)
+// All but EMA_RATIO use the per-band thresholds (set_band_threshold_db); CFAR training
+// bins never cross into another band.
+enum class DETECTOR_ALGORITHM { EMA_RATIO, CA_CFAR, OS_CFAR, MEDIAN_FLOOR };
+
 class EnergyDetector : virtual public FreqDomainBase {
 public:
   std::vector<ptr_tsQ<IpcDetector>> v_q_detect;
+  std::vector<ptr_tsQ<IpcDetectionEvent>> v_q_event;
 
   EnergyDetector() : FreqDomainBase() {
     this->thread_name = "detector_thr";
@@ -36,11 +51,102 @@ public:
 
   void run();
   void register_client(QueueClient &client);
+  // detection events only; the thread builds events while it has event clients
+  void register_client(ptr_tsQ<IpcDetectionEvent> q_event);
+
+  // Synchronous processing of one FFT frame; the detector thread is a loop around this.
+  // The first frame (and the first after a band / NFFT change) seeds the averages.
+  std::shared_ptr<IpcDetector> process(const std::shared_ptr<IpcFFT> &ipc_fft);
+  // Same for a batch of consecutive frames, one IpcDetector each (appended to out)
+  void process_batch(const std::vector<std::shared_ptr<IpcFFT>> &frames,
+                     std::vector<std::shared_ptr<IpcDetector>> &out);
+  // Merge consecutive detecting frames (from process / process_batch) into events;
+  // completed events are appended to out. flush_events closes the open event.
+  void process_events(const std::vector<std::shared_ptr<IpcDetector>> &detections,
+                      std::vector<std::shared_ptr<IpcDetectionEvent>> &events);
+  void flush_events(std::vector<std::shared_ptr<IpcDetectionEvent>> &events);
+  void set_event_merge(size_t max_gap_frames, double max_duration_sec);
+  void reset() {
+    this->initialized = false;
+    this->event_builder.reset();
+  }
+
+  void set_algorithm(DETECTOR_ALGORITHM algorithm);
+  DETECTOR_ALGORITHM get_algorithm() { return this->algorithm; }
+
+  // EMA_RATIO
+  void set_threshold(double threshold) { this->threshold = threshold; }
+  double get_threshold() { return this->threshold; }
+  void set_averaging(double alpha_st, double alpha_lt);
+
+  // CA_CFAR / OS_CFAR : training and guard bins on each side of the bin under test, and
+  // the training bin rank used by OS_CFAR (0.75 : upper quartile)
+  void set_cfar_window(size_t num_train, size_t num_guard);
+  void set_os_rank(double rank) { this->os_rank = rank; }
+
+  // CA_CFAR / OS_CFAR / MEDIAN_FLOOR : power over the noise estimate needed to detect;
+  // bands index frequency_bands in the order they were added
+  void set_threshold_db(double threshold_db) { this->threshold_db = threshold_db; }
+  double get_threshold_db() { return this->threshold_db; }
+  void set_band_threshold_db(size_t band, double threshold_db);
+  double get_band_threshold_db(size_t band);
 
 protected:
   double phone_sensitivity_V_uPa;
 
   static void *_run_detector_thread(void *arg);
+  void push_events(const std::vector<std::shared_ptr<IpcDetectionEvent>> &events);
+  // band of each FFT bin, refreshed when the bands or the sample rate change
+  void update_bands();
+  // Detections in one frame; updates the detector state in place. Only the cells
+  // allocate, so the common no-detection frame costs no allocations once the state is
+  // sized for the frame's channel count.
+  void detect(const IpcFFT &ipc_fft, IpcDetector &out);
+  void detect_ema(const IpcFFT &ipc_fft, const std::vector<int> &columns, bool seed,
+                  IpcDetector &out);
+  void detect_cfar(const IpcFFT &ipc_fft, const std::vector<int> &columns, IpcDetector &out);
+  void detect_median(const IpcFFT &ipc_fft, const std::vector<int> &columns, bool seed,
+                     IpcDetector &out);
+  void add_cell(const IpcFFT &ipc_fft, int channel, int icol, int band, double snr_db,
+                IpcDetector &out);
+
+  DETECTOR_ALGORITHM algorithm = DETECTOR_ALGORITHM::EMA_RATIO;
+  double alpha_st = 0.1;    // 2/(N+1) : N=19 (20 points produce >90% of weight distrib)
+  double alpha_lt = 0.0001; // 2/(N+1) : N~20k (20k points produce >90% of weight distrib)
+  // on the short / long term ratio of the band's magnitude (|X|) peak-over-mean
+  double threshold = 1.2;
+  size_t num_train = 8;
+  size_t num_guard = 2;
+  double os_rank = 0.75;
+  double threshold_db = 10;
+  std::vector<double> band_threshold_db; // NaN : use threshold_db
+
+  // processing state, owned by whichever thread calls process()
+  bool initialized = false;
+  std::vector<int> bin_band;
+  DetectionEventBuilder event_builder;
+  std::vector<double> band_threshold; // per band, linear power ratio
+
+  // EMA_RATIO, per channel: |X| of one bin, band peak and sum of |X|, and Sxx
+  // peak-over-mean (NOT median; see MEDIAN_FLOOR), with its short / long term EMAs
+  Eigen::ArrayXd bin_mag;
+  Eigen::ArrayXd band_peak;
+  Eigen::ArrayXd band_sum;
+  Eigen::ArrayXd Sxx_ratio;
+  Eigen::ArrayXd ema_st;
+  Eigen::ArrayXd ema_lt;
+
+  // CFAR / MEDIAN_FLOOR : |X|^2 of the active columns (channels x columns), their bands,
+  // and per channel scratch
+  Eigen::ArrayXXd power;
+  std::vector<int> column_band;
+  Eigen::ArrayXd cumsum;
+  std::vector<double> training;
+
+  // MEDIAN_FLOOR : mean power per channel and band, and its running median (channel-major)
+  Eigen::ArrayXXd band_mean;
+  Eigen::ArrayXd band_count;
+  std::vector<P2Quantile> noise_floor;
 };
 
 #endif
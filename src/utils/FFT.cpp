@@ -7,6 +7,7 @@
 /*    For help, contact us at: support@acbotics.com                */
 /*******************************************************************/
 
+#include <algorithm>
 #include <arpa/inet.h>
 #include <cstring>
 #include <fstream>
@@ -25,65 +26,167 @@
 DEFINE_bool(debug_fft, false, "Enable expanded debug for FFT");
 
 
-void FFT::run_fft_thread()
-{
-  prctl(PR_SET_NAME, this->thread_name.substr(0, 15).c_str());
-  VLOG(3) << "Starting FFT utility in thread " << pthread_self();
-  this->_is_running = true;
-
-  std::shared_ptr<UdpAcousticData> aco_pkt;
-  // size_t num_channels;
-  size_t icol;
-  size_t ncols;
-
-  int32_t packet_num = 0;
-
-  double audio_scale = 1.0 / pow(2, 15) * this->adc_scale;
-
-  Eigen::MatrixXd data_buffer;
-  Eigen::Matrix<int64_t, Eigen::Dynamic, 1> data_timestamps;
-
-  Eigen::MatrixXd _fft_data_in(0, 0);
-  std::shared_ptr<IpcFFT> fft_frame;
-
-  aco_pkt = this->q_aco->pop();
-
+void FFT::initialize(const UdpAcousticData &aco_pkt) {
   bool use_ch_filter = this->use_channel_filter && this->channel_filter.size() > 0;
-
-  this->num_channels =
-      use_ch_filter ? this->channel_filter.size() : aco_pkt->header.num_channels;
-
-  if (use_ch_filter) {
-    data_buffer = (aco_pkt->data(this->channel_filter, Eigen::all).cast<double>() * audio_scale);
+  this->num_channels = use_ch_filter ? this->channel_filter.size() : aco_pkt.header.num_channels;
+
+  // aco_pkt.header.sample_rate is a float; make sure we cast
+  double fs_in = (double)aco_pkt.header.sample_rate;
+  this->decimation_f_high = this->use_decimation ? this->max_band_frequency() : 0;
+  if (this->decimation_f_high > 0) {
+    this->decimator.configure_lowpass(fs_in, this->decimation_f_high);
+    LOG(INFO) << this->thread_name << " :: Decimating by " << this->decimator.get_factor()
+              << " for bands up to " << this->decimation_f_high << " Hz ("
+              << this->decimator.get_num_taps() << " taps)";
   } else {
-    data_buffer = (aco_pkt->data.cast<double>() * audio_scale);
+    this->decimator = Decimator();
   }
 
-  data_timestamps =
-      Eigen::Matrix<int64_t, Eigen::Dynamic, 1>::LinSpaced(
-          aco_pkt->data.cols(), 0, 1e9 / aco_pkt->header.sample_rate * (aco_pkt->data.cols() - 1))
-          .array() +
-      aco_pkt->header.start_time_nsec;
-
-  // aco_pkt->header.sample_rate is a float; make sure we cast
-  if (this->sample_rate != (double)aco_pkt->header.sample_rate) {
-    this->sample_rate = (double)aco_pkt->header.sample_rate;
+  if (this->sample_rate != fs_in / this->decimator.get_factor()) {
+    this->sample_rate = fs_in / this->decimator.get_factor();
     LOG(INFO) << "Sampling rate initialized: " << this->sample_rate << " Hz";
+    // frequency bands are in Hz; map them onto bins at the actual rate
+    this->recompute_frequencies();
   }
 
+  this->data_buffer.resize(this->num_channels, 0);
+  this->data_timestamps.resize(0);
+  this->update_window();
+  this->initialized = true;
+}
+
+void FFT::update_window() {
   // Note that win is 2D for element-wise scaling across all channels
-  Eigen::ArrayXXd win = get_hann(this->num_channels, this->NFFT);
+  this->win = get_hann(this->num_channels, this->NFFT);
 
   // Scaling modes:
   // PSD : 2 / (Fs * sum(win*win) )
   // Spectrum : 2 / (sum(win)^2)
   // >> adapted to directly yield re 1V or re 1uPa: sqrt(2) / sum(win)
   //
-  double scale_coeff = std::sqrt(2 / (this->sample_rate * (win.row(0) * win.row(0)).sum()));
+  double scale_coeff =
+      std::sqrt(2 / (this->sample_rate * (this->win.row(0) * this->win.row(0)).sum()));
   // double scale_coeff = std::sqrt(2 / ( pow(win.row(0).sum(),2)));
   // double scale_coeff = std::sqrt(2) / win.row(0).sum();
-  win *= scale_coeff;
+  this->win *= scale_coeff;
+}
+
+void FFT::reset() {
+  this->initialized = false;
+  this->data_buffer.resize(0, 0);
+  this->data_timestamps.resize(0);
+  this->stage_marks.clear();
+  this->psd_frame.reset();
+  this->decimator.reset();
+}
+
+std::vector<std::shared_ptr<IpcFFT>> FFT::process(std::shared_ptr<UdpAcousticData> aco_pkt) {
+  return this->process(std::vector<std::shared_ptr<UdpAcousticData>>{aco_pkt});
+}
+
+double FFT::max_band_frequency() {
+  double f_high = 0;
+  for (auto &band : this->frequency_bands) {
+    f_high = std::max(f_high, band.second);
+  }
+  return f_high;
+}
+
+bool FFT::append(const std::vector<std::shared_ptr<UdpAcousticData>> &packets) {
+  if (packets.empty()) {
+    return false;
+  }
+  // the decimation factor follows the bands; start over when they move
+  if (this->initialized && this->use_decimation &&
+      this->max_band_frequency() != this->decimation_f_high) {
+    this->reset();
+  }
+  if (!this->initialized) {
+    this->initialize(*packets.front());
+  }
+
+  bool use_ch_filter = this->use_channel_filter && this->channel_filter.size() > 0;
+  this->audio_scale = 1.0 / pow(2, 15) * this->adc_scale;
+
+  // packets whose layout no longer matches the buffer are skipped, not resized into it
+  auto is_valid = [this, use_ch_filter](const UdpAcousticData &pkt) {
+    if (use_ch_filter) {
+      return *std::max_element(this->channel_filter.begin(), this->channel_filter.end()) <
+             pkt.data.rows();
+    }
+    return (size_t)pkt.data.rows() == this->num_channels;
+  };
+
+  bool decimate = this->decimator.is_enabled();
+  size_t ncols = 0;
+  size_t phase = this->decimator.get_phase();
+  for (auto &aco_pkt : packets) {
+    if (is_valid(*aco_pkt))
+      ncols += decimate ? this->decimator.count_outputs(aco_pkt->data.cols(), phase)
+                        : aco_pkt->data.cols();
+  }
+
+  size_t icol = this->data_buffer.cols();
+  if (FLAGS_debug_fft)
+    VLOG(4) << "Expading buffer of size " << this->data_buffer.cols() << " by " << ncols << " to "
+            << this->data_buffer.cols() + ncols;
+  this->data_buffer.conservativeResize(Eigen::NoChange, this->data_buffer.cols() + ncols);
+  this->data_timestamps.conservativeResize(this->data_timestamps.size() + ncols);
+
+  for (auto &aco_pkt : packets) {
+    if (!is_valid(*aco_pkt)) {
+      LOG_EVERY_N(WARNING, 1000) << this->thread_name << " :: Dropping packet with "
+                                 << aco_pkt->data.rows() << " channels; expected "
+                                 << this->num_channels;
+      continue;
+    }
+    ncols = aco_pkt->data.cols();
+    double dt_nsec = 1e9 / aco_pkt->header.sample_rate;
+    int64_t t0_nsec = aco_pkt->header.start_time_nsec;
+
+    if (decimate) {
+      if (use_ch_filter) {
+        this->_decim_in =
+            aco_pkt->data(this->channel_filter, Eigen::all).cast<double>() * this->audio_scale;
+      } else {
+        this->_decim_in = aco_pkt->data.cast<double>() * this->audio_scale;
+      }
+      // outputs line up with input samples phase, phase + D, ..., less the filter delay
+      t0_nsec += (int64_t)((this->decimator.get_phase() - this->decimator.get_delay()) * dt_nsec);
+      dt_nsec *= this->decimator.get_factor();
+      Eigen::MatrixXd decimated = this->decimator.process(this->_decim_in);
+      ncols = decimated.cols();
+      this->data_buffer.block(0, icol, this->num_channels, ncols) = decimated;
+    } else if (use_ch_filter) {
+      this->data_buffer.block(0, icol, this->num_channels, ncols) =
+          (aco_pkt->data(this->channel_filter, Eigen::all).cast<double>() * this->audio_scale);
+    } else {
+      this->data_buffer.block(0, icol, this->num_channels, ncols) =
+          (aco_pkt->data.cast<double>() * this->audio_scale);
+    }
+    this->packet_fs = aco_pkt->header.sample_rate / this->decimator.get_factor();
+    this->data_timestamps.segment(icol, ncols) =
+        Eigen::Matrix<int64_t, Eigen::Dynamic, 1>::LinSpaced(ncols, 0, dt_nsec * (ncols - 1))
+            .array() +
+        t0_nsec;
+    icol += ncols;
+
+    if (LatencyTracker::is_enabled()) {
+      this->stage_marks.emplace_back(icol, aco_pkt->stage_times);
+    }
+  }
+
+  if (this->data_buffer.cols() < this->NFFT) {
+    return false;
+  }
 
+  if (this->win.rows() != this->num_channels || this->win.cols() != this->NFFT) {
+    this->update_window();
+  }
+  return true;
+}
+
+void FFT::compute_frame(size_t offset, Eigen::MatrixXcd &out) {
   const pocketfft::shape_t shape_{static_cast<size_t>(this->num_channels),
                                   static_cast<size_t>(this->NFFT)};
 
@@ -93,95 +196,181 @@ void FFT::run_fft_thread()
       sizeof(std::complex<double>),
       (ptrdiff_t)(sizeof(std::complex<double>) * this->num_channels)};
 
-  std::vector<std::shared_ptr<UdpAcousticData>> new_packets;
+  out.resize(this->num_channels, this->nfreq);
 
-  size_t offset;
+  // Compute FFT:
+  // 1 - get NFFT snapshot
+  this->_fft_data_in = this->data_buffer.block(0, offset, this->num_channels, this->NFFT);
 
-  while (this->keep_alive) {
+  // 2 - detrend by mean & enforce window to manage ringing
+  this->_fft_data_in =
+      (this->_fft_data_in.colwise() - this->_fft_data_in.rowwise().mean()).array() * this->win;
 
-    if (this->_rx_runtime_update) {
-      audio_scale = 1.0 / pow(2, 15) * this->adc_scale;
-    }
-    double fs = -1;
-    if (this->q_aco->size() > 0) {
+  pocketfft::r2c(shape_, stride_in_, stride_out_, 1, pocketfft::FORWARD, &this->_fft_data_in(0, 0),
+                 &out(0, 0), static_cast<double>(1), 0);
 
-      new_packets = this->q_aco->pop_limit(10);
-      if (FLAGS_debug_fft)
-        VLOG(3) << "New ACO packet count : " << new_packets.size();
-      ncols = 0;
-      for (int ii = 0; ii < new_packets.size(); ii++) {
-        ncols += new_packets[ii]->data.cols();
-      }
+  // fft_frame *= scale_coeff; // scale_coeff built into win
+}
 
-      icol = data_buffer.cols();
-      if (FLAGS_debug_fft)
-        VLOG(4) << "Expading buffer of size " << data_buffer.cols() << " by " << ncols << " to "
-                << data_buffer.cols() + ncols;
-      data_buffer.conservativeResize(Eigen::NoChange, data_buffer.cols() + ncols);
-      data_timestamps.conservativeResize(data_timestamps.size() + ncols);
-      for (int ii = 0; ii < new_packets.size(); ii++) {
-        aco_pkt = new_packets.at(ii);
-        ncols = aco_pkt->data.cols();
-
-        if (use_ch_filter) {
-          data_buffer.block(0, icol, this->num_channels, ncols) =
-              (aco_pkt->data(this->channel_filter, Eigen::all).cast<double>() * audio_scale);
-        } else {
-          data_buffer.block(0, icol, this->num_channels, ncols) =
-              (aco_pkt->data.cast<double>() * audio_scale);
-        }
-        fs = aco_pkt->header.sample_rate;
-        data_timestamps.segment(icol, ncols) =
-            Eigen::Matrix<int64_t, Eigen::Dynamic, 1>::LinSpaced(aco_pkt->data.cols(), 0,
-                                                                 1e9 / aco_pkt->header.sample_rate *
-                                                                     (aco_pkt->data.cols() - 1))
-                .array() +
-            aco_pkt->header.start_time_nsec;
-        icol += ncols;
-      }
+StageTimes FFT::frame_stage_times(size_t offset) {
+  // the frame is as late as the packet that completed it
+  while (!this->stage_marks.empty() && this->stage_marks.front().first < offset + this->NFFT) {
+    this->stage_marks.pop_front();
+  }
+  if (!this->stage_marks.empty()) {
+    return this->stage_marks.front().second;
+  }
+  return StageTimes();
+}
+
+int32_t FFT::next_packet_num() {
+  int32_t packet_num = this->packet_num;
+  this->packet_num = this->packet_num == std::numeric_limits<int>::max() ? 0 : this->packet_num + 1;
+  return packet_num;
+}
+
+void FFT::consume(size_t offset) {
+  // From Eigen: use .eval() to prevent aliasing!
+  this->data_buffer =
+      this->data_buffer.block(0, offset, this->num_channels, this->data_buffer.cols() - offset)
+          .eval();
+  this->data_timestamps =
+      this->data_timestamps.segment(offset, this->data_timestamps.size() - offset).eval();
+  for (auto &mark : this->stage_marks) {
+    mark.first -= offset;
+  }
+
+  if (FLAGS_debug_fft)
+    VLOG(4) << "Buffer is of size " << this->data_buffer.cols() << " after dropping " << offset
+            << " samples";
+}
+
+std::vector<std::shared_ptr<IpcFFT>>
+FFT::process(const std::vector<std::shared_ptr<UdpAcousticData>> &packets) {
+  std::vector<std::shared_ptr<IpcFFT>> frames;
+  if (!this->append(packets)) {
+    return frames;
+  }
+
+  bool active_only = this->mode == FFT_MODE::ACTIVE_BINS && !this->active_frequencies.empty();
+  if (this->mode == FFT_MODE::ACTIVE_BINS && this->active_frequencies.empty())
+    LOG_EVERY_N(WARNING, 1000) << this->thread_name
+                               << " :: No active frequency bins; emitting the full spectrum";
+
+  size_t offset = 0;
+  while ((this->data_buffer.cols() - offset) >= this->NFFT) {
+
+    auto fft_frame = std::make_shared<IpcFFT>();
+    fft_frame->header.start_time_nsec = this->data_timestamps[offset];
+    fft_frame->header.packet_num = this->next_packet_num();
+    fft_frame->FS = this->packet_fs;
+    fft_frame->stage_times = this->frame_stage_times(offset);
+
+    if (active_only) {
+      this->compute_frame(offset, this->_fft_data_out);
+      fft_frame->fft = this->_fft_data_out(Eigen::all, this->active_frequencies);
+      fft_frame->bins = this->active_frequencies;
+    } else {
+      this->compute_frame(offset, fft_frame->fft);
     }
 
-    if (data_buffer.cols() >= this->NFFT) {
+    offset += this->nstep;
+    frames.push_back(fft_frame);
+  }
+  this->consume(offset);
 
-      offset = 0;
-      while ((data_buffer.cols() - offset) >= this->NFFT) {
+  return frames;
+}
 
-        fft_frame = std::make_shared<IpcFFT>(this->num_channels, this->nfreq);
-        fft_frame->header.start_time_nsec = data_timestamps[offset];
-        fft_frame->FS=fs;
+std::vector<std::shared_ptr<IpcPSD>>
+FFT::process_psd(const std::vector<std::shared_ptr<UdpAcousticData>> &packets) {
+  std::vector<std::shared_ptr<IpcPSD>> averages;
+  if (!this->append(packets)) {
+    return averages;
+  }
+  size_t num_averages = this->get_psd_averages();
 
-        fft_frame->header.packet_num = packet_num;
-        packet_num = packet_num == std::numeric_limits<int>::max() ? 0 : packet_num + 1;
+  size_t offset = 0;
+  while ((this->data_buffer.cols() - offset) >= this->NFFT) {
 
-        // Compute FFT:
-        // 1 - get NFFT snapshot
-        _fft_data_in = data_buffer.block(0, offset, this->num_channels, this->NFFT);
+    if (this->psd_frame == nullptr) {
+      this->psd_frame = std::make_shared<IpcPSD>(this->num_channels, this->nfreq);
+      this->psd_frame->header.start_time_nsec = this->data_timestamps[offset];
+    }
 
-        // 2 - detrend by mean & enforce window to manage ringing
-        _fft_data_in = (_fft_data_in.colwise() - _fft_data_in.rowwise().mean()).array() * win;
+    // |X|^2 is the one-sided PSD, since win carries the PSD scaling (see update_window)
+    this->compute_frame(offset, this->_fft_data_out);
+    this->psd_frame->psd += this->_fft_data_out.cwiseAbs2();
+    this->psd_frame->num_averages++;
+    this->psd_frame->end_time_nsec = this->data_timestamps[offset];
+
+    if ((size_t)this->psd_frame->num_averages >= num_averages) {
+      this->psd_frame->psd /= this->psd_frame->num_averages;
+      this->psd_frame->header.packet_num = this->next_packet_num();
+      this->psd_frame->FS = this->packet_fs;
+      this->psd_frame->stage_times = this->frame_stage_times(offset);
+      averages.push_back(this->psd_frame);
+      this->psd_frame.reset();
+    }
 
-        pocketfft::r2c(shape_, stride_in_, stride_out_, 1, pocketfft::FORWARD, &_fft_data_in(0, 0),
-                       &((*fft_frame).fft(0, 0)), static_cast<double>(1), 0);
+    offset += this->nstep;
+  }
+  this->consume(offset);
 
-        // fft_frame *= scale_coeff; // scale_coeff built into win
+  return averages;
+}
 
-        offset += this->nstep;
+void FFT::run_fft_thread()
+{
+  prctl(PR_SET_NAME, this->thread_name.substr(0, 15).c_str());
+  VLOG(3) << "Starting FFT utility in thread " << pthread_self();
+  this->_is_running = true;
 
-        for (auto q_fft : this->v_q_fft) {
+  std::vector<std::shared_ptr<UdpAcousticData>> new_packets;
+  std::vector<std::shared_ptr<IpcFFT>> frames;
+  std::vector<std::shared_ptr<IpcPSD>> averages;
 
-          q_fft->push(fft_frame);
-        }
-      }
+  while (this->keep_alive) {
 
-      // From Eigen: use .eval() to prevent aliasing!
-      data_buffer =
-          data_buffer.block(0, offset, this->num_channels, data_buffer.cols() - offset).eval();
-      data_timestamps = data_timestamps.segment(offset, data_timestamps.size() - offset).eval();
+    if (this->q_aco->size() > 0) {
 
+      new_packets = this->q_aco->pop_limit(10);
       if (FLAGS_debug_fft)
-        VLOG(4) << "Buffer is of size " << data_buffer.cols() << " after dropping " << offset
-                << " samples";
+        VLOG(3) << "New ACO packet count : " << new_packets.size();
+      for (auto &aco_pkt : new_packets) {
+        aco_pkt->stage_times.mark(STAGE::FFT_DEQUEUED);
+      }
+
+      auto t_start = std::chrono::steady_clock::now();
+      if (this->mode == FFT_MODE::WELCH_PSD) {
+        averages = this->process_psd(new_packets);
+      } else {
+        frames = this->process(new_packets);
+      }
+      this->processing_stats->add_busy(t_start);
+      this->processing_stats->items_in += new_packets.size();
+
+      if (this->mode == FFT_MODE::WELCH_PSD) {
+        this->processing_stats->items_out += averages.size();
+        for (auto &psd_frame : averages) {
+          for (auto q_psd : this->v_q_psd) {
+            q_psd->push(psd_frame);
+          }
+          psd_frame->stage_times.mark(STAGE::FFT_EMITTED);
+        }
+        averages.clear();
+      } else {
+        this->processing_stats->items_out += frames.size();
+        for (auto &fft_frame : frames) {
+          for (auto q_fft : this->v_q_fft) {
+            q_fft->push(fft_frame);
+          }
+          fft_frame->stage_times.mark(STAGE::FFT_EMITTED);
+        }
+        frames.clear();
+      }
     }
+    this->log_queue_health();
 
     //usleep(1000);
     std::this_thread::sleep_for(std::chrono::microseconds(1000));
@@ -201,6 +390,7 @@ void *FFT::_run_fft_thread(void *ptr) {
 void FFT::run() {
   pthread_t thread;
   this->keep_alive = true;
+  this->register_queues();
   if (!this->is_running()) {
     pthread_create(&thread, NULL, _run_fft_thread, this);
     this->own_thread = thread;
@@ -212,6 +402,15 @@ void FFT::run() {
 
 void FFT::register_client(QueueClient &client) {
   LOG(INFO) << "Registering " << client.get_name();
+  // clients receive whichever output the current mode produces
+  if (this->mode == FFT_MODE::WELCH_PSD) {
+    if (client.q_psd != nullptr) {
+      v_q_psd.push_back(client.q_psd);
+    } else {
+      LOG(WARNING) << "Cannot register PSD data queue; received nullptr!";
+    }
+    return;
+  }
   if (client.q_fft != nullptr) {
     auto init_count = v_q_fft.size();
     v_q_fft.push_back(client.q_fft);
@@ -227,6 +426,46 @@ void FFT::register_client(std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> q_ff
   this->v_q_fft.push_back(q_fft);
 }
 
+void FFT::register_client(std::shared_ptr<tsQueue<std::shared_ptr<IpcPSD>>> q_psd)
+{
+  this->v_q_psd.push_back(q_psd);
+}
+
+void FFT::set_mode(FFT_MODE mode) {
+  if (this->is_running()) {
+    LOG(WARNING) << "Cannot change FFT mode while the thread is running";
+    return;
+  }
+  this->mode = mode;
+  this->psd_frame.reset();
+}
+
+void FFT::set_psd_averages(size_t num_frames) {
+  this->psd_averages = std::max<size_t>(num_frames, 1);
+  this->psd_average_sec = 0;
+  this->psd_frame.reset();
+}
+
+void FFT::set_psd_average_sec(double span_sec) {
+  this->psd_average_sec = span_sec;
+  this->psd_frame.reset();
+}
+
+size_t FFT::get_psd_averages() {
+  if (this->psd_average_sec > 0 && this->sample_rate > 0) {
+    // hops whose frames start within the span
+    return std::max<size_t>(std::lround(this->psd_average_sec * this->sample_rate / this->nstep),
+                            1);
+  }
+  return this->psd_averages;
+}
+
+void FFT::set_decimation(bool enable) {
+  this->use_decimation = enable;
+  // re-initialize (and re-design the filter) on the next packet
+  this->reset();
+}
+
 void FFT::set_adc_scale(double new_adc_scale) {
   this->adc_scale = new_adc_scale;
   this->_rx_runtime_update = true;
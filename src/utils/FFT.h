@@ -11,18 +11,27 @@
 #define fft_HEADER
 
 #include <Eigen/Dense>
+#include <deque>
 #include <iostream>
 #include <pthread.h>
 
 // includes from within project
+#include "utils/Decimator.h"
 #include "utils/FreqDomainBase.h"
 // #include "utils/UdpSocketIn.h"
 
 DECLARE_bool(debug_fft);
 
+// What the FFT thread emits:
+//  SPECTRUM    : one complex IpcFFT per hop, to the q_fft clients
+//  ACTIVE_BINS : same, but only the active frequency bins (IpcFFT::bins lists them)
+//  WELCH_PSD   : one real IpcPSD per average of |X|^2 over K hops, to the q_psd clients
+enum class FFT_MODE { SPECTRUM, ACTIVE_BINS, WELCH_PSD };
+
 class FFT : public FreqDomainBase {
 public:
   std::vector<std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>>> v_q_fft;
+  std::vector<std::shared_ptr<tsQueue<std::shared_ptr<IpcPSD>>>> v_q_psd;
   FFT() : FreqDomainBase() {
     this->adc_scale = 2.5;
 
@@ -37,8 +46,26 @@ public:
   void run() override;
   void register_client(QueueClient &client);
   void register_client(std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> q_fft);
+  void register_client(std::shared_ptr<tsQueue<std::shared_ptr<IpcPSD>>> q_psd);
   void set_adc_scale(double new_adc_scale);
 
+  void set_mode(FFT_MODE mode);
+  FFT_MODE get_mode() { return this->mode; }
+  // Welch averaging length, as a number of hops or as a time span (resolved to hops
+  // once the sample rate is known); either call drops a partially accumulated average
+  void set_psd_averages(size_t num_frames);
+  void set_psd_average_sec(double span_sec);
+  size_t get_psd_averages();
+
+  // Low-pass and decimate the input ahead of the FFT, by the largest factor that keeps the
+  // highest frequency band (add_frequency_band_*) alias-free. NFFT then applies at the
+  // reduced rate, e.g. the same resolution with NFFT / factor. No effect without bands.
+  void set_decimation(bool enable);
+  bool get_decimation() { return this->use_decimation; }
+  size_t get_decimation_factor() { return this->decimator.get_factor(); }
+  // length of the decimation filter, in input samples (0 : not decimating)
+  size_t get_decimation_taps() { return this->decimator.get_num_taps(); }
+
   std::shared_ptr<tsQueue<std::shared_ptr<UdpAcousticData>>>get_input_queue()
   {
     return this->q_aco;
@@ -47,15 +74,63 @@ public:
   void set_channel_filter(int num_ch);
   void set_channel_filter(std::vector<int> channel_filter);
 
+  // Synchronous processing: append the packets to the sample buffer and return every
+  // complete NFFT frame (advancing by nstep). The FFT thread is a loop around this.
+  // In ACTIVE_BINS mode, frames hold only the active bins (full spectrum if none are set).
+  std::vector<std::shared_ptr<IpcFFT>>
+  process(const std::vector<std::shared_ptr<UdpAcousticData>> &packets);
+  std::vector<std::shared_ptr<IpcFFT>> process(std::shared_ptr<UdpAcousticData> aco_pkt);
+  // Same, but accumulate |X|^2 of each frame and return every completed Welch average
+  std::vector<std::shared_ptr<IpcPSD>>
+  process_psd(const std::vector<std::shared_ptr<UdpAcousticData>> &packets);
+  // Drop buffered samples; the next packet re-initializes channels and sample rate
+  void reset();
+
   bool use_channel_filter;
   std::vector<int> channel_filter;
 
 protected:
   static void *_run_fft_thread(void *arg);
   void run_fft_thread(void);
+  void initialize(const UdpAcousticData &aco_pkt);
+  void update_window();
+  double max_band_frequency();
+  // append packets to data_buffer; false if less than one frame is buffered
+  bool append(const std::vector<std::shared_ptr<UdpAcousticData>> &packets);
+  // window and transform the NFFT samples at offset into out (num_channels x nfreq)
+  void compute_frame(size_t offset, Eigen::MatrixXcd &out);
+  StageTimes frame_stage_times(size_t offset);
+  int32_t next_packet_num();
+  // drop samples before offset
+  void consume(size_t offset);
   size_t num_channels;
 
   double adc_scale;
+
+  // processing state, owned by whichever thread calls process()
+  bool initialized = false;
+  int32_t packet_num = 0;
+  double audio_scale = 0;
+  double packet_fs = -1;
+  Eigen::MatrixXd data_buffer;
+  Eigen::Matrix<int64_t, Eigen::Dynamic, 1> data_timestamps;
+  Eigen::ArrayXXd win;
+  Eigen::MatrixXd _fft_data_in;
+  // (end column in data_buffer, stage times) of buffered packets; only with latency tracking
+  std::deque<std::pair<size_t, StageTimes>> stage_marks;
+
+  // output mode and Welch averaging state
+  FFT_MODE mode = FFT_MODE::SPECTRUM;
+  size_t psd_averages = 16;
+  double psd_average_sec = 0; // > 0 overrides psd_averages
+  Eigen::MatrixXcd _fft_data_out; // full spectrum, when frames do not hold it
+  std::shared_ptr<IpcPSD> psd_frame;
+
+  // decimating front end, configured from the bands at initialize()
+  bool use_decimation = false;
+  double decimation_f_high = 0;
+  Decimator decimator;
+  Eigen::MatrixXd _decim_in;
 };
 
 #endif
@@ -8,6 +8,7 @@
 /*******************************************************************/
 
 #include <glog/logging.h>
+#include <numeric>
 
 // includes from within project
 #include "utils/FreqDomainBase.h"
@@ -141,6 +142,39 @@ void FreqDomainBase::reset_frequency_band_center(double f_center, double b_width
   add_frequency_band_center(f_center, b_width);
 }
 
+const std::vector<int> &FreqDomainBase::active_columns(const IpcFFT &ipc_fft) {
+  if (ipc_fft.bins.empty()) {
+    return this->active_frequencies;
+  }
+  if (ipc_fft.bins == this->active_frequencies) {
+    // band-limited frame matching our bands; every column is active
+    if (this->all_columns.size() != ipc_fft.bins.size()) {
+      this->all_columns.resize(ipc_fft.bins.size());
+      std::iota(this->all_columns.begin(), this->all_columns.end(), 0);
+    }
+    return this->all_columns;
+  }
+  if (ipc_fft.bins != this->frame_bins || this->_rx_runtime_update) {
+    this->frame_bins = ipc_fft.bins;
+    this->frame_columns.clear();
+    // both lists are sorted; keep the active bins the frame carries
+    size_t icol = 0;
+    for (int bin : this->active_frequencies) {
+      while (icol < this->frame_bins.size() && this->frame_bins[icol] < bin) {
+        icol++;
+      }
+      if (icol < this->frame_bins.size() && this->frame_bins[icol] == bin) {
+        this->frame_columns.push_back(icol);
+      }
+    }
+    if (this->frame_columns.size() < this->active_frequencies.size())
+      LOG_EVERY_N(WARNING, 1000) << this->thread_name << " :: FFT frames carry only "
+                                 << this->frame_columns.size() << " of "
+                                 << this->active_frequencies.size() << " active bins";
+  }
+  return this->frame_columns;
+}
+
 Eigen::ArrayXXd FreqDomainBase::get_hann(size_t num_ch, size_t NFFT) {
   Eigen::ArrayXXd win;
   Eigen::VectorXd col;
@@ -10,9 +10,26 @@
 #ifndef freq_domain_base_HEADER
 #define freq_domain_base_HEADER
 
+#include <atomic>
+
 // includes from within project
 #include "utils/QueueClient.h"
 
+// Throughput counters of a processing thread. Held by shared_ptr so they stay readable
+// (e.g. by the MetricsExporter) without touching the processing object itself.
+struct ProcessingStats {
+  std::atomic<uint64_t> items_in{0};  // packets / frames consumed
+  std::atomic<uint64_t> items_out{0}; // frames / results emitted
+  std::atomic<uint64_t> events{0};    // stage-specific; detector: frames with detections
+  std::atomic<uint64_t> busy_nsec{0}; // time spent in process()
+
+  void add_busy(std::chrono::steady_clock::time_point t_start) {
+    this->busy_nsec += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - t_start)
+                           .count();
+  }
+};
+
 class FreqDomainBase : virtual public QueueClient {
 public:
   FreqDomainBase() : QueueClient() {
@@ -53,7 +70,11 @@ public:
   void reset_frequency_band_center(double f_center, double b_width);
   static Eigen::ArrayXXd get_hann(size_t num_ch, size_t NFFT);
 
+  std::shared_ptr<ProcessingStats> get_processing_stats() { return this->processing_stats; }
+
 protected:
+  std::shared_ptr<ProcessingStats> processing_stats = std::make_shared<ProcessingStats>();
+
   double sample_rate;
 
   size_t NFFT;
@@ -70,6 +91,14 @@ protected:
   std::vector<int> active_frequencies;
 
   void recompute_frequencies();
+
+  // Columns of an FFT frame that hold the active frequencies: the active bins themselves
+  // for full-spectrum frames, else their positions in the frame's IpcFFT::bins. Cached
+  // per frame layout; call from the processing thread only.
+  const std::vector<int> &active_columns(const IpcFFT &ipc_fft);
+  std::vector<int> frame_bins;
+  std::vector<int> frame_columns;
+  std::vector<int> all_columns;
 };
 
 #endif
@@ -20,6 +20,8 @@ void InterfaceHelper::run_threads() {
   pthread_t _thread;
   bool _enable_fft_helper = false;
 
+  this->register_queues();
+
   if (this->enable_thread_aco_fork) {
     pthread_create(&_thread, NULL, _run_thread_aco_helper, this);
     this->threads.push_back(_thread);
@@ -41,6 +43,7 @@ void InterfaceHelper::run_threads() {
     this->threads.push_back(_thread);
     this->_fft_helper.register_client(this->_detector);
     this->_detector.register_client(*this);
+    this->_detector.register_client(this->q_event);
     _enable_fft_helper = true;
   }
 
@@ -202,6 +205,20 @@ void InterfaceHelper::start_logging(LOGGER logger) { this->logger_active[logger]
 // Stop loggers
 void InterfaceHelper::stop_logging(LOGGER logger) { this->logger_active[logger] = false; }
 
+void InterfaceHelper::set_fsync_policy(FSYNC_POLICY policy, double period_sec) {
+  for (auto &it : this->logger_writers) {
+    it.second->set_fsync_policy(policy, period_sec);
+  }
+}
+
+WriterStats InterfaceHelper::get_writer_stats(LOGGER logger) {
+  auto it = this->logger_writers.find(logger);
+  if (it == this->logger_writers.end()) {
+    return WriterStats();
+  }
+  return it->second->get_stats();
+}
+
 void InterfaceHelper::set_rollover(LOGGER logger, float rollover_min) {
   this->rollover_min[logger] = rollover_min;
   LOG(INFO) << LOGGER_NAME[logger] << " log rollover time is " << rollover_min << " minutes";
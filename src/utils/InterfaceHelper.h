@@ -17,6 +17,9 @@
 #include <libgpsmm.h>
 
 // includes from within project
+#include "utils/AsyncFileWriter.h"
+#include "utils/BearingTimeRecord.h"
+#include "utils/CsvWriter.h"
 #include "utils/EnergyDetector.h"
 #include "utils/FFT.h"
 #include "utils/QueueClient.h"
@@ -39,9 +42,15 @@ public:
   std::shared_ptr<tsQueue<Eigen::MatrixXd>> q_cbf_out;
   std::shared_ptr<tsQueue<bool>> q_request_cbf;
 
+  std::shared_ptr<tsQueue<std::vector<BearingPeak>>> q_peaks_out;
+  std::shared_ptr<tsQueue<bool>> q_request_peaks;
+
   std::shared_ptr<tsQueue<std::vector<int>>> q_detections_out;
   std::shared_ptr<tsQueue<bool>> q_request_detections;
 
+  std::shared_ptr<tsQueue<std::vector<IpcDetectionEvent>>> q_events_out;
+  std::shared_ptr<tsQueue<bool>> q_request_events;
+
   int8_t curr_ch;
 
   std::vector<UdpSocketIn> sockets;
@@ -79,17 +88,26 @@ public:
     this->q_aco_out = std::make_shared<tsQueue<Eigen::MatrixX<int16_t>>>();
     this->q_fft_out = std::make_shared<tsQueue<Eigen::MatrixXd>>();
     this->q_cbf_out = std::make_shared<tsQueue<Eigen::MatrixXd>>();
+    this->q_peaks_out = std::make_shared<tsQueue<std::vector<BearingPeak>>>();
     this->q_detections_out = std::make_shared<tsQueue<std::vector<int>>>();
+    this->q_events_out = std::make_shared<tsQueue<std::vector<IpcDetectionEvent>>>();
 
     this->q_request_aco = std::make_shared<tsQueue<bool>>();
     this->q_request_fft = std::make_shared<tsQueue<bool>>();
     this->q_request_cbf = std::make_shared<tsQueue<bool>>();
+    this->q_request_peaks = std::make_shared<tsQueue<bool>>();
     this->q_request_detections = std::make_shared<tsQueue<bool>>();
+    this->q_request_events = std::make_shared<tsQueue<bool>>();
 
     this->history_aco_sec = 0.25;
     this->history_aco = 50000;
     this->history_fft_sec = 0.25;
     this->history_fft = 100;
+    this->history_cbf = 1000;
+    this->btr_reduction = BTR_REDUCTION::MEAN;
+    this->btr_num_peaks = 0;
+    this->history_detections = 10000;
+    this->history_events = 1000;
 
     this->curr_ch = 0;
     this->adc_scale = 2.5;
@@ -118,6 +136,12 @@ public:
     this->rollover_min[LOGGER::BNO] = 60;
     this->rollover_min[LOGGER::BNR] = 60;
 
+    // write-behind output for the CSV loggers; sensor streams only need small buffers
+    this->logger_writers[LOGGER::ACO_CSV] = std::make_shared<AsyncFileWriter>();
+    for (LOGGER L : {LOGGER::PTS, LOGGER::EPT, LOGGER::IMU, LOGGER::RTC, LOGGER::BNO, LOGGER::BNR}) {
+      this->logger_writers[L] = std::make_shared<AsyncFileWriter>(64 * 1024, 2);
+    }
+
     this->buffer_has_data_aco = false;
     this->buffer_has_data_fft = false;
     this->buffer_has_data_cbf = false;
@@ -143,9 +167,27 @@ public:
   void enable_logger(LOGGER, bool);
   void start_logging(LOGGER);
   void stop_logging(LOGGER);
+  void set_fsync_policy(FSYNC_POLICY policy, double period_sec = 5.0);
+  WriterStats get_writer_stats(LOGGER logger);
 
   virtual void run_threads();
   virtual void stop_threads();
+
+  std::vector<std::pair<std::string, std::shared_ptr<tsQueueBase>>> named_queues() override {
+    auto named = QueueClient::named_queues();
+    // the "fft" fork is the FFT helper's own input queue, reported by that client
+    for (auto &dup : this->q_aco_dup) {
+      if (dup.first != "fft")
+        named.push_back({"aco_" + dup.first, dup.second});
+    }
+    named.push_back({"aco_out", this->q_aco_out});
+    named.push_back({"fft_out", this->q_fft_out});
+    named.push_back({"cbf_out", this->q_cbf_out});
+    named.push_back({"peaks_out", this->q_peaks_out});
+    named.push_back({"detections_out", this->q_detections_out});
+    named.push_back({"events_out", this->q_events_out});
+    return named;
+  }
   bool check_sockets();
 
   bool has_data_aco() { return this->buffer_has_data_aco; }
@@ -155,6 +197,11 @@ public:
   void set_adc_scale(double new_adc_scale);
   void set_phone_sensitivity_V_uPa(double new_phone_sensitivity_V_uPa);
 
+  // Beamformer buffer: reduction over elevation, and bearing peaks picked per frame
+  // (0 : none)
+  void set_btr_reduction(BTR_REDUCTION reduction) { this->btr_reduction = reduction; }
+  void set_btr_peaks(size_t num_peaks) { this->btr_num_peaks = num_peaks; }
+
   virtual void set_NFFT(size_t NFFT);
   virtual void set_noverlap(size_t noverlap);
   virtual void set_sample_rate(double sample_rate);
@@ -194,6 +241,13 @@ protected:
   size_t history_aco;
   double history_fft_sec;
   size_t history_fft;
+  // beamformer frames kept between requests; a preallocated ring
+  size_t history_cbf;
+  BTR_REDUCTION btr_reduction;
+  size_t btr_num_peaks;
+  // per-frame detection counts / detection events kept between requests (oldest dropped)
+  size_t history_detections;
+  size_t history_events;
 
   std::string logger_outdir;
 
@@ -215,6 +269,8 @@ protected:
 
   std::unordered_map<LOGGER, float> rollover_min;
 
+  std::unordered_map<LOGGER, std::shared_ptr<AsyncFileWriter>> logger_writers;
+
   bool buffer_has_data_aco;
   bool buffer_has_data_fft;
   bool buffer_has_data_cbf;
@@ -251,6 +307,9 @@ template <typename T, LOGGER L> void *InterfaceHelper::_run_csv_logger_thread(vo
   std::shared_ptr<T> _data;
 
   ptr_tsQ<T> queue = std::static_pointer_cast<tsQ_T<T>>(argPtr->queue[LOGGER_QUEUE[L]]);
+  AsyncFileWriter &ofil = *argPtr->logger_writers.at(L);
+  CsvWriter csv(64 * 1024);
+  std::ostringstream csv_header;
 
   bool wrote_header = false;
 
@@ -261,7 +320,7 @@ template <typename T, LOGGER L> void *InterfaceHelper::_run_csv_logger_thread(vo
 
       VLOG(5) << "=========== NEW FILE =========== ";
       LOG(INFO) << "Writing to file : " << output_filename;
-      std::ofstream ofil(output_filename);
+      ofil.open(output_filename);
       wrote_header = false;
 
       while (argPtr->keep_alive && logging_active && ofil.is_open() &&
@@ -270,7 +329,9 @@ template <typename T, LOGGER L> void *InterfaceHelper::_run_csv_logger_thread(vo
           if (!wrote_header) {
             // Check for header bool when queue data is available, to
             // allow data-driven header (e.g. num_ch in acoustic data)
-            _data_vec.front()->csv_header(ofil);
+            csv_header.str("");
+            _data_vec.front()->csv_header(csv_header);
+            ofil.write(csv_header.str());
             wrote_header = true;
           }
 
@@ -278,9 +339,10 @@ template <typename T, LOGGER L> void *InterfaceHelper::_run_csv_logger_thread(vo
           for (int ii = 0; ii < _data_vec.size(); ii++) {
             _data = _data_vec.at(ii);
             if (_data->header.start_time_nsec >= 0) {
-              _data->csv_serialize(ofil);
+              _data->csv_serialize(csv);
             }
           }
+          csv.write_to(ofil);
           ofil.flush();
         }
         // rest here, to allow for external control switch
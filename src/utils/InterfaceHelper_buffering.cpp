@@ -165,6 +165,7 @@ void *InterfaceHelper::_run_thread_fft_buffer(void *ptr) {
         fft_pkt = new_packets[ii]->fft.row(argPtr->curr_ch).array().abs().log10() * 20 -
                   argPtr->phone_sensitivity_V_uPa;
         fft_buffer.block(irow + ii, 0, fft_pkt.rows(), fft_pkt.cols()) = fft_pkt;
+        new_packets[ii]->stage_times.mark(STAGE::DELIVERED);
       }
       if (fft_buffer.rows() > argPtr->history_fft * 2) { // using 2x as margin for hysteresis
         if (FLAGS_debug_interface_helper)
@@ -200,61 +201,43 @@ void *InterfaceHelper::_run_thread_beamformer_buffer(void *ptr) {
   prctl(PR_SET_NAME, "cbf_buffer_thr");
   VLOG(3) << "Starting beamformer data buffer in thread " << pthread_self();
 
-  size_t icol;
-  size_t ncols;
-
-  std::shared_ptr<UdpBeamform2D> cbf_pkt;
   std::vector<std::shared_ptr<UdpBeamform2D>> new_packets;
+  std::vector<BearingPeak> peaks;
 
-  Eigen::MatrixXd data_buffer(0, 0);
-
-  bool initialized = false;
-
-  while (argPtr->keep_alive && !initialized) {
-    if (argPtr->q_beam2d->pop(cbf_pkt)) {
-      initialized = true;
-    } else {
-      //usleep(10000);
-      std::this_thread::sleep_for(std::chrono::microseconds(10000));
-    }
-  }
-
-  data_buffer = cbf_pkt->get_1D();
+  // Each frame is reduced straight into its column of the ring; the ring keeps the
+  // latest history_cbf frames between requests
+  BearingTimeRecord btr(argPtr->history_cbf);
 
   while (argPtr->keep_alive) {
 
     if (argPtr->q_beam2d->pop_all(new_packets)) {
-
-      ncols = new_packets.size();
-
-      icol = data_buffer.cols();
-      data_buffer.conservativeResize(Eigen::NoChange, data_buffer.cols() + ncols);
-      for (int ii = 0; ii < new_packets.size(); ii++) {
-        cbf_pkt = new_packets[ii];
-        data_buffer.block(0, icol, cbf_pkt->data.bearings_rad.size(), 1) = cbf_pkt->get_1D();
-        icol += 1;
-      }
-      if (data_buffer.cols() > argPtr->history_aco * 2.0) { // using 2x as margin for hysteresis
-        if (FLAGS_debug_interface_helper)
-          VLOG(5) << "Long CBF buffer; trimming to " << argPtr->history_aco << " samples";
-        Eigen::MatrixXd buff;
-        buff = data_buffer.block(0, data_buffer.cols() - argPtr->history_aco, data_buffer.rows(),
-                                 argPtr->history_aco);
-        data_buffer = buff;
+      btr.set_reduction(argPtr->btr_reduction);
+      btr.set_num_peaks(argPtr->btr_num_peaks);
+      for (auto &cbf_pkt : new_packets) {
+        btr.add(*cbf_pkt);
+        peaks.insert(peaks.end(), btr.get_latest_peaks().begin(), btr.get_latest_peaks().end());
+        cbf_pkt->stage_times.mark(STAGE::DELIVERED);
       }
-      argPtr->buffer_has_data_cbf = true;
+      if (peaks.size() > 2 * argPtr->history_cbf * btr.get_num_peaks())
+        peaks.erase(peaks.begin(), peaks.end() - argPtr->history_cbf * btr.get_num_peaks());
+      argPtr->buffer_has_data_cbf = btr.size() > 0;
     }
     if (argPtr->q_request_cbf->size() > 0) {
       if (FLAGS_debug_interface_helper)
-        VLOG(5) << "Received request for cbf data; buffer size " << data_buffer.rows() << " x "
-                << data_buffer.cols();
+        VLOG(5) << "Received request for cbf data; buffer size " << btr.get_bearings_rad().size()
+                << " x " << btr.size();
       argPtr->q_request_cbf->pop();
-      argPtr->q_cbf_out->push(data_buffer);
+      argPtr->q_cbf_out->push(btr.get_btr());
 
       argPtr->buffer_has_data_cbf = false;
-
-      cbf_pkt = argPtr->q_beam2d->pop();
-      data_buffer = cbf_pkt->get_1D();
+      btr.clear();
+    }
+    if (argPtr->q_request_peaks->size() > 0) {
+      if (FLAGS_debug_interface_helper)
+        VLOG(5) << "Received request for bearing peaks; buffer size " << peaks.size();
+      argPtr->q_request_peaks->pop();
+      argPtr->q_peaks_out->push(peaks);
+      peaks.clear();
     }
 
     //usleep(1000);
@@ -270,7 +253,16 @@ void *InterfaceHelper::_run_thread_detections_buffer(void *ptr) {
   VLOG(3) << "Starting energy detector data buffer in thread " << pthread_self();
 
   std::vector<std::shared_ptr<IpcDetector>> new_packets;
+  std::vector<std::shared_ptr<IpcDetectionEvent>> new_events;
   std::vector<int> detections;
+  std::vector<IpcDetectionEvent> events;
+
+  // Bound the buffers when nobody asks for them; trimming in chunks of the history
+  // keeps the erase cost amortized
+  auto trim = [](auto &buffer, size_t history) {
+    if (buffer.size() > 2 * history)
+      buffer.erase(buffer.begin(), buffer.end() - history);
+  };
 
   while (argPtr->keep_alive) {
 
@@ -278,7 +270,17 @@ void *InterfaceHelper::_run_thread_detections_buffer(void *ptr) {
 
       for (int ii = 0; ii < new_packets.size(); ii++) {
         detections.push_back(new_packets[ii]->detections);
+        new_packets[ii]->stage_times.mark(STAGE::DELIVERED);
+      }
+      trim(detections, argPtr->history_detections);
+    }
+
+    if (argPtr->q_event->pop_all(new_events)) {
+      for (auto &event : new_events) {
+        events.push_back(*event);
+        event->stage_times.mark(STAGE::DELIVERED);
       }
+      trim(events, argPtr->history_events);
     }
 
     if (argPtr->q_request_detections->size() > 0) {
@@ -289,6 +291,14 @@ void *InterfaceHelper::_run_thread_detections_buffer(void *ptr) {
       detections.clear();
     }
 
+    if (argPtr->q_request_events->size() > 0) {
+      if (FLAGS_debug_interface_helper)
+        VLOG(5) << "Received request for detection events; buffer size " << events.size();
+      argPtr->q_request_events->pop();
+      argPtr->q_events_out->push(events);
+      events.clear();
+    }
+
     //usleep(1000);
     std::this_thread::sleep_for(std::chrono::microseconds(1000));
   }
@@ -359,6 +369,8 @@ void *InterfaceHelper::_run_thread_bno_state_buffer(void *ptr) {
               ? new_bnr_frame.header.start_time_nsec
               : argPtr->latest_bno_state.header.start_time_nsec;
     }
+    // this thread always runs, so it also reports the helper's queue health
+    argPtr->log_queue_health();
     //usleep(1000);
     std::this_thread::sleep_for(std::chrono::microseconds(1000));
   }
@@ -34,7 +34,8 @@ void *InterfaceHelper::_run_logger_thread_audio_csv(void *ptr) {
   std::shared_ptr<UdpAcousticData> aco_data;
   int8_t num_channels;
   std::ostringstream csv_header;
-  std::ofstream ofil;
+  AsyncFileWriter &ofil = *argPtr->logger_writers.at(LOGGER::ACO_CSV);
+  CsvWriter csv;
 
   bool initialized = false;
 
@@ -63,8 +64,8 @@ void *InterfaceHelper::_run_logger_thread_audio_csv(void *ptr) {
 
       VLOG(5) << "=========== NEW FILE =========== ";
       LOG(INFO) << "Writing to file : " << output_filename;
-      ofil = std::ofstream(output_filename);
-      ofil << csv_header.str() << std::endl;
+      ofil.open(output_filename);
+      ofil.write(csv_header.str() + "\n");
 
       while (argPtr->keep_alive && logging_active && ofil.is_open() &&
              (std::time(nullptr) < fntime.rollover_time)) {
@@ -73,27 +74,23 @@ void *InterfaceHelper::_run_logger_thread_audio_csv(void *ptr) {
         for (int iac = 0; iac < aco_data_vec.size(); iac++) {
           aco_data = aco_data_vec.at(iac);
           if (aco_data->data.size() > 0) {
-            for (int ii = 0; ii < (aco_data->header.num_values / aco_data->header.num_channels);
-                 ii++) {
-              ofil << std::fixed
-                   << aco_data->header.start_time_nsec +
-                          (int64_t)(ii / (double)aco_data->header.sample_rate * 1e9)
-                   << ",";
-              ofil << std::fixed
-                   << aco_data->header.tick_time_nsec +
-                          (int64_t)(ii / (double)aco_data->header.sample_rate * 1e9)
-                   << ",";
-              ofil << std::fixed << aco_data->header.adc_count + ii << ",";
-
-              ofil << aco_data->header.packet_num << ",";
+            const int num_samples = aco_data->header.num_values / aco_data->header.num_channels;
+            for (int ii = 0; ii < num_samples; ii++) {
+              const int64_t offset_nsec =
+                  (int64_t)(ii / (double)aco_data->header.sample_rate * 1e9);
+              csv.put(aco_data->header.start_time_nsec + offset_nsec).sep();
+              csv.put(aco_data->header.tick_time_nsec + (uint64_t)offset_nsec).sep();
+              csv.put(aco_data->header.adc_count + ii).sep();
+              csv.put(aco_data->header.packet_num).sep();
               for (int ch = 0; ch < num_channels - 1; ch++) {
-                ofil << aco_data->data(ch, ii) << ",";
+                csv.put(aco_data->data(ch, ii)).sep();
               }
-              ofil << aco_data->data(num_channels - 1, ii) << std::endl;
+              csv.put(aco_data->data(num_channels - 1, ii)).eol();
             }
-            ofil.flush();
           }
         }
+        // one write for the whole popped batch
+        csv.write_to(ofil);
         // rest here, to allow for external control switch
         //usleep(10000);
 	std::this_thread::sleep_for(std::chrono::microseconds(10000));
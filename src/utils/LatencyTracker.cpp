@@ -0,0 +1,246 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: LatencyTracker.cpp                                     */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+// includes from within project
+#include "utils/LatencyTracker.h"
+
+DEFINE_bool(latency_tracking, false,
+            "Stamp packets and FFT/detector frames at each pipeline stage and aggregate "
+            "per-stage latency histograms");
+
+const char *stage_name(STAGE stage) {
+  switch (stage) {
+  case STAGE::RECEIVED:
+    return "RECEIVED";
+  case STAGE::PARSED:
+    return "PARSED";
+  case STAGE::ENQUEUED:
+    return "ENQUEUED";
+  case STAGE::FFT_DEQUEUED:
+    return "FFT_DEQUEUED";
+  case STAGE::FFT_EMITTED:
+    return "FFT_EMITTED";
+  case STAGE::DETECTOR_EMITTED:
+    return "DETECTOR_EMITTED";
+  case STAGE::LOGGED:
+    return "LOGGED";
+  case STAGE::DELIVERED:
+    return "DELIVERED";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+// The stage(s) feeding each stage; the first one that is set is used for step latency
+static const std::vector<STAGE> &stage_inputs(STAGE stage) {
+  static const std::array<std::vector<STAGE>, (size_t)STAGE::NUM_STAGES> inputs{{
+      {},                                                               // RECEIVED
+      {STAGE::RECEIVED},                                                // PARSED
+      {STAGE::PARSED},                                                  // ENQUEUED
+      {STAGE::ENQUEUED},                                                // FFT_DEQUEUED
+      {STAGE::FFT_DEQUEUED},                                            // FFT_EMITTED
+      {STAGE::FFT_EMITTED},                                             // DETECTOR_EMITTED
+      {STAGE::ENQUEUED},                                                // LOGGED
+      {STAGE::DETECTOR_EMITTED, STAGE::FFT_EMITTED, STAGE::ENQUEUED},   // DELIVERED
+  }};
+  return inputs[(size_t)stage];
+}
+
+// StageTimes
+// ==========
+StageTimes &StageTimes::operator=(const StageTimes &other) {
+  for (size_t ii = 0; ii < this->nsec.size(); ii++) {
+    this->nsec[ii].store(other.nsec[ii].load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+  }
+  return *this;
+}
+
+void StageTimes::clear() {
+  for (auto &t : this->nsec) {
+    t.store(-1, std::memory_order_relaxed);
+  }
+}
+
+void StageTimes::mark(STAGE stage) {
+  if (!LatencyTracker::is_enabled())
+    return;
+  this->mark(stage, LatencyTracker::now());
+}
+
+void StageTimes::mark(STAGE stage, int64_t t_nsec) {
+  if (!LatencyTracker::is_enabled() || t_nsec < 0)
+    return;
+  this->nsec[(size_t)stage].store(t_nsec, std::memory_order_relaxed);
+  if (stage != STAGE::RECEIVED)
+    LatencyTracker::instance().record(*this, stage);
+}
+
+std::ostream &operator<<(std::ostream &os, const StageTimes &st) {
+  int64_t t_rx = st.get(STAGE::RECEIVED);
+  os << "StageTimes (usec since RECEIVED):";
+  for (size_t ii = 0; ii < (size_t)STAGE::NUM_STAGES; ii++) {
+    if (st.has((STAGE)ii) && t_rx >= 0) {
+      os << " " << stage_name((STAGE)ii) << "=" << (st.get((STAGE)ii) - t_rx) / 1e3;
+    }
+  }
+  return os;
+}
+
+std::ostream &operator<<(std::ostream &os, const LatencyStats &st) {
+  os << std::left << std::setw(18) << st.stage << std::right << " n=" << std::setw(9) << st.count
+     << std::fixed << std::setprecision(1) << "  mean=" << std::setw(10) << st.mean_nsec / 1e3
+     << "  p50=" << std::setw(10) << st.p50_nsec / 1e3 << "  p99=" << std::setw(10)
+     << st.p99_nsec / 1e3 << "  max=" << std::setw(10) << st.max_nsec / 1e3 << " usec";
+  return os;
+}
+
+// LatencyHistogram
+// ================
+int LatencyHistogram::bucket_index(int64_t value) {
+  if (value < NUM_SUB_BUCKETS) {
+    return std::max<int64_t>(value, 0);
+  }
+  int msb = 63 - __builtin_clzll((uint64_t)value);
+  int shift = msb - SUB_BUCKET_BITS;
+  return (shift + 1) * NUM_SUB_BUCKETS + ((value >> shift) & (NUM_SUB_BUCKETS - 1));
+}
+
+int64_t LatencyHistogram::bucket_upper(int index) {
+  if (index < NUM_SUB_BUCKETS) {
+    return index;
+  }
+  int shift = index / NUM_SUB_BUCKETS - 1;
+  int64_t lower = (int64_t)(NUM_SUB_BUCKETS + index % NUM_SUB_BUCKETS) << shift;
+  return lower + ((int64_t)1 << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t value_nsec) {
+  this->counts[bucket_index(value_nsec)].fetch_add(1, std::memory_order_relaxed);
+  this->count.fetch_add(1, std::memory_order_relaxed);
+  this->sum.fetch_add(value_nsec, std::memory_order_relaxed);
+
+  int64_t prev_max = this->max.load(std::memory_order_relaxed);
+  while (value_nsec > prev_max &&
+         !this->max.compare_exchange_weak(prev_max, value_nsec, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::reset() {
+  for (auto &c : this->counts) {
+    c.store(0, std::memory_order_relaxed);
+  }
+  this->count.store(0, std::memory_order_relaxed);
+  this->sum.store(0, std::memory_order_relaxed);
+  this->max.store(0, std::memory_order_relaxed);
+}
+
+LatencyStats LatencyHistogram::get_stats() const {
+  LatencyStats stats;
+  // buckets are read one by one while writers may still be recording; use their total
+  std::array<uint64_t, NUM_BUCKETS> snapshot;
+  for (int ii = 0; ii < NUM_BUCKETS; ii++) {
+    snapshot[ii] = this->counts[ii].load(std::memory_order_relaxed);
+    stats.count += snapshot[ii];
+  }
+  if (stats.count == 0) {
+    return stats;
+  }
+  stats.max_nsec = this->max.load(std::memory_order_relaxed);
+  stats.mean_nsec = this->sum.load(std::memory_order_relaxed) /
+                    (int64_t)std::max<uint64_t>(this->count.load(std::memory_order_relaxed), 1);
+
+  uint64_t rank_p50 = (uint64_t)std::ceil(0.50 * stats.count);
+  uint64_t rank_p99 = (uint64_t)std::ceil(0.99 * stats.count);
+  uint64_t cumulative = 0;
+  for (int ii = 0; ii < NUM_BUCKETS; ii++) {
+    if (snapshot[ii] == 0)
+      continue;
+    uint64_t prev = cumulative;
+    cumulative += snapshot[ii];
+    int64_t value = std::min(bucket_upper(ii), stats.max_nsec);
+    if (prev < rank_p50 && cumulative >= rank_p50)
+      stats.p50_nsec = value;
+    if (prev < rank_p99 && cumulative >= rank_p99) {
+      stats.p99_nsec = value;
+      break;
+    }
+  }
+  return stats;
+}
+
+// LatencyTracker
+// ==============
+LatencyTracker &LatencyTracker::instance() {
+  static LatencyTracker tracker;
+  return tracker;
+}
+
+void LatencyTracker::record(const StageTimes &times, STAGE stage) {
+  int64_t t_stage = times.get(stage);
+  int64_t t_rx = times.get(STAGE::RECEIVED);
+  if (t_stage < 0)
+    return;
+
+  if (t_rx >= 0) {
+    this->since_receive[(size_t)stage].record(t_stage - t_rx);
+  }
+  for (STAGE input : stage_inputs(stage)) {
+    if (times.has(input)) {
+      this->step[(size_t)stage].record(t_stage - times.get(input));
+      break;
+    }
+  }
+}
+
+void LatencyTracker::reset() {
+  for (auto &hist : this->since_receive) {
+    hist.reset();
+  }
+  for (auto &hist : this->step) {
+    hist.reset();
+  }
+}
+
+static std::vector<LatencyStats>
+collect_stats(const std::array<LatencyHistogram, (size_t)STAGE::NUM_STAGES> &hists) {
+  std::vector<LatencyStats> out;
+  for (size_t ii = 0; ii < hists.size(); ii++) {
+    LatencyStats stats = hists[ii].get_stats();
+    if (stats.count > 0) {
+      stats.stage = stage_name((STAGE)ii);
+      out.push_back(stats);
+    }
+  }
+  return out;
+}
+
+std::vector<LatencyStats> LatencyTracker::get_since_receive() {
+  return collect_stats(this->since_receive);
+}
+
+std::vector<LatencyStats> LatencyTracker::get_step() { return collect_stats(this->step); }
+
+std::string LatencyTracker::report() {
+  std::ostringstream oss;
+  oss << "Latency since RECEIVED:" << std::endl;
+  for (auto &stats : this->get_since_receive()) {
+    oss << "  " << stats << std::endl;
+  }
+  oss << "Latency from previous stage:" << std::endl;
+  for (auto &stats : this->get_step()) {
+    oss << "  " << stats << std::endl;
+  }
+  return oss.str();
+}
@@ -0,0 +1,127 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: LatencyTracker.h                                       */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef latency_tracker_HEADER
+#define latency_tracker_HEADER
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <gflags/gflags.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+DECLARE_bool(latency_tracking);
+
+// Pipeline stages a frame can be stamped at, in the order they normally happen
+enum class STAGE {
+  RECEIVED,         // datagram returned by recv()
+  PARSED,           // packet decoded and sanity checked
+  ENQUEUED,         // pushed to every registered queue
+  FFT_DEQUEUED,     // popped by the FFT thread
+  FFT_EMITTED,      // FFT frame pushed downstream
+  DETECTOR_EMITTED, // detector output pushed downstream
+  LOGGED,           // handed to the file format encoder by a logger
+  DELIVERED,        // taken by a Python-facing consumer (InterfaceHelper, Q_FFT.pop)
+  NUM_STAGES
+};
+
+const char *stage_name(STAGE stage);
+
+// Monotonic timestamps carried with each packet / IPC frame. Unset stages are -1.
+//
+// Stamping is a no-op unless tracking is enabled (--latency_tracking), and every stamp
+// after RECEIVED is recorded by the LatencyTracker. Entries are atomic because one
+// packet is shared by several consumer threads (FFT, loggers), each stamping its stage.
+struct StageTimes {
+  std::array<std::atomic<int64_t>, (size_t)STAGE::NUM_STAGES> nsec;
+
+  StageTimes() { this->clear(); }
+  StageTimes(const StageTimes &other) { *this = other; }
+  StageTimes &operator=(const StageTimes &other);
+
+  void clear();
+  int64_t get(STAGE stage) const {
+    return this->nsec[(size_t)stage].load(std::memory_order_relaxed);
+  }
+  bool has(STAGE stage) const { return this->get(stage) >= 0; }
+
+  // Stamp a stage with the current monotonic time and record it
+  void mark(STAGE stage);
+  // Stamp with a time taken earlier (e.g. right after recv())
+  void mark(STAGE stage, int64_t t_nsec);
+};
+
+std::ostream &operator<<(std::ostream &os, const StageTimes &st);
+
+// Percentiles of one latency histogram
+struct LatencyStats {
+  std::string stage;
+  uint64_t count = 0;
+  int64_t mean_nsec = 0;
+  int64_t p50_nsec = 0;
+  int64_t p99_nsec = 0;
+  int64_t max_nsec = 0;
+};
+
+std::ostream &operator<<(std::ostream &os, const LatencyStats &st);
+
+// Lock-free log-linear histogram: 16 sub-buckets per power of two, so reported
+// percentiles are within ~6% of the recorded value (exact below 16 nsec).
+class LatencyHistogram {
+public:
+  LatencyHistogram() { this->reset(); }
+  void record(int64_t value_nsec);
+  void reset();
+  LatencyStats get_stats() const;
+
+protected:
+  static const int SUB_BUCKET_BITS = 4;
+  static const int NUM_SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static const int NUM_BUCKETS = (64 - SUB_BUCKET_BITS) * NUM_SUB_BUCKETS;
+
+  static int bucket_index(int64_t value);
+  static int64_t bucket_upper(int index);
+
+  std::array<std::atomic<uint64_t>, NUM_BUCKETS> counts;
+  std::atomic<uint64_t> count;
+  std::atomic<int64_t> sum;
+  std::atomic<int64_t> max;
+};
+
+// Process-wide latency aggregation, per stage:
+//  - since receive : stage time - RECEIVED, i.e. end-to-end latency up to that stage
+//  - step          : stage time - the stage that feeds it, i.e. time spent in between
+class LatencyTracker {
+public:
+  static LatencyTracker &instance();
+
+  static bool is_enabled() { return FLAGS_latency_tracking; }
+  static void set_enabled(bool enabled) { FLAGS_latency_tracking = enabled; }
+  static int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void record(const StageTimes &times, STAGE stage);
+  void reset();
+
+  std::vector<LatencyStats> get_since_receive();
+  std::vector<LatencyStats> get_step();
+  std::string report();
+
+protected:
+  LatencyTracker() {}
+  std::array<LatencyHistogram, (size_t)STAGE::NUM_STAGES> since_receive;
+  std::array<LatencyHistogram, (size_t)STAGE::NUM_STAGES> step;
+};
+
+#endif
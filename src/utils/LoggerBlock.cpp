@@ -35,6 +35,49 @@ void LoggerBlock::set_rollover_min(float min)
   this->csv_logger.set_rollover_min(min);
 }
 
+void LoggerBlock::set_write_behind(size_t max_depth)
+{
+  this->csv_logger.set_write_behind(max_depth);
+  this->flac_logger.set_write_behind(max_depth);
+  this->wav_logger.set_write_behind(max_depth);
+}
+
+void LoggerBlock::set_flac_workers(int num_workers)
+{
+  this->flac_logger.set_num_workers(num_workers);
+}
+
+void LoggerBlock::set_flac_compression_level(int level)
+{
+  this->flac_logger.set_compression_level(level);
+}
+
+void LoggerBlock::set_flac_block_frames(int block_frames)
+{
+  this->flac_logger.set_write_block_frames(block_frames);
+}
+
+void LoggerBlock::set_fsync_policy(FSYNC_POLICY policy, double period_sec)
+{
+  this->csv_logger.set_fsync_policy(policy, period_sec);
+  this->flac_logger.set_fsync_policy(policy, period_sec);
+  this->wav_logger.set_fsync_policy(policy, period_sec);
+}
+
+WriterStats LoggerBlock::get_writer_stats(LOGGER logger)
+{
+  switch (logger) {
+  case LOGGER::ACO_CSV:
+    return this->csv_logger.get_writer_stats();
+  case LOGGER::ACO_FLAC:
+    return this->flac_logger.get_writer_stats();
+  case LOGGER::ACO_WAV:
+    return this->wav_logger.get_writer_stats();
+  default:
+    return WriterStats();
+  }
+}
+
 void LoggerBlock::start_logging(){
 {
     this->csv_logger.Start();
@@ -49,6 +92,7 @@ void LoggerBlock::stop_logging(){
 
 void LoggerBlock::run()
 {
+  this->register_queues();
   pthread_create(&_thread, NULL, _run_logger_thread_audio, this);
 }
 void LoggerBlock::stop_threads(){}
@@ -87,6 +131,7 @@ void LoggerBlock::run_log_thread_audio() {
             this->wav_logger.Log_ACO_Data(aco_data);
             this->flac_logger.Log_ACO_Data(aco_data);
           }
+        this->log_queue_health();
         // rest here, to allow for external control switch
         //usleep(10000);
 	std::this_thread::sleep_for(std::chrono::microseconds(10000));
@@ -103,4 +148,9 @@ void LoggerBlock::run_log_thread_audio() {
   this->csv_logger.Stop();
   this->flac_logger.Stop();
   this->wav_logger.Stop();
+
+  // flush anything still queued for the write-behind threads
+  this->csv_logger.Shutdown();
+  this->flac_logger.Shutdown();
+  this->wav_logger.Shutdown();
 }
@@ -8,6 +8,7 @@
 #include <chrono>
 class LoggerBlock : public QueueClient {
 public:
+  LoggerBlock() : QueueClient() { this->thread_name = "ac_log_aco"; }
   void set_outdir(std::string logger_outdir);
   // void set_rollover(LOGGER logger, float rollover_min);
   // void enable_logger(LOGGER, bool);
@@ -15,6 +16,12 @@ public:
   void stop_logging();
   void run_log_thread_audio();
   void set_rollover_min(float min);
+  void set_write_behind(size_t max_depth);
+  void set_flac_workers(int num_workers);
+  void set_flac_compression_level(int level);
+  void set_flac_block_frames(int block_frames);
+  void set_fsync_policy(FSYNC_POLICY policy, double period_sec = 5.0);
+  WriterStats get_writer_stats(LOGGER logger);
   std::vector<std::string> get_current_paths(void);
   static void *_run_logger_thread_audio(void *arg);
 
@@ -1,4 +1,24 @@
 #include "utils/Logger_Acoustic.h"
+#include <chrono>
+#include <cstring>
+#include <sys/prctl.h>
+
+// Copy `num_ch` consecutive channels of each frame out of channel-major packet data.
+// A full 8-channel group is a constant 16-byte memcpy, which the compiler lowers to a
+// single vector load/store per frame.
+static inline void copy_channels(const int16_t *src, int src_ch, int start_idx, int num_ch,
+                                 int num_frames, int16_t *dst) {
+  src += start_idx;
+  if (num_ch == 8) {
+    for (int ii = 0; ii < num_frames; ii++) {
+      std::memcpy(dst + 8 * ii, src + (size_t)src_ch * ii, 8 * sizeof(int16_t));
+    }
+    return;
+  }
+  for (int ii = 0; ii < num_frames; ii++) {
+    std::memcpy(dst + (size_t)num_ch * ii, src + (size_t)src_ch * ii, num_ch * sizeof(int16_t));
+  }
+}
 
 Logger_Acoustic::Logger_Acoustic(std::string logger_dir) {
     this->file_initialized=false;
@@ -10,12 +30,170 @@ Logger_Acoustic::Logger_Acoustic(std::string logger_dir) {
     this->output_filename = "";
 }
 
-Logger_Acoustic::Logger_Acoustic() {
-  Logger_Acoustic("/tmp/");
+Logger_Acoustic::Logger_Acoustic() : Logger_Acoustic("/tmp/") {}
+
+Logger_Acoustic::~Logger_Acoustic() {}
+
+void Logger_Acoustic::Write_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data){}
+
+void Logger_Acoustic::Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) {
+  if (!this->wb_running) {
+    this->Process_ACO_Data(this->running, aco_data);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(this->wb_mutex);
+  if (this->wb_queue.size() >= this->wb_max_depth) {
+    // writer fell behind; apply backpressure instead of silently dropping audio
+    auto t_start = std::chrono::steady_clock::now();
+    this->wb_cond_space.wait(lock, [this] {
+      return this->wb_queue.size() < this->wb_max_depth || !this->wb_keep_alive;
+    });
+    // a wait cut short by shutdown is not a stall
+    if (this->wb_queue.size() < this->wb_max_depth) {
+      this->wb_stats.stalls++;
+      this->wb_stats.stall_nsec += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - t_start)
+                                       .count();
+    }
+  }
+  // the running state is captured here, so packets accepted before Stop() are still written
+  this->wb_queue.push_back({this->running, aco_data});
+  this->wb_stats.max_queue_depth = std::max(this->wb_stats.max_queue_depth, this->wb_queue.size());
+  this->wb_cond_data.notify_one();
+}
+
+void Logger_Acoustic::Process_ACO_Data(bool active, std::shared_ptr<UdpAcousticData> aco_data) {
+  if (this->close_pending.exchange(false)) {
+    this->close_file();
+  }
+  if (!active) {
+    // we are not active. close out file if still open
+    this->close_file();
+    return;
+  }
+
+  auto t_start = std::chrono::steady_clock::now();
+  this->Write_ACO_Data(aco_data);
+  aco_data->stage_times.mark(STAGE::LOGGED);
+  this->apply_fsync_policy();
+  uint64_t write_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - t_start)
+                            .count();
+
+  std::lock_guard<std::mutex> lock(this->wb_mutex);
+  this->wb_stats.writes++;
+  this->wb_stats.bytes_written += aco_data->data.size() * sizeof(int16_t);
+  this->wb_stats.max_write_nsec = std::max(this->wb_stats.max_write_nsec, write_nsec);
+}
+
+void Logger_Acoustic::close_file() {
+  if (this->file_initialized) {
+    this->StopFile();
+    this->file_initialized = false;
+  }
+}
+
+void Logger_Acoustic::set_write_behind(size_t max_depth) {
+  {
+    std::lock_guard<std::mutex> lock(this->wb_mutex);
+    this->wb_max_depth = max_depth;
+  }
+
+  if (max_depth > 0 && !this->wb_running) {
+    {
+      std::lock_guard<std::mutex> lock(this->wb_mutex);
+      this->wb_keep_alive = true;
+      this->wb_running = true;
+    }
+    pthread_create(&this->wb_thread, NULL, _run_write_behind_thread, this);
+  } else if (max_depth == 0 && this->wb_running) {
+    {
+      std::lock_guard<std::mutex> lock(this->wb_mutex);
+      this->wb_keep_alive = false;
+    }
+    this->wb_cond_data.notify_all();
+    this->wb_cond_space.notify_all();
+    // the worker drains the queue, control items included, before it exits
+    pthread_join(this->wb_thread, NULL);
+    std::lock_guard<std::mutex> lock(this->wb_mutex);
+    this->wb_running = false;
+  }
+}
+
+void *Logger_Acoustic::_run_write_behind_thread(void *ptr) {
+  Logger_Acoustic *argPtr = static_cast<Logger_Acoustic *>(ptr);
+  argPtr->run_write_behind_thread();
+  pthread_exit(NULL);
+}
+
+void Logger_Acoustic::run_write_behind_thread() {
+  prctl(PR_SET_NAME, "ac_log_aco_wb");
+  VLOG(3) << "Starting audio write-behind in thread " << pthread_self();
+
+  std::pair<bool, std::shared_ptr<UdpAcousticData>> item;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(this->wb_mutex);
+      this->wb_cond_data.wait_for(lock, std::chrono::milliseconds(100), [this] {
+        return !this->wb_queue.empty() || !this->wb_keep_alive;
+      });
+      if (this->wb_queue.empty()) {
+        if (!this->wb_keep_alive) {
+          break;
+        }
+        continue;
+      }
+      item = this->wb_queue.front();
+      this->wb_queue.pop_front();
+    }
+    this->wb_cond_space.notify_one();
+
+    if (item.second == nullptr) {
+      // Start() / Stop(): either way the current file ends here
+      this->close_file();
+      continue;
+    }
+
+    this->Process_ACO_Data(item.first, item.second);
+  }
+
+  VLOG(3) << "Audio write-behind exited";
+}
+
+void Logger_Acoustic::Shutdown() {
+  this->set_write_behind(0);
+  this->close_file();
+}
+
+void Logger_Acoustic::set_fsync_policy(FSYNC_POLICY policy, double period_sec) {
+  this->fsync_policy = policy;
+  this->fsync_period_sec = period_sec;
 }
 
+void Logger_Acoustic::apply_fsync_policy() {
+  if (!this->file_initialized) {
+    return;
+  }
+
+  bool do_fsync = (this->fsync_policy == FSYNC_POLICY::EVERY_WRITE);
+  if (this->fsync_policy == FSYNC_POLICY::PERIODIC) {
+    std::chrono::duration<double> since_fsync = std::chrono::steady_clock::now() - this->last_fsync;
+    do_fsync = since_fsync.count() >= this->fsync_period_sec;
+  }
+  if (do_fsync) {
+    this->SyncFile();
+    this->last_fsync = std::chrono::steady_clock::now();
+  }
+}
 
-void Logger_Acoustic::Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data){}
+WriterStats Logger_Acoustic::get_writer_stats() {
+  std::lock_guard<std::mutex> lock(this->wb_mutex);
+  WriterStats stats = this->wb_stats;
+  stats.queue_depth = this->wb_queue.size();
+  return stats;
+}
 
 void Logger_Acoustic::StartFile(){}
 
@@ -25,11 +203,27 @@ void Logger_Acoustic::set_outdir(std::string logger_outdir)
 }
 
 void Logger_Acoustic::Start() {
+  std::lock_guard<std::mutex> lock(this->wb_mutex);
   this->running = true;
-  this->file_initialized = false;
+  // start on a fresh file; the thread writing closes the current one
+  this->queue_close_locked();
 }
 
-void Logger_Acoustic::Stop() { this->running = false; }
+void Logger_Acoustic::Stop() {
+  std::lock_guard<std::mutex> lock(this->wb_mutex);
+  this->running = false;
+  this->queue_close_locked();
+}
+
+void Logger_Acoustic::queue_close_locked() {
+  if (!this->wb_running) {
+    this->close_pending = true;
+    return;
+  }
+  // control items bypass the depth limit: Start() / Stop() never block on the writer
+  this->wb_queue.push_back({this->running, nullptr});
+  this->wb_cond_data.notify_one();
+}
 
 void Logger_Acoustic::Initialize_from_aco(std::shared_ptr<UdpAcousticData> aco_data) {
   num_channels = aco_data->header.num_channels;
@@ -48,10 +242,36 @@ std::string Logger_Acoustic_CSV::get_current_path() {
   return this->output_filename;
 }
 
+void Logger_Acoustic_CSV::set_fsync_policy(FSYNC_POLICY policy, double period_sec) {
+  Logger_Acoustic::set_fsync_policy(policy, period_sec);
+  // text output is synced by the file writer's own I/O thread
+  this->ofil.set_fsync_policy(policy, period_sec);
+}
+
+WriterStats Logger_Acoustic_CSV::get_writer_stats() {
+  WriterStats stats = Logger_Acoustic::get_writer_stats();
+  WriterStats io_stats = this->ofil.get_stats();
+
+  stats.bytes_written = io_stats.bytes_written;
+  stats.write_errors = io_stats.write_errors;
+  stats.fsyncs = io_stats.fsyncs;
+  stats.files_opened = io_stats.files_opened;
+  stats.max_write_nsec = std::max(stats.max_write_nsec, io_stats.max_write_nsec);
+  stats.stalls += io_stats.stalls;
+  stats.stall_nsec += io_stats.stall_nsec;
+  stats.queue_depth += io_stats.queue_depth;
+  stats.max_queue_depth = std::max(stats.max_queue_depth, io_stats.max_queue_depth);
+  return stats;
+}
+
 void Logger_Acoustic_FLAC::Initialize_from_aco(std::shared_ptr<UdpAcousticData> aco_data) {
   Logger_Acoustic::Initialize_from_aco(aco_data);
+  // file-to-worker assignment depends on the channel count
+  this->stop_workers();
 
   num_files = std::ceil((double)num_channels / 8);
+  start_idx_per_file.clear();
+  ch_per_file.clear();
   for (int ii = 0; ii < num_files; ii++) {
     start_idx_per_file.push_back(8 * ii);
     ch_per_file.push_back(8);
@@ -66,8 +286,8 @@ void Logger_Acoustic_CSV::StartFile() {
   this->output_filename = this->logger_outdir + "ACO_" + fntime.fname_str + ".csv";
   VLOG(5) << "=========== NEW FILE =========== ";
   LOG(INFO) << "Writing to file : " << this->output_filename;
-  this->ofil = std::ofstream(this->output_filename);
-  this->ofil << this->csv_header.str() << std::endl;
+  this->ofil.open(this->output_filename);
+  this->ofil.write(this->csv_header.str() + "\n");
   this->file_initialized = true;   
   this->interpolation_initialized = false;                        
 
@@ -81,7 +301,9 @@ void Logger_Acoustic_WAV::StartFile() {
 
   ofil_wav = SndfileHandle(output_filename, SFM_WRITE, SF_FORMAT_WAV | SF_FORMAT_PCM_16,
                            num_channels, sample_rate);
-  this->file_initialized = true;                           
+  this->file_initialized = true;
+  std::lock_guard<std::mutex> lock(this->wb_mutex);
+  this->wb_stats.files_opened++;                           
 }
 
 void Logger_Acoustic_FLAC::StartFile() {
@@ -96,10 +318,26 @@ void Logger_Acoustic_FLAC::StartFile() {
     output_files.push_back(SndfileHandle(output_filename, SFM_WRITE,
                                          SF_FORMAT_FLAC | SF_FORMAT_PCM_16, ch_per_file.at(ii),
                                          sample_rate));
+    if (this->compression_level >= 0) {
+      // libsndfile maps [0, 1] onto the FLAC encoder presets 0..8
+      double level = this->compression_level / 8.0;
+      output_files.back().command(SFC_SET_COMPRESSION_LEVEL, &level, sizeof(level));
+    }
+  }
+
+  pending_blocks.resize(num_files);
+  pending_fill.assign(num_files, 0);
+  for (int ii = 0; ii < num_files; ii++) {
+    if (this->write_block_frames > 0) {
+      pending_blocks.at(ii).resize(ch_per_file.at(ii), this->write_block_frames);
+    }
   }
   VLOG(5) << "=========== NEW FILE(s) =========== ";
   LOG(INFO) << "Writing to files starting with : " << output_filenames.at(0);
-  this->file_initialized = true;                           
+  this->file_initialized = true;
+  this->start_workers();
+  std::lock_guard<std::mutex> lock(this->wb_mutex);
+  this->wb_stats.files_opened += num_files;                           
 
 }
 
@@ -112,9 +350,14 @@ void Logger_Acoustic_CSV::StopFile() {
 }
 
 void Logger_Acoustic_FLAC::StopFile() {
+    // encoders must be done with the current files before they are finalized
+    this->wait_workers_idle();
+    this->flush_pending_blocks();
 
+    if (this->fsync_policy != FSYNC_POLICY::NONE) {
+      this->SyncFile();
+    }
     for (int ff = 0; ff < num_files; ff++) {
-      output_files.at(ff).writeSync();
       LOG(INFO) << "Closing file : " << output_filenames.at(ff);
     }
     output_filenames.clear();
@@ -122,23 +365,29 @@ void Logger_Acoustic_FLAC::StopFile() {
 }
 
 void Logger_Acoustic_WAV::StopFile() {
-    ofil_wav.writeSync();
+    if (this->fsync_policy != FSYNC_POLICY::NONE) {
+      this->SyncFile();
+    }
     LOG(INFO) << "Closing file : " << output_filename;
     ofil_wav = SndfileHandle();
 }
 
+void Logger_Acoustic_WAV::SyncFile() {
+  ofil_wav.writeSync();
+  std::lock_guard<std::mutex> lock(this->wb_mutex);
+  this->wb_stats.fsyncs++;
+}
 
-void Logger_Acoustic_CSV::Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) {
-  if (!this->running)
-  {
-    // we are not active. close out file if still open
-    if (this->file_initialized)
-    {
-      this->StopFile();
-      this->file_initialized=false;
-    }
-    return;
+void Logger_Acoustic_FLAC::SyncFile() {
+  for (int ff = 0; ff < (int)output_files.size(); ff++) {
+    output_files.at(ff).writeSync();
   }
+  std::lock_guard<std::mutex> lock(this->wb_mutex);
+  this->wb_stats.fsyncs += output_files.size();
+}
+
+
+void Logger_Acoustic_CSV::Write_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) {
   if (!ofil.is_open() || !this->file_initialized) {
     LOG(INFO) << "Starting CVS : " << ofil.is_open() << "  " << this->file_initialized;
 
@@ -156,43 +405,31 @@ void Logger_Acoustic_CSV::Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data
       this->interpolation_initialized = true;
     }
 
-    for (int ii = 0; ii < (aco_data->header.num_values / aco_data->header.num_channels); ii++) {
-      ofil << std::time(nullptr)<< ",";
-      ofil << std::fixed
-           << aco_data->header.start_time_nsec //+
-                  //(int64_t)(ii / (double)aco_data->header.sample_rate * 1e9)
-           << ",";
-      ofil << std::fixed
-           << aco_data->header.tick_time_nsec //+
-                  //(int64_t)(ii / (double)aco_data->header.sample_rate * 1e9)
-           << ",";
-      ofil << std::fixed
-           << ((aco_data->header.adc_count+ ii-this->adc_count_file_start) / (double)aco_data->header.sample_rate )*1e9 + this->tick_file_start_ns
-           << ",";
-
-      ofil << std::fixed << aco_data->header.adc_count + ii << ",";
-
-      ofil << aco_data->header.packet_num << ",";
+    // format the whole packet into the reusable buffer, then hand it off in a single write
+    const int64_t host_epoch_sec = std::time(nullptr);
+    const int num_samples = aco_data->header.num_values / aco_data->header.num_channels;
+    for (int ii = 0; ii < num_samples; ii++) {
+      csv.put(host_epoch_sec).sep();
+      csv.put(aco_data->header.start_time_nsec).sep();
+      csv.put(aco_data->header.tick_time_nsec).sep();
+      csv.put(((aco_data->header.adc_count + ii - this->adc_count_file_start) /
+               (double)aco_data->header.sample_rate) *
+                      1e9 +
+                  this->tick_file_start_ns)
+          .sep();
+      csv.put(aco_data->header.adc_count + ii).sep();
+      csv.put(aco_data->header.packet_num).sep();
       for (int ch = 0; ch < num_channels - 1; ch++) {
-        ofil << aco_data->data(ch, ii) << ",";
+        csv.put(aco_data->data(ch, ii)).sep();
       }
-      ofil << aco_data->data(num_channels - 1, ii) << std::endl;
+      csv.put(aco_data->data(num_channels - 1, ii)).eol();
     }
+    csv.write_to(ofil);
+    // rows reach the I/O thread per packet, so they are not held back when input stops
     ofil.flush();
   }
 }
-void Logger_Acoustic_FLAC::Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) {
-  if (!this->running)
-  {
-    // we are not active. close out file if still open
-    if (this->file_initialized)
-    {
-      this->StopFile();
-      this->file_initialized=false;
-    }
-    return;
-  }
-
+void Logger_Acoustic_FLAC::Write_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) {
   if (!this->file_initialized) {
     this->StartFile();
   }
@@ -200,28 +437,229 @@ void Logger_Acoustic_FLAC::Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_dat
     this->StopFile();
     this->StartFile();
   }
+
+  if (this->workers.empty()) {
+    if (num_files > 1 && this->write_block_frames <= 0) {
+      this->encode_split(*aco_data);
+      return;
+    }
+    for (int ff = 0; ff < num_files; ff++) {
+      this->encode_file(ff, *aco_data, this->buff_mat);
+    }
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(this->enc_mutex);
+  for (auto &worker : this->workers) {
+    if (worker->jobs.size() >= this->max_jobs_per_worker) {
+      // slowest encoder sets the pace; account for it like any other writer stall
+      auto t_start = std::chrono::steady_clock::now();
+      this->enc_cond_done.wait(
+          lock, [&worker, this] { return worker->jobs.size() < this->max_jobs_per_worker; });
+      std::lock_guard<std::mutex> stats_lock(this->wb_mutex);
+      this->wb_stats.stalls++;
+      this->wb_stats.stall_nsec += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - t_start)
+                                       .count();
+    }
+    worker->jobs.push_back(aco_data);
+  }
+  this->enc_cond_job.notify_all();
+}
+
+void Logger_Acoustic_FLAC::encode_file(int ff, const UdpAcousticData &aco_data,
+                                       Eigen::MatrixX<int16_t> &buff) {
+  const int src_ch = aco_data.data.rows();
+  const int start_idx = start_idx_per_file.at(ff);
+  const int num_ch = ch_per_file.at(ff);
+  const int num_frames = aco_data.data.cols();
+  if (start_idx + num_ch > src_ch) {
+    LOG(WARNING) << "Packet has " << src_ch << " channels; expected " << (int)num_channels;
+    return;
+  }
+
+  if (this->write_block_frames <= 0) {
+    if (num_ch == src_ch) {
+      // each column is already an interleaved frame; hand libsndfile the packet memory
+      output_files.at(ff).writef(aco_data.data.data(), num_frames);
+      return;
+    }
+    buff.resize(num_ch, num_frames);
+    copy_channels(aco_data.data.data(), src_ch, start_idx, num_ch, num_frames, buff.data());
+    output_files.at(ff).writef(buff.data(), num_frames);
+    return;
+  }
+
+  // accumulate into a fixed-size block so the encoder sees large, regular writes
+  Eigen::MatrixX<int16_t> &pending = this->pending_blocks.at(ff);
+  int &fill = this->pending_fill.at(ff);
+  int col = 0;
+  while (col < num_frames) {
+    int n = std::min(this->write_block_frames - fill, num_frames - col);
+    copy_channels(aco_data.data.data() + (size_t)src_ch * col, src_ch, start_idx, num_ch, n,
+                  pending.data() + (size_t)num_ch * fill);
+    fill += n;
+    col += n;
+    if (fill == this->write_block_frames) {
+      output_files.at(ff).writef(pending.data(), fill);
+      fill = 0;
+    }
+  }
+}
+
+void Logger_Acoustic_FLAC::encode_split(const UdpAcousticData &aco_data) {
+  const int src_ch = aco_data.data.rows();
+  const int num_frames = aco_data.data.cols();
+  if (src_ch != num_channels) {
+    LOG(WARNING) << "Packet has " << src_ch << " channels; expected " << (int)num_channels;
+    return;
+  }
+
+  this->split_buffs.resize(num_files);
+  std::vector<int16_t *> dst(num_files);
   for (int ff = 0; ff < num_files; ff++) {
-    buff_mat = aco_data->data.block(start_idx_per_file.at(ff), 0, ch_per_file.at(ff),
-                                    aco_data->data.cols());
-    size_t num_its = buff_mat.rows() * buff_mat.cols() * sizeof(aco_data->data(0));
-    int16_t buffer[num_its] = {0};
-    memcpy(&buffer, &buff_mat(0), num_its);
-    output_files.at(ff).writef(buffer, buff_mat.cols());
+    this->split_buffs.at(ff).resize(ch_per_file.at(ff), num_frames);
+    dst.at(ff) = this->split_buffs.at(ff).data();
+  }
+
+  // single pass over the packet: each frame is read once and scattered to every file
+  const int num_full = src_ch / 8;
+  const int tail_ch = src_ch - 8 * num_full;
+  const int16_t *src = aco_data.data.data();
+  for (int ii = 0; ii < num_frames; ii++) {
+    for (int ff = 0; ff < num_full; ff++) {
+      std::memcpy(dst[ff], src + 8 * ff, 8 * sizeof(int16_t));
+      dst[ff] += 8;
+    }
+    if (tail_ch > 0) {
+      std::memcpy(dst[num_full], src + 8 * num_full, tail_ch * sizeof(int16_t));
+      dst[num_full] += tail_ch;
+    }
+    src += src_ch;
+  }
+
+  for (int ff = 0; ff < num_files; ff++) {
+    output_files.at(ff).writef(this->split_buffs.at(ff).data(), num_frames);
+  }
+}
+
+void Logger_Acoustic_FLAC::flush_pending_blocks() {
+  for (int ff = 0; ff < (int)this->pending_fill.size() && ff < (int)output_files.size(); ff++) {
+    if (this->pending_fill.at(ff) > 0) {
+      output_files.at(ff).writef(this->pending_blocks.at(ff).data(), this->pending_fill.at(ff));
+      this->pending_fill.at(ff) = 0;
+    }
+  }
+}
+
+void Logger_Acoustic_FLAC::set_compression_level(int level) {
+  this->compression_level = level < 0 ? -1 : std::min(level, 8);
+}
+
+void Logger_Acoustic_FLAC::set_write_block_frames(int block_frames) {
+  this->write_block_frames = block_frames > 0 ? block_frames : 0;
+}
+
+void Logger_Acoustic_FLAC::set_num_workers(int num_workers) {
+  this->stop_workers();
+  this->num_workers = num_workers > 0 ? num_workers : 0;
+  if (this->file_initialized) {
+    this->start_workers();
+  }
+}
+
+void Logger_Acoustic_FLAC::start_workers() {
+  int n_workers = std::min(this->num_workers, this->num_files);
+  if (n_workers <= 0 || !this->workers.empty()) {
+    return;
+  }
+
+  this->enc_keep_alive = true;
+  for (int ww = 0; ww < n_workers; ww++) {
+    auto worker = std::make_unique<EncodeWorker>();
+    worker->parent = this;
+    for (int ff = ww; ff < this->num_files; ff += n_workers) {
+      worker->files.push_back(ff);
+    }
+    this->workers.push_back(std::move(worker));
+  }
+  for (auto &worker : this->workers) {
+    pthread_create(&worker->thread, NULL, _run_encode_thread, worker.get());
   }
+  VLOG(3) << "Encoding " << this->num_files << " FLAC file(s) with " << n_workers << " worker(s)";
 }
 
-void Logger_Acoustic_WAV::Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) {
-  if (!this->running)
+void Logger_Acoustic_FLAC::stop_workers() {
+  if (this->workers.empty()) {
+    return;
+  }
   {
-    // we are not active. close out file if still open
-    if (this->file_initialized)
+    std::lock_guard<std::mutex> lock(this->enc_mutex);
+    this->enc_keep_alive = false;
+  }
+  this->enc_cond_job.notify_all();
+  for (auto &worker : this->workers) {
+    pthread_join(worker->thread, NULL);
+  }
+  this->workers.clear();
+}
+
+void Logger_Acoustic_FLAC::wait_workers_idle() {
+  std::unique_lock<std::mutex> lock(this->enc_mutex);
+  this->enc_cond_done.wait(lock, [this] {
+    for (auto &worker : this->workers) {
+      if (!worker->jobs.empty() || worker->busy) {
+        return false;
+      }
+    }
+    return true;
+  });
+}
+
+void *Logger_Acoustic_FLAC::_run_encode_thread(void *ptr) {
+  EncodeWorker *worker = static_cast<EncodeWorker *>(ptr);
+  worker->parent->run_encode_thread(*worker);
+  pthread_exit(NULL);
+}
+
+void Logger_Acoustic_FLAC::run_encode_thread(EncodeWorker &worker) {
+  prctl(PR_SET_NAME, "ac_log_flac_enc");
+  VLOG(3) << "Starting FLAC encoder for " << worker.files.size() << " file(s) in thread "
+          << pthread_self();
+
+  std::shared_ptr<UdpAcousticData> aco_data;
+
+  while (true) {
     {
-      this->StopFile();
-      this->file_initialized=false;
+      std::unique_lock<std::mutex> lock(this->enc_mutex);
+      this->enc_cond_job.wait(
+          lock, [&worker, this] { return !worker.jobs.empty() || !this->enc_keep_alive; });
+      if (worker.jobs.empty()) {
+        break;
+      }
+      aco_data = worker.jobs.front();
+      worker.jobs.pop_front();
+      worker.busy = true;
     }
-    return;
+
+    for (int ff : worker.files) {
+      this->encode_file(ff, *aco_data, worker.buff_mat);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->enc_mutex);
+      worker.busy = false;
+    }
+    this->enc_cond_done.notify_all();
   }
+}
+
+Logger_Acoustic_FLAC::~Logger_Acoustic_FLAC() {
+  this->Shutdown();
+  this->stop_workers();
+}
 
+void Logger_Acoustic_WAV::Write_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) {
   if (!this->file_initialized) {
     this->StartFile();
   }
@@ -230,9 +668,12 @@ void Logger_Acoustic_WAV::Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data
     this->StopFile();
     this->StartFile();
   }
-  size_t num_its = aco_data->data.rows() * aco_data->data.cols() * sizeof(aco_data->data(0));
-  int16_t buffer[num_its] = {0};
-  memcpy(&buffer, &aco_data->data(0), num_its);
-  ofil_wav.writef(buffer, aco_data->data.cols());
+  if (aco_data->data.rows() != num_channels) {
+    LOG(WARNING) << "Packet has " << aco_data->data.rows() << " channels; expected "
+                 << (int)num_channels;
+    return;
+  }
+  // column-major channels x samples is already frame-interleaved; write it in place
+  ofil_wav.writef(aco_data->data.data(), aco_data->data.cols());
 }
 
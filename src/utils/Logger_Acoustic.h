@@ -10,17 +10,28 @@
 #include <sndfile.hh>
 #include <time.h>
 #include "utils/log_filename_time.h"
+#include "utils/AsyncFileWriter.h"
+#include "utils/CsvWriter.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <pthread.h>
 
 class Logger_Acoustic {
 public:
   Logger_Acoustic(std::string logger_dir);
   Logger_Acoustic();
+  virtual ~Logger_Acoustic();
 
   void Start();
   virtual void Stop();
+  // Drain any write-behind backlog and close the open file(s)
+  void Shutdown();
   // virtual void Set();
 
-  virtual void Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data);
+  // Writes synchronously, or hands the packet to the write-behind thread when enabled
+  void Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data);
   virtual void Initialize_from_aco(std::shared_ptr<UdpAcousticData> aco_data);
   virtual void StartFile();
   virtual void set_outdir(std::string logger_outdir);
@@ -31,9 +42,47 @@ public:
     this->rollover_min=min;
   }
 
+  // Max packets queued for the write-behind thread; 0 writes in the caller's thread
+  void set_write_behind(size_t max_depth);
+  virtual void set_fsync_policy(FSYNC_POLICY policy, double period_sec = 5.0);
+  virtual WriterStats get_writer_stats();
+
 protected:
-  bool running;
-  bool file_initialized;
+  void Process_ACO_Data(bool active, std::shared_ptr<UdpAcousticData> aco_data);
+  // close the current file, if any; the next packet while running opens a new one
+  void close_file();
+  // have the thread writing close the file: queued in order with the packets under
+  // write-behind, else on the next packet. Caller holds wb_mutex.
+  void queue_close_locked();
+  virtual void Write_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data);
+  virtual void SyncFile() {}
+  void apply_fsync_policy();
+
+  static void *_run_write_behind_thread(void *ptr);
+  void run_write_behind_thread();
+
+  size_t wb_max_depth = 0;
+  // {running when queued, packet}; a null packet is a Start() / Stop() for the worker to
+  // apply between the packets around it (see close_file)
+  std::deque<std::pair<bool, std::shared_ptr<UdpAcousticData>>> wb_queue;
+  std::mutex wb_mutex;
+  std::condition_variable wb_cond_data;
+  std::condition_variable wb_cond_space;
+  pthread_t wb_thread;
+  bool wb_keep_alive = false;
+  std::atomic<bool> wb_running{false};
+  WriterStats wb_stats;
+
+  FSYNC_POLICY fsync_policy = FSYNC_POLICY::ON_CLOSE;
+  double fsync_period_sec = 5.0;
+  std::chrono::steady_clock::time_point last_fsync;
+
+
+  // set by Start() / Stop() from the control thread; the file itself (file_initialized
+  // included) is only touched by the thread writing it
+  std::atomic<bool> running;
+  std::atomic<bool> file_initialized;
+  std::atomic<bool> close_pending{false}; // Start() without write-behind
   int8_t num_channels;
   FilenameTime fntime;
   float rollover_min = 5;
@@ -45,14 +94,19 @@ protected:
 
 class Logger_Acoustic_CSV : public Logger_Acoustic {
 public:
-  void Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) override;
+  ~Logger_Acoustic_CSV() { this->Shutdown(); }
   void StartFile() override;
   void StopFile() override;
   void Initialize_from_aco(std::shared_ptr<UdpAcousticData> aco_data) override;
   std::string get_current_path();
+  void set_fsync_policy(FSYNC_POLICY policy, double period_sec = 5.0) override;
+  WriterStats get_writer_stats() override;
   //   Logger_Acoustic_CSV(std::string logger_dir);
 protected:
-  std::ofstream ofil;
+  void Write_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) override;
+
+  AsyncFileWriter ofil;
+  CsvWriter csv;
   std::ostringstream csv_header;
   bool interpolation_initialized =false;
   long adc_count_file_start = 0;
@@ -62,26 +116,75 @@ protected:
 
 class Logger_Acoustic_WAV : public Logger_Acoustic {
 public:
-  void Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) override;
+  ~Logger_Acoustic_WAV() { this->Shutdown(); }
   void StartFile() override;
   void StopFile() override;
 
 protected:
+  void Write_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) override;
+  void SyncFile() override;
+
   SndfileHandle ofil_wav;
 };
 
 class Logger_Acoustic_FLAC : public Logger_Acoustic {
 public:
-  void Log_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) override;
+  ~Logger_Acoustic_FLAC();
   void StartFile() override;
   void StopFile() override;
   void Initialize_from_aco(std::shared_ptr<UdpAcousticData> aco_data) override;
 
+  // Encode the per-8-channel files concurrently; 0 encodes all files in the logging thread.
+  // Set before logging starts.
+  void set_num_workers(int num_workers);
+  // FLAC compression level 0 (fastest) .. 8 (smallest); -1 keeps the libsndfile default
+  void set_compression_level(int level);
+  // Frames accumulated per file before each writef(); 0 writes every packet as it arrives
+  void set_write_block_frames(int block_frames);
+
 protected:
+  void Write_ACO_Data(std::shared_ptr<UdpAcousticData> aco_data) override;
+  void SyncFile() override;
+
+  // Each worker owns a fixed subset of the output files and reads its channels
+  // straight out of the shared packet; packets are never copied per worker.
+  struct EncodeWorker {
+    Logger_Acoustic_FLAC *parent;
+    pthread_t thread;
+    std::vector<int> files;
+    std::deque<std::shared_ptr<UdpAcousticData>> jobs;
+    Eigen::MatrixX<int16_t> buff_mat;
+    bool busy = false;
+  };
+
+  void encode_file(int ff, const UdpAcousticData &aco_data, Eigen::MatrixX<int16_t> &buff);
+  // Regroup every file's channels in one pass over the packet (logging-thread encoding)
+  void encode_split(const UdpAcousticData &aco_data);
+  void flush_pending_blocks();
+  void start_workers();
+  void stop_workers();
+  void wait_workers_idle();
+  static void *_run_encode_thread(void *ptr);
+  void run_encode_thread(EncodeWorker &worker);
+
   int num_files;
   std::vector<int> start_idx_per_file;
   std::vector<int> ch_per_file;
   std::vector<std::string> output_filenames;
   std::vector<SndfileHandle> output_files;
+
+  int compression_level = -1;
+  int write_block_frames = 0;
+  std::vector<Eigen::MatrixX<int16_t>> pending_blocks;
+  std::vector<int> pending_fill;
+  std::vector<Eigen::MatrixX<int16_t>> split_buffs;
+
+  int num_workers = 0;
+  size_t max_jobs_per_worker = 64;
+  std::vector<std::unique_ptr<EncodeWorker>> workers;
+  std::mutex enc_mutex;
+  std::condition_variable enc_cond_job;
+  std::condition_variable enc_cond_done;
+  bool enc_keep_alive = false;
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,134 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: Logger_Beamform.cpp                                    */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <chrono>
+#include <glog/logging.h>
+#include <thread>
+
+// includes from within project
+#include "utils/Logger_Beamform.h"
+
+Logger_Beamform_Block::Logger_Beamform_Block() : QueueClient() {
+  this->thread_name = "ac_log_beam";
+  for (LOGGER L : {LOGGER::BEAM2D, LOGGER::BEAMRAW}) {
+    this->writers[L] = std::make_shared<BeamformLogWriter>();
+  }
+  this->set_rollover_min(60);
+  this->logger_outdir = "/tmp/";
+}
+
+void Logger_Beamform_Block::run() {
+  pthread_t _thread;
+  this->keep_alive = true;
+  this->register_queues();
+  if (!this->threads.empty()) {
+    LOG(WARNING) << "Beamformer logger threads already running";
+    return;
+  }
+  pthread_create(&_thread, NULL, _run_beam_logger_thread<UdpBeamform2D, LOGGER::BEAM2D>, this);
+  this->threads.push_back(_thread);
+  pthread_create(&_thread, NULL, _run_beam_logger_thread<UdpBeamformRaw, LOGGER::BEAMRAW>, this);
+  this->threads.push_back(_thread);
+}
+
+void Logger_Beamform_Block::stop() {
+  this->keep_alive = false;
+  for (auto &thread : this->threads) {
+    pthread_join(thread, NULL);
+  }
+  this->threads.clear();
+}
+
+void Logger_Beamform_Block::open_file(LOGGER logger, const FilenameTime &fntime, int part) {
+  std::string &output_filename = this->output_filename[logger];
+  output_filename = this->logger_outdir + LOGGER_NAME[logger] + "_" + fntime.fname_str +
+                    (part > 0 ? "_" + std::to_string(part) : "") + ".acbl";
+  VLOG(5) << "=========== NEW FILE =========== ";
+  LOG(INFO) << "Writing to file : " << output_filename;
+  this->writers.at(logger)->open(output_filename);
+}
+
+template <typename T, LOGGER L> void Logger_Beamform_Block::run_beam_logger_thread() {
+  prctl(PR_SET_NAME, ("ac_log_" + LOGGER_NAME[L]).c_str());
+  VLOG(3) << "Starting " << LOGGER_NAME[L] << " logger in thread " << pthread_self();
+
+  std::vector<std::shared_ptr<T>> _data_vec;
+
+  ptr_tsQ<T> queue = std::static_pointer_cast<tsQ_T<T>>(this->queue[LOGGER_QUEUE[L]]);
+  BeamformLogWriter &writer = *this->writers.at(L);
+
+  while (this->keep_alive) {
+    if (this->logging_active) {
+      FilenameTime fntime = FilenameTime(this->rollover_min[L]);
+      int part = 0;
+      this->open_file(L, fntime, part);
+
+      while (this->keep_alive && this->logging_active && writer.is_open() &&
+             (std::time(nullptr) < fntime.rollover_time)) {
+        if (queue->pop_all(_data_vec)) {
+          for (auto &_data : _data_vec) {
+            if (_data->header.start_time_nsec < 0)
+              continue;
+            if (writer.write(*_data) == BEAM_LOG_WRITE::NEW_FILE) {
+              // the geometry or grid changed; it gets a file of its own
+              this->open_file(L, fntime, ++part);
+              writer.write(*_data);
+            }
+          }
+          writer.flush();
+        }
+        this->log_queue_health();
+        // rest here, to allow for external control switch
+        std::this_thread::sleep_for(std::chrono::microseconds(10000));
+      }
+      LOG(INFO) << "Closing file : " << this->output_filename[L];
+      writer.close();
+    } else {
+      // frames are large; do not let them pile up while not logging
+      queue->clear();
+      std::this_thread::sleep_for(std::chrono::microseconds(100000));
+    }
+  }
+}
+
+template <typename T, LOGGER L> void *Logger_Beamform_Block::_run_beam_logger_thread(void *ptr) {
+  Logger_Beamform_Block *argPtr = static_cast<Logger_Beamform_Block *>(ptr);
+  argPtr->run_beam_logger_thread<T, L>();
+  pthread_exit(NULL);
+}
+
+std::vector<std::string> Logger_Beamform_Block::get_current_paths(void) {
+  std::vector<std::string> vec;
+  vec.push_back(this->output_filename[LOGGER::BEAM2D]);
+  vec.push_back(this->output_filename[LOGGER::BEAMRAW]);
+  return vec;
+}
+
+void Logger_Beamform_Block::set_rollover_min(float min) {
+  this->rollover_min[LOGGER::BEAM2D] = min;
+  this->rollover_min[LOGGER::BEAMRAW] = min;
+}
+
+void Logger_Beamform_Block::set_storage(BEAM_STORAGE storage, double db_range) {
+  this->writers.at(LOGGER::BEAM2D)->set_storage(storage, db_range);
+}
+
+void Logger_Beamform_Block::set_fsync_policy(FSYNC_POLICY policy, double period_sec) {
+  for (auto &it : this->writers) {
+    it.second->set_fsync_policy(policy, period_sec);
+  }
+}
+
+WriterStats Logger_Beamform_Block::get_writer_stats(LOGGER logger) {
+  auto it = this->writers.find(logger);
+  if (it == this->writers.end()) {
+    return WriterStats();
+  }
+  return it->second->get_stats();
+}
@@ -0,0 +1,57 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: Logger_Beamform.h                                      */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef logger_beamform_HEADER
+#define logger_beamform_HEADER
+
+#include <pthread.h>
+
+// includes from within project
+#include "utils/BeamformLog.h"
+#include "utils/QueueClient.h"
+#include "utils/Types.h"
+#include "utils/log_filename_time.h"
+
+// Logs the UdpBeamform2D (LOGGER::BEAM2D) and UdpBeamformRaw (LOGGER::BEAMRAW) frames it
+// receives into indexed .acbl files (see BeamformLog.h), named like the other loggers:
+// <outdir><LOGGER_NAME>_<time>.acbl. A file rolls over on time, and early when the array
+// geometry or look-direction grid changes, so each file holds one geometry.
+class Logger_Beamform_Block : public QueueClient {
+public:
+  Logger_Beamform_Block();
+  ~Logger_Beamform_Block() { this->stop(); }
+
+  void start_logging() { this->logging_active = true; }
+  void stop_logging() { this->logging_active = false; }
+  void run() override;
+  // joins the logger threads, closing (indexing) any open file
+  void stop() override;
+
+  void set_outdir(std::string logger_outdir) { this->logger_outdir = logger_outdir; }
+  void set_rollover_min(float min);
+  // Storage of 2D beampatterns in new files (see BEAM_STORAGE)
+  void set_storage(BEAM_STORAGE storage, double db_range = BEAM_DB_U8_RANGE);
+  void set_fsync_policy(FSYNC_POLICY policy, double period_sec = 5.0);
+  WriterStats get_writer_stats(LOGGER logger);
+  std::vector<std::string> get_current_paths(void);
+
+protected:
+  template <typename T, LOGGER L> static void *_run_beam_logger_thread(void *ptr);
+  template <typename T, LOGGER L> void run_beam_logger_thread();
+  void open_file(LOGGER logger, const FilenameTime &fntime, int part);
+
+  bool logging_active = false;
+  std::vector<pthread_t> threads;
+  std::unordered_map<LOGGER, float> rollover_min;
+  std::unordered_map<LOGGER, std::string> output_filename;
+  std::unordered_map<LOGGER, std::shared_ptr<BeamformLogWriter>> writers;
+  std::string logger_outdir;
+};
+
+#endif
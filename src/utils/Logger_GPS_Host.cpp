@@ -60,9 +60,10 @@ void Logger_GPS_Host_Block::run_csv_logger_thread() {
 
       VLOG(5) << "=========== NEW FILE =========== ";
       LOG(INFO) << "Writing to file : " << output_filename;
-      std::ofstream ofil(output_filename);
-      ofil << csv_header.str() << std::endl;
-      int default_precision = ofil.precision();
+      ofil.open(output_filename);
+      ofil.write(csv_header.str() + "\n");
+
+      CsvWriter csv(4096);
 
       while ( logging_active && ofil.is_open() &&
              (std::time(nullptr) < fntime.rollover_time)) {
@@ -95,32 +96,29 @@ void Logger_GPS_Host_Block::run_csv_logger_thread() {
 
           //  std::string(buff) + "." + nsec;
 
-          ofil << std::time(nullptr) << "," << std::to_string(new_gps_data->fix.time.tv_sec);
+          csv.put(std::time(nullptr)).sep().put((int64_t)new_gps_data->fix.time.tv_sec);
           if (new_gps_data->fix.time.tv_nsec > 0) {
             std::string nsec = std::to_string(new_gps_data->fix.time.tv_nsec);
             size_t len_nsec_padding = 9 - nsec.length();
             nsec.insert(0, len_nsec_padding, '0');
-            ofil << "." << nsec;
+            csv.put('.').put(nsec);
           }
-          ofil << ",";
-          ofil << std::fixed << std::setprecision(8);
-          ofil << new_gps_data->fix.latitude << "," << new_gps_data->fix.longitude;
-
-          ofil << "," << new_gps_data->satellites_used << "," << new_gps_data->fix.mode;
-          ofil << "," << new_gps_data->fix.status << "," << new_gps_data->fix.altHAE;
-          ofil << "," << new_gps_data->fix.epx << "," << new_gps_data->fix.epy;
-          ofil << "," << new_gps_data->fix.epv << "," << new_gps_data->fix.epd;
-          ofil << "," << new_gps_data->fix.track << "," << new_gps_data->fix.speed;
-          ofil << "," << new_gps_data->fix.eps << "," << new_gps_data->fix.eph;
-          ofil << "," << new_gps_data->fix.climb << "," << new_gps_data->fix.epc;
-
-
-          ofil << std::setprecision(default_precision) << std::defaultfloat;
-          ofil << std::endl;
+          csv.sep();
+          csv.put(new_gps_data->fix.latitude, 8).sep().put(new_gps_data->fix.longitude, 8);
+
+          csv.sep().put(new_gps_data->satellites_used).sep().put(new_gps_data->fix.mode);
+          csv.sep().put(new_gps_data->fix.status).sep().put(new_gps_data->fix.altHAE, 8);
+          csv.sep().put(new_gps_data->fix.epx, 8).sep().put(new_gps_data->fix.epy, 8);
+          csv.sep().put(new_gps_data->fix.epv, 8).sep().put(new_gps_data->fix.epd, 8);
+          csv.sep().put(new_gps_data->fix.track, 8).sep().put(new_gps_data->fix.speed, 8);
+          csv.sep().put(new_gps_data->fix.eps, 8).sep().put(new_gps_data->fix.eph, 8);
+          csv.sep().put(new_gps_data->fix.climb, 8).sep().put(new_gps_data->fix.epc, 8);
+          csv.eol();
         }
 
         // this->latest_gps_data = *new_gps_data;
 
+        csv.write_to(ofil);
         ofil.flush();
       }
       LOG(INFO) << "Closing file : " << output_filename;
@@ -148,6 +146,17 @@ void *Logger_GPS_Host_Block::_run_csv_logger_thread(void *ptr) {
 }
 
 
+void Logger_GPS_Host_Block::set_fsync_policy(FSYNC_POLICY policy, double period_sec)
+{
+  this->ofil.set_fsync_policy(policy, period_sec);
+}
+
+WriterStats Logger_GPS_Host_Block::get_writer_stats()
+{
+  return this->ofil.get_stats();
+}
+
+
 Logger_GPS_Host_Block::Logger_GPS_Host_Block()
 {
     this->rollover_min = 60;
@@ -8,6 +8,8 @@
 #include <sndfile.h>
 #include <sndfile.hh>
 #include <time.h>
+#include "utils/AsyncFileWriter.h"
+#include "utils/CsvWriter.h"
 #include "utils/QueueClient.h"
 #include "utils/log_filename_time.h"
 #include <libgpsmm.h>
@@ -20,6 +22,8 @@ public:
   void stop_logging();
   void run();
   std::vector<std::string> get_current_paths(void);
+  void set_fsync_policy(FSYNC_POLICY policy, double period_sec = 5.0);
+  WriterStats get_writer_stats();
 
   virtual void set_outdir(std::string logger_outdir);
   static void *_run_csv_logger_thread(void *ptr);
@@ -31,6 +35,7 @@ protected:
   float rollover_min;
   std::string logger_outdir;
   std::string output_filename="";
+  AsyncFileWriter ofil{64 * 1024, 2};
 
 };
 
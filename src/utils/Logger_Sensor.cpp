@@ -51,6 +51,9 @@ template <typename T, LOGGER L> void Logger_Sensor_Block::run_csv_logger_thread(
   std::shared_ptr<T> _data;
 
   ptr_tsQ<T> queue = std::static_pointer_cast<tsQ_T<T>>(this->queue[LOGGER_QUEUE[L]]);
+  AsyncFileWriter &ofil = *this->writers.at(L);
+  CsvWriter csv(64 * 1024);
+  std::ostringstream csv_header;
 
   bool wrote_header = false;
 
@@ -61,7 +64,7 @@ template <typename T, LOGGER L> void Logger_Sensor_Block::run_csv_logger_thread(
 
       VLOG(5) << "=========== NEW FILE =========== ";
       LOG(INFO) << "Writing to file : " << this->output_filename[L];
-      std::ofstream ofil(this->output_filename[L]);
+      ofil.open(this->output_filename[L]);
       wrote_header = false;
 
       while (this->keep_alive && logging_active && ofil.is_open() &&
@@ -70,7 +73,9 @@ template <typename T, LOGGER L> void Logger_Sensor_Block::run_csv_logger_thread(
           if (!wrote_header) {
             // Check for header bool when queue data is available, to
             // allow data-driven header (e.g. num_ch in acoustic data)
-            _data_vec.front()->csv_header(ofil);
+            csv_header.str("");
+            _data_vec.front()->csv_header(csv_header);
+            ofil.write(csv_header.str());
             wrote_header = true;
           }
 
@@ -79,9 +84,10 @@ template <typename T, LOGGER L> void Logger_Sensor_Block::run_csv_logger_thread(
             for (int ii = 0; ii < _data_vec.size(); ii++) {
                 _data = _data_vec.at(ii);
                 if (_data->header.start_time_nsec >= 0) {
-                _data->csv_serialize(ofil);
+                _data->csv_serialize(csv);
                 }
             }
+            csv.write_to(ofil);
             ofil.flush();
             }
         }
@@ -132,8 +138,29 @@ void Logger_Sensor_Block::set_rollover_min(float min)
 }
 
 
+void Logger_Sensor_Block::set_fsync_policy(FSYNC_POLICY policy, double period_sec)
+{
+  for (auto &it : this->writers) {
+    it.second->set_fsync_policy(policy, period_sec);
+  }
+}
+
+WriterStats Logger_Sensor_Block::get_writer_stats(LOGGER logger)
+{
+  auto it = this->writers.find(logger);
+  if (it == this->writers.end()) {
+    return WriterStats();
+  }
+  return it->second->get_stats();
+}
+
+
 Logger_Sensor_Block::Logger_Sensor_Block()
 {
+    // sensor streams are low rate; small double buffers are plenty
+    for (LOGGER L : {LOGGER::PTS, LOGGER::EPT, LOGGER::IMU, LOGGER::RTC, LOGGER::BNO, LOGGER::BNR}) {
+      this->writers[L] = std::make_shared<AsyncFileWriter>(64 * 1024, 2);
+    }
     this->set_rollover_min(60);
     this->logger_outdir = "/TMP/";
 }
@@ -9,6 +9,8 @@
 #include <sndfile.h>
 #include <sndfile.hh>
 #include <time.h>
+#include "utils/AsyncFileWriter.h"
+#include "utils/CsvWriter.h"
 #include "utils/QueueClient.h"
 #include "utils/log_filename_time.h"
 
@@ -20,6 +22,8 @@ public:
   void stop_logging();
   void run() override;
   void set_rollover_min(float min);
+  void set_fsync_policy(FSYNC_POLICY policy, double period_sec = 5.0);
+  WriterStats get_writer_stats(LOGGER logger);
 
   virtual void set_outdir(std::string logger_outdir);
   template <typename T, LOGGER L> static void *_run_csv_logger_thread(void *ptr);
@@ -31,6 +35,7 @@ protected:
   std::vector<pthread_t> threads;
   std::unordered_map<LOGGER, float> rollover_min;
   std::unordered_map<LOGGER, std::string> output_filename;
+  std::unordered_map<LOGGER, std::shared_ptr<AsyncFileWriter>> writers;
   std::string logger_outdir;
 
 };
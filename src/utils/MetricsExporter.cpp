@@ -0,0 +1,438 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: MetricsExporter.cpp                                    */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <glog/logging.h>
+#include <iomanip>
+#include <iterator>
+#include <poll.h>
+#include <sstream>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// includes from within project
+#include "utils/InterfaceHelper.h"
+#include "utils/LatencyTracker.h"
+#include "utils/LoggerBlock.h"
+#include "utils/MetricsExporter.h"
+#include "utils/QueueRegistry.h"
+
+DEFINE_bool(debug_metrics, false, "Enable expanded debug for MetricsExporter");
+
+// MetricsWriter
+// =============
+static std::string escape_label(const std::string &value) {
+  std::string out;
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      out += '\\';
+      out += c;
+    } else if (c == '\n') {
+      out += "\\n";
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
+
+void MetricsWriter::add(const std::string &name, const std::string &help, METRIC_TYPE type,
+                        double value, const MetricLabels &labels) {
+  auto it = this->families.find(name);
+  if (it == this->families.end()) {
+    it = this->families.emplace(name, Family{help, type, {}}).first;
+    this->order.push_back(name);
+  }
+
+  std::ostringstream oss;
+  oss << name;
+  if (!labels.empty()) {
+    oss << "{";
+    for (size_t ii = 0; ii < labels.size(); ii++) {
+      oss << (ii > 0 ? "," : "") << labels[ii].first << "=\"" << escape_label(labels[ii].second)
+          << "\"";
+    }
+    oss << "}";
+  }
+  oss << " " << std::setprecision(15) << value;
+  it->second.samples.push_back(oss.str());
+}
+
+std::string MetricsWriter::render() const {
+  std::ostringstream oss;
+  for (auto &name : this->order) {
+    const Family &family = this->families.at(name);
+    oss << "# HELP " << name << " " << family.help << "\n";
+    oss << "# TYPE " << name << " " << (family.type == METRIC_TYPE::COUNTER ? "counter" : "gauge")
+        << "\n";
+    for (auto &sample : family.samples) {
+      oss << sample << "\n";
+    }
+  }
+  return oss.str();
+}
+
+// Built-in collectors
+// ===================
+static void collect_queues(MetricsWriter &writer) {
+  for (auto &stats : QueueRegistry::instance().snapshot()) {
+    MetricLabels labels{{"queue", stats.name}};
+    writer.gauge("acsense_queue_depth", "Items currently queued", stats.depth, labels);
+    writer.gauge("acsense_queue_high_water", "Largest queue depth seen", stats.high_water,
+                 labels);
+    writer.gauge("acsense_queue_max_length", "Queue length limit (0 = unbounded)",
+                 stats.max_length, labels);
+    writer.counter("acsense_queue_pushed_total", "Items pushed", stats.pushes, labels);
+    writer.counter("acsense_queue_popped_total", "Items popped", stats.pops, labels);
+    writer.counter("acsense_queue_dropped_total", "Oldest items dropped on a full queue",
+                   stats.drops, labels);
+    writer.counter("acsense_queue_cleared_total", "Items discarded by clear()", stats.cleared,
+                   labels);
+    writer.counter("acsense_queue_wait_seconds_total", "Time consumers spent waiting for data",
+                   stats.wait_nsec / 1e9, labels);
+  }
+}
+
+// CPU time of every thread in the process, by the name set with prctl(PR_SET_NAME)
+static void collect_threads(MetricsWriter &writer) {
+  DIR *dir = opendir("/proc/self/task");
+  if (dir == nullptr)
+    return;
+
+  double ticks_per_sec = sysconf(_SC_CLK_TCK);
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    if (entry->d_name[0] == '.')
+      continue;
+    std::ifstream ifil(std::string("/proc/self/task/") + entry->d_name + "/stat");
+    std::string line;
+    if (!std::getline(ifil, line))
+      continue;
+
+    // pid (comm) state ppid ... ; comm may contain spaces, so split after the last ')'
+    size_t name_start = line.find('(');
+    size_t name_end = line.rfind(')');
+    if (name_start == std::string::npos || name_end == std::string::npos)
+      continue;
+    std::istringstream iss(line.substr(name_end + 1));
+    std::vector<std::string> fields{std::istream_iterator<std::string>(iss),
+                                    std::istream_iterator<std::string>()};
+    if (fields.size() < 13)
+      continue;
+    // fields[0] is the state; utime and stime are the 14th and 15th stat fields
+    double cpu_ticks = std::stod(fields[11]) + std::stod(fields[12]);
+
+    writer.counter("acsense_thread_cpu_seconds_total", "CPU time (user + system) per thread",
+                   cpu_ticks / ticks_per_sec,
+                   {{"thread", line.substr(name_start + 1, name_end - name_start - 1)},
+                    {"tid", entry->d_name}});
+  }
+  closedir(dir);
+}
+
+static void collect_latency(MetricsWriter &writer) {
+  if (!LatencyTracker::is_enabled())
+    return;
+  for (auto &stats : LatencyTracker::instance().get_since_receive()) {
+    writer.gauge("acsense_latency_seconds", "Latency from datagram receipt to stage",
+                 stats.p50_nsec / 1e9, {{"stage", stats.stage}, {"quantile", "0.5"}});
+    writer.gauge("acsense_latency_seconds", "Latency from datagram receipt to stage",
+                 stats.p99_nsec / 1e9, {{"stage", stats.stage}, {"quantile", "0.99"}});
+    writer.gauge("acsense_latency_seconds", "Latency from datagram receipt to stage",
+                 stats.max_nsec / 1e9, {{"stage", stats.stage}, {"quantile", "1"}});
+  }
+}
+
+// MetricsExporter
+// ===============
+MetricsExporter::MetricsExporter() {
+  this->collectors.push_back(collect_queues);
+  this->collectors.push_back(collect_threads);
+  this->collectors.push_back(collect_latency);
+}
+
+MetricsExporter::~MetricsExporter() { this->stop(); }
+
+void MetricsExporter::add_collector(Collector collector) {
+  std::lock_guard<std::mutex> lock(this->collector_mutex);
+  this->collectors.push_back(collector);
+}
+
+void MetricsExporter::add_socket(const UdpSocketIn &socket) {
+  std::shared_ptr<SocketStats> stats = socket.get_stats();
+  std::string port = std::to_string(socket.port);
+  this->add_collector([stats, port](MetricsWriter &writer) {
+    for (size_t ii = 0; ii < (size_t)MSG_ID::NUM_MSG_ID; ii++) {
+      uint64_t packets = stats->packets[ii].load(std::memory_order_relaxed);
+      if (packets == 0)
+        continue;
+      MetricLabels labels{{"port", port}, {"type", msg_id_name((MSG_ID)ii)}};
+      writer.counter("acsense_udp_packets_total", "Datagrams received, by message type",
+                     packets, labels);
+      writer.counter("acsense_udp_bytes_total", "Bytes received, by message type",
+                     stats->bytes[ii].load(std::memory_order_relaxed), labels);
+    }
+    writer.counter("acsense_udp_rejected_total", "Datagrams decoded but rejected",
+                   stats->rejected.load(std::memory_order_relaxed), {{"port", port}});
+  });
+}
+
+void MetricsExporter::add_fft(FFT &fft, std::string name) {
+  std::shared_ptr<ProcessingStats> stats = fft.get_processing_stats();
+  this->add_collector([stats, name](MetricsWriter &writer) {
+    MetricLabels labels{{"name", name}};
+    writer.counter("acsense_fft_packets_total", "Acoustic packets consumed by the FFT",
+                   stats->items_in.load(), labels);
+    writer.counter("acsense_fft_frames_total", "FFT frames emitted", stats->items_out.load(),
+                   labels);
+    writer.counter("acsense_fft_busy_seconds_total", "Time spent computing FFT frames",
+                   stats->busy_nsec.load() / 1e9, labels);
+  });
+}
+
+void MetricsExporter::add_detector(EnergyDetector &detector, std::string name) {
+  std::shared_ptr<ProcessingStats> stats = detector.get_processing_stats();
+  this->add_collector([stats, name](MetricsWriter &writer) {
+    MetricLabels labels{{"name", name}};
+    writer.counter("acsense_detector_frames_total", "FFT frames processed by the detector",
+                   stats->items_out.load(), labels);
+    writer.counter("acsense_detector_detection_frames_total",
+                   "Detector outputs with at least one detection", stats->events.load(), labels);
+    writer.counter("acsense_detector_busy_seconds_total", "Time spent in the detector",
+                   stats->busy_nsec.load() / 1e9, labels);
+  });
+}
+
+void MetricsExporter::add_writer(std::string logger, std::function<WriterStats()> get_stats) {
+  this->add_collector([logger, get_stats](MetricsWriter &writer) {
+    WriterStats stats = get_stats();
+    // loggers that never opened a file (i.e. not enabled) are left out
+    if (stats.files_opened == 0 && stats.writes == 0)
+      return;
+    MetricLabels labels{{"logger", logger}};
+    writer.counter("acsense_logger_bytes_written_total", "Bytes written to log files",
+                   stats.bytes_written, labels);
+    writer.counter("acsense_logger_writes_total", "Write calls issued", stats.writes, labels);
+    writer.counter("acsense_logger_write_errors_total", "Failed writes", stats.write_errors,
+                   labels);
+    writer.counter("acsense_logger_files_opened_total", "Log files opened (incl. rollovers)",
+                   stats.files_opened, labels);
+    writer.counter("acsense_logger_fsyncs_total", "fsync() calls", stats.fsyncs, labels);
+    writer.counter("acsense_logger_dropped_total", "Packets / frames that could not be logged",
+                   stats.dropped, labels);
+    writer.counter("acsense_logger_stall_seconds_total",
+                   "Time producers were blocked on the write-behind queue",
+                   stats.stall_nsec / 1e9, labels);
+    writer.gauge("acsense_logger_queue_depth", "Buffers / packets awaiting write",
+                 stats.queue_depth, labels);
+  });
+}
+
+void MetricsExporter::add_interface_helper(InterfaceHelper &helper) {
+  // sockets added to the helper after this call are not picked up
+  for (auto &socket : helper.sockets) {
+    this->add_socket(socket);
+  }
+  this->add_fft(helper._fft_helper);
+  this->add_detector(helper._detector);
+  for (auto &logger : LOGGER_NAME) {
+    LOGGER L = logger.first;
+    this->add_writer(logger.second, [&helper, L]() { return helper.get_writer_stats(L); });
+  }
+}
+
+void MetricsExporter::add_logger_block(LoggerBlock &block) {
+  for (LOGGER L : {LOGGER::ACO_CSV, LOGGER::ACO_FLAC, LOGGER::ACO_WAV}) {
+    this->add_writer(LOGGER_NAME[L], [&block, L]() { return block.get_writer_stats(L); });
+  }
+}
+
+std::string MetricsExporter::render() {
+  MetricsWriter writer;
+  std::lock_guard<std::mutex> lock(this->collector_mutex);
+  for (auto &collector : this->collectors) {
+    collector(writer);
+  }
+  return writer.render();
+}
+
+bool MetricsExporter::serve_http(int port, std::string bind_ip) {
+  if (this->listen_fd >= 0) {
+    LOG(WARNING) << "Metrics endpoint already open";
+    return false;
+  }
+
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0) {
+    LOG(WARNING) << "Could not create metrics socket : " << strerror(errno);
+    return false;
+  }
+  int reuse = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  inet_pton(AF_INET, bind_ip.c_str(), &addr.sin_addr);
+
+  if (bind(sock, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(sock, 4) < 0) {
+    LOG(WARNING) << "Could not open metrics endpoint on " << bind_ip << ":" << port << " : "
+                 << strerror(errno);
+    close(sock);
+    return false;
+  }
+
+  this->listen_fd = sock;
+  LOG(INFO) << "Serving metrics at http://" << bind_ip << ":" << port << "/metrics";
+  this->start_thread();
+  return true;
+}
+
+void MetricsExporter::write_file(std::string path, double period_sec) {
+  {
+    std::lock_guard<std::mutex> lock(this->collector_mutex);
+    this->file_path = path;
+    this->file_period = std::chrono::milliseconds((int64_t)(period_sec * 1000));
+  }
+  LOG(INFO) << "Writing metrics to " << path << " every " << period_sec << " s";
+  this->start_thread();
+}
+
+void MetricsExporter::start_thread() {
+  if (this->_is_running)
+    return;
+  this->keep_alive = true;
+  this->_is_running = true;
+  pthread_create(&this->own_thread, NULL, _run_metrics_thread, this);
+}
+
+void MetricsExporter::stop() {
+  this->keep_alive = false;
+  if (this->_is_running) {
+    pthread_join(this->own_thread, NULL);
+    this->_is_running = false;
+  }
+  if (this->listen_fd >= 0) {
+    close(this->listen_fd);
+    this->listen_fd = -1;
+  }
+}
+
+void *MetricsExporter::_run_metrics_thread(void *ptr) {
+  MetricsExporter *argPtr = static_cast<MetricsExporter *>(ptr);
+  argPtr->run_metrics_thread();
+  pthread_exit(NULL);
+}
+
+void MetricsExporter::run_metrics_thread() {
+  prctl(PR_SET_NAME, "metrics_thr");
+  VLOG(3) << "Starting metrics exporter in thread " << pthread_self();
+
+  auto next_file_write = std::chrono::steady_clock::now();
+  while (this->keep_alive) {
+    int fd = this->listen_fd;
+    if (fd >= 0) {
+      pollfd pfd{fd, POLLIN, 0};
+      if (poll(&pfd, 1, 200) > 0 && (pfd.revents & POLLIN)) {
+        int client_fd = accept(fd, NULL, NULL);
+        if (client_fd >= 0)
+          this->handle_client(client_fd);
+      }
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    bool write_now = false;
+    {
+      std::lock_guard<std::mutex> lock(this->collector_mutex);
+      auto now = std::chrono::steady_clock::now();
+      if (!this->file_path.empty() && now >= next_file_write) {
+        next_file_write = now + this->file_period;
+        write_now = true;
+      }
+    }
+    if (write_now)
+      this->write_file_now();
+  }
+}
+
+void MetricsExporter::handle_client(int client_fd) {
+  // a scraper that connects but never sends a request must not stall the thread
+  timeval timeout{1, 0};
+  setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  std::string request;
+  char buff[1024];
+  while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+    ssize_t len = recv(client_fd, buff, sizeof(buff), 0);
+    if (len <= 0)
+      break;
+    request.append(buff, len);
+  }
+
+  std::string path;
+  size_t path_start = request.find(' ');
+  size_t path_end = request.find(' ', path_start + 1);
+  if (path_start != std::string::npos && path_end != std::string::npos)
+    path = request.substr(path_start + 1, path_end - path_start - 1);
+
+  std::string status = "200 OK";
+  std::string body;
+  if (request.compare(0, 4, "GET ") != 0) {
+    status = "405 Method Not Allowed";
+  } else if (path == "/metrics" || path == "/") {
+    body = this->render();
+  } else {
+    status = "404 Not Found";
+  }
+  if (FLAGS_debug_metrics)
+    VLOG(3) << "Metrics request for '" << path << "' : " << status;
+
+  std::ostringstream oss;
+  oss << "HTTP/1.0 " << status << "\r\n"
+      << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+      << "Content-Length: " << body.size() << "\r\n"
+      << "Connection: close\r\n\r\n"
+      << body;
+  std::string response = oss.str();
+
+  size_t sent = 0;
+  while (sent < response.size()) {
+    ssize_t len = send(client_fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+    if (len <= 0)
+      break;
+    sent += len;
+  }
+  close(client_fd);
+}
+
+void MetricsExporter::write_file_now() {
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(this->collector_mutex);
+    path = this->file_path;
+  }
+
+  // write a temporary file and rename it, so readers never see a partial file
+  std::string tmp_path = path + ".tmp";
+  std::ofstream ofil(tmp_path, std::ios::trunc);
+  ofil << this->render();
+  ofil.close();
+  if (!ofil || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG_EVERY_N(WARNING, 100) << "Could not write metrics file " << path << " : "
+                              << strerror(errno);
+  }
+}
@@ -0,0 +1,116 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: MetricsExporter.h                                      */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef metrics_exporter_HEADER
+#define metrics_exporter_HEADER
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <gflags/gflags.h>
+#include <mutex>
+#include <pthread.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// includes from within project
+#include "utils/AsyncFileWriter.h"
+
+DECLARE_bool(debug_metrics);
+
+class EnergyDetector;
+class FFT;
+class InterfaceHelper;
+class LoggerBlock;
+struct UdpSocketIn;
+
+enum class METRIC_TYPE { COUNTER, GAUGE };
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+// Accumulates samples and renders them in the Prometheus text exposition format,
+// with the HELP / TYPE lines once per metric family.
+class MetricsWriter {
+public:
+  void add(const std::string &name, const std::string &help, METRIC_TYPE type, double value,
+           const MetricLabels &labels = {});
+  void counter(const std::string &name, const std::string &help, double value,
+               const MetricLabels &labels = {}) {
+    this->add(name, help, METRIC_TYPE::COUNTER, value, labels);
+  }
+  void gauge(const std::string &name, const std::string &help, double value,
+             const MetricLabels &labels = {}) {
+    this->add(name, help, METRIC_TYPE::GAUGE, value, labels);
+  }
+  std::string render() const;
+
+protected:
+  struct Family {
+    std::string help;
+    METRIC_TYPE type;
+    std::vector<std::string> samples;
+  };
+  std::vector<std::string> order;
+  std::unordered_map<std::string, Family> families;
+};
+
+// Publishes pipeline metrics, pulled from the existing objects at scrape time, either
+// over HTTP (GET /metrics, bound to localhost by default) or as a text file rewritten
+// atomically every period (e.g. for the node_exporter textfile collector).
+//
+// Queue counters (QueueRegistry), per-thread CPU time and latency percentiles (when
+// --latency_tracking is on) are always included; the add_*() calls register the
+// objects to pull from. Objects passed by reference must outlive the exporter.
+class MetricsExporter {
+public:
+  using Collector = std::function<void(MetricsWriter &)>;
+
+  MetricsExporter();
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter &) = delete;
+  MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+  void add_collector(Collector collector);
+  void add_socket(const UdpSocketIn &socket);
+  void add_fft(FFT &fft, std::string name = "fft");
+  void add_detector(EnergyDetector &detector, std::string name = "detector");
+  void add_writer(std::string logger, std::function<WriterStats()> get_stats);
+  // sockets, FFT, detector and loggers of a helper / logger block
+  void add_interface_helper(InterfaceHelper &helper);
+  void add_logger_block(LoggerBlock &block);
+
+  bool serve_http(int port, std::string bind_ip = "127.0.0.1");
+  void write_file(std::string path, double period_sec = 10.0);
+  void stop();
+
+  std::string render();
+
+protected:
+  std::mutex collector_mutex;
+  std::vector<Collector> collectors;
+
+  std::atomic<int> listen_fd{-1};
+  std::string file_path;
+  std::chrono::milliseconds file_period{10000};
+
+  pthread_t own_thread;
+  bool keep_alive = false;
+  bool _is_running = false;
+
+  void start_thread();
+  static void *_run_metrics_thread(void *arg);
+  void run_metrics_thread();
+  void handle_client(int client_fd);
+  void write_file_now();
+};
+
+#endif
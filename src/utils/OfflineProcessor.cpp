@@ -0,0 +1,373 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: OfflineProcessor.cpp                                   */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <glog/logging.h>
+#include <sys/prctl.h>
+#include <thread>
+
+// includes from within project
+#include "utils/OfflineProcessor.h"
+#include "utils/PacketCapture.h"
+#include "utils/UdpSocketIn.h"
+
+DEFINE_bool(debug_offline_processor, false, "Enable expanded debug for offline processing");
+
+struct OfflineProcessor::LogSource : public OfflineProcessor::Source {
+  AcousticLogReader reader;
+
+  std::shared_ptr<UdpAcousticData> read_packet(size_t first, size_t count) override {
+    return this->reader.read_packet(first, count);
+  }
+};
+
+struct OfflineProcessor::CaptureSource : public OfflineProcessor::Source {
+  PacketReplay replay;
+  const OfflineProcessor &owner;
+  std::vector<int8_t> msg;
+
+  CaptureSource(const OfflineProcessor &owner) : owner(owner) {}
+
+  std::shared_ptr<UdpAcousticData> read_packet(size_t first, size_t count) override {
+    const std::vector<size_t> &samples = this->owner.capture_samples;
+    if (first >= samples.back() || count == 0) {
+      return nullptr;
+    }
+    size_t pp = std::upper_bound(samples.begin(), samples.end(), first) - samples.begin() - 1;
+    int64_t arrival_nsec;
+    if (!this->replay.read(this->owner.capture_packets[pp], this->msg, arrival_nsec)) {
+      return nullptr;
+    }
+    auto aco_data = std::make_shared<UdpAcousticData>(this->msg);
+    size_t offset = first - samples[pp];
+    count = std::min(count, samples[pp + 1] - first);
+    if (offset == 0 && count == (size_t)aco_data->data.cols()) {
+      return aco_data;
+    }
+    // part of the packet, as the device would have sent it
+    UdpAcousticData::Header &hdr = aco_data->header;
+    aco_data->data = aco_data->data.middleCols(offset, count).eval();
+    hdr.num_values = hdr.num_channels * count;
+    hdr.start_time_nsec += (int64_t)std::llround(offset * 1e9 / hdr.sample_rate);
+    hdr.adc_count += offset;
+    return aco_data;
+  }
+};
+
+bool OfflineProcessor::open_log(const std::string &path, LOGGER format) {
+  this->close();
+  if (!this->reader.open(path, format)) {
+    return false;
+  }
+  this->path = path;
+  this->log_format = format;
+  this->num_samples = this->reader.size();
+  this->sample_rate = this->reader.get_sample_rate();
+  this->num_channels = this->reader.get_num_channels();
+  return true;
+}
+
+bool OfflineProcessor::open_capture(const std::string &path) {
+  this->close();
+  PacketReplay replay;
+  if (!replay.open(path)) {
+    return false;
+  }
+
+  // one pass over the datagrams to lay the ACO packets end to end
+  std::vector<int8_t> msg;
+  int64_t arrival_nsec;
+  size_t total = 0;
+  for (size_t ii = 0; ii < replay.size(); ii++) {
+    if (!replay.read(ii, msg, arrival_nsec) || UdpSocketIn::check_msg_id(msg) != MSG_ID::ACO) {
+      continue;
+    }
+    UdpAcousticData::Header hdr(msg);
+    if (hdr.num_channels <= 0 || hdr.num_values < hdr.num_channels || hdr.sample_rate <= 0) {
+      continue;
+    }
+    if (this->capture_packets.empty()) {
+      this->num_channels = hdr.num_channels;
+      this->sample_rate = hdr.sample_rate;
+    } else if (hdr.num_channels != this->num_channels) {
+      LOG_EVERY_N(WARNING, 1000) << "Skipping packet with " << (int)hdr.num_channels
+                                 << " channels; expected " << this->num_channels;
+      continue;
+    }
+    this->capture_packets.push_back(ii);
+    this->capture_samples.push_back(total);
+    this->capture_times.push_back(hdr.start_time_nsec);
+    total += hdr.num_values / hdr.num_channels;
+  }
+  this->capture_samples.push_back(total);
+
+  if (total == 0) {
+    LOG(WARNING) << "No acoustic packets in " << path;
+    this->close();
+    return false;
+  }
+  this->path = path;
+  this->is_capture = true;
+  this->num_samples = total;
+  return true;
+}
+
+void OfflineProcessor::close() {
+  this->reader.close();
+  this->path.clear();
+  this->is_capture = false;
+  this->num_samples = 0;
+  this->sample_rate = 0;
+  this->num_channels = 0;
+  this->capture_packets.clear();
+  this->capture_samples.clear();
+  this->capture_times.clear();
+}
+
+int64_t OfflineProcessor::get_time_nsec(size_t sample) {
+  if (!this->is_capture) {
+    return this->reader.get_time_nsec(sample);
+  }
+  if (this->capture_packets.empty()) {
+    return 0;
+  }
+  sample = std::min(sample, this->num_samples - 1);
+  size_t pp = std::upper_bound(this->capture_samples.begin(), this->capture_samples.end(), sample) -
+              this->capture_samples.begin() - 1;
+  return this->capture_times[pp] +
+         (int64_t)std::llround((sample - this->capture_samples[pp]) * 1e9 / this->sample_rate);
+}
+
+size_t OfflineProcessor::find(int64_t time_nsec) {
+  if (!this->is_capture) {
+    return this->reader.find(time_nsec);
+  }
+  auto it = std::upper_bound(this->capture_times.begin(), this->capture_times.end(), time_nsec);
+  size_t pp = it - this->capture_times.begin();
+  if (pp > 0) {
+    // within the packet before, if it was still recording at time_nsec
+    size_t offset = (size_t)std::ceil((time_nsec - this->capture_times[pp - 1]) *
+                                      this->sample_rate / 1e9);
+    if (this->capture_samples[pp - 1] + offset < this->capture_samples[pp]) {
+      return this->capture_samples[pp - 1] + offset;
+    }
+  }
+  return this->capture_samples[pp];
+}
+
+void OfflineProcessor::set_samples_per_packet(size_t samples_per_packet) {
+  this->samples_per_packet = std::max<size_t>(samples_per_packet, 1);
+}
+
+std::unique_ptr<OfflineProcessor::Source> OfflineProcessor::open_source() {
+  if (this->is_capture) {
+    auto source = std::make_unique<CaptureSource>(*this);
+    if (!source->replay.open(this->path))
+      return nullptr;
+    return source;
+  }
+  auto source = std::make_unique<LogSource>();
+  source->reader.set_default_sample_rate(this->sample_rate);
+  if (!source->reader.open(this->path, this->log_format))
+    return nullptr;
+  source->reader.set_samples_per_packet(this->samples_per_packet);
+  return source;
+}
+
+bool OfflineProcessor::plan(size_t first, size_t last, Plan &plan) {
+  plan = Plan();
+  plan.first = first;
+  plan.last = last;
+
+  // the FFT settles its decimation and Welch length on the first packet; probe a copy
+  auto source = this->open_source();
+  auto aco_data = source ? source->read_packet(first, this->samples_per_packet) : nullptr;
+  if (aco_data == nullptr) {
+    return false;
+  }
+  FFT probe = *this->fft;
+  probe.reset();
+  if (probe.get_mode() == FFT_MODE::WELCH_PSD) {
+    probe.process_psd({aco_data});
+  } else {
+    probe.process(aco_data);
+  }
+
+  size_t factor = std::max<size_t>(probe.get_decimation_factor(), 1);
+  plan.hop_samples = probe.get_nstep() * factor;
+  plan.psd = probe.get_mode() == FFT_MODE::WELCH_PSD;
+  plan.frames_per_unit = plan.psd ? std::max<size_t>(probe.get_psd_averages(), 1) : 1;
+  plan.detect = this->detector != nullptr && !plan.psd;
+  if (this->detector != nullptr && plan.psd) {
+    LOG(WARNING) << "The detector takes FFT frames, not Welch PSDs; running the FFT only";
+  }
+
+  // frames on the hop grid from `first`, so every chunk lines up with a single pass
+  size_t unit_samples = plan.hop_samples * plan.frames_per_unit;
+  plan.units_per_chunk =
+      std::max<size_t>(std::llround(this->chunk_sec * this->sample_rate / unit_samples), 1);
+
+  // lead-in: decimation filter history ahead of the first frame, then detector warm-up
+  size_t history = probe.get_decimation_taps() > 0 ? probe.get_decimation_taps() - 1 : 0;
+  size_t lead_frames = (history + plan.hop_samples - 1) / plan.hop_samples;
+  plan.detector_lead = plan.detect ? this->detector_warmup : 0;
+  lead_frames += plan.detector_lead;
+  plan.lead_units = (lead_frames + plan.frames_per_unit - 1) / plan.frames_per_unit;
+
+  size_t num_units = (last - first) / unit_samples + 1;
+  plan.num_chunks = (num_units + plan.units_per_chunk - 1) / plan.units_per_chunk;
+  return true;
+}
+
+void OfflineProcessor::run_chunk(size_t chunk, Source &source, OfflineResult &out) {
+  const Plan &plan = this->run_plan;
+  size_t u0 = chunk * plan.units_per_chunk;
+  size_t lead = std::min(u0, plan.lead_units);
+  // the last chunk runs to the end of the data
+  size_t need = chunk + 1 == plan.num_chunks ? SIZE_MAX : lead + plan.units_per_chunk;
+
+  FFT fft = *this->fft;
+  fft.reset();
+  std::unique_ptr<EnergyDetector> detector;
+  if (plan.detect) {
+    detector = std::make_unique<EnergyDetector>(*this->detector);
+    detector->reset();
+  }
+
+  size_t sample = plan.first + (u0 - lead) * plan.frames_per_unit * plan.hop_samples;
+  size_t produced = 0;
+  out.num_samples = 0;
+  while (this->keep_alive && sample < plan.last && produced < need) {
+    auto aco_data = source.read_packet(
+        sample, std::min(this->samples_per_packet, plan.last - sample));
+    if (aco_data == nullptr)
+      break;
+    sample += aco_data->data.cols();
+
+    if (plan.psd) {
+      for (auto &psd : fft.process_psd({aco_data})) {
+        if (produced >= need)
+          break;
+        size_t idx = produced++;
+        if (idx < lead)
+          continue;
+        psd->header.packet_num = u0 + idx - lead;
+        out.psd.push_back(psd);
+      }
+      continue;
+    }
+    for (auto &frame : fft.process(aco_data)) {
+      if (produced >= need)
+        break;
+      size_t idx = produced++;
+      // frames within the detector warm-up only seed its averages
+      if (idx + plan.detector_lead < lead)
+        continue;
+      frame->header.packet_num = u0 + idx - std::min(idx, lead);
+      std::shared_ptr<IpcDetector> detect = detector ? detector->process(frame) : nullptr;
+      if (idx < lead)
+        continue;
+      if (this->keep_fft)
+        out.fft.push_back(frame);
+      if (detect)
+        out.detections.push_back(detect);
+    }
+  }
+
+  if (FLAGS_debug_offline_processor) {
+    VLOG(3) << "Offline chunk " << chunk << " : outputs from " << u0 << ", " << lead
+            << " lead-in; " << (produced - std::min(produced, lead)) << " kept";
+  }
+}
+
+void *OfflineProcessor::_run_worker_thread(void *ptr) {
+  OfflineProcessor *argPtr = static_cast<OfflineProcessor *>(ptr);
+  argPtr->run_worker_thread();
+  pthread_exit(NULL);
+}
+
+void OfflineProcessor::run_worker_thread() {
+  prctl(PR_SET_NAME, "ac_offline");
+  auto source = this->open_source();
+  if (source == nullptr) {
+    LOG(WARNING) << "Offline worker could not open " << this->path;
+    return;
+  }
+  for (size_t chunk = this->next_chunk++; chunk < this->run_plan.num_chunks && this->keep_alive;
+       chunk = this->next_chunk++) {
+    this->run_chunk(chunk, *source, this->chunk_results[chunk]);
+  }
+}
+
+OfflineResult OfflineProcessor::process(size_t first, size_t last) {
+  OfflineResult result;
+  last = std::min(last, this->num_samples);
+  if (first >= last) {
+    return result;
+  }
+  if (this->fft == nullptr) {
+    LOG(WARNING) << "Offline processing needs an FFT; see set_fft()";
+    return result;
+  }
+  if (this->fft->is_running() || (this->detector && this->detector->is_running())) {
+    LOG(WARNING) << "Offline processing copies the FFT / detector settings; stop them first";
+    return result;
+  }
+
+  auto t_start = std::chrono::steady_clock::now();
+  this->keep_alive = true;
+  if (!this->plan(first, last, this->run_plan)) {
+    LOG(WARNING) << "Could not read " << this->path;
+    return result;
+  }
+  this->next_chunk = 0;
+  this->chunk_results.assign(this->run_plan.num_chunks, OfflineResult());
+
+  size_t num_threads =
+      this->num_threads > 0 ? this->num_threads : std::max(std::thread::hardware_concurrency(), 1u);
+  num_threads = std::min(num_threads, this->run_plan.num_chunks);
+  std::vector<pthread_t> threads;
+  for (size_t ii = 0; ii < num_threads; ii++) {
+    pthread_t _thread;
+    pthread_create(&_thread, NULL, _run_worker_thread, this);
+    threads.push_back(_thread);
+  }
+  for (auto &thread : threads) {
+    pthread_join(thread, NULL);
+  }
+
+  // chunks are consecutive, so their results concatenate in time order
+  for (auto &chunk : this->chunk_results) {
+    result.fft.insert(result.fft.end(), chunk.fft.begin(), chunk.fft.end());
+    result.psd.insert(result.psd.end(), chunk.psd.begin(), chunk.psd.end());
+    result.detections.insert(result.detections.end(), chunk.detections.begin(),
+                             chunk.detections.end());
+  }
+  this->chunk_results.clear();
+  if (this->run_plan.detect) {
+    EnergyDetector events = *this->detector;
+    events.reset();
+    events.process_events(result.detections, result.events);
+    events.flush_events(result.events);
+  }
+
+  result.num_samples = last - first;
+  result.num_chunks = this->run_plan.num_chunks;
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t_start;
+  result.elapsed_sec = elapsed.count();
+  if (FLAGS_debug_offline_processor) {
+    VLOG(3) << "Processed " << result.num_samples << " samples in " << result.num_chunks
+            << " chunks on " << num_threads << " threads in " << result.elapsed_sec << " s ("
+            << result.num_samples / this->sample_rate / std::max(result.elapsed_sec, 1e-9)
+            << "x real time)";
+  }
+  return result;
+}
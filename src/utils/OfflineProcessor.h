@@ -0,0 +1,151 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: OfflineProcessor.h                                     */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef offline_processor_HEADER
+#define offline_processor_HEADER
+
+#include <atomic>
+#include <gflags/gflags.h>
+#include <memory>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+// includes from within project
+#include "utils/AcousticLogReader.h"
+#include "utils/EnergyDetector.h"
+#include "utils/FFT.h"
+
+DECLARE_bool(debug_offline_processor);
+
+// Everything an offline run produced, in time order
+struct OfflineResult {
+  std::vector<std::shared_ptr<IpcFFT>> fft; // SPECTRUM / ACTIVE_BINS, with set_keep_fft()
+  std::vector<std::shared_ptr<IpcPSD>> psd; // WELCH_PSD
+  std::vector<std::shared_ptr<IpcDetector>> detections;
+  std::vector<std::shared_ptr<IpcDetectionEvent>> events;
+
+  size_t num_samples = 0; // input samples covered
+  size_t num_chunks = 0;
+  double elapsed_sec = 0;
+};
+
+// Runs a recording through FFT (and optionally EnergyDetector) with their synchronous
+// process() calls, as fast as the CPU allows: no queues, no sleeps, and the sample rate
+// comes with every packet. The source is an acoustic log (see AcousticLogReader) or a
+// packet capture (see PacketReplay; only its ACO datagrams are used).
+//
+// The FFT and detector passed in are templates: each chunk of work runs on copies, so
+// configure them (NFFT, bands, mode, algorithm, ...) before process() and do not run()
+// them. The recording is cut into chunks of whole FFT hops (whole Welch averages in
+// WELCH_PSD mode), processed on set_num_threads() threads, each with its own reader.
+// At a chunk boundary, the worker starts early and drops what it computes before the
+// chunk:
+//  - FFT frames overlap by NFFT - nstep samples, and the decimation filter (if any) needs
+//    its taps of history; frames from the lead-in hops make both match a single pass
+//  - detector averages (EMA_RATIO, MEDIAN_FLOOR) have long memories; they are seeded over
+//    set_detector_warmup_frames() frames ahead of the chunk, so early detections in a
+//    chunk can differ from a single pass. CA_CFAR / OS_CFAR keep no state across frames.
+// Detection events are merged over the whole run, so they may span chunks. FFT / PSD
+// packet numbers count frames from the start of the run.
+class OfflineProcessor {
+public:
+  OfflineProcessor() {}
+  ~OfflineProcessor() { this->close(); }
+
+  // acoustic log, or directory of rolled-over logs (see AcousticLogReader::open)
+  bool open_log(const std::string &path, LOGGER format = LOGGER::UNKNOWN);
+  // PacketCapture file
+  bool open_capture(const std::string &path);
+  void close();
+  bool is_open() { return this->num_samples > 0; }
+
+  size_t size() { return this->num_samples; }
+  double get_sample_rate() { return this->sample_rate; }
+  int get_num_channels() { return this->num_channels; }
+  int64_t get_time_nsec(size_t sample);
+  // First sample at or after time_nsec (size() if none)
+  size_t find(int64_t time_nsec);
+
+  void set_fft(std::shared_ptr<FFT> fft) { this->fft = fft; }
+  // optional; ignored in WELCH_PSD mode
+  void set_detector(std::shared_ptr<EnergyDetector> detector) { this->detector = detector; }
+  // 0 : one per core
+  void set_num_threads(size_t num_threads) { this->num_threads = num_threads; }
+  void set_chunk_sec(double chunk_sec) { this->chunk_sec = chunk_sec; }
+  void set_detector_warmup_frames(size_t num_frames) { this->detector_warmup = num_frames; }
+  void set_samples_per_packet(size_t samples_per_packet);
+  // Keep every FFT frame in the result; off by default. Each frame holds channels x bins
+  // complex doubles (16 bytes each): 32 channels x 513 bins is ~260 kB a frame, ~2 GB per
+  // minute of 64 kHz audio at a 512-sample hop. Detections / PSDs are kept regardless
+  void set_keep_fft(bool keep_fft) { this->keep_fft = keep_fft; }
+
+  // Process samples [first, last); blocks until done, or stop() from another thread
+  OfflineResult process(size_t first = 0, size_t last = SIZE_MAX);
+  void stop() { this->keep_alive = false; }
+
+protected:
+  // an open view of the recording; each worker thread has its own
+  struct Source {
+    virtual ~Source() {}
+    // samples [first, first + count) or fewer, as one packet; nullptr past the end
+    virtual std::shared_ptr<UdpAcousticData> read_packet(size_t first, size_t count) = 0;
+  };
+  struct LogSource;
+  struct CaptureSource;
+  std::unique_ptr<Source> open_source();
+
+  // how a run is cut up; fixed by process() before the workers start
+  struct Plan {
+    size_t first = 0;
+    size_t last = 0;
+    size_t hop_samples = 0;      // input samples per FFT hop
+    size_t frames_per_unit = 1;  // FFT frames per output (Welch averages)
+    size_t units_per_chunk = 1;  // outputs per chunk
+    size_t lead_units = 0;       // outputs computed ahead of a chunk and dropped
+    size_t detector_lead = 0;    // of which, detector warm-up
+    size_t num_chunks = 0;
+    bool psd = false;
+    bool detect = false;
+  };
+  bool plan(size_t first, size_t last, Plan &plan);
+  void run_chunk(size_t chunk, Source &source, OfflineResult &out);
+
+  static void *_run_worker_thread(void *ptr);
+  void run_worker_thread();
+
+  std::string path;
+  LOGGER log_format = LOGGER::UNKNOWN;
+  bool is_capture = false;
+
+  size_t num_samples = 0;
+  double sample_rate = 0;
+  int num_channels = 0;
+  AcousticLogReader reader; // log metadata (time <-> sample), main thread only
+  // capture: datagram of each ACO packet, its first sample (plus the total) and its time
+  std::vector<size_t> capture_packets;
+  std::vector<size_t> capture_samples;
+  std::vector<int64_t> capture_times;
+
+  std::shared_ptr<FFT> fft;
+  std::shared_ptr<EnergyDetector> detector;
+  size_t num_threads = 0;
+  double chunk_sec = 60;
+  size_t detector_warmup = 1000;
+  size_t samples_per_packet = 1024;
+  bool keep_fft = false;
+
+  // state of the current run
+  Plan run_plan;
+  std::atomic<size_t> next_chunk{0};
+  std::atomic<bool> keep_alive{false};
+  std::vector<OfflineResult> chunk_results;
+};
+
+#endif
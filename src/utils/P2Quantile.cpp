@@ -0,0 +1,82 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: P2Quantile.cpp                                         */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+// includes from within project
+#include "utils/P2Quantile.h"
+
+void P2Quantile::add(double x) {
+  if (this->num_samples < 5) {
+    this->q[this->num_samples++] = x;
+    if (this->num_samples == 5) {
+      std::sort(this->q.begin(), this->q.end());
+      this->n = {0, 1, 2, 3, 4};
+      this->np = {0, 2 * this->p, 4 * this->p, 2 + 2 * this->p, 4};
+    }
+    return;
+  }
+  this->num_samples++;
+
+  // cell the sample falls in; stretch the extremes if it is outside them
+  size_t k;
+  if (x < this->q[0]) {
+    this->q[0] = x;
+    k = 0;
+  } else if (x >= this->q[4]) {
+    this->q[4] = x;
+    k = 3;
+  } else {
+    k = std::upper_bound(this->q.begin() + 1, this->q.begin() + 4, x) - this->q.begin() - 1;
+  }
+  for (size_t ii = k + 1; ii < 5; ii++) {
+    this->n[ii] += 1;
+  }
+  const double dn[5] = {0, this->p / 2, this->p, (1 + this->p) / 2, 1};
+  for (size_t ii = 0; ii < 5; ii++) {
+    this->np[ii] += dn[ii];
+  }
+
+  // move the middle markers (by one position at most) towards where they should be
+  for (size_t ii = 1; ii < 4; ii++) {
+    double d = this->np[ii] - this->n[ii];
+    if ((d >= 1 && this->n[ii + 1] - this->n[ii] > 1) ||
+        (d <= -1 && this->n[ii - 1] - this->n[ii] < -1)) {
+      d = d > 0 ? 1 : -1;
+      double qp = this->q[ii] + d / (this->n[ii + 1] - this->n[ii - 1]) *
+                                    ((this->n[ii] - this->n[ii - 1] + d) *
+                                         (this->q[ii + 1] - this->q[ii]) /
+                                         (this->n[ii + 1] - this->n[ii]) +
+                                     (this->n[ii + 1] - this->n[ii] - d) *
+                                         (this->q[ii] - this->q[ii - 1]) /
+                                         (this->n[ii] - this->n[ii - 1]));
+      if (this->q[ii - 1] < qp && qp < this->q[ii + 1]) {
+        this->q[ii] = qp;
+      } else {
+        // parabola overshoots its neighbours; fall back to linear
+        size_t jj = d > 0 ? ii + 1 : ii - 1;
+        this->q[ii] += d * (this->q[jj] - this->q[ii]) / (this->n[jj] - this->n[ii]);
+      }
+      this->n[ii] += d;
+    }
+  }
+}
+
+double P2Quantile::value() const {
+  if (this->num_samples == 0) {
+    return 0;
+  }
+  if (this->num_samples < 5) {
+    std::array<double, 5> sorted = this->q;
+    std::sort(sorted.begin(), sorted.begin() + this->num_samples);
+    return sorted[(size_t)std::round(this->p * (this->num_samples - 1))];
+  }
+  return this->q[2];
+}
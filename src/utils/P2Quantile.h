@@ -0,0 +1,37 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: P2Quantile.h                                           */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef p2_quantile_HEADER
+#define p2_quantile_HEADER
+
+#include <array>
+#include <cstddef>
+
+// Streaming quantile estimate (Jain & Chlamtac's P^2 algorithm): five markers, O(1)
+// memory and time per sample, no stored history to sort. Exact for the first five
+// samples, then a piecewise-parabolic approximation.
+class P2Quantile {
+public:
+  P2Quantile(double p = 0.5) : p(p) {}
+
+  void add(double x);
+  double value() const;
+  size_t count() const { return this->num_samples; }
+  double get_quantile() const { return this->p; }
+  void reset() { this->num_samples = 0; }
+
+protected:
+  double p;
+  size_t num_samples = 0;
+  std::array<double, 5> q;  // marker heights
+  std::array<double, 5> n;  // marker positions
+  std::array<double, 5> np; // desired marker positions
+};
+
+#endif
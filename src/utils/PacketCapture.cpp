@@ -0,0 +1,305 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: PacketCapture.cpp                                      */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// includes from within project
+#include "utils/PacketCapture.h"
+#include "utils/UdpSocketIn.h"
+
+DEFINE_bool(debug_packet_capture, false, "Enable expanded debug for packet capture/replay");
+
+static const char PCAP_MAGIC[8] = {'A', 'C', 'P', 'C', 'A', 'P', '0', '1'};
+static const char PCAP_INDEX_MAGIC[8] = {'A', 'C', 'P', 'C', 'I', 'D', 'X', '1'};
+static const uint32_t PCAP_VERSION = 1;
+// largest datagram UdpSocketIn can receive; anything bigger marks a corrupt record
+static const uint32_t PCAP_MAX_LENGTH = 65535;
+
+// PacketRecorder
+// ==============
+bool PacketRecorder::open(const std::string &path) {
+  this->close();
+
+  std::lock_guard<std::mutex> lock(this->m_mutex);
+  if (!this->ofil.open(path)) {
+    return false;
+  }
+  this->path = path;
+  this->index.clear();
+
+  pcap_format::FileHeader header;
+  std::memcpy(header.magic, PCAP_MAGIC, sizeof(header.magic));
+  header.version = PCAP_VERSION;
+  header.reserved = 0;
+  this->ofil.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  this->offset = sizeof(header);
+
+  LOG(INFO) << "Capturing packets to " << path;
+  return true;
+}
+
+void PacketRecorder::close() {
+  // all under the lock: a record() from the socket thread either lands before the index
+  // or finds the file closed
+  std::lock_guard<std::mutex> lock(this->m_mutex);
+  if (!this->ofil.is_open()) {
+    return;
+  }
+
+  pcap_format::Trailer trailer;
+  trailer.index_offset = this->offset;
+  trailer.num_packets = this->index.size();
+  std::memcpy(trailer.magic, PCAP_INDEX_MAGIC, sizeof(trailer.magic));
+
+  this->ofil.write(reinterpret_cast<const char *>(this->index.data()),
+                   this->index.size() * sizeof(pcap_format::IndexEntry));
+  this->ofil.write(reinterpret_cast<const char *>(&trailer), sizeof(trailer));
+  this->ofil.close();
+
+  LOG(INFO) << "Closed capture " << this->path << " (" << this->index.size() << " packets)";
+}
+
+void PacketRecorder::record(const int8_t *data, size_t len, int64_t arrival_nsec) {
+  if (len > PCAP_MAX_LENGTH) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->m_mutex);
+  if (!this->ofil.is_open()) {
+    return;
+  }
+
+  pcap_format::RecordHeader rec;
+  rec.arrival_nsec = arrival_nsec;
+  rec.length = len;
+  this->ofil.write(reinterpret_cast<const char *>(&rec), sizeof(rec));
+  this->ofil.write(reinterpret_cast<const char *>(data), len);
+
+  this->index.push_back({arrival_nsec, this->offset, (uint32_t)len});
+  this->offset += sizeof(rec) + len;
+
+  if (FLAGS_debug_packet_capture) {
+    VLOG_EVERY_N(3, 1000) << "Captured " << this->index.size() << " packets to " << this->path;
+  }
+}
+
+uint64_t PacketRecorder::get_num_packets() {
+  std::lock_guard<std::mutex> lock(this->m_mutex);
+  return this->index.size();
+}
+
+// PacketReplay
+// ============
+PacketReplay::~PacketReplay() { this->close(); }
+
+bool PacketReplay::open(const std::string &path) {
+  this->close();
+
+  this->fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (this->fd < 0) {
+    LOG(ERROR) << "Could not open capture " << path << ": " << std::strerror(errno);
+    return false;
+  }
+  this->path = path;
+
+  struct stat st;
+  fstat(this->fd, &st);
+  this->file_size = st.st_size;
+
+  pcap_format::FileHeader header;
+  if (pread(this->fd, &header, sizeof(header), 0) != sizeof(header) ||
+      std::memcmp(header.magic, PCAP_MAGIC, sizeof(header.magic)) != 0) {
+    LOG(ERROR) << path << " is not a packet capture file";
+    this->close();
+    return false;
+  }
+
+  if (!this->load_index()) {
+    LOG(WARNING) << "Capture " << path << " has no valid index (not closed cleanly?); rebuilding";
+    this->rebuild_index();
+  }
+
+  LOG(INFO) << "Opened capture " << path << " with " << this->index.size() << " packets";
+  return true;
+}
+
+void PacketReplay::close() {
+  this->stop();
+  if (this->fd >= 0) {
+    ::close(this->fd);
+  }
+  this->fd = -1;
+  this->index.clear();
+  this->file_size = 0;
+}
+
+bool PacketReplay::load_index() {
+  pcap_format::Trailer trailer;
+  if (this->file_size < sizeof(pcap_format::FileHeader) + sizeof(trailer)) {
+    return false;
+  }
+  if (pread(this->fd, &trailer, sizeof(trailer), this->file_size - sizeof(trailer)) !=
+          sizeof(trailer) ||
+      std::memcmp(trailer.magic, PCAP_INDEX_MAGIC, sizeof(trailer.magic)) != 0) {
+    return false;
+  }
+
+  uint64_t index_bytes = trailer.num_packets * sizeof(pcap_format::IndexEntry);
+  if (trailer.index_offset + index_bytes + sizeof(trailer) != this->file_size) {
+    return false;
+  }
+
+  this->index.resize(trailer.num_packets);
+  if (pread(this->fd, this->index.data(), index_bytes, trailer.index_offset) !=
+      (ssize_t)index_bytes) {
+    this->index.clear();
+    return false;
+  }
+  return true;
+}
+
+bool PacketReplay::rebuild_index() {
+  this->index.clear();
+
+  uint64_t offset = sizeof(pcap_format::FileHeader);
+  pcap_format::RecordHeader rec;
+  while (offset + sizeof(rec) <= this->file_size) {
+    if (pread(this->fd, &rec, sizeof(rec), offset) != sizeof(rec)) {
+      break;
+    }
+    if (rec.length > PCAP_MAX_LENGTH || offset + sizeof(rec) + rec.length > this->file_size) {
+      // truncated tail of an interrupted capture
+      break;
+    }
+    this->index.push_back({rec.arrival_nsec, offset, rec.length});
+    offset += sizeof(rec) + rec.length;
+  }
+  return !this->index.empty();
+}
+
+int64_t PacketReplay::get_start_time_nsec() {
+  return this->index.empty() ? -1 : this->index.front().arrival_nsec;
+}
+
+int64_t PacketReplay::get_end_time_nsec() {
+  return this->index.empty() ? -1 : this->index.back().arrival_nsec;
+}
+
+size_t PacketReplay::find(int64_t arrival_nsec) {
+  auto it = std::lower_bound(this->index.begin(), this->index.end(), arrival_nsec,
+                             [](const pcap_format::IndexEntry &entry, int64_t t) {
+                               return entry.arrival_nsec < t;
+                             });
+  return it - this->index.begin();
+}
+
+bool PacketReplay::read(size_t idx, std::vector<int8_t> &msg, int64_t &arrival_nsec) {
+  if (idx >= this->index.size()) {
+    return false;
+  }
+  const pcap_format::IndexEntry &entry = this->index.at(idx);
+  msg.resize(entry.length);
+  ssize_t res = pread(this->fd, msg.data(), entry.length,
+                      entry.offset + sizeof(pcap_format::RecordHeader));
+  if (res != (ssize_t)entry.length) {
+    LOG(WARNING) << "Short read of packet " << idx << " from " << this->path;
+    return false;
+  }
+  arrival_nsec = entry.arrival_nsec;
+  return true;
+}
+
+size_t PacketReplay::replay(UdpSocketIn &socket, REPLAY_PACING pacing, double speed, size_t first,
+                            size_t last) {
+  this->keep_alive = true;
+  return this->replay_range(socket, pacing, speed, first, last);
+}
+
+size_t PacketReplay::replay_range(UdpSocketIn &socket, REPLAY_PACING pacing, double speed,
+                                  size_t first, size_t last) {
+  last = std::min(last, this->index.size());
+
+  std::vector<int8_t> msg;
+  int64_t arrival_nsec;
+  size_t count = 0;
+
+  auto t_start = std::chrono::steady_clock::now();
+  int64_t t0_nsec = first < last ? this->index.at(first).arrival_nsec : 0;
+  speed = speed > 0 ? speed : 1.0;
+
+  for (size_t ii = first; ii < last && this->keep_alive; ii++) {
+    if (!this->read(ii, msg, arrival_nsec)) {
+      continue;
+    }
+    if (pacing == REPLAY_PACING::REALTIME) {
+      // schedule against the replay start, so per-packet sleep jitter does not accumulate
+      auto offset = std::chrono::nanoseconds((int64_t)((arrival_nsec - t0_nsec) / speed));
+      std::this_thread::sleep_until(t_start + offset);
+    }
+    socket.dispatch(msg);
+    count++;
+    this->num_replayed++;
+  }
+
+  if (FLAGS_debug_packet_capture) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t_start;
+    VLOG(3) << "Replayed " << count << " packets from " << this->path << " in " << elapsed.count()
+            << " s";
+  }
+  return count;
+}
+
+void PacketReplay::run(UdpSocketIn &socket, REPLAY_PACING pacing, double speed, bool loop) {
+  this->stop();
+  this->target = &socket;
+  this->pacing = pacing;
+  this->speed = speed;
+  this->loop = loop;
+  this->num_replayed = 0;
+
+  this->keep_alive = true;
+  this->_is_running = true;
+  pthread_create(&this->own_thread, NULL, _run_replay_thread, this);
+  this->thread_started = true;
+}
+
+void PacketReplay::stop() {
+  this->keep_alive = false;
+  if (this->thread_started) {
+    pthread_join(this->own_thread, NULL);
+    this->thread_started = false;
+  }
+}
+
+void *PacketReplay::_run_replay_thread(void *ptr) {
+  PacketReplay *argPtr = static_cast<PacketReplay *>(ptr);
+  argPtr->run_replay_thread();
+  pthread_exit(NULL);
+}
+
+void PacketReplay::run_replay_thread() {
+  prctl(PR_SET_NAME, "ac_replay");
+  VLOG(3) << "Starting replay of " << this->path << " in thread " << pthread_self();
+
+  do {
+    this->replay_range(*this->target, this->pacing, this->speed, 0, SIZE_MAX);
+  } while (this->loop && this->keep_alive && !this->index.empty());
+
+  this->_is_running = false;
+  VLOG(3) << "Replay of " << this->path << " finished";
+}
@@ -0,0 +1,147 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: PacketCapture.h                                        */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef packet_capture_HEADER
+#define packet_capture_HEADER
+
+#include <atomic>
+#include <cstdint>
+#include <gflags/gflags.h>
+#include <mutex>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+// includes from within project
+#include "utils/AsyncFileWriter.h"
+
+DECLARE_bool(debug_packet_capture);
+
+struct UdpSocketIn;
+
+// Capture file layout (little endian, packed):
+//
+//   FileHeader                      magic "ACPCAP01", version
+//   { RecordHeader, payload } * N   arrival time (host epoch ns), datagram length, raw bytes
+//   IndexEntry * N                  arrival time, record offset, datagram length
+//   Trailer                         index offset, N, magic "ACPCIDX1"
+//
+// The index and trailer are written on close. A capture that was never closed cleanly
+// (power loss, crash) is still readable; the reader rebuilds the index by walking the
+// records from the start of the file.
+namespace pcap_format {
+struct __attribute__((__packed__)) FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+struct __attribute__((__packed__)) RecordHeader {
+  int64_t arrival_nsec;
+  uint32_t length;
+};
+struct __attribute__((__packed__)) IndexEntry {
+  int64_t arrival_nsec;
+  uint64_t offset;
+  uint32_t length;
+};
+struct __attribute__((__packed__)) Trailer {
+  uint64_t index_offset;
+  uint64_t num_packets;
+  char magic[8];
+};
+} // namespace pcap_format
+
+enum class REPLAY_PACING { AS_FAST_AS_POSSIBLE, REALTIME };
+
+// Appends raw datagrams to a capture file through the write-behind file writer.
+// record() is called from the socket thread only; open() / close() may come from another
+// thread, and all file access is serialized on m_mutex.
+class PacketRecorder {
+public:
+  PacketRecorder() : ofil(1 << 20, 3) {}
+  ~PacketRecorder() { this->close(); }
+
+  bool open(const std::string &path);
+  void close();
+  bool is_open() {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    return this->ofil.is_open();
+  }
+  std::string get_path() { return this->path; }
+
+  void record(const int8_t *data, size_t len, int64_t arrival_nsec);
+
+  uint64_t get_num_packets();
+  WriterStats get_writer_stats() { return this->ofil.get_stats(); }
+
+protected:
+  AsyncFileWriter ofil;
+  std::string path;
+  uint64_t offset = 0;
+  std::vector<pcap_format::IndexEntry> index;
+  std::mutex m_mutex;
+};
+
+// Reads a capture file and feeds its datagrams back through UdpSocketIn::dispatch(),
+// i.e. the same decode and queue fan-out path as live traffic.
+class PacketReplay {
+public:
+  PacketReplay() {}
+  ~PacketReplay();
+
+  bool open(const std::string &path);
+  void close();
+  bool is_open() { return this->fd >= 0; }
+
+  size_t size() { return this->index.size(); }
+  int64_t get_start_time_nsec();
+  int64_t get_end_time_nsec();
+  // Index of the first packet that arrived at or after `arrival_nsec`
+  size_t find(int64_t arrival_nsec);
+  // Raw datagram `idx`; false if out of range or unreadable
+  bool read(size_t idx, std::vector<int8_t> &msg, int64_t &arrival_nsec);
+
+  // Replay packets [first, last) into `socket` in the calling thread. REALTIME reproduces
+  // the recorded inter-arrival gaps (scaled by 1/speed); returns the number dispatched.
+  size_t replay(UdpSocketIn &socket, REPLAY_PACING pacing = REPLAY_PACING::AS_FAST_AS_POSSIBLE,
+                double speed = 1.0, size_t first = 0, size_t last = SIZE_MAX);
+
+  // Same as replay(), but in a separate thread; `socket` must outlive the replay
+  void run(UdpSocketIn &socket, REPLAY_PACING pacing = REPLAY_PACING::AS_FAST_AS_POSSIBLE,
+           double speed = 1.0, bool loop = false);
+  void stop();
+  bool is_running() { return this->_is_running; }
+  size_t get_num_replayed() { return this->num_replayed; }
+
+protected:
+  bool load_index();
+  bool rebuild_index();
+  size_t replay_range(UdpSocketIn &socket, REPLAY_PACING pacing, double speed, size_t first,
+                      size_t last);
+
+  static void *_run_replay_thread(void *ptr);
+  void run_replay_thread();
+
+  int fd = -1;
+  std::string path;
+  uint64_t file_size = 0;
+  std::vector<pcap_format::IndexEntry> index;
+
+  pthread_t own_thread;
+  std::atomic<bool> keep_alive{false};
+  std::atomic<bool> _is_running{false};
+  bool thread_started = false;
+  UdpSocketIn *target = nullptr;
+  REPLAY_PACING pacing = REPLAY_PACING::AS_FAST_AS_POSSIBLE;
+  double speed = 1.0;
+  bool loop = false;
+  std::atomic<size_t> num_replayed{0};
+};
+
+#endif
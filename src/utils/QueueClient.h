@@ -10,12 +10,16 @@
 #ifndef queue_client_HEADER
 #define queue_client_HEADER
 
+#include <chrono>
+#include <sstream>
 #include <sys/prctl.h>
 
 #include "utils/Types.h"
 
+#include "ipc_protocols/IpcDetectionEvent.h"
 #include "ipc_protocols/IpcDetector.h"
 #include "ipc_protocols/IpcFFT.h"
+#include "ipc_protocols/IpcPSD.h"
 
 #include "udp_protocols/UdpAcousticData.h"
 #include "udp_protocols/UdpBeamform2D.h"
@@ -27,6 +31,7 @@
 #include "udp_protocols/UdpPtsData.h"
 #include "udp_protocols/UdpRtcData.h"
 
+#include "utils/QueueRegistry.h"
 #include "utils/thread_safe_queue.h"
 
 template <typename T> using tsQ_T = tsQueue<std::shared_ptr<T>>;
@@ -47,8 +52,10 @@ struct QueueClient {
   ptr_tsQ<UdpBnrData> q_bnr;
 
   ptr_tsQ<IpcFFT> q_fft;
+  ptr_tsQ<IpcPSD> q_psd;
 
   ptr_tsQ<IpcDetector> q_detect;
+  ptr_tsQ<IpcDetectionEvent> q_event;
 
   std::unordered_map<QUEUE, std::shared_ptr<tsQueueBase>> queue;
 
@@ -66,10 +73,14 @@ struct QueueClient {
     this->q_bnr = std::make_shared<tsQ_T<UdpBnrData>>();
 
     this->q_fft = std::make_shared<tsQ_T<IpcFFT>>();
+    this->q_psd = std::make_shared<tsQ_T<IpcPSD>>();
 
     this->q_detect = std::make_shared<tsQ_T<IpcDetector>>();
+    this->q_event = std::make_shared<tsQ_T<IpcDetectionEvent>>();
 
     this->queue[QUEUE::ACO] = this->q_aco;
+    this->queue[QUEUE::CBF] = this->q_beam2d;
+    this->queue[QUEUE::CBF_RAW] = this->q_beamraw;
     this->queue[QUEUE::PTS] = this->q_pts;
     this->queue[QUEUE::IMU] = this->q_imu;
     this->queue[QUEUE::EPT] = this->q_ept;
@@ -104,11 +115,67 @@ struct QueueClient {
   virtual bool is_running() { return this->_is_running; }
   std::string get_name() { return this->thread_name; }
 
+  // Queues owned by this client, by short name; clients with extra queues append theirs
+  virtual std::vector<std::pair<std::string, std::shared_ptr<tsQueueBase>>> named_queues() {
+    return {{"aco", this->q_aco}, {"beam2d", this->q_beam2d}, {"beamraw", this->q_beamraw},
+            {"pts", this->q_pts}, {"imu", this->q_imu},       {"ept", this->q_ept},
+            {"rtc", this->q_rtc}, {"bno", this->q_bno},       {"bnr", this->q_bnr},
+            {"fft", this->q_fft}, {"psd", this->q_psd},       {"detect", this->q_detect},
+            {"event", this->q_event}};
+  }
+
+  // Name the queues "<thread_name>.<queue>" and add them to the QueueRegistry
+  void register_queues() {
+    for (auto &named : this->named_queues()) {
+      QueueRegistry::instance().add(named.second, this->thread_name + "." + named.first);
+    }
+  }
+
+  std::vector<QueueStats> get_queue_stats() {
+    std::vector<QueueStats> out;
+    for (auto &named : this->named_queues()) {
+      out.push_back(named.second->get_stats());
+      out.back().name = named.first;
+    }
+    return out;
+  }
+
+  // One line covering the queues that have seen any traffic
+  std::string queue_health() {
+    std::ostringstream oss;
+    oss << this->thread_name << " queues:";
+    bool idle = true;
+    for (auto &stats : this->get_queue_stats()) {
+      if (stats.pushes > 0 || stats.depth > 0) {
+        oss << " [" << stats << "]";
+        idle = false;
+      }
+    }
+    if (idle)
+      oss << " idle";
+    return oss.str();
+  }
+
+  // Log queue_health() every --queue_health_sec; meant to be called from the thread loop
+  void log_queue_health() {
+    if (FLAGS_queue_health_sec <= 0)
+      return;
+    auto now = std::chrono::steady_clock::now();
+    if (this->last_health_log == std::chrono::steady_clock::time_point()) {
+      this->last_health_log = now;
+    } else if (now - this->last_health_log >= std::chrono::seconds(FLAGS_queue_health_sec)) {
+      LOG(INFO) << this->queue_health();
+      this->last_health_log = now;
+    }
+  }
+
 protected:
   pthread_t own_thread;
   bool keep_alive;
   bool _is_running;
   std::string thread_name;
+
+  std::chrono::steady_clock::time_point last_health_log;
 };
 
 #endif
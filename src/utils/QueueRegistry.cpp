@@ -0,0 +1,73 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: QueueRegistry.cpp                                      */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <sstream>
+
+// includes from within project
+#include "utils/QueueRegistry.h"
+
+DEFINE_int32(queue_health_sec, 60,
+             "Period of the one-line queue health log from each processing thread; 0 disables");
+
+QueueRegistry &QueueRegistry::instance() {
+  static QueueRegistry registry;
+  return registry;
+}
+
+void QueueRegistry::add(std::shared_ptr<tsQueueBase> queue, std::string name) {
+  if (queue == nullptr)
+    return;
+  queue->set_name(name);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (auto &weak : this->queues) {
+    if (weak.lock() == queue)
+      return;
+  }
+  this->queues.push_back(queue);
+}
+
+std::vector<std::shared_ptr<tsQueueBase>> QueueRegistry::get_queues() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->queues.erase(std::remove_if(this->queues.begin(), this->queues.end(),
+                                    [](const std::weak_ptr<tsQueueBase> &weak) {
+                                      return weak.expired();
+                                    }),
+                     this->queues.end());
+
+  std::vector<std::shared_ptr<tsQueueBase>> out;
+  for (auto &weak : this->queues) {
+    if (auto queue = weak.lock())
+      out.push_back(queue);
+  }
+  return out;
+}
+
+std::vector<QueueStats> QueueRegistry::snapshot() {
+  std::vector<QueueStats> out;
+  for (auto &queue : this->get_queues()) {
+    out.push_back(queue->get_stats());
+  }
+  return out;
+}
+
+std::string QueueRegistry::summary() {
+  std::ostringstream oss;
+  for (auto &stats : this->snapshot()) {
+    oss << stats << std::endl;
+  }
+  return oss.str();
+}
+
+void QueueRegistry::reset_stats() {
+  for (auto &queue : this->get_queues()) {
+    queue->reset_stats();
+  }
+}
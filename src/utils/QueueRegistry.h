@@ -0,0 +1,45 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: QueueRegistry.h                                        */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef queue_registry_HEADER
+#define queue_registry_HEADER
+
+#include <gflags/gflags.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// includes from within project
+#include "utils/thread_safe_queue.h"
+
+DECLARE_int32(queue_health_sec);
+
+// Process-wide list of named queues, for health summaries and the Python snapshot API.
+// Only weak references are held; queues that have been destroyed are pruned on access.
+class QueueRegistry {
+public:
+  static QueueRegistry &instance();
+
+  // Name the queue and add it (once) to the registry
+  void add(std::shared_ptr<tsQueueBase> queue, std::string name);
+  std::vector<QueueStats> snapshot();
+  // One line per queue
+  std::string summary();
+  void reset_stats();
+
+protected:
+  QueueRegistry() {}
+  std::vector<std::shared_ptr<tsQueueBase>> get_queues();
+
+  std::mutex mutex;
+  std::vector<std::weak_ptr<tsQueueBase>> queues;
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: SteeringCache.cpp                                      */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <cstring>
+#include <glog/logging.h>
+
+// includes from within project
+#include "utils/SteeringCache.h"
+
+DEFINE_int32(steering_cache_entries, 16, "Steering tensors kept by the process-wide cache");
+
+namespace {
+// FNV-1a over the raw bytes
+void hash_bytes(uint64_t &h, const void *data, size_t len) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  for (size_t ii = 0; ii < len; ii++) {
+    h ^= bytes[ii];
+    h *= 1099511628211ULL;
+  }
+}
+
+void hash_vector(uint64_t &h, const Eigen::VectorXd &v) {
+  Eigen::Index n = v.size();
+  hash_bytes(h, &n, sizeof(n));
+  hash_bytes(h, v.data(), n * sizeof(double));
+}
+
+bool same(const Eigen::VectorXd &a, const Eigen::VectorXd &b) {
+  return a.size() == b.size() &&
+         (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+}
+} // namespace
+
+SteeringGrid::SteeringGrid(const UdpBeamform2D::Payload &d, double sound_speed)
+    : array_x(d.array_x), array_y(d.array_y), array_z(d.array_z), frequencies(d.frequencies),
+      bearings_rad(d.bearings_rad), elevations_rad(d.elevations_rad), sound_speed(sound_speed) {}
+
+uint64_t SteeringGrid::hash() const {
+  uint64_t h = 14695981039346656037ULL;
+  hash_vector(h, this->array_x);
+  hash_vector(h, this->array_y);
+  hash_vector(h, this->array_z);
+  hash_vector(h, this->frequencies);
+  hash_vector(h, this->bearings_rad);
+  hash_vector(h, this->elevations_rad);
+  hash_bytes(h, &this->sound_speed, sizeof(this->sound_speed));
+  return h;
+}
+
+bool SteeringGrid::matches(const UdpBeamform2D::Payload &d, double sound_speed) const {
+  return this->sound_speed == sound_speed && same(this->array_x, d.array_x) &&
+         same(this->array_y, d.array_y) && same(this->array_z, d.array_z) &&
+         same(this->frequencies, d.frequencies) && same(this->bearings_rad, d.bearings_rad) &&
+         same(this->elevations_rad, d.elevations_rad);
+}
+
+bool SteeringGrid::operator==(const SteeringGrid &other) const {
+  return this->sound_speed == other.sound_speed && same(this->array_x, other.array_x) &&
+         same(this->array_y, other.array_y) && same(this->array_z, other.array_z) &&
+         same(this->frequencies, other.frequencies) &&
+         same(this->bearings_rad, other.bearings_rad) &&
+         same(this->elevations_rad, other.elevations_rad);
+}
+
+SteeringTensor::SteeringTensor(const SteeringGrid &grid) : grid(grid), hash(grid.hash()) {
+  Eigen::Index num_bearings = grid.bearings_rad.size();
+  this->num_elements = grid.array_x.size();
+  this->num_beams = num_bearings * grid.elevations_rad.size();
+  this->num_frequencies = grid.frequencies.size();
+
+  // look directions, one row per beam
+  Eigen::MatrixXd look(this->num_beams, 3);
+  for (Eigen::Index iel = 0; iel < grid.elevations_rad.size(); iel++) {
+    double el = grid.elevations_rad[iel];
+    for (Eigen::Index ibrg = 0; ibrg < num_bearings; ibrg++) {
+      double brg = grid.bearings_rad[ibrg];
+      look.row(iel * num_bearings + ibrg) << std::cos(el) * std::cos(brg),
+          std::cos(el) * std::sin(brg), std::sin(el);
+    }
+  }
+  Eigen::MatrixXd coords(this->num_elements, 3);
+  coords << grid.array_x, grid.array_y, grid.array_z;
+  // path advance of each element towards each look direction, in m
+  Eigen::ArrayXXd advance = look * coords.transpose();
+
+  this->data.resize(this->num_beams, this->num_elements * this->num_frequencies);
+  for (Eigen::Index kk = 0; kk < this->num_frequencies; kk++) {
+    Eigen::ArrayXXd phase = (-2 * M_PI * grid.frequencies[kk] / grid.sound_speed) * advance;
+    auto block = this->data.middleCols(kk * this->num_elements, this->num_elements);
+    block.real() = phase.cos();
+    block.imag() = phase.sin();
+  }
+}
+
+SteeringCache &SteeringCache::instance() {
+  static SteeringCache cache;
+  return cache;
+}
+
+std::shared_ptr<const SteeringTensor> SteeringCache::find(uint64_t h, const SteeringGrid &grid) {
+  auto range = this->entries.equal_range(h);
+  for (auto it = range.first; it != range.second; it++) {
+    if (it->second.tensor->grid == grid) {
+      it->second.last_use = ++this->use_count;
+      this->hits++;
+      return it->second.tensor;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const SteeringTensor> SteeringCache::get(const SteeringGrid &grid) {
+  uint64_t h = grid.hash();
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto tensor = this->find(h, grid);
+    if (tensor != nullptr)
+      return tensor;
+  }
+
+  // build outside the lock; of concurrent builds of one grid, the first one in is kept
+  auto built = std::make_shared<const SteeringTensor>(grid);
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto tensor = this->find(h, grid);
+  if (tensor != nullptr)
+    return tensor;
+  this->misses++;
+  this->entries.emplace(h, Entry{built, ++this->use_count});
+  this->evict();
+  VLOG(3) << "SteeringCache :: " << built->num_beams << " beams x " << built->num_elements
+          << " elements x " << built->num_frequencies << " frequencies ("
+          << this->entries.size() << " entries)";
+  return built;
+}
+
+bool SteeringCache::refresh(std::shared_ptr<const SteeringTensor> &current,
+                            const UdpBeamform2D::Payload &d, double sound_speed) {
+  if (current != nullptr && current->grid.matches(d, sound_speed))
+    return false;
+  current = this->get(SteeringGrid(d, sound_speed));
+  return true;
+}
+
+void SteeringCache::evict() {
+  size_t max_entries = std::max(FLAGS_steering_cache_entries, 1);
+  while (this->entries.size() > max_entries) {
+    auto oldest = this->entries.begin();
+    for (auto it = this->entries.begin(); it != this->entries.end(); it++) {
+      if (it->second.last_use < oldest->second.last_use)
+        oldest = it;
+    }
+    this->entries.erase(oldest);
+  }
+}
+
+size_t SteeringCache::size() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->entries.size();
+}
+
+void SteeringCache::clear() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->entries.clear();
+  this->hits = 0;
+  this->misses = 0;
+}
+
+uint64_t SteeringCache::get_hits() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->hits;
+}
+
+uint64_t SteeringCache::get_misses() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->misses;
+}
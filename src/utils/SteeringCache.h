@@ -0,0 +1,103 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: SteeringCache.h                                        */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef steering_cache_HEADER
+#define steering_cache_HEADER
+
+#include <Eigen/Dense>
+#include <gflags/gflags.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// includes from within project
+#include "udp_protocols/UdpBeamform2D.h"
+
+DECLARE_int32(steering_cache_entries);
+
+// What a set of steering vectors depends on: element coordinates (m), frequencies (Hz),
+// look directions (rad) and sound speed (m/s). Element weights and masks are not part of
+// it; consumers apply them to the snapshots.
+struct SteeringGrid {
+  Eigen::VectorXd array_x;
+  Eigen::VectorXd array_y;
+  Eigen::VectorXd array_z;
+  Eigen::VectorXd frequencies;
+  Eigen::VectorXd bearings_rad;
+  Eigen::VectorXd elevations_rad;
+  double sound_speed = 1500;
+
+  SteeringGrid() {}
+  SteeringGrid(const UdpBeamform2D::Payload &d, double sound_speed);
+
+  uint64_t hash() const;
+  // same geometry and grid as the payload (no copies, no hashing)
+  bool matches(const UdpBeamform2D::Payload &d, double sound_speed) const;
+  bool operator==(const SteeringGrid &other) const;
+};
+
+// Conjugated steering vectors of every look direction, for every frequency, in one
+// contiguous buffer: frequency kk is the (num_beams x num_elements) column-major block
+// at data() + kk * num_beams * num_elements, so that beams = frequency(kk) * snapshots.
+// Row iel * num_bearings + ibrg holds a^H, a = exp(j 2 pi f (r . u) / c) the response to
+// a plane wave from u = (cos(el) cos(brg), cos(el) sin(brg), sin(el)).
+struct SteeringTensor {
+  SteeringGrid grid;
+  uint64_t hash;
+  Eigen::Index num_beams;
+  Eigen::Index num_elements;
+  Eigen::Index num_frequencies;
+  Eigen::MatrixXcd data; // num_beams x (num_elements * num_frequencies)
+
+  SteeringTensor(const SteeringGrid &grid);
+  Eigen::Map<const Eigen::MatrixXcd> frequency(Eigen::Index kk) const {
+    return Eigen::Map<const Eigen::MatrixXcd>(this->data.data() + kk * this->num_beams *
+                                                                      this->num_elements,
+                                              this->num_beams, this->num_elements);
+  }
+};
+
+// Process-wide cache of steering tensors keyed by SteeringGrid::hash() (full grid compared
+// on lookup). Entries are immutable and shared between threads; a tensor stays valid for
+// as long as a consumer holds it, even once evicted. At most --steering_cache_entries are
+// kept, least recently used first out.
+class SteeringCache {
+public:
+  static SteeringCache &instance();
+
+  std::shared_ptr<const SteeringTensor> get(const SteeringGrid &grid);
+  // Keep current while incoming headers carry its geometry and grid; look up otherwise.
+  // Returns true when current was replaced.
+  bool refresh(std::shared_ptr<const SteeringTensor> &current, const UdpBeamform2D::Payload &d,
+               double sound_speed);
+
+  size_t size();
+  // drops the entries and zeroes the hit / miss counts
+  void clear();
+  uint64_t get_hits();
+  uint64_t get_misses();
+
+protected:
+  SteeringCache() {}
+  // with the mutex held
+  std::shared_ptr<const SteeringTensor> find(uint64_t h, const SteeringGrid &grid);
+  void evict();
+
+  struct Entry {
+    std::shared_ptr<const SteeringTensor> tensor;
+    uint64_t last_use;
+  };
+  std::mutex mutex;
+  std::unordered_multimap<uint64_t, Entry> entries;
+  uint64_t use_count = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+#endif
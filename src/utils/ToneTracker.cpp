@@ -0,0 +1,269 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: ToneTracker.cpp                                        */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <glog/logging.h>
+#include <thread>
+
+// includes from within project
+#include "utils/ToneTracker.h"
+
+DEFINE_bool(debug_tone_tracker, false, "Enable expanded debug for ToneTracker");
+
+void ToneTracker::initialize(const UdpAcousticData &aco_pkt) {
+  this->num_channels = aco_pkt.data.rows();
+
+  // aco_pkt.header.sample_rate is a float; make sure we cast
+  if (this->sample_rate != (double)aco_pkt.header.sample_rate) {
+    this->sample_rate = (double)aco_pkt.header.sample_rate;
+    LOG(INFO) << this->thread_name << " :: Sampling rate initialized: " << this->sample_rate
+              << " Hz";
+    this->recompute_frequencies();
+  }
+  this->_rx_runtime_update = false;
+  this->bins = this->active_frequencies;
+  if (this->bins.empty())
+    LOG(WARNING) << this->thread_name << " :: No active frequency bins; no frames will be emitted";
+
+  size_t N = this->NFFT;
+  this->ring = Eigen::MatrixXd::Zero(this->num_channels, N);
+  this->ring_times = Eigen::Matrix<int64_t, Eigen::Dynamic, 1>::Zero(N);
+  this->ring_pos = 0;
+  this->num_samples = 0;
+
+  // Same PSD scaling as FFT::update_window
+  this->win = get_hann(1, N).row(0).transpose();
+  this->win *= std::sqrt(2 / (this->sample_rate * this->win.square().sum()));
+  this->coeff.resize(this->bins.size());
+  for (size_t ii = 0; ii < this->bins.size(); ii++) {
+    this->coeff[ii] = 2 * std::cos(2 * M_PI * this->bins[ii] / N);
+  }
+
+  // A bin's Hann-windowed value needs its neighbours; track each once, folded into
+  // [0, N/2] (X[-m] = X[N-m] = conj(X[m]) for real input). DC is never needed: the
+  // mean is removed, so it is zero.
+  this->sdft_bins.clear();
+  for (int bin : this->bins) {
+    for (int m : {bin - 1, bin, bin + 1}) {
+      m = std::abs(m);
+      m = m > (int)N / 2 ? N - m : m;
+      if (m > 0)
+        this->sdft_bins.push_back(m);
+    }
+  }
+  std::sort(this->sdft_bins.begin(), this->sdft_bins.end());
+  this->sdft_bins.erase(std::unique(this->sdft_bins.begin(), this->sdft_bins.end()),
+                        this->sdft_bins.end());
+  this->twiddle.resize(this->sdft_bins.size());
+  for (size_t ii = 0; ii < this->sdft_bins.size(); ii++) {
+    this->twiddle[ii] = std::polar(1.0, 2 * M_PI * this->sdft_bins[ii] / N);
+  }
+  this->sdft = Eigen::MatrixXcd::Zero(this->num_channels, this->sdft_bins.size());
+  // periodic Hann: sum(w^2) = 3N/8
+  this->sdft_scale = std::sqrt(2 / (this->sample_rate * 3.0 * N / 8));
+  this->_delta.resize(this->num_channels);
+  this->_lo.resize(this->num_channels);
+  this->_mid.resize(this->num_channels);
+  this->_hi.resize(this->num_channels);
+
+  if (FLAGS_debug_tone_tracker)
+    VLOG(3) << this->thread_name << " :: Tracking " << this->bins.size() << " bins ("
+            << this->sdft_bins.size() << " sliding DFT bins) on " << this->num_channels
+            << " channels";
+  this->initialized = true;
+}
+
+void ToneTracker::push_sample(const Eigen::VectorXd &x, int64_t t_nsec) {
+  if (this->method == TONE_METHOD::SLIDING_DFT && this->sdft.cols() > 0) {
+    // X_k <- e^{j 2 pi k / N} (X_k + x[n] - x[n-N])
+    // coefficient-wise, in place: no temporaries per sample
+    this->_delta = (x - this->ring.col(this->ring_pos)).cast<std::complex<double>>();
+    this->sdft.colwise() += this->_delta;
+    this->sdft.array().rowwise() *= this->twiddle.transpose();
+  }
+  this->ring.col(this->ring_pos) = x;
+  this->ring_times[this->ring_pos] = t_nsec;
+  this->ring_pos = (this->ring_pos + 1) % this->NFFT;
+  this->num_samples++;
+}
+
+void ToneTracker::goertzel(Eigen::MatrixXcd &out) {
+  size_t N = this->NFFT;
+  // oldest sample first, then detrend by mean & window, as in FFT::compute_frame
+  this->_frame.resize(this->num_channels, N);
+  this->_frame.leftCols(N - this->ring_pos) = this->ring.rightCols(N - this->ring_pos);
+  this->_frame.rightCols(this->ring_pos) = this->ring.leftCols(this->ring_pos);
+  this->_frame.colwise() -= this->_frame.rowwise().mean();
+  this->_frame.array().rowwise() *= this->win.transpose();
+
+  Eigen::ArrayXd s0(this->num_channels), s1(this->num_channels), s2(this->num_channels);
+  for (size_t ii = 0; ii < this->bins.size(); ii++) {
+    double c = this->coeff[ii];
+    s1.setZero();
+    s2.setZero();
+    for (size_t nn = 0; nn < N; nn++) {
+      s0 = this->_frame.col(nn).array() + c * s1 - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+    // one more (zero) input, then X_k = s[N] - e^{-j 2 pi k / N} s[N-1]
+    std::complex<double> w = std::polar(1.0, -2 * M_PI * this->bins[ii] / N);
+    s0 = c * s1 - s2;
+    out.col(ii) = s0.cast<std::complex<double>>() - w * s1.cast<std::complex<double>>();
+  }
+}
+
+void ToneTracker::sliding_dft(Eigen::MatrixXcd &out) {
+  int N = this->NFFT;
+  // X[m] of every channel into a scratch vector
+  auto tracked = [this, N](int m, Eigen::VectorXcd &dst) {
+    bool conj = m < 0 || m > N / 2;
+    m = std::abs(m);
+    m = m > N / 2 ? N - m : m;
+    if (m == 0) {
+      dst.setZero();
+      return;
+    }
+    size_t idx = std::lower_bound(this->sdft_bins.begin(), this->sdft_bins.end(), m) -
+                 this->sdft_bins.begin();
+    if (conj)
+      dst = this->sdft.col(idx).conjugate();
+    else
+      dst = this->sdft.col(idx);
+  };
+
+  // Hann in the frequency domain: 0.5 X[k] - 0.25 (X[k-1] + X[k+1])
+  for (size_t ii = 0; ii < this->bins.size(); ii++) {
+    int k = this->bins[ii];
+    tracked(k - 1, this->_lo);
+    tracked(k, this->_mid);
+    tracked(k + 1, this->_hi);
+    out.col(ii).noalias() = (0.5 * this->_mid - 0.25 * (this->_lo + this->_hi)) * this->sdft_scale;
+  }
+}
+
+std::vector<std::shared_ptr<IpcFFT>>
+ToneTracker::process(const std::vector<std::shared_ptr<UdpAcousticData>> &packets) {
+  std::vector<std::shared_ptr<IpcFFT>> frames;
+  double audio_scale = 1.0 / pow(2, 15) * this->adc_scale;
+  Eigen::VectorXd x;
+
+  for (auto &aco_pkt : packets) {
+    if (!this->initialized || this->_rx_runtime_update) {
+      this->initialize(*aco_pkt);
+    }
+    if ((size_t)aco_pkt->data.rows() != this->num_channels) {
+      LOG_EVERY_N(WARNING, 1000) << this->thread_name << " :: Dropping packet with "
+                                 << aco_pkt->data.rows() << " channels; expected "
+                                 << this->num_channels;
+      continue;
+    }
+    this->packet_fs = aco_pkt->header.sample_rate;
+    double dt_nsec = 1e9 / aco_pkt->header.sample_rate;
+
+    for (int icol = 0; icol < aco_pkt->data.cols(); icol++) {
+      x = aco_pkt->data.col(icol).cast<double>() * audio_scale;
+      this->push_sample(x, aco_pkt->header.start_time_nsec + (int64_t)(icol * dt_nsec));
+
+      if (this->num_samples < this->NFFT || (this->num_samples - this->NFFT) % this->nstep != 0 ||
+          this->bins.empty())
+        continue;
+
+      auto fft_frame = std::make_shared<IpcFFT>(this->num_channels, this->bins.size());
+      fft_frame->header.start_time_nsec = this->ring_times[this->ring_pos];
+      fft_frame->header.packet_num = this->packet_num;
+      this->packet_num =
+          this->packet_num == std::numeric_limits<int>::max() ? 0 : this->packet_num + 1;
+      fft_frame->FS = this->packet_fs;
+      fft_frame->bins = this->bins;
+      fft_frame->stage_times = aco_pkt->stage_times;
+
+      if (this->method == TONE_METHOD::SLIDING_DFT) {
+        this->sliding_dft(fft_frame->fft);
+      } else {
+        this->goertzel(fft_frame->fft);
+      }
+      frames.push_back(fft_frame);
+    }
+  }
+  return frames;
+}
+
+void ToneTracker::run_tone_thread() {
+  prctl(PR_SET_NAME, this->thread_name.substr(0, 15).c_str());
+  VLOG(3) << "Starting tone tracker in thread " << pthread_self();
+  this->_is_running = true;
+
+  std::vector<std::shared_ptr<UdpAcousticData>> new_packets;
+  std::vector<std::shared_ptr<IpcFFT>> frames;
+
+  while (this->keep_alive) {
+    if (this->q_aco->size() > 0) {
+      new_packets = this->q_aco->pop_limit(10);
+      for (auto &aco_pkt : new_packets) {
+        aco_pkt->stage_times.mark(STAGE::FFT_DEQUEUED);
+      }
+
+      auto t_start = std::chrono::steady_clock::now();
+      frames = this->process(new_packets);
+      this->processing_stats->add_busy(t_start);
+      this->processing_stats->items_in += new_packets.size();
+      this->processing_stats->items_out += frames.size();
+      for (auto &fft_frame : frames) {
+        for (auto q_fft : this->v_q_fft) {
+          q_fft->push(fft_frame);
+        }
+        fft_frame->stage_times.mark(STAGE::FFT_EMITTED);
+      }
+    }
+    this->log_queue_health();
+
+    std::this_thread::sleep_for(std::chrono::microseconds(1000));
+  }
+
+  this->_is_running = false;
+}
+
+void *ToneTracker::_run_tone_thread(void *ptr) {
+  ToneTracker *argPtr = static_cast<ToneTracker *>(ptr);
+  argPtr->run_tone_thread();
+  pthread_exit(NULL);
+}
+
+void ToneTracker::run() {
+  pthread_t thread;
+  this->keep_alive = true;
+  this->register_queues();
+  if (!this->is_running()) {
+    pthread_create(&thread, NULL, _run_tone_thread, this);
+    this->own_thread = thread;
+  } else {
+    LOG(WARNING) << "Tone tracker thread already running";
+  }
+}
+
+void ToneTracker::register_client(QueueClient &client) {
+  if (client.q_fft != nullptr) {
+    this->v_q_fft.push_back(client.q_fft);
+  } else {
+    LOG(WARNING) << "Cannot register FFT data queue; received nullptr!";
+  }
+}
+
+void ToneTracker::register_client(std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> q_fft) {
+  this->v_q_fft.push_back(q_fft);
+}
+
+void ToneTracker::set_method(TONE_METHOD method) {
+  this->method = method;
+  // the sliding DFT state is only kept up to date in its own mode; rebuild it
+  this->initialized = false;
+}
@@ -0,0 +1,98 @@
+/*******************************************************************/
+/*    NAME: Oscar Viquez                                           */
+/*    ORG:  Acbotics Research, LLC                                 */
+/*    FILE: ToneTracker.h                                          */
+/*    DATE: Oct 19th 2026                                          */
+/*                                                                 */
+/*    For help, contact us at: support@acbotics.com                */
+/*******************************************************************/
+
+#ifndef tone_tracker_HEADER
+#define tone_tracker_HEADER
+
+#include <Eigen/Dense>
+#include <pthread.h>
+
+// includes from within project
+#include "utils/FreqDomainBase.h"
+
+DECLARE_bool(debug_tone_tracker);
+
+// How the active bins are evaluated:
+//  GOERTZEL    : per hop, over the detrended + windowed NFFT samples; O(NFFT) per bin,
+//                same window and scaling as the FFT, so values match its bins
+//  SLIDING_DFT : recursive update of each bin (and its neighbours) every sample; O(1) per
+//                bin per sample. Hann is applied in the frequency domain, i.e. the periodic
+//                Hann window, so values differ from the FFT's by the window's end effects
+enum class TONE_METHOD { GOERTZEL, SLIDING_DFT };
+
+// Narrowband alternative to the FFT for a few bins (add_frequency_bin_closest /
+// add_frequency_band_*): emits IpcFFT frames with the same NFFT / nstep framing, holding
+// only the active bins (IpcFFT::bins lists them), so the EnergyDetector and other q_fft
+// clients can consume them unchanged.
+class ToneTracker : public FreqDomainBase {
+public:
+  std::vector<std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>>> v_q_fft;
+
+  ToneTracker() : FreqDomainBase() {
+    this->adc_scale = 2.5;
+    this->thread_name = "tone_thr";
+  };
+  static std::shared_ptr<ToneTracker> create() { return std::make_shared<ToneTracker>(); }
+
+  void run() override;
+  void register_client(QueueClient &client);
+  void register_client(std::shared_ptr<tsQueue<std::shared_ptr<IpcFFT>>> q_fft);
+  void set_adc_scale(double new_adc_scale) { this->adc_scale = new_adc_scale; }
+  void set_method(TONE_METHOD method);
+  TONE_METHOD get_method() { return this->method; }
+
+  std::shared_ptr<tsQueue<std::shared_ptr<UdpAcousticData>>> get_input_queue() {
+    return this->q_aco;
+  };
+
+  // Synchronous processing: return a frame every nstep samples once NFFT are buffered
+  std::vector<std::shared_ptr<IpcFFT>>
+  process(const std::vector<std::shared_ptr<UdpAcousticData>> &packets);
+  void reset() { this->initialized = false; }
+
+protected:
+  static void *_run_tone_thread(void *arg);
+  void run_tone_thread(void);
+  void initialize(const UdpAcousticData &aco_pkt);
+  void push_sample(const Eigen::VectorXd &x, int64_t t_nsec);
+  void goertzel(Eigen::MatrixXcd &out);
+  void sliding_dft(Eigen::MatrixXcd &out);
+
+  double adc_scale;
+  TONE_METHOD method = TONE_METHOD::GOERTZEL;
+
+  // processing state, owned by whichever thread calls process()
+  bool initialized = false;
+  size_t num_channels = 0;
+  int32_t packet_num = 0;
+  double packet_fs = -1;
+  std::vector<int> bins;
+
+  // last NFFT samples (num_channels x NFFT) and their times; ring_pos is the oldest
+  Eigen::MatrixXd ring;
+  Eigen::Matrix<int64_t, Eigen::Dynamic, 1> ring_times;
+  size_t ring_pos = 0;
+  size_t num_samples = 0;
+
+  // GOERTZEL : window with the FFT's PSD scaling built in, and 2cos(w) per bin
+  Eigen::ArrayXd win;
+  Eigen::ArrayXd coeff;
+  Eigen::MatrixXd _frame;
+
+  // SLIDING_DFT : unwindowed DFT of the ring at each tracked bin (bins and neighbours)
+  std::vector<int> sdft_bins;
+  Eigen::ArrayXcd twiddle;
+  Eigen::MatrixXcd sdft;
+  double sdft_scale = 0;
+  // per-sample / per-frame scratch (num_channels), sized in initialize()
+  Eigen::VectorXcd _delta;
+  Eigen::VectorXcd _lo, _mid, _hi;
+};
+
+#endif
@@ -12,20 +12,22 @@
 
 #include <unordered_map>
 #include <string>
-enum class QUEUE { UNKNOWN, ACO, FFT, CBF, GPS, PTS, IMU, EPT, RTC, BNO, BNR, DETECT };
+enum class QUEUE { UNKNOWN, ACO, FFT, CBF, GPS, PTS, IMU, EPT, RTC, BNO, BNR, DETECT, PSD, EVENT,
+                   CBF_RAW };
 
-enum class LOGGER { UNKNOWN, ACO_CSV, ACO_FLAC, ACO_WAV, GPS, PTS, IMU, EPT, RTC, BNO, BNR };
+enum class LOGGER { UNKNOWN, ACO_CSV, ACO_FLAC, ACO_WAV, GPS, PTS, IMU, EPT, RTC, BNO, BNR,
+                    BEAM2D, BEAMRAW };
 
 inline std::unordered_map<LOGGER, std::string> LOGGER_NAME{
     {LOGGER::ACO_CSV, "ACO_CSV"}, {LOGGER::ACO_FLAC, "ACO_FLAC"}, {LOGGER::ACO_WAV, "ACO_WAV"},
     {LOGGER::GPS, "GPS"},         {LOGGER::PTS, "PTS"},           {LOGGER::IMU, "IMU"},
     {LOGGER::EPT, "EPT"},         {LOGGER::RTC, "RTC"},           {LOGGER::BNO, "BNO"},
-    {LOGGER::BNR, "BNR"}};
+    {LOGGER::BNR, "BNR"},         {LOGGER::BEAM2D, "BEAM2D"},     {LOGGER::BEAMRAW, "BEAMRAW"}};
 
 inline std::unordered_map<LOGGER, QUEUE> LOGGER_QUEUE{
     {LOGGER::ACO_CSV, QUEUE::ACO}, {LOGGER::ACO_FLAC, QUEUE::ACO}, {LOGGER::ACO_WAV, QUEUE::ACO},
     {LOGGER::GPS, QUEUE::GPS},     {LOGGER::PTS, QUEUE::PTS},      {LOGGER::IMU, QUEUE::IMU},
     {LOGGER::EPT, QUEUE::EPT},     {LOGGER::RTC, QUEUE::RTC},      {LOGGER::BNO, QUEUE::BNO},
-    {LOGGER::BNR, QUEUE::BNR}};
+    {LOGGER::BNR, QUEUE::BNR},     {LOGGER::BEAM2D, QUEUE::CBF},   {LOGGER::BEAMRAW, QUEUE::CBF_RAW}};
 
 #endif
@@ -18,10 +18,38 @@
 #include <vector>
 #include <chrono>
 // includes from within project
+#include "utils/PacketCapture.h"
 #include "utils/UdpSocketIn.h"
 
 DEFINE_bool(debug_socket_in, false, "Enable expanded debug for UdpSocketIn");
 
+const char *msg_id_name(MSG_ID id) {
+  switch (id) {
+  case MSG_ID::ACB2:
+    return "ACB2";
+  case MSG_ID::ACBR:
+    return "ACBR";
+  case MSG_ID::ACBC:
+    return "ACBC";
+  case MSG_ID::ACO:
+    return "ACO";
+  case MSG_ID::PTS:
+    return "PTS";
+  case MSG_ID::IMU:
+    return "IMU";
+  case MSG_ID::EPT:
+    return "EPT";
+  case MSG_ID::RTC:
+    return "RTC";
+  case MSG_ID::BNO:
+    return "BNO";
+  case MSG_ID::BNR:
+    return "BNR";
+  default:
+    return "UNKNOWN";
+  }
+}
+
 void *UdpSocketIn::_run_socket_thread(void *ptr) {
 
   UdpSocketIn *argPtr = static_cast<UdpSocketIn *>(ptr);
@@ -47,9 +75,38 @@ void *UdpSocketIn::_run_socket_thread(void *ptr) {
   buff.resize(65535);
 
   ssize_t msg_len;
+  int64_t rx_nsec;
+  std::shared_ptr<PacketRecorder> recorder;
+
+  while (argPtr->keep_alive) {
+    msg_len = recv(argPtr->m_socket, buff.data(), 65535, 0);
+    if (msg_len <= 0) {
+      continue;
+    }
+    rx_nsec = LatencyTracker::is_enabled() ? LatencyTracker::now() : -1;
+
+    recorder = std::atomic_load(&argPtr->recorder);
+    if (recorder != nullptr) {
+      int64_t arrival_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch())
+                                 .count();
+      recorder->record(buff.data(), msg_len, arrival_nsec);
+    }
+
+    msg = std::vector<int8_t>(buff.begin(), buff.begin() + msg_len);
+    argPtr->dispatch(msg, rx_nsec);
+
+    if (FLAGS_debug_socket_in)
+      VLOG(2) << "Socket thread heartbeat : ID " << pthread_self();
+  }
+
+  argPtr->_is_running = false;
+  pthread_exit(NULL);
+}
+
+void UdpSocketIn::dispatch(std::vector<int8_t> &msg, int64_t rx_nsec) {
   std::shared_ptr<UdpAcousticData> aco_data;
   std::shared_ptr<UdpBeamform2D> beam_2d;
-  std::shared_ptr<UdpBeamformRaw> beam_raw_0;
   std::shared_ptr<UdpBeamformRaw> beam_raw_c;
   std::shared_ptr<UdpPtsData> pts_data;
   std::shared_ptr<UdpImuData> imu_data;
@@ -58,120 +115,131 @@ void *UdpSocketIn::_run_socket_thread(void *ptr) {
   std::shared_ptr<UdpBnoData> bno_data;
   std::shared_ptr<UdpBnrData> bnr_data;
 
-  while (argPtr->keep_alive) {
-    msg_len = recv(argPtr->m_socket, buff.data(), 65535, 0);
-    msg = std::vector<int8_t>(buff.begin(), buff.begin() + msg_len);
+  // datagrams handed in without an arrival time (e.g. replay) are stamped on entry
+  if (rx_nsec < 0 && LatencyTracker::is_enabled())
+    rx_nsec = LatencyTracker::now();
 
-    switch (check_msg_id(msg)) {
-    case MSG_ID::ACB2:
-      if (FLAGS_debug_socket_in)
-        VLOG(3) << "Received ACB2";
-      beam_2d = std::make_shared<UdpBeamform2D>(msg);
-
-      for (auto q_beam2d : argPtr->v_q_beam2d) {
-        q_beam2d->push(beam_2d);
-      }
-      break;
-    case MSG_ID::ACBR:
-      if (FLAGS_debug_socket_in)
-        VLOG(3) << "Received ACBR";
-      beam_raw_0 = std::make_shared<UdpBeamformRaw>(msg);
-      if (beam_raw_0->header.start_time_nsec >= 0)
-        for (auto q_beamraw : argPtr->v_q_beamraw) {
-          q_beamraw->push(beam_raw_0);
-        }
+  MSG_ID msg_id = check_msg_id(msg);
+  this->stats->count(msg_id, msg.size());
 
-      break;
-    case MSG_ID::ACBC:
-      if (FLAGS_debug_socket_in)
-        VLOG(3) << "Received ACBC";
-      beam_raw_c = std::make_shared<UdpBeamformRaw>(msg);
-      if (beam_raw_c->header.packet_num == beam_raw_0->header.packet_num) {
-        if (beam_raw_0->add_cont_packet(msg, beam_raw_c->header.num_subpackets)) {
-          // if primary packet is complete, add it to queue for downstream clients
-          for (auto q_beamraw : argPtr->v_q_beamraw) {
-            q_beamraw->push(beam_raw_0);
-          }
-        }
-      }
-      break;
-    case MSG_ID::ACO:
-      aco_data = std::make_shared<UdpAcousticData>(msg);
-      if (check_aco_data(*aco_data) == 0) {
-        if (FLAGS_debug_socket_in)
-          VLOG(3) << "Received AC; socket thread heartbeat" << " : ID " << pthread_self()
-                  << " : latest packet num : " << aco_data->header.packet_num;
-        for (auto q_aco : argPtr->v_q_aco) {
-          q_aco->push(aco_data);
-        }
-        for (auto out_queue: argPtr->v_out_queue)
-        {
-          out_queue->push(aco_data);
-        }
+  switch (msg_id) {
+  case MSG_ID::ACB2:
+    if (FLAGS_debug_socket_in)
+      VLOG(3) << "Received ACB2";
+    beam_2d = std::make_shared<UdpBeamform2D>(msg, this->beam_storage);
+    beam_2d->stage_times.mark(STAGE::RECEIVED, rx_nsec);
+    beam_2d->stage_times.mark(STAGE::PARSED);
 
+    for (auto q_beam2d : this->v_q_beam2d) {
+      q_beam2d->push(beam_2d);
+    }
+    beam_2d->stage_times.mark(STAGE::ENQUEUED);
+    break;
+  case MSG_ID::ACBR:
+    if (FLAGS_debug_socket_in)
+      VLOG(3) << "Received ACBR";
+    this->beam_raw_0 = std::make_shared<UdpBeamformRaw>(msg);
+    // multi-part series are pushed once their last ACBC continuation arrives
+    if (this->beam_raw_0->header.start_time_nsec >= 0 &&
+        this->beam_raw_0->header.num_subpackets <= 1)
+      for (auto q_beamraw : this->v_q_beamraw) {
+        q_beamraw->push(this->beam_raw_0);
       }
 
-      break;
-    case MSG_ID::PTS:
-      if (FLAGS_debug_socket_in)
-        VLOG(3) << "Received PTS";
-      pts_data = std::make_shared<UdpPtsData>(msg);
-      for (auto q_pts : argPtr->v_q_pts) {
-        q_pts->push(pts_data);
-      }
-      break;
-    case MSG_ID::IMU:
-      if (FLAGS_debug_socket_in)
-        VLOG(3) << "Received IMU";
-      imu_data = std::make_shared<UdpImuData>(msg);
-      for (auto q_imu : argPtr->v_q_imu) {
-        q_imu->push(imu_data);
+    break;
+  case MSG_ID::ACBC:
+    if (FLAGS_debug_socket_in)
+      VLOG(3) << "Received ACBC";
+    beam_raw_c = std::make_shared<UdpBeamformRaw>(msg);
+    // continuation packets that arrive before (or without) their primary packet are dropped
+    if (this->beam_raw_0 != nullptr &&
+        beam_raw_c->header.packet_num == this->beam_raw_0->header.packet_num) {
+      if (this->beam_raw_0->add_cont_packet(msg, beam_raw_c->header.num_subpackets)) {
+        // if primary packet is complete, add it to queue for downstream clients
+        for (auto q_beamraw : this->v_q_beamraw) {
+          q_beamraw->push(this->beam_raw_0);
+        }
       }
-      break;
-    case MSG_ID::BNO:
+    } else {
+      this->stats->rejected++;
+    }
+    break;
+  case MSG_ID::ACO:
+    aco_data = std::make_shared<UdpAcousticData>(msg);
+    if (check_aco_data(*aco_data) == 0) {
+      aco_data->stage_times.mark(STAGE::RECEIVED, rx_nsec);
+      aco_data->stage_times.mark(STAGE::PARSED);
       if (FLAGS_debug_socket_in)
-        VLOG(3) << "Received BNO";
-      bno_data = std::make_shared<UdpBnoData>(msg);
-      for (auto q_bno : argPtr->v_q_bno) {
-        q_bno->push(bno_data);
+        VLOG(3) << "Received AC; socket thread heartbeat" << " : ID " << pthread_self()
+                << " : latest packet num : " << aco_data->header.packet_num;
+      for (auto q_aco : this->v_q_aco) {
+        q_aco->push(aco_data);
       }
-      break;
-    case MSG_ID::BNR:
-      if (FLAGS_debug_socket_in)
-        VLOG(3) << "Received BNR";
-      bnr_data = std::make_shared<UdpBnrData>(msg);
-      for (auto q_bnr : argPtr->v_q_bnr) {
-        q_bnr->push(bnr_data);
+      for (auto out_queue: this->v_out_queue)
+      {
+        out_queue->push(aco_data);
       }
-      break;
+      aco_data->stage_times.mark(STAGE::ENQUEUED);
+    } else {
+      this->stats->rejected++;
+    }
 
-    case MSG_ID::EPT:
-      if (FLAGS_debug_socket_in)
-        VLOG(3) << "Received EPT";
-      ept_data = std::make_shared<UdpEptData>(msg);
-      for (auto q_ept : argPtr->v_q_ept) {
-        q_ept->push(ept_data);
-      }
-      break;
-    case MSG_ID::RTC:
-      if (FLAGS_debug_socket_in)
-        VLOG(3) << "Received RTC";
-      rtc_data = std::make_shared<UdpRtcData>(msg);
-      for (auto q_rtc : argPtr->v_q_rtc) {
-        q_rtc->push(rtc_data);
-      }
-      break;
+    break;
+  case MSG_ID::PTS:
+    if (FLAGS_debug_socket_in)
+      VLOG(3) << "Received PTS";
+    pts_data = std::make_shared<UdpPtsData>(msg);
+    for (auto q_pts : this->v_q_pts) {
+      q_pts->push(pts_data);
+    }
+    break;
+  case MSG_ID::IMU:
+    if (FLAGS_debug_socket_in)
+      VLOG(3) << "Received IMU";
+    imu_data = std::make_shared<UdpImuData>(msg);
+    for (auto q_imu : this->v_q_imu) {
+      q_imu->push(imu_data);
+    }
+    break;
+  case MSG_ID::BNO:
+    if (FLAGS_debug_socket_in)
+      VLOG(3) << "Received BNO";
+    bno_data = std::make_shared<UdpBnoData>(msg);
+    for (auto q_bno : this->v_q_bno) {
+      q_bno->push(bno_data);
+    }
+    break;
+  case MSG_ID::BNR:
+    if (FLAGS_debug_socket_in)
+      VLOG(3) << "Received BNR";
+    bnr_data = std::make_shared<UdpBnrData>(msg);
+    for (auto q_bnr : this->v_q_bnr) {
+      q_bnr->push(bnr_data);
+    }
+    break;
 
-    default:
-      break;
+  case MSG_ID::EPT:
+    if (FLAGS_debug_socket_in)
+      VLOG(3) << "Received EPT";
+    ept_data = std::make_shared<UdpEptData>(msg);
+    for (auto q_ept : this->v_q_ept) {
+      q_ept->push(ept_data);
     }
+    break;
+  case MSG_ID::RTC:
     if (FLAGS_debug_socket_in)
-      VLOG(2) << "Socket thread heartbeat : ID " << pthread_self();
-  }
+      VLOG(3) << "Received RTC";
+    rtc_data = std::make_shared<UdpRtcData>(msg);
+    for (auto q_rtc : this->v_q_rtc) {
+      q_rtc->push(rtc_data);
+    }
+    break;
 
-  argPtr->_is_running = false;
-  pthread_exit(NULL);
+  default:
+    break;
+  }
 }
+
 void UdpSocketIn::run() {
   LOG(WARNING) << ("Running UdpSocketIn");
   this->run_socket_thread();
@@ -452,6 +520,32 @@ void UdpSocketIn::register_client_beam2d(std::shared_ptr<tsQueue<std::shared_ptr
 
 
 
+bool UdpSocketIn::start_capture(std::string path) {
+  auto new_recorder = std::make_shared<PacketRecorder>();
+  if (!new_recorder->open(path)) {
+    return false;
+  }
+  auto old_recorder = std::atomic_exchange(&this->recorder, new_recorder);
+  if (old_recorder != nullptr) {
+    old_recorder->close();
+  }
+  return true;
+}
+
+void UdpSocketIn::stop_capture() {
+  auto old_recorder = std::atomic_exchange(&this->recorder, std::shared_ptr<PacketRecorder>());
+  if (old_recorder != nullptr) {
+    // the socket thread may still hold a reference; close() writes the index and closes the
+    // file under the recorder's mutex, after which its record() calls are no-ops
+    old_recorder->close();
+  }
+}
+
+uint64_t UdpSocketIn::get_num_captured() {
+  auto current = std::atomic_load(&this->recorder);
+  return current != nullptr ? current->get_num_packets() : 0;
+}
+
 bool UdpSocketIn::is_connected() { return this->m_socket > 0; }
 
 std::ostream &operator<<(std::ostream &os, const UdpSocketIn &st) {
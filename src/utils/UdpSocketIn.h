@@ -10,14 +10,35 @@
 #ifndef udp_socket_in_HEADER
 #define udp_socket_in_HEADER
 
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <memory>
 
 // includes from within project
 #include "utils/QueueClient.h"
 
+class PacketRecorder;
+
 DECLARE_bool(debug_socket_in);
 
-enum class MSG_ID { UNKNOWN, ACB2, ACBR, ACBC, ACO, PTS, IMU, EPT, RTC, BNO, BNR };
+enum class MSG_ID { UNKNOWN, ACB2, ACBR, ACBC, ACO, PTS, IMU, EPT, RTC, BNO, BNR, NUM_MSG_ID };
+const char *msg_id_name(MSG_ID id);
+
+// Receive counters per message type. Copies of a UdpSocketIn share one instance, so the
+// counters can be read from any thread (and outlive the socket).
+struct SocketStats {
+  std::array<std::atomic<uint64_t>, (size_t)MSG_ID::NUM_MSG_ID> packets{};
+  std::array<std::atomic<uint64_t>, (size_t)MSG_ID::NUM_MSG_ID> bytes{};
+  // decoded but rejected: acoustic layout mismatch, ACBC without its ACBR
+  std::atomic<uint64_t> rejected{0};
+
+  void count(MSG_ID id, size_t num_bytes) {
+    this->packets[(size_t)id].fetch_add(1, std::memory_order_relaxed);
+    this->bytes[(size_t)id].fetch_add(num_bytes, std::memory_order_relaxed);
+  }
+};
+
 struct UdpSocketIn {
   bool use_mcast;
   std::vector<std::shared_ptr<tsQueue<std::shared_ptr<UdpAcousticData>>>> v_out_queue;
@@ -63,6 +84,24 @@ struct UdpSocketIn {
   bool is_connected();
   void stop();
 
+  // Decode one raw datagram and push it to the registered queues; used by the socket
+  // thread and by PacketReplay. rx_nsec is the monotonic arrival time for latency
+  // tracking (now, if not given).
+  void dispatch(std::vector<int8_t> &msg, int64_t rx_nsec = -1);
+  // Message type of a raw datagram, from its leading id bytes
+  static MSG_ID check_msg_id(std::vector<int8_t> &msg);
+
+  std::shared_ptr<SocketStats> get_stats() const { return this->stats; }
+
+  // In-memory storage of received beampatterns (ACB2), for consumers keeping history
+  void set_beam_storage(BEAM_STORAGE storage) { this->beam_storage = storage; }
+  BEAM_STORAGE get_beam_storage() const { return this->beam_storage; }
+
+  // Record every received datagram, with its arrival time, to a capture file
+  bool start_capture(std::string path);
+  void stop_capture();
+  uint64_t get_num_captured();
+
   static std::shared_ptr<UdpSocketIn> create(bool use_mcast, std::string iface_ip, int32_t port, std::string mcast_group)
   {
     return std::make_shared<UdpSocketIn>(use_mcast, iface_ip, port, mcast_group);
@@ -76,11 +115,16 @@ protected:
   bool keep_alive = true;
   bool _is_running = false;
   std::string thread_name;
+  BEAM_STORAGE beam_storage = BEAM_STORAGE::FLOAT64;
+
+  // primary ACBR packet awaiting its ACBC continuation packets
+  std::shared_ptr<UdpBeamformRaw> beam_raw_0;
+  std::shared_ptr<PacketRecorder> recorder;
+  std::shared_ptr<SocketStats> stats = std::make_shared<SocketStats>();
 
   static void *_run_socket_thread(void *arg);
   static int configure_socket(UdpSocketIn &args);
   static int check_aco_data(UdpAcousticData aco_data);
-  static MSG_ID check_msg_id(std::vector<int8_t> &msg);
 };
 
 std::ostream &operator<<(std::ostream &os, const UdpSocketIn &st);
@@ -10,13 +10,139 @@
 #ifndef thread_safe_queue_HEADER
 #define thread_safe_queue_HEADER
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <glog/logging.h>
+#include <iomanip>
 #include <mutex>
+#include <ostream>
 #include <queue>
+#include <string>
+
+// Snapshot of a queue's counters; all counts are since creation (or reset_stats()).
+// pushes - pops - drops - cleared == depth holds only until the first reset_stats() on a
+// non-empty queue: the counters restart from zero, the depth does not
+struct QueueStats {
+  std::string name;
+  size_t depth = 0;
+  size_t max_length = 0; // 0 = unbounded
+  size_t high_water = 0;
+  uint64_t pushes = 0;
+  uint64_t pops = 0;
+  uint64_t drops = 0;     // oldest items discarded because the queue was full
+  uint64_t cleared = 0;   // items discarded by clear()
+  uint64_t wait_nsec = 0; // time consumers spent blocked waiting for data
+};
+
+inline std::ostream &operator<<(std::ostream &os, const QueueStats &st) {
+  os << st.name << " " << st.depth << "/";
+  if (st.max_length > 0)
+    os << st.max_length;
+  else
+    os << "inf";
+  os << " (hwm " << st.high_water << ", in " << st.pushes << ", out " << st.pops << ", drops "
+     << st.drops << ", cleared " << st.cleared << ", wait " << std::fixed << std::setprecision(1) << st.wait_nsec / 1e9
+     << " s)";
+  return os;
+}
+
+// Type-independent part of tsQueue: name, limits and counters. Counters are only written
+// with the queue's mutex held, but are atomic so get_stats() never takes the lock.
 class tsQueueBase {
 public:
   virtual ~tsQueueBase() {} // Virtual destructor for proper cleanup
+  virtual size_t size() = 0;
+
+  void set_queue_length(size_t max_length) { this->m_length = max_length; }
+  void warn_dropped_data(bool show_warning) { this->show_warning = show_warning; }
+
+  void set_name(std::string name) {
+    std::lock_guard<std::mutex> lock(this->name_mutex);
+    this->name = name;
+  }
+  std::string get_name() {
+    std::lock_guard<std::mutex> lock(this->name_mutex);
+    return this->name;
+  }
+
+  QueueStats get_stats() {
+    QueueStats stats;
+    stats.name = this->get_name();
+    stats.depth = this->depth.load(std::memory_order_relaxed);
+    stats.max_length = this->m_length;
+    stats.high_water = this->high_water.load(std::memory_order_relaxed);
+    stats.pushes = this->n_pushes.load(std::memory_order_relaxed);
+    stats.pops = this->n_pops.load(std::memory_order_relaxed);
+    stats.drops = this->n_drops.load(std::memory_order_relaxed);
+    stats.cleared = this->n_cleared.load(std::memory_order_relaxed);
+    stats.wait_nsec = this->wait_nsec.load(std::memory_order_relaxed);
+    return stats;
+  }
+  void reset_stats() {
+    this->high_water = this->depth.load();
+    this->n_pushes = 0;
+    this->n_pops = 0;
+    this->n_drops = 0;
+    this->n_cleared = 0;
+    this->wait_nsec = 0;
+  }
+
+protected:
+  // Use non-zero default limit to constrain growth when queue is populated but not read.
+  // A max length value of 0 allows unbounded growth.
+  size_t m_length = 1000;
+  bool show_warning = false;
+
+  std::mutex name_mutex;
+  std::string name;
+
+  std::atomic<size_t> depth{0};
+  std::atomic<size_t> high_water{0};
+  std::atomic<uint64_t> n_pushes{0};
+  std::atomic<uint64_t> n_pops{0};
+  std::atomic<uint64_t> n_drops{0};
+  std::atomic<uint64_t> n_cleared{0};
+  std::atomic<uint64_t> wait_nsec{0};
+
+  // drop warnings are summarized, at most one line per interval
+  std::chrono::steady_clock::time_point last_drop_warning;
+  uint64_t drops_since_warning = 0;
+  static constexpr std::chrono::seconds drop_warning_interval{10};
+
+  // Bookkeeping helpers; call with the queue's mutex held
+  void count_push(size_t num_items, size_t new_depth) {
+    this->n_pushes.fetch_add(num_items, std::memory_order_relaxed);
+    this->depth.store(new_depth, std::memory_order_relaxed);
+    if (new_depth > this->high_water.load(std::memory_order_relaxed))
+      this->high_water.store(new_depth, std::memory_order_relaxed);
+  }
+  void count_pop(size_t num_items, size_t new_depth) {
+    this->n_pops.fetch_add(num_items, std::memory_order_relaxed);
+    this->depth.store(new_depth, std::memory_order_relaxed);
+  }
+  void count_drop(const char *type_name) {
+    this->n_drops.fetch_add(1, std::memory_order_relaxed);
+    if (!this->show_warning)
+      return;
+    this->drops_since_warning++;
+    auto now = std::chrono::steady_clock::now();
+    if (now - this->last_drop_warning >= drop_warning_interval) {
+      std::string queue_name = this->get_name();
+      LOG(WARNING) << "Queue " << (queue_name.empty() ? type_name : queue_name)
+                   << " at max length of " << this->m_length << " items; dropped "
+                   << this->drops_since_warning << " oldest item(s) since last warning ("
+                   << this->n_drops.load(std::memory_order_relaxed) << " total)";
+      this->drops_since_warning = 0;
+      this->last_drop_warning = now;
+    }
+  }
+  void count_wait(std::chrono::steady_clock::time_point t_start) {
+    this->wait_nsec.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now() - t_start)
+                                  .count(),
+                              std::memory_order_relaxed);
+  }
 };
 
 template <typename T> class tsQueue : public tsQueueBase {
@@ -24,20 +150,28 @@ private:
   std::queue<T> m_queue;
   std::mutex m_mutex;
   std::condition_variable m_cond;
-  size_t m_length;
-  bool show_warning;
 
-public:
-  tsQueue() {
-    // Use non-zero default limit to constrain growth when queue is populated but not read.
-    // A max length value of 0 allows unbounded growth.
-    this->m_length = 1000;
-    this->show_warning = false;
+  // Block until pred() holds; only actual blocking is counted as wait time
+  template <typename P> void wait(std::unique_lock<std::mutex> &lock, P pred) {
+    if (pred())
+      return;
+    auto t_start = std::chrono::steady_clock::now();
+    m_cond.wait(lock, pred);
+    this->count_wait(t_start);
+  }
+  template <typename P>
+  bool wait_for(std::unique_lock<std::mutex> &lock, std::chrono::seconds timeout, P pred) {
+    if (pred())
+      return true;
+    auto t_start = std::chrono::steady_clock::now();
+    bool ready = m_cond.wait_for(lock, timeout, pred);
+    this->count_wait(t_start);
+    return ready;
   }
-  tsQueue(size_t max_length) : tsQueue() { this->m_length = max_length; }
 
-  void set_queue_length(size_t max_length) { this->m_length = max_length; }
-  void warn_dropped_data(bool show_warning) { this->show_warning = show_warning; }
+public:
+  tsQueue() {}
+  tsQueue(size_t max_length) : tsQueue() { this->m_length = max_length; }
 
   static std::shared_ptr<tsQueue<T>> create()
   {
@@ -49,13 +183,10 @@ public:
     std::lock_guard<std::mutex> lock(m_mutex);
     m_queue.push(item);
     if (m_length > 0 && m_queue.size() > m_length) {
-      if (this->show_warning)
-      {
-        LOG(WARNING) << "Queue at max length of " << m_length << " items; dropping oldest item";
-        LOG(WARNING) << typeid(T).name();
-      }
+      this->count_drop(typeid(T).name());
       m_queue.pop();
     }
+    this->count_push(1, m_queue.size());
     m_cond.notify_one();
   }
 
@@ -65,14 +196,10 @@ public:
       m_queue.push(item_vec.at(ii));
     }
     while (m_length > 0 && m_queue.size() > m_length) {
-      if (this->show_warning)
-      {
-        LOG(WARNING) << "Queue at max length of " << m_length << " items; dropping oldest item";
-        LOG(WARNING) << typeid(T).name();
-
-      }
+      this->count_drop(typeid(T).name());
       m_queue.pop();
     }
+    this->count_push(item_vec.size(), m_queue.size());
     m_cond.notify_one();
   }
 
@@ -80,19 +207,21 @@ public:
   // ==============
   T pop() {
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_cond.wait(lock, [this]() { return !m_queue.empty(); });
+    this->wait(lock, [this]() { return !m_queue.empty(); });
 
     T item = m_queue.front();
     m_queue.pop();
+    this->count_pop(1, m_queue.size());
     return item;
   }
 
   bool pop(T &dst) {
     std::unique_lock<std::mutex> lock(m_mutex);
-    if (m_cond.wait_for(lock, std::chrono::seconds(1), [this]() { return !m_queue.empty(); })) {
+    if (this->wait_for(lock, std::chrono::seconds(1), [this]() { return !m_queue.empty(); })) {
 
       dst = m_queue.front();
       m_queue.pop();
+      this->count_pop(1, m_queue.size());
       return true;
     }
     return false;
@@ -100,7 +229,7 @@ public:
 
   std::vector<T> pop_N(size_t nn) {
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_cond.wait(lock, [this, nn]() { return m_queue.size() >= nn; });
+    this->wait(lock, [this, nn]() { return m_queue.size() >= nn; });
 
     std::vector<T> vec;
     size_t q_count = m_queue.size();
@@ -108,12 +237,13 @@ public:
       vec.push_back(m_queue.front());
       m_queue.pop();
     }
+    this->count_pop(q_count, 0);
     return vec;
   }
 
   std::vector<T> pop_all() {
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_cond.wait(lock, [this]() { return !m_queue.empty(); });
+    this->wait(lock, [this]() { return !m_queue.empty(); });
 
     std::vector<T> vec;
     size_t q_count = m_queue.size();
@@ -121,12 +251,13 @@ public:
       vec.push_back(m_queue.front());
       m_queue.pop();
     }
+    this->count_pop(q_count, 0);
     return vec;
   }
 
   bool pop_all(std::vector<T> &dst) {
     std::unique_lock<std::mutex> lock(m_mutex);
-    if (m_cond.wait_for(lock, std::chrono::seconds(1), [this]() { return !m_queue.empty(); })) {
+    if (this->wait_for(lock, std::chrono::seconds(1), [this]() { return !m_queue.empty(); })) {
 
       dst.clear();
       size_t q_count = m_queue.size();
@@ -134,6 +265,7 @@ public:
         dst.push_back(m_queue.front());
         m_queue.pop();
       }
+      this->count_pop(q_count, 0);
       return true;
     }
     return false;
@@ -141,7 +273,7 @@ public:
 
   std::vector<T> pop_limit(int max_its) {
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_cond.wait(lock, [this]() { return !m_queue.empty(); });
+    this->wait(lock, [this]() { return !m_queue.empty(); });
 
     std::vector<T> vec;
     size_t q_count = m_queue.size();
@@ -149,12 +281,13 @@ public:
       vec.push_back(m_queue.front());
       m_queue.pop();
     }
+    this->count_pop(vec.size(), m_queue.size());
     return vec;
   }
 
   T front() {
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_cond.wait(lock, [this]() { return !m_queue.empty(); });
+    this->wait(lock, [this]() { return !m_queue.empty(); });
 
     T item = m_queue.front();
     return item;
@@ -162,7 +295,7 @@ public:
 
   T back() {
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_cond.wait(lock, [this]() { return !m_queue.empty(); });
+    this->wait(lock, [this]() { return !m_queue.empty(); });
 
     T item = m_queue.back();
     return item;
@@ -176,11 +309,13 @@ public:
     for (int ii = 0; ii < q_count; ii++) {
       m_queue.pop();
     }
+    this->n_cleared.fetch_add(q_count, std::memory_order_relaxed);
+    this->depth.store(0, std::memory_order_relaxed);
   }
 
   // Query queue info
   // ================
-  size_t size() {
+  size_t size() override {
     std::lock_guard<std::mutex> lock(m_mutex);
     return m_queue.size();
   }